@@ -1,19 +1,201 @@
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+
 #include "GHE_Algorithm.h"
+#include "GHE_Trace.h"
+
+// Contexts registered per pipe. Creation and destruction are expected to happen from the
+// modeset path and are not serialized against each other.
+static GlobalHist_CONTEXT *PipeContext[GlobalHist_MAX_PIPES];
 
+// Records every processed frame while set, see DisplayGheSetTraceRecorder. A frame announces
+// itself in the counter of the current epoch before it loads the writer again, and leaves once its
+// record is written. A setter flips the epoch and waits for the old counter to drain, frames that
+// arrive meanwhile count in the other one.
+static _Atomic(GlobalHist_TRACE_WRITER *) pTraceRecorder;
+static atomic_uint TraceEpoch;
+static atomic_uint TraceFramesInFlight[2];
+
+static bool IsRegisteredPipe(PIPE_ID Pipe)
+{
+    return ((uint32_t)Pipe < GlobalHist_MAX_PIPES);
+}
 
 void SetHistogramDataBin(GlobalHist_ARGS *GheArgs)
 {
-  
-   GlobalHist_CONTEXT* pGheContext = (GlobalHist_CONTEXT *)malloc(sizeof(GlobalHist_CONTEXT));
-   
-   memcpy(pGheContext->Histogram, GheArgs->Histogram, GlobalHist_BIN_COUNT * sizeof(uint32_t));    
-   
-   pGheContext->Algorithm.ImageSize = (GheArgs->Resolution_X * GheArgs->Resolution_Y);
+   GlobalHist_CONTEXT *pGheContext = DisplayGheGetPipeContext(GheArgs->PipeId);
+
+   // First histogram of a pipe creates its context, every later frame reuses it.
+   if (NULL == pGheContext)
+   {
+       pGheContext = DisplayGheCreateContext(GheArgs->PipeId);
+
+       if (NULL == pGheContext)
+       {
+           return;
+       }
+   }
+
+   DisplayGheProcessFrame(pGheContext, GheArgs);
+}
+
+size_t DisplayGheGetContextSize(void)
+{
+    return sizeof(GlobalHist_CONTEXT);
+}
+
+GlobalHist_CONTEXT *DisplayGheCreateContextInPlace(PIPE_ID Pipe, void *pMemory, size_t MemorySize)
+{
+    GlobalHist_CONTEXT *pGheContext = (GlobalHist_CONTEXT *)pMemory;
+
+    if ((NULL == pMemory) || (MemorySize < sizeof(GlobalHist_CONTEXT)) ||
+        (0 != ((uintptr_t)pMemory % GlobalHist_CONTEXT_ALIGNMENT)))
+    {
+        return NULL;
+    }
+
+    if (IsRegisteredPipe(Pipe) && (NULL != PipeContext[Pipe]))
+    {
+        return NULL;
+    }
+
+    memset(pGheContext, 0, sizeof(GlobalHist_CONTEXT));
+    pGheContext->Pipe                = Pipe;
+    pGheContext->IsCallerOwnedMemory = TRUE;
+
+    DisplayInitializeAlgorithmState(pGheContext);
+
+    if (IsRegisteredPipe(Pipe))
+    {
+        PipeContext[Pipe] = pGheContext;
+    }
+
+    return pGheContext;
+}
+
+GlobalHist_CONTEXT *DisplayGheCreateContext(PIPE_ID Pipe)
+{
+    GlobalHist_CONTEXT *pGheContext;
+    void *pMemory = malloc(sizeof(GlobalHist_CONTEXT));
+
+    if (NULL == pMemory)
+    {
+        return NULL;
+    }
+
+    pGheContext = DisplayGheCreateContextInPlace(Pipe, pMemory, sizeof(GlobalHist_CONTEXT));
+
+    if (NULL == pGheContext)
+    {
+        free(pMemory);
+        return NULL;
+    }
+
+    pGheContext->IsCallerOwnedMemory = FALSE;
+
+    return pGheContext;
+}
+
+static void RecordFrame(GlobalHist_CONTEXT *pGheContext, const GlobalHist_ARGS *GheArgs)
+{
+    uint32_t Epoch = atomic_load(&TraceEpoch);
+    GlobalHist_TRACE_WRITER *pWriter;
+
+    atomic_fetch_add(&TraceFramesInFlight[Epoch & 1], 1);
+
+    // Loaded after the announcement, so a setter that missed this frame has stored its writer first
+    pWriter = atomic_load(&pTraceRecorder);
+
+    if (NULL != pWriter)
+    {
+        struct timespec Now;
+
+        // A writer set since the last setup record of the context, or a setter ran
+        if (Epoch + 1 != pGheContext->TraceSetupEpoch)
+        {
+            GlobalHist_TRACE_SETUP Setup;
+
+            Setup.Cfg              = pGheContext->GheCfg;
+            Setup.TransferFunction = pGheContext->TransferFunction;
+            Setup.Precision        = pGheContext->Precision;
+            Setup.ChangeTolerance  = pGheContext->ChangeDetection.Tolerance;
+            Setup.CacheKeyShift    = pGheContext->ChangeDetection.CacheKeyShift;
+
+            DisplayGheTraceRecordSetup(pWriter, pGheContext->Pipe, &Setup);
+            pGheContext->TraceSetupEpoch = Epoch + 1;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &Now);
+        DisplayGheTraceRecord(pWriter, (uint64_t)Now.tv_sec * 1000000000ull + (uint64_t)Now.tv_nsec, GheArgs);
+    }
+
+    atomic_fetch_sub_explicit(&TraceFramesInFlight[Epoch & 1], 1, memory_order_release);
+}
+
+// Per frame path. No allocation and no re-initialization, temporal filter state carries over.
+void DisplayGheProcessFrame(GlobalHist_CONTEXT *pGheContext, GlobalHist_ARGS *GheArgs)
+{
+    GlobalHist_STATS_TIMER_START(FrameStart);
 
-   DisplayInitializeAlgorithm(pGheContext, GheArgs);
+    memcpy(pGheContext->Histogram, GheArgs->Histogram, GlobalHist_BIN_COUNT * sizeof(uint32_t));
 
+    pGheContext->Algorithm.ImageSize = (GheArgs->Resolution_X * GheArgs->Resolution_Y);
+
+    pGheContext->GheFuncTable.pGheAlgorithm(pGheContext, GheArgs);
+
+    GlobalHist_STATS_TIMER_START(DietStart);
+    pGheContext->GheFuncTable.pGheSetIet(pGheContext, GheArgs);
+    GlobalHist_STATS_TIMER_STOP(pGheContext, GlobalHist_STATS_STAGE_PROGRAM_DIET, DietStart);
+
+    GlobalHist_STATS_COUNT(pGheContext, FramesProcessed, 1);
+    GlobalHist_STATS_TIMER_STOP(pGheContext, GlobalHist_STATS_STAGE_FRAME, FrameStart);
+    GlobalHist_STATS_PUBLISH(pGheContext);
+
+    if (NULL != atomic_load_explicit(&pTraceRecorder, memory_order_acquire))
+    {
+        RecordFrame(pGheContext, GheArgs);
+    }
+}
+
+void DisplayGheSetTraceRecorder(GlobalHist_TRACE_WRITER *pWriter)
+{
+    uint32_t Epoch;
+
+    atomic_store(&pTraceRecorder, pWriter);
+    Epoch = atomic_fetch_add(&TraceEpoch, 1) & 1;
+
+    // Frames of the old epoch may still hold the previous writer
+    while (0 != atomic_load(&TraceFramesInFlight[Epoch]))
+    {
+        sched_yield();
+    }
 }
 
+void DisplayGheDestroyContext(GlobalHist_CONTEXT *pGheContext)
+{
+    if (NULL == pGheContext)
+    {
+        return;
+    }
 
+    if (IsRegisteredPipe(pGheContext->Pipe) && (PipeContext[pGheContext->Pipe] == pGheContext))
+    {
+        PipeContext[pGheContext->Pipe] = NULL;
+    }
 
+    if (FALSE == pGheContext->IsCallerOwnedMemory)
+    {
+        free(pGheContext);
+    }
+}
 
+GlobalHist_CONTEXT *DisplayGheGetPipeContext(PIPE_ID Pipe)
+{
+    if (FALSE == IsRegisteredPipe(Pipe))
+    {
+        return NULL;
+    }
+
+    return PipeContext[Pipe];
+}
@@ -31,6 +31,8 @@
 
 #define GlobalHist_BIN_COUNT 32   // Total number of segments in GlobalHist
 #define GlobalHist_IET_LUT_LENGTH 33 // Total number of IET entries
+#define GlobalHist_MAX_PIPES 4    // Number of pipes that can own a persistent context
+#define GlobalHist_CONTEXT_ALIGNMENT 8 // Required alignment of caller provided context memory
 
 typedef enum _PIPE_ID  {
     NULL_PIPE = 0x7F,
@@ -41,6 +43,7 @@ typedef enum _PIPE_ID  {
     GlobalHist_PIPE_D = 3
 } PIPE_ID;
 
+// Zero-initialize before filling in, fields appended to the end default to 0 (unknown)
 typedef struct _DD_GlobalHist_ARGS
 {
     PIPE_ID PipeId;
@@ -49,12 +52,83 @@ typedef struct _DD_GlobalHist_ARGS
     uint32_t Histogram[GlobalHist_BIN_COUNT];
     uint32_t Resolution_X;
     uint32_t Resolution_Y;
+    uint64_t TimestampNs;   // Monotonic time the histogram was sampled at, 0 when unknown (assumes about 30 Hz)
 }GlobalHist_ARGS;
 
+// Transfer function of the pipe signal. Bins are weighted by their decoded linear light.
+typedef enum _GlobalHist_TRANSFER_FUNCTION
+{
+    GlobalHist_TRANSFER_SRGB    = 0, // IEC 61966-2-1, the default
+    GlobalHist_TRANSFER_GAMMA22 = 1, // Pure 2.2 power
+    GlobalHist_TRANSFER_PQ      = 2, // SMPTE ST 2084 EOTF, 1.0 is 10000 nits
+    GlobalHist_TRANSFER_HLG     = 3, // ARIB STD-B67 inverse OETF, scene light
+    GlobalHist_TRANSFER_COUNT
+} GlobalHist_TRANSFER_FUNCTION;
+
+// Arithmetic of the enhancement target computation, see DisplayGheSetPrecision
+typedef enum _GlobalHist_PRECISION
+{
+    GlobalHist_PRECISION_DOUBLE = 0, // The default, bit exact on every GlobalHist_ISA
+    GlobalHist_PRECISION_SINGLE = 1, // Float, twice the SIMD lanes. DietFactor within one LSB of the double path.
+    GlobalHist_PRECISION_COUNT
+} GlobalHist_PRECISION;
+
+// Tunable algorithm parameters, see DisplayGheSetConfig
+typedef struct _GlobalHist_CFG
+{
+    double MinimumStepPercent;  // The filter snaps to the target once every entry is this close, in 100 * percent
+    double MinIIRCutOffFreq;    // Temporal filter cut off frequency for unchanged brightness, in Hz with milli Hz resolution
+    double MaxIIRCutOffFreq;    // Cut off frequency for a full brightness change
+    double MinPhaseInDuration;  // Shortest time in ms a raised cut off frequency is kept
+    double MaxPhaseInDuration;  // Longest time in ms one frame moves the filter by, however late it is
+    double MinSlope;            // Clamp of the enhancement curve slope
+    double MaxSlope;
+} GlobalHist_CFG;
+
+// Opaque per-pipe algorithm state. Lives across frames so that the temporal filter history is kept.
+typedef struct _GlobalHist_CONTEXT GlobalHist_CONTEXT;
+
 
 void SetHistogramDataBin(GlobalHist_ARGS *GheArgs);
 
-                 
+// Context life cycle.
+// A context created for GlobalHist_PIPE_A..D is registered for that pipe and is looked up by SetHistogramDataBin.
+// Contexts for any other PIPE_ID are not registered and can only be driven through DisplayGheProcessFrame.
+size_t DisplayGheGetContextSize(void);
+GlobalHist_CONTEXT *DisplayGheCreateContext(PIPE_ID Pipe);
+GlobalHist_CONTEXT *DisplayGheCreateContextInPlace(PIPE_ID Pipe, void *pMemory, size_t MemorySize);
+void DisplayGheProcessFrame(GlobalHist_CONTEXT *pGheContext, GlobalHist_ARGS *GheArgs);
+void DisplayGheDestroyContext(GlobalHist_CONTEXT *pGheContext);
+GlobalHist_CONTEXT *DisplayGheGetPipeContext(PIPE_ID Pipe);
+
+// Change detection for static and repeating content.
+// Once the temporal filter has converged, a frame whose histogram is within Tolerance of the last
+// processed one keeps the programmed DietFactor without running the algorithm. Tolerance is the
+// summed absolute bin difference in 1/65536 of the pixel count.
+// Enhancement targets are cached per histogram with the low CacheKeyShift bits of every bin dropped.
+// The default of 0, 0 only matches identical histograms, so the DietFactor is bit exact.
+void DisplayGheSetChangeDetection(GlobalHist_CONTEXT *pGheContext, uint32_t Tolerance, uint32_t CacheKeyShift);
+
+// Decoding curve the solid color and brightness change estimates weight bins with, sRGB by default.
+// Switching drops the cached enhancement targets and the converged state of the change detection.
+// Returns FALSE for an unknown transfer function.
+bool DisplayGheSetTransferFunction(GlobalHist_CONTEXT *pGheContext, GlobalHist_TRANSFER_FUNCTION TransferFunction);
+
+// Precision the LutTarget kernels run at, double by default. The temporal filter state stays
+// double either way. Switching drops the cached enhancement targets and the converged state of the
+// change detection. Returns FALSE for an unknown precision.
+bool DisplayGheSetPrecision(GlobalHist_CONTEXT *pGheContext, GlobalHist_PRECISION Precision);
+
+// Runtime parameters. Contexts start with the defaults. Taking a new config drops the cached
+// enhancement targets and the converged state of the change detection, the temporal filter
+// history is kept. Returns FALSE and changes nothing when a value is out of range:
+// 0.001 <= MinIIRCutOffFreq <= MaxIIRCutOffFreq <= 1000 Hz, MinimumStepPercent in [0, 10000],
+// MinPhaseInDuration in [0, 60000] ms, MaxPhaseInDuration in (0, 1000] ms and 0 <= MinSlope <= MaxSlope <= 64.
+void DisplayGheGetDefaultConfig(GlobalHist_CFG *pCfg);
+bool DisplayGheIsValidConfig(const GlobalHist_CFG *pCfg);
+bool DisplayGheSetConfig(GlobalHist_CONTEXT *pGheContext, const GlobalHist_CFG *pCfg);
+void DisplayGheGetConfig(const GlobalHist_CONTEXT *pGheContext, GlobalHist_CFG *pCfg);
+
 
 
 #endif
@@ -1,29 +1,45 @@
+#include <pthread.h>
+
 #include "GHE_Algorithm.h"
+#include "GHE_DeGamma.h"
+#include "GHE_Engine.h"
+
+static double IIRCoefficientTable[GlobalHist_IIR_COEFFICIENT_TABLE_SIZE + 1];
+static pthread_once_t IIRCoefficientTableOnce = PTHREAD_ONCE_INIT;
 
 void DisplayInitializeAlgorithm(GlobalHist_CONTEXT *pGheContext,GlobalHist_ARGS *GheArgs )
+{
+    DisplayInitializeAlgorithmState(pGheContext);
+
+    // This call will manage the GlobalHist algorithm and activate Phase-In.
+    pGheContext->GheFuncTable.pGheAlgorithm(pGheContext, GheArgs);
+    
+    // Program calculated DIET factor
+    pGheContext->GheFuncTable.pGheSetIet(pGheContext, GheArgs);
+      
+}
+
+// One time setup of a context. Everything done here survives across frames.
+void DisplayInitializeAlgorithmState(GlobalHist_CONTEXT *pGheContext)
 {
 
     pGheContext->GheFuncTable.pGheAlgorithm      = (PFN_GlobalHistALGORITHM)DisplayGheAlgorithm ;
     pGheContext->GheFuncTable.pGheSetIet         = (PFN_GlobalHistPROGRAMIETREGISTERS)DisplaySetDietReg;
     
     pGheContext->GheFuncTable.pGheResetAlgorithm = (PFN_GlobalHistRESETALGORITHM)DisplayResetAlgorithm;
+
+    // Exact change detection and an empty LUT cache
+    memset(&pGheContext->ChangeDetection, 0, sizeof(pGheContext->ChangeDetection));
       
     // Reset GlobalHist data structures
     pGheContext->GheFuncTable.pGheResetAlgorithm(pGheContext);
 
+    DisplayGheGetDefaultConfig(&pGheContext->GheCfg);
     DisplayInitializeTemporalIIRFilterParams(pGheContext);
 
-    double HistLutStepSize = 1.0 / (double)GlobalHist_MAX_BIN_INDEX;
-
-    for(uint8_t BinIndex=0; BinIndex<GlobalHist_MAX_BIN_INDEX; BinIndex++)
-       pGheContext->DeGammaLUT[BinIndex] = GetSRGBDecodingValue((double)BinIndex * HistLutStepSize);
-    
-    // This call will manage the GlobalHist algorithm and activate Phase-In.
-    pGheContext->GheFuncTable.pGheAlgorithm(pGheContext, GheArgs);
-    
-    // Program calculated DIET factor
-    pGheContext->GheFuncTable.pGheSetIet(pGheContext, GheArgs);
-      
+    pGheContext->TransferFunction = GlobalHist_TRANSFER_SRGB;
+    pGheContext->pDeGammaLUT      = DisplayGheGetDeGammaLUT(GlobalHist_TRANSFER_SRGB, GlobalHist_BIN_COUNT);
+    pGheContext->Precision        = GlobalHist_PRECISION_DOUBLE;
 }
 
 double GetSRGBDecodingValue(double input)
@@ -46,14 +62,16 @@ void DisplayInitializeTemporalIIRFilterParams(GlobalHist_CONTEXT *pGheContext)
 {
     pGheContext->FilterParams.MinCutOffFreqInMilliHz = GlobalHist_SMOOTHENING_MIN_SPEED_DEFAULT;
     pGheContext->FilterParams.MaxCutOffFreqInMilliHz = GlobalHist_SMOOTHENING_MAX_SPEED_DEFAULT;
+    pGheContext->FilterParams.CurrentMinCutOffFreqInMilliHz = DD_MIN(pGheContext->FilterParams.MaxCutOffFreqInMilliHz, pGheContext->FilterParams.MinCutOffFreqInMilliHz);
     pGheContext->FilterParams.CurrentMaxCutOffFreqInMilliHz = DD_MAX(pGheContext->FilterParams.MaxCutOffFreqInMilliHz, pGheContext->FilterParams.MinCutOffFreqInMilliHz);
     pGheContext->FilterParams.MinimumStepPercent = GlobalHist_SMOOTHENING_TOLERANCE_DEFAULT;
+    DisplayGheInitializeFilterClock(&pGheContext->FilterParams.Clock);
    
     for (uint8_t IetBinIndex = 0; IetBinIndex < GlobalHist_IET_LUT_LENGTH; IetBinIndex++)
     {
         for ( uint8_t FilterOrder = 0; FilterOrder < GlobalHist_IIR_FILTER_ORDER; FilterOrder++)
         {
-            pGheContext->FilterParams.IETHistory[IetBinIndex][FilterOrder] = GlobalHist_IET_SCALE_FACTOR;
+            pGheContext->FilterParams.IETHistory[FilterOrder][IetBinIndex] = GlobalHist_IET_SCALE_FACTOR;
         }
     }
 
@@ -64,137 +82,340 @@ void DisplayInitializeTemporalIIRFilterParams(GlobalHist_CONTEXT *pGheContext)
 
 } 
 
-void DisplayGheAlgorithm(GlobalHist_CONTEXT *pGheContext, GlobalHist_ARGS *GheArgs)
-{ 
+static bool SmoothenIET(GlobalHist_CONTEXT *pGheContext, double FramePower);
+
+// Cheap change check against the last processed histogram, one pass over the bins
+static bool IsHistogramUnchanged(GlobalHist_CONTEXT *pGheContext, uint32_t *pTotalNumOfPixel)
+{
+    const uint32_t *pHistogram = pGheContext->Histogram;
+    const uint32_t *pPrevHistogram = pGheContext->FilterParams.PrevHistogram;
+    uint64_t Distance = 0;
     uint32_t TotalNumOfPixel = 0;
-    uint32_t *pMultiplierLut = pGheContext->ImageEnhancement.LutTarget;
-
-    double EnhancementTable[GlobalHist_BIN_COUNT];
-    double FilteredEnhancementTable[GlobalHist_BIN_COUNT];
-    double BinIndexNormalized, IetVal;
-    double CDFRange, CdfNormalizingFactor;
-    double ProbabilityOfFullScreenSolidColor;
-    double SumPower = 0; // Total Power of input frame
-    double PowerDistribution[GlobalHist_BIN_COUNT]; // Histogram bin wise distribution of power
-
-    const double MaxHistBinIndex = GlobalHist_MAX_BIN_INDEX;
-    const double IetLutStepSize = 1.0 / (double)GlobalHist_MAX_IET_INDEX;
-    const double HistBinStepSize = 1.0 / MaxHistBinIndex;
-    const double MaxSlope = 7.0;
-    const double MinSlope = 0.3;
 
-    for (uint8_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        TotalNumOfPixel += pHistogram[BinIndex];
+        Distance += DD_DIFF(pHistogram[BinIndex], pPrevHistogram[BinIndex]);
+    }
+
+    *pTotalNumOfPixel = TotalNumOfPixel;
+
+    return (Distance * GlobalHist_CHANGE_TOLERANCE_SCALE <= (uint64_t)pGheContext->ChangeDetection.Tolerance * TotalNumOfPixel);
+}
+
+static void ClearLutCache(GlobalHist_CHANGE_DETECTION *pChange)
+{
+    memset(pChange->CacheFingerprint, 0, sizeof(pChange->CacheFingerprint));
+    memset(pChange->CacheLastUse, 0, sizeof(pChange->CacheLastUse));
+}
+
+// The setup the targets depend on changed. Cached targets are stale, and the filter converged on
+// a target of the old setup, so KeepConvergedLut must not hold LutApplied on the next frame.
+static void DropConvergedLut(GlobalHist_CHANGE_DETECTION *pChange)
+{
+    ClearLutCache(pChange);
+    pChange->IsConverged = FALSE;
+}
+
+// LutTarget of the current histogram, from the cache when it was seen before. A cached target
+// only depends on the histogram and the DeGamma LUT, so an exact key gives an exact target.
+static bool GetLutTarget(GlobalHist_CONTEXT *pGheContext, uint32_t *pTotalNumOfPixel, double *pFramePower)
+{
+    GlobalHist_CHANGE_DETECTION *pChange = &pGheContext->ChangeDetection;
+    GlobalHist_LUT_CACHE_ENTRY *pEntry;
+    GlobalHist_ENGINE_32_33_ANALYSIS Analysis;
+    uint32_t Key[GlobalHist_BIN_COUNT];
+    uint64_t Fingerprint = 0;
+    uint32_t TotalNumOfPixel = 0;
+    uint32_t Victim = 0;
+
+    // Every bin times its own odd constant. No dependency chain between bins, unlike a byte wise hash.
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
     {
         TotalNumOfPixel += pGheContext->Histogram[BinIndex];
-        EnhancementTable[BinIndex] = TotalNumOfPixel;
+        Key[BinIndex] = pGheContext->Histogram[BinIndex] >> pChange->CacheKeyShift;
+        Fingerprint += (uint64_t)Key[BinIndex] * (0x9E3779B97F4A7C15ull ^ ((uint64_t)BinIndex * 0x632BE59BD9B4E01Aull));
     }
 
-    pGheContext->Algorithm.ImageSize = TotalNumOfPixel;
+    Fingerprint = (Fingerprint ^ (Fingerprint >> 29)) | 1;
+    pChange->UseCounter++;
 
-    // Calculate histogram bin wise power distribution and total frame power
-    for (uint8_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    for (uint32_t EntryIndex = 0; EntryIndex < GlobalHist_LUT_CACHE_ENTRIES; EntryIndex++)
+    {
+        GlobalHist_LUT_CACHE_ENTRY *pCandidate = &pChange->Cache[EntryIndex];
+
+        if ((Fingerprint == pChange->CacheFingerprint[EntryIndex]) && (0 == memcmp(Key, pCandidate->Key, sizeof(Key))))
+        {
+            memcpy(pGheContext->ImageEnhancement.LutTarget, pCandidate->LutTarget, sizeof(pCandidate->LutTarget));
+            pChange->CacheLastUse[EntryIndex] = pChange->UseCounter;
+            pChange->CacheHits++;
+
+            *pTotalNumOfPixel = TotalNumOfPixel;
+            *pFramePower = DisplayGheEngine_32_33_GetFramePower(pGheContext->Histogram, pGheContext->pDeGammaLUT);
+
+            return pCandidate->IsEnhanced;
+        }
+
+        // Least recently used entry is replaced on a miss, unused entries have LastUse 0
+        Victim = (pChange->CacheLastUse[EntryIndex] < pChange->CacheLastUse[Victim]) ? EntryIndex : Victim;
+    }
+
+    pChange->CacheMisses++;
+
+    pEntry = &pChange->Cache[Victim];
+
+    if (GlobalHist_PRECISION_SINGLE == pGheContext->Precision)
     {
-        double BinWeight = pGheContext->DeGammaLUT[BinIndex];
-        PowerDistribution[BinIndex] = BinWeight * (double)pGheContext->Histogram[BinIndex];
+        pEntry->IsEnhanced = DisplayGheEngine_32_33_ComputeLutTargetSingle(pGheContext->Histogram, pGheContext->pDeGammaLUT, pGheContext->GheCfg.MinSlope,
+                                                                           pGheContext->GheCfg.MaxSlope, pGheContext->ImageEnhancement.LutTarget, &Analysis);
+    }
+    else
+    {
+        pEntry->IsEnhanced = DisplayGheEngine_32_33_ComputeLutTarget(pGheContext->Histogram, pGheContext->pDeGammaLUT, pGheContext->GheCfg.MinSlope,
+                                                                     pGheContext->GheCfg.MaxSlope, pGheContext->ImageEnhancement.LutTarget, &Analysis);
+    }
+
+    pChange->CacheFingerprint[Victim] = Fingerprint;
+    pChange->CacheLastUse[Victim] = pChange->UseCounter;
+    memcpy(pEntry->Key, Key, sizeof(Key));
+    memcpy(pEntry->LutTarget, pGheContext->ImageEnhancement.LutTarget, sizeof(pEntry->LutTarget));
+    GlobalHist_STATS_COUNT(pGheContext, MinSlopeClamps, Analysis.MinSlopeClamps);
+    GlobalHist_STATS_COUNT(pGheContext, MaxSlopeClamps, Analysis.MaxSlopeClamps);
+    GlobalHist_STATS_COUNT(pGheContext, IetMaxClamps, Analysis.IetMaxClamps);
+
+    *pTotalNumOfPixel = Analysis.TotalNumOfPixel;
+    *pFramePower = Analysis.FramePower;
+
+    return pEntry->IsEnhanced;
+}
 
-        SumPower += PowerDistribution[BinIndex];
+// Static content. The filter already sits on the target of this histogram, keep LutApplied.
+static bool KeepConvergedLut(GlobalHist_CONTEXT *pGheContext)
+{
+    GlobalHist_CHANGE_DETECTION *pChange = &pGheContext->ChangeDetection;
+    uint32_t TotalNumOfPixel;
+
+    if ((FALSE == pChange->IsConverged) || (FALSE == IsHistogramUnchanged(pGheContext, &TotalNumOfPixel)))
+    {
+        return FALSE;
     }
 
-    ProbabilityOfFullScreenSolidColor = EstimateProbabilityOfFullScreenSolidColor(PowerDistribution, SumPower);
+    memcpy(pGheContext->ImageEnhancement.LutTarget, pGheContext->ImageEnhancement.LutApplied, sizeof(pGheContext->ImageEnhancement.LutTarget));
+    pGheContext->Algorithm.ImageSize = TotalNumOfPixel;
+    pChange->FastPathHits++;
+
+    return TRUE;
+}
+
+// Filter stage, LutTarget holds the target of the current histogram. Returns TRUE when the filter
+// snapped to it.
+static bool ApplyLutTarget(GlobalHist_CONTEXT *pGheContext, bool IsEnhanced, uint32_t TotalNumOfPixel, double FramePower)
+{
+    GlobalHist_CHANGE_DETECTION *pChange = &pGheContext->ChangeDetection;
+
+    pGheContext->Algorithm.ImageSize = TotalNumOfPixel;
 
     // Do not modify pixel values for Solid Color
-    if (1 == ProbabilityOfFullScreenSolidColor)
+    if (FALSE == IsEnhanced)
     {
-        for (uint8_t BinIndex = 0; BinIndex < GlobalHist_IET_LUT_LENGTH; BinIndex++)
-        {
-            pMultiplierLut[BinIndex] = GlobalHist_IET_SCALE_FACTOR;
-        }
+        GlobalHist_STATS_COUNT(pGheContext, SolidColorFrames, 1);
+        return FALSE;
+    }
+
+    GlobalHist_STATS_TIMER_START(FilterStart);
+    pChange->IsConverged = SmoothenIET(pGheContext, FramePower);
+    GlobalHist_STATS_TIMER_STOP(pGheContext, GlobalHist_STATS_STAGE_TEMPORAL_FILTER, FilterStart);
+    GlobalHist_STATS_FILTER_STEP(pGheContext, pChange->IsConverged);
+
+    return pChange->IsConverged;
+}
+
+void DisplayGheAlgorithm(GlobalHist_CONTEXT *pGheContext, GlobalHist_ARGS *GheArgs)
+{
+    uint32_t TotalNumOfPixel;
+    double FramePower;
+    bool IsEnhanced;
+
+    DisplayGheAdvanceFilterClock(&pGheContext->FilterParams.Clock, GheArgs->TimestampNs);
 
+    if (KeepConvergedLut(pGheContext))
+    {
         return;
     }
 
-    CDFRange = EnhancementTable[GlobalHist_BIN_COUNT - 1] - pGheContext->Histogram[0];
-    CdfNormalizingFactor = 1.0 / CDFRange;
-    EnhancementTable[0] = (double)(EnhancementTable[0] - pGheContext->Histogram[0]) * CdfNormalizingFactor;
+    GlobalHist_STATS_TIMER_START(LutTargetStart);
+    IsEnhanced = GetLutTarget(pGheContext, &TotalNumOfPixel, &FramePower);
+    GlobalHist_STATS_TIMER_STOP(pGheContext, GlobalHist_STATS_STAGE_LUT_TARGET, LutTargetStart);
+
+    ApplyLutTarget(pGheContext, IsEnhanced, TotalNumOfPixel, FramePower);
+}
+
+bool DisplayGheAlgorithmWithTarget(GlobalHist_CONTEXT *pGheContext, GlobalHist_ARGS *GheArgs, const GlobalHist_LUT_TARGET_RESULT *pTarget)
+{
+    DisplayGheAdvanceFilterClock(&pGheContext->FilterParams.Clock, GheArgs->TimestampNs);
 
-    for (uint8_t BinIndex = 1; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    if (KeepConvergedLut(pGheContext))
     {
-        double OutVal = (EnhancementTable[BinIndex] - pGheContext->Histogram[0]) * CdfNormalizingFactor;
-        double PrevSampleVal = EnhancementTable[BinIndex - 1];
-        double Slope = MaxHistBinIndex * (OutVal - PrevSampleVal);
+        return FALSE;
+    }
+
+    memcpy(pGheContext->ImageEnhancement.LutTarget, pTarget->LutTarget, sizeof(pTarget->LutTarget));
 
-        Slope = DD_MAX(Slope, MinSlope);
-        Slope = DD_MIN(Slope, MaxSlope);
+    return ApplyLutTarget(pGheContext, pTarget->IsEnhanced, pTarget->TotalNumOfPixel, pTarget->FramePower);
+}
 
-        OutVal = PrevSampleVal + Slope * HistBinStepSize;
-        OutVal = DD_MIN(OutVal, 1.0);
+bool DisplayGheComputeLutTarget(const GlobalHist_CONTEXT *pGheContext, const uint32_t *pHistogram, GlobalHist_LUT_TARGET_RESULT *pTarget)
+{
+    GlobalHist_ENGINE_32_33_ANALYSIS Analysis;
 
-        EnhancementTable[BinIndex] = OutVal;
+    // Cached targets stand in for every histogram of their key, and a cache hit in single
+    // precision reports the double frame power. Either way the target depends on the history.
+    if ((0 != pGheContext->ChangeDetection.CacheKeyShift) || (GlobalHist_PRECISION_DOUBLE != pGheContext->Precision))
+    {
+        return FALSE;
     }
 
-    //No filtering for 0th and last values of the IET.
-    FilteredEnhancementTable[0] = EnhancementTable[0];
-    FilteredEnhancementTable[GlobalHist_MAX_BIN_INDEX] = EnhancementTable[GlobalHist_MAX_BIN_INDEX];
+    pTarget->IsEnhanced      = DisplayGheEngine_32_33_ComputeLutTarget(pHistogram, pGheContext->pDeGammaLUT, pGheContext->GheCfg.MinSlope,
+                                                                       pGheContext->GheCfg.MaxSlope, pTarget->LutTarget, &Analysis);
+    pTarget->TotalNumOfPixel = Analysis.TotalNumOfPixel;
+    pTarget->FramePower      = Analysis.FramePower;
 
-    //Smoothen jerks in FilteredEnhancementTable by averaging with nearby bins.
-    for (uint8_t BinIndex = 1; BinIndex < GlobalHist_MAX_BIN_INDEX; BinIndex++)
+    return TRUE;
+}
+
+void DisplayGheSetChangeDetection(GlobalHist_CONTEXT *pGheContext, uint32_t Tolerance, uint32_t CacheKeyShift)
+{
+    GlobalHist_CHANGE_DETECTION *pChange = &pGheContext->ChangeDetection;
+
+    CacheKeyShift = DD_MIN(CacheKeyShift, 31);
+
+    // Entries keyed with another quantization can not be matched any more
+    if (CacheKeyShift != pChange->CacheKeyShift)
     {
-        //Average out current and two nearby sampels.
-        FilteredEnhancementTable[BinIndex] = 0.333333 * (EnhancementTable[BinIndex - 1] + EnhancementTable[BinIndex] + EnhancementTable[BinIndex + 1]);
+        ClearLutCache(pChange);
     }
 
-    //Convert LUT of size GlobalHist_BIN_COUNT to IET LUT of size GlobalHist_IET_LUT_LENGTH
-    for (uint32_t BinIndex = 1; BinIndex < GlobalHist_IET_LUT_LENGTH; BinIndex++)
+    pChange->Tolerance     = Tolerance;
+    pChange->CacheKeyShift = CacheKeyShift;
+    pGheContext->TraceSetupEpoch = 0;
+}
+
+bool DisplayGheSetTransferFunction(GlobalHist_CONTEXT *pGheContext, GlobalHist_TRANSFER_FUNCTION TransferFunction)
+{
+    GlobalHist_CHANGE_DETECTION *pChange = &pGheContext->ChangeDetection;
+    const double *pDeGammaLUT = DisplayGheGetDeGammaLUT(TransferFunction, GlobalHist_BIN_COUNT);
+
+    if (NULL == pDeGammaLUT)
     {
-        BinIndexNormalized = (double)BinIndex * IetLutStepSize;
-        IetVal = Apply1DLUT(BinIndexNormalized, FilteredEnhancementTable, MaxHistBinIndex);
-        IetVal = IetVal / BinIndexNormalized;                   // Compute sample for multiplier LUT
-        IetVal = DD_MIN(IetVal, 1.0 / BinIndexNormalized);      // Cap IET val to the value that will not cause clipping.
+        return FALSE;
+    }
 
-        IetVal = (double)GlobalHist_IET_SCALE_FACTOR * IetVal + 0.5;
-        IetVal = DD_MIN(IetVal, GlobalHist_IET_MAX_VAL);
-        IetVal = DD_MAX(IetVal, GlobalHist_IET_SCALE_FACTOR); // Never dim any pixel
+    // Cached targets, the converged LUT and the previous frame power were weighted with the old curve
+    if (pDeGammaLUT != pGheContext->pDeGammaLUT)
+    {
+        DropConvergedLut(pChange);
 
-        pMultiplierLut[BinIndex] = IetVal;
+        pGheContext->FilterParams.PrevFramePower = DisplayGheEngine_32_33_GetFramePower(pGheContext->FilterParams.PrevHistogram, pDeGammaLUT);
     }
 
-    pMultiplierLut[0] = pMultiplierLut[1]; // 0th multiplier sample can't be computed. Extend 1st sample to the 0th 
-    
-    TemporalSmoothenIET(pGheContext,GheArgs );
+    pGheContext->TransferFunction = TransferFunction;
+    pGheContext->pDeGammaLUT      = pDeGammaLUT;
+    pGheContext->TraceSetupEpoch  = 0;
 
-    memcpy(pGheContext->FilterParams.PrevHistogram, pGheContext->Histogram, sizeof(pGheContext->Histogram));
+    return TRUE;
+}
 
+bool DisplayGheSetPrecision(GlobalHist_CONTEXT *pGheContext, GlobalHist_PRECISION Precision)
+{
+    if ((uint32_t)Precision >= GlobalHist_PRECISION_COUNT)
+    {
+        return FALSE;
+    }
+
+    // Cached targets and the converged LUT were computed at the old precision
+    if (Precision != pGheContext->Precision)
+    {
+        DropConvergedLut(&pGheContext->ChangeDetection);
+    }
+
+    pGheContext->Precision       = Precision;
+    pGheContext->TraceSetupEpoch = 0;
+
+    return TRUE;
+}
+
+void DisplayGheGetDefaultConfig(GlobalHist_CFG *pCfg)
+{
+    pCfg->MinimumStepPercent = GlobalHist_SMOOTHENING_TOLERANCE_DEFAULT;
+    pCfg->MinIIRCutOffFreq   = MILLIUNIT_TO_UNIT((double)GlobalHist_SMOOTHENING_MIN_SPEED_DEFAULT);
+    pCfg->MaxIIRCutOffFreq   = MILLIUNIT_TO_UNIT((double)GlobalHist_SMOOTHENING_MAX_SPEED_DEFAULT);
+    pCfg->MinPhaseInDuration = SMOOTHENING_MIN_STABLE_CUT_OFF_FREQUNCY_DURATION;
+    pCfg->MaxPhaseInDuration = PHASE_GlobalHist_PERIOD;
+    pCfg->MinSlope           = GlobalHist_MIN_SLOPE;
+    pCfg->MaxSlope           = GlobalHist_MAX_SLOPE;
+}
+
+// Written so that NaN fails every test
+bool DisplayGheIsValidConfig(const GlobalHist_CFG *pCfg)
+{
+    return (NULL != pCfg) &&
+           (pCfg->MinimumStepPercent >= 0) && (pCfg->MinimumStepPercent <= 10000) &&
+           (pCfg->MinIIRCutOffFreq >= GlobalHist_CFG_MIN_CUT_OFF_FREQ) && (pCfg->MinIIRCutOffFreq <= pCfg->MaxIIRCutOffFreq) &&
+           (pCfg->MaxIIRCutOffFreq >= GlobalHist_CFG_MIN_CUT_OFF_FREQ) && (pCfg->MaxIIRCutOffFreq <= GlobalHist_CFG_MAX_CUT_OFF_FREQ) &&
+           (pCfg->MinPhaseInDuration >= 0) && (pCfg->MinPhaseInDuration <= 60000) &&
+           (pCfg->MaxPhaseInDuration > 0) && (pCfg->MaxPhaseInDuration <= 1000) &&
+           (pCfg->MinSlope >= 0) && (pCfg->MinSlope <= pCfg->MaxSlope) && (pCfg->MaxSlope <= GlobalHist_CFG_MAX_SLOPE);
+}
+
+bool DisplayGheSetConfig(GlobalHist_CONTEXT *pGheContext, const GlobalHist_CFG *pCfg)
+{
+    GlobalHist_TEMPORAL_FILTER_PARAMS *pFilterParams = &pGheContext->FilterParams;
+
+    if (FALSE == DisplayGheIsValidConfig(pCfg))
+    {
+        return FALSE;
+    }
+
+    // Cached targets were clamped with the old slopes, and the filter converged under the old limits
+    if (0 != memcmp(pCfg, &pGheContext->GheCfg, sizeof(*pCfg)))
+    {
+        DropConvergedLut(&pGheContext->ChangeDetection);
+    }
+
+    pGheContext->GheCfg          = *pCfg;
+    pGheContext->TraceSetupEpoch = 0;
+
+    pFilterParams->MinCutOffFreqInMilliHz        = (uint32_t)(pCfg->MinIIRCutOffFreq * 1000 + 0.5);
+    pFilterParams->MaxCutOffFreqInMilliHz        = (uint32_t)(pCfg->MaxIIRCutOffFreq * 1000 + 0.5);
+    pFilterParams->CurrentMinCutOffFreqInMilliHz = DD_MIN(pFilterParams->MaxCutOffFreqInMilliHz, pFilterParams->MinCutOffFreqInMilliHz);
+    pFilterParams->CurrentMaxCutOffFreqInMilliHz = DD_MAX(pFilterParams->MaxCutOffFreqInMilliHz, pFilterParams->MinCutOffFreqInMilliHz);
+    pFilterParams->MinimumStepPercent            = pCfg->MinimumStepPercent;
+    DisplayGheSetFilterClockLimits(&pFilterParams->Clock, pCfg);
+
+    return TRUE;
+}
+
+void DisplayGheGetConfig(const GlobalHist_CONTEXT *pGheContext, GlobalHist_CFG *pCfg)
+{
+    *pCfg = pGheContext->GheCfg;
 }
 
 double EstimateProbabilityOfFullScreenSolidColor(double *pPowerHistogram, double TotalPower)
 {
-    const double SolidColorPowerThreshold = SOLID_COLOR_POWER_THRESHOLD * TotalPower;
-    double WindowSizeToProbabilityMapping[SOLID_COLOR_SEARCH_WINDOW_SIZE] = { 1, 1, 0.75, 0.375 };
-    uint8_t N;
+    double PowerPrefix[GlobalHist_BIN_COUNT + 1];
 
     // Find N number of consecutive bins which contain SOLID_COLOR_POWER_THRESHOLD amount of frame power.
     // N = 1 means solid color for sure. Since SOLID_COLOR_POWER_THRESHOLD is not 1.0, it detects almost solid color.
     // N = 2 may mean near solid color. One pixel value shift will shift energy to next or prev bin.
     // For example, image with solid color patches 247 and 248 will look almost single solid, but teh histogram will be spread across two bins.
     // N >= 3 means probability of solid color is less. Return value is gradullay reduced to 0 for N >= 3.
-    for (N = 1; N <= SOLID_COLOR_SEARCH_WINDOW_SIZE; N++)
+    PowerPrefix[0] = 0;
+    for (uint8_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
     {
-        for (uint8_t BinIndex = 0; BinIndex < (GlobalHist_BIN_COUNT - N + 1); BinIndex++)
-        {
-            double SumPower = 0;
-            for (uint8_t i = BinIndex; i < (BinIndex + N); i++)
-            {
-                SumPower += pPowerHistogram[i];
-
-                if (SumPower >= SolidColorPowerThreshold)
-                {
-                    return WindowSizeToProbabilityMapping[N - 1];
-                }
-            }
-        }
+        PowerPrefix[BinIndex + 1] = PowerPrefix[BinIndex] + pPowerHistogram[BinIndex];
     }
 
-    return 0;
+    return DisplayGheEngine_32_33_EstimateSolidColor(PowerPrefix, TotalPower);
 }
 
  // Interpolate IET LUT from histogram based LUT.
@@ -240,98 +461,155 @@ void DisplayResetAlgorithm(GlobalHist_CONTEXT *pGheContext)
 
         for (uint8_t FilterOrder = 0; FilterOrder < GlobalHist_IIR_FILTER_ORDER; FilterOrder++)
         {
-            pGheContext->FilterParams.IETHistory[Count][FilterOrder] = GlobalHist_IET_SCALE_FACTOR;
+            pGheContext->FilterParams.IETHistory[FilterOrder][Count] = GlobalHist_IET_SCALE_FACTOR;
         }
     }
 
     // Reset filter params
     pGheContext->FilterParams.TargetBoost         = GlobalHist_DEFAULT_BOOST;
     pGheContext->FilterParams.SmootheningIteration = 0;
+    pGheContext->ChangeDetection.IsConverged       = FALSE;
 }
 
 
 bool TemporalSmoothenIET(GlobalHist_CONTEXT *pGheContext, GlobalHist_ARGS *GheArgs)
 {
- 
-    double TemporalFilterCoefficient;
-    double MaxAcceptableDelta;
+    return SmoothenIET(pGheContext, DisplayGheEngine_32_33_GetFramePower(pGheContext->Histogram, pGheContext->pDeGammaLUT));
+}
 
-    MaxAcceptableDelta = pGheContext->FilterParams.MinimumStepPercent;
-    
-    if (FALSE == IsTargetIETReached(pGheContext))
-    { 
+// TemporalSmoothenIET for a frame whose power is already known
+static bool SmoothenIET(GlobalHist_CONTEXT *pGheContext, double FramePower)
+{
+    GlobalHist_IE *pEnhancement = &pGheContext->ImageEnhancement;
+    GlobalHist_TEMPORAL_FILTER_PARAMS *pFilterParams = &pGheContext->FilterParams;
+    bool IsTargetReached = IsTargetIETReached(pGheContext);
 
-        TemporalFilterCoefficient = CalculateIIRFilterCoefficient(pGheContext);
-        
-	for (uint8_t Count = 0; Count < GlobalHist_IET_LUT_LENGTH; Count++)
-	{
-            double IetVal= (uint32_t)DisplayPcPhaseCoordinatorTemporalIIRFilterNthOrder( TemporalFilterCoefficient, 
-			           pGheContext->ImageEnhancement.LutTarget[Count],&pGheContext->FilterParams.IETHistory[Count][0]) + 0.5 ;
-            IetVal = DD_MIN(IetVal, GlobalHist_IET_MAX_VAL);
-	    pGheContext->ImageEnhancement.LutApplied[Count] = IetVal;
-	
-	}
+    if (FALSE == IsTargetReached)
+    {
+        double CutOffFreq = DisplayGheGetCutOffFrequency(&pFilterParams->Clock, DisplayGheGetRelativeBrightnessChange(pFilterParams->PrevFramePower, FramePower),
+                                                         MILLIUNIT_TO_UNIT((double)pFilterParams->CurrentMinCutOffFreqInMilliHz),
+                                                         MILLIUNIT_TO_UNIT((double)pFilterParams->CurrentMaxCutOffFreqInMilliHz));
+        double TemporalFilterCoefficient = DisplayGheGetIIRFilterCoefficient(CutOffFreq, pFilterParams->Clock.SamplingPeriod);
 
+        DisplayGheEngine_32_33_TemporalFilter(TemporalFilterCoefficient, pEnhancement->LutTarget, pEnhancement->LutApplied, pFilterParams->IETHistory);
     }
     else
     {
-        memcpy(pGheContext->ImageEnhancement.LutApplied ,pGheContext->ImageEnhancement.LutTarget , sizeof(pGheContext->ImageEnhancement.LutTarget));    
-         
-       for (uint8_t Count = 0; Count < GlobalHist_IET_LUT_LENGTH; Count++)
-        {
-            for (uint8_t HistoryIndex = 0; HistoryIndex < GlobalHist_IIR_FILTER_ORDER; HistoryIndex++)
-            {
-                pGheContext->FilterParams.IETHistory[Count][HistoryIndex] = pGheContext->ImageEnhancement.LutTarget[Count];
-            }
-        }
-    
+        DisplayGheEngine_32_33_SnapToTarget(pEnhancement->LutTarget, pEnhancement->LutApplied, pFilterParams->IETHistory);
     }
 
-    memcpy(pGheContext->FilterParams.PrevHistogram, pGheContext->Histogram, sizeof(pGheContext->FilterParams.PrevHistogram)); 
+    memcpy(pFilterParams->PrevHistogram, pGheContext->Histogram, sizeof(pFilterParams->PrevHistogram)); 
+    pFilterParams->PrevFramePower = FramePower;
 
+    return IsTargetReached;
 }
 
 bool IsTargetIETReached(GlobalHist_CONTEXT *pGheContext)
 {
-    double MaxAcceptableDelta;
-    double IETDelta;
-    double LinearBoostDelta;
+    return DisplayGheEngine_32_33_IsTargetReached(pGheContext->ImageEnhancement.LutApplied, pGheContext->ImageEnhancement.LutTarget,
+                                                  pGheContext->FilterParams.MinimumStepPercent);
+}
 
-    MaxAcceptableDelta = pGheContext->FilterParams.MinimumStepPercent / 100.0 ;
-    for (uint32_t i = 0; i < GlobalHist_IET_LUT_LENGTH; i++)
+// Coefficient the next filter step would use. Works on a copy of the clock, so the hold is not touched.
+double CalculateIIRFilterCoefficient(GlobalHist_CONTEXT *pGheContext)
+{
+    GlobalHist_TEMPORAL_FILTER_PARAMS *pFilterParams = &pGheContext->FilterParams;
+    GlobalHist_FILTER_CLOCK Clock = pFilterParams->Clock;
+    double FramePower = DisplayGheEngine_32_33_GetFramePower(pGheContext->Histogram, pGheContext->pDeGammaLUT);
+    double CutOffFreq = DisplayGheGetCutOffFrequency(&Clock, DisplayGheGetRelativeBrightnessChange(pFilterParams->PrevFramePower, FramePower),
+                                                     MILLIUNIT_TO_UNIT((double)pFilterParams->CurrentMinCutOffFreqInMilliHz),
+                                                     MILLIUNIT_TO_UNIT((double)pFilterParams->CurrentMaxCutOffFreqInMilliHz));
+
+    return DisplayGheGetIIRFilterCoefficient(CutOffFreq, Clock.SamplingPeriod);
+}
+
+void DisplayGheInitializeFilterClock(GlobalHist_FILTER_CLOCK *pClock)
+{
+    pClock->PrevTimestampNs   = 0;
+    pClock->SamplingPeriod    = GlobalHist_SMOOTHENING_SAMPLING_PERIOD;
+    pClock->HeldCutOffFreq    = 0;
+    pClock->HoldRemaining     = 0;
+    pClock->MaxSamplingPeriod = MILLIUNIT_TO_UNIT((double)PHASE_GlobalHist_PERIOD);
+    pClock->HoldDuration      = MILLIUNIT_TO_UNIT(SMOOTHENING_MIN_STABLE_CUT_OFF_FREQUNCY_DURATION);
+}
+
+void DisplayGheSetFilterClockLimits(GlobalHist_FILTER_CLOCK *pClock, const GlobalHist_CFG *pCfg)
+{
+    pClock->MaxSamplingPeriod = MILLIUNIT_TO_UNIT(pCfg->MaxPhaseInDuration);
+    pClock->HoldDuration      = MILLIUNIT_TO_UNIT(pCfg->MinPhaseInDuration);
+}
+
+void DisplayGheAdvanceFilterClock(GlobalHist_FILTER_CLOCK *pClock, uint64_t TimestampNs)
+{
+    double SamplingPeriod = GlobalHist_SMOOTHENING_SAMPLING_PERIOD;
+
+    if ((0 != TimestampNs) && (0 != pClock->PrevTimestampNs))
     {
-        IETDelta = abs((double)pGheContext->ImageEnhancement.LutApplied[i] - (double)pGheContext->ImageEnhancement.LutTarget[i]) / (double)pGheContext->ImageEnhancement.LutTarget[i];
+        // A stalled or repeated frame never moves the filter by more than one phase period
+        SamplingPeriod = (TimestampNs > pClock->PrevTimestampNs) ? (double)(TimestampNs - pClock->PrevTimestampNs) * 1e-9 : 0;
+        SamplingPeriod = DD_MIN(SamplingPeriod, pClock->MaxSamplingPeriod);
+    }
 
-        if (IETDelta > MaxAcceptableDelta)
-        {
-             return FALSE;
-         }
+    pClock->PrevTimestampNs = TimestampNs;
+    pClock->SamplingPeriod  = SamplingPeriod;
+    pClock->HoldRemaining  -= SamplingPeriod;
+
+    // An expired hold no longer bounds anything. Cleared, every clock past its hold is in the same state.
+    if (pClock->HoldRemaining <= 0)
+    {
+        pClock->HeldCutOffFreq = 0;
+        pClock->HoldRemaining  = 0;
+    }
+}
+
+double DisplayGheGetCutOffFrequency(GlobalHist_FILTER_CLOCK *pClock, double RelativeBrightnessChange, double MinCutoffFreq, double MaxCutoffFreq)
+{
+    double CutOffFreq = MinCutoffFreq + (MaxCutoffFreq - MinCutoffFreq) * RelativeBrightnessChange;
+
+    if ((pClock->HoldRemaining > 0) && (CutOffFreq < pClock->HeldCutOffFreq))
+    {
+        return pClock->HeldCutOffFreq;
     }
-        return TRUE;
 
+    pClock->HeldCutOffFreq = CutOffFreq;
+    pClock->HoldRemaining  = pClock->HoldDuration;
+
+    return CutOffFreq;
 }
 
-double CalculateIIRFilterCoefficient(GlobalHist_CONTEXT *pGheContext)
+// First order low pass coefficient wT / (1 + wT) as a function of CutOffFreq * SamplingPeriod
+static double GetIIRFilterCoefficientExact(double CutOffTimesPeriod)
 {
+    double AngularFrequencyTimesPeriod = 6.2831853 * CutOffTimesPeriod;
 
-    double AngularFrequency, TemporalFilterCoefficient;
-    double MinCutoffFreq, MaxCutoffFreq;
-    double CutOffFreq=0;
-    double MinGheSmootheningPeriod;
-    GlobalHist_TEMPORAL_FILTER_PARAMS *pFilterParams;
+    return AngularFrequencyTimesPeriod / (1 + AngularFrequencyTimesPeriod);
+}
 
-    pFilterParams            = &pGheContext->FilterParams;
-    MinCutoffFreq            = MILLIUNIT_TO_UNIT((double)pFilterParams->CurrentMinCutOffFreqInMilliHz);
-    MaxCutoffFreq            = MILLIUNIT_TO_UNIT((double)pFilterParams->CurrentMaxCutOffFreqInMilliHz);
-    MinGheSmootheningPeriod = (double)(332225.9136) / (double)(10 * 1000 * 1000); //SampingFreq.
-  
-    double RelativeFrameBrightnessChange = GetRelativeFrameBrightnessChange(pGheContext, pFilterParams->PrevHistogram);
-    CutOffFreq = MinCutoffFreq + (MaxCutoffFreq - MinCutoffFreq) * RelativeFrameBrightnessChange;
+static void BuildIIRCoefficientTable(void)
+{
+    for (uint32_t Index = 0; Index <= GlobalHist_IIR_COEFFICIENT_TABLE_SIZE; Index++)
+    {
+        IIRCoefficientTable[Index] = GetIIRFilterCoefficientExact((double)Index * GlobalHist_IIR_COEFFICIENT_TABLE_RANGE / GlobalHist_IIR_COEFFICIENT_TABLE_SIZE);
+    }
+}
+
+// Linear interpolation in the table is within 1e-6 of the exact coefficient. Products beyond the
+// table, above 10 Hz at PHASE_GlobalHist_PERIOD, are computed directly.
+double DisplayGheGetIIRFilterCoefficient(double CutOffFreq, double SamplingPeriod)
+{
+    double Position = CutOffFreq * SamplingPeriod * (GlobalHist_IIR_COEFFICIENT_TABLE_SIZE / GlobalHist_IIR_COEFFICIENT_TABLE_RANGE);
+    uint32_t Index;
 
-    AngularFrequency = 6.2831853 * CutOffFreq;
-    TemporalFilterCoefficient = (MinGheSmootheningPeriod * AngularFrequency) / (1 + (MinGheSmootheningPeriod * AngularFrequency));
+    pthread_once(&IIRCoefficientTableOnce, BuildIIRCoefficientTable);
 
-    return TemporalFilterCoefficient;
+    if (Position >= GlobalHist_IIR_COEFFICIENT_TABLE_SIZE)
+    {
+        return GetIIRFilterCoefficientExact(CutOffFreq * SamplingPeriod);
+    }
+
+    Index = (uint32_t)Position;
+
+    return IIRCoefficientTable[Index] + (Position - (double)Index) * (IIRCoefficientTable[Index + 1] - IIRCoefficientTable[Index]);
 }
 
 
@@ -351,31 +629,25 @@ double DisplayPcPhaseCoordinatorTemporalIIRFilterNthOrder(double FilterCoefficie
 
 double GetRelativeFrameBrightnessChange(GlobalHist_CONTEXT* pGheContext,  uint32_t* pPrevHist)
 {
-    double FrameAveragePowerPrev = 0;
-    double FrameAveragePowerCurr = 0;
+    double FramePowerPrev = (pPrevHist == pGheContext->FilterParams.PrevHistogram) ?
+                            pGheContext->FilterParams.PrevFramePower : DisplayGheEngine_32_33_GetFramePower(pPrevHist, pGheContext->pDeGammaLUT);
+
+    return DisplayGheGetRelativeBrightnessChange(FramePowerPrev,
+                                                 DisplayGheEngine_32_33_GetFramePower(pGheContext->Histogram, pGheContext->pDeGammaLUT));
+}
+
+double DisplayGheGetRelativeBrightnessChange(double FramePowerPrev, double FramePowerCurr)
+{
     double HistChangePercentage = 0;
-    
-    for ( uint32_t Count = 0; Count < GlobalHist_BIN_COUNT; Count++)
-    {
-        FrameAveragePowerPrev += pGheContext->DeGammaLUT[Count] * (double)pPrevHist[Count];
-        FrameAveragePowerCurr += pGheContext->DeGammaLUT[Count] * (double)pGheContext->Histogram[Count];
-    }
 
-    if (FrameAveragePowerPrev > 0)
+    if (FramePowerPrev > 0)
     {
-        HistChangePercentage = DD_ABS(FrameAveragePowerCurr - FrameAveragePowerPrev) / FrameAveragePowerPrev;
+        HistChangePercentage = DD_ABS(FramePowerCurr - FramePowerPrev) / FramePowerPrev;
     }
-    else if (FrameAveragePowerPrev != FrameAveragePowerCurr)
+    else if (FramePowerPrev != FramePowerCurr)
     {
         HistChangePercentage = 1.0;
     }
 
     return DD_MIN(HistChangePercentage, 1.0);
 }
-
-
-
-
-
-
-
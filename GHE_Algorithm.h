@@ -10,6 +10,7 @@
 #include <stdlib.h>
 
 #include "DisplayPc.h"
+#include "GHE_Stats.h"
 
 #ifndef IN
 #define IN
@@ -47,6 +48,17 @@
 #define GlobalHist_IET_MAX_VAL    1023            // IET values are in 1.9 format (1 bit integer, 9 bit fraction)
 #define SOLID_COLOR_POWER_THRESHOLD 0.95
 #define SOLID_COLOR_SEARCH_WINDOW_SIZE 4
+#define SOLID_COLOR_WINDOW_PROBABILITY { 1, 1, 0.75, 0.375 } // Solid color probability per search window size
+#define GlobalHist_MIN_SLOPE 0.3                                   // Lower clamp of enhancement curve slope
+#define GlobalHist_MAX_SLOPE 7.0                                   // Upper clamp of enhancement curve slope
+#define GlobalHist_SMOOTHENING_SAMPLING_PERIOD ((double)(332225.9136) / (double)(10 * 1000 * 1000)) // Temporal filter sampling period in seconds
+#define GlobalHist_IIR_COEFFICIENT_TABLE_SIZE 2048                // Intervals of the IIR coefficient table
+#define GlobalHist_IIR_COEFFICIENT_TABLE_RANGE 0.5                 // Cut off frequency (Hz) * sampling period (s) covered by the table
+#define GlobalHist_LUT_CACHE_ENTRIES 8                             // LutTarget results kept per context for repeating content
+#define GlobalHist_CFG_MIN_CUT_OFF_FREQ 0.001                      // GlobalHist_CFG limits, see DisplayGheSetConfig
+#define GlobalHist_CFG_MAX_CUT_OFF_FREQ 1000.0
+#define GlobalHist_CFG_MAX_SLOPE 64.0
+#define GlobalHist_CHANGE_TOLERANCE_SCALE 65536                    // Change detection tolerance unit is 1/65536 of the pixel count
 
 
 // GlobalHist Algorithm function pointer.
@@ -73,59 +85,110 @@ typedef struct _GlobalHist_IE
 {
      uint32_t LutApplied[GlobalHist_IET_LUT_LENGTH];
      uint32_t LutTarget[GlobalHist_IET_LUT_LENGTH]; 
-     uint32_t LutDelta[GlobalHist_IET_LUT_LENGTH];
 } GlobalHist_IE;
 
+// Elapsed time and cut off frequency hold of one temporal filter
+typedef struct _GlobalHist_FILTER_CLOCK
+{
+    uint64_t PrevTimestampNs;        // 0 when the previous frame carried no timestamp
+    double SamplingPeriod;           // Seconds since the previous frame, at most MaxSamplingPeriod
+    double HeldCutOffFreq;           // In Hz
+    double HoldRemaining;            // Seconds HeldCutOffFreq still is the lower bound of the cut off frequency
+    double MaxSamplingPeriod;        // Seconds, GlobalHist_CFG.MaxPhaseInDuration
+    double HoldDuration;             // Seconds, GlobalHist_CFG.MinPhaseInDuration
+} GlobalHist_FILTER_CLOCK;
+
+// Hot fields first: the per frame path reads PrevHistogram through MinimumStepPercent
 typedef struct _GlobalHist_TEMPORAL_FILTER_PARAMS
 {
-    uint64_t SmootheningIteration;
-    uint32_t MinCutOffFreqInMilliHz; // Value from the INF or Default
-    uint32_t MaxCutOffFreqInMilliHz; // Value from the INF or Default
+    uint32_t PrevHistogram[GlobalHist_BIN_COUNT];
+    double PrevFramePower;           // Power of PrevHistogram, kept with it so it is never recomputed
+    GlobalHist_FILTER_CLOCK Clock;
     uint32_t CurrentMinCutOffFreqInMilliHz;
     uint32_t CurrentMaxCutOffFreqInMilliHz;
-    uint32_t PrevHistogram[GlobalHist_BIN_COUNT];
-    double IETHistory[GlobalHist_IET_LUT_LENGTH][GlobalHist_IIR_FILTER_ORDER];
-    double TargetBoost;
     double MinimumStepPercent;
+    double IETHistory[GlobalHist_IIR_FILTER_ORDER][GlobalHist_IET_LUT_LENGTH]; // One row per tap, the filter runs across entries
+    uint32_t MinCutOffFreqInMilliHz; // Value from the INF or Default
+    uint32_t MaxCutOffFreqInMilliHz; // Value from the INF or Default
+    uint64_t SmootheningIteration;
+    double TargetBoost;
 } GlobalHist_TEMPORAL_FILTER_PARAMS;
 
-
-typedef struct _GlobalHist_CFG
+typedef struct _GlobalHist_LUT_CACHE_ENTRY
 {
-    double MinimumStepPercent;
-    double MinIIRCutOffFreq;
-    double MaxIIRCutOffFreq;
-    double MinPhaseInDuration;
-    double MaxPhaseInDuration;
-
-}GlobalHist_CFG;
+    uint32_t Key[GlobalHist_BIN_COUNT];              // Histogram with the low CacheKeyShift bits of every bin dropped
+    uint32_t LutTarget[GlobalHist_IET_LUT_LENGTH];
+    bool IsEnhanced;                                 // FALSE for a solid color histogram
+} GlobalHist_LUT_CACHE_ENTRY;
 
-
-typedef struct _GlobalHist_CONTEXT
+typedef struct _GlobalHist_CHANGE_DETECTION
+{
+    uint32_t Tolerance;              // Max L1 distance to PrevHistogram that still reuses LutApplied
+    uint32_t CacheKeyShift;
+    bool IsConverged;                // LutApplied was snapped to LutTarget on the last processed frame
+    uint64_t UseCounter;
+    uint64_t FastPathHits;
+    uint64_t CacheHits;
+    uint64_t CacheMisses;
+    // Scanned on every lookup, so kept apart from the entries: two cache lines instead of eight
+    uint64_t CacheFingerprint[GlobalHist_LUT_CACHE_ENTRIES]; // Hash of the entry Key, 0 for an unused entry
+    uint64_t CacheLastUse[GlobalHist_LUT_CACHE_ENTRIES];
+    GlobalHist_LUT_CACHE_ENTRY Cache[GlobalHist_LUT_CACHE_ENTRIES]; // Touched on a fingerprint match or a miss only
+} GlobalHist_CHANGE_DETECTION;
+
+
+// Hot / cold layout. Everything DisplayGheProcessFrame touches on every frame comes first and in
+// the order it is used, so the per frame working set is one contiguous run of cache lines. The
+// LUT cache entries, setup only fields and the stats follow it.
+struct _GlobalHist_CONTEXT
 {
-    // Hardware dependent variables //
-  
+    // Hot, every frame
     GlobalHist_FUNCTBL GheFuncTable;      // GlobalHist Algorithm Function Table
     PIPE_ID Pipe;
-    uint32_t Histogram[GlobalHist_BIN_COUNT]; // Bin wise histogram data for current frame.
-    uint32_t LUT[GlobalHist_BIN_COUNT];
     GlobalHist_ALGORITHM Algorithm;
-    // Runtime variables
+    uint32_t Histogram[GlobalHist_BIN_COUNT]; // Bin wise histogram data for current frame.
+    const double *pDeGammaLUT;            // Shared read only table of TransferFunction, see GHE_DeGamma.h
+    GlobalHist_PRECISION Precision;       // Of the LutTarget kernels
     GlobalHist_IE ImageEnhancement;
-     
     GlobalHist_TEMPORAL_FILTER_PARAMS FilterParams;
-    GlobalHist_CFG GheCfg;
-
-    double DeGammaLUT[GlobalHist_BIN_COUNT];
+    GlobalHist_CHANGE_DETECTION ChangeDetection; // Ends with the cold LUT cache entries
 
-} GlobalHist_CONTEXT;
+    // Cold
+    bool IsCallerOwnedMemory;             // Context lives in memory handed in by the caller, never freed here
+    GlobalHist_TRANSFER_FUNCTION TransferFunction;
+    uint32_t LUT[GlobalHist_BIN_COUNT];
+    GlobalHist_CFG GheCfg;
+    uint32_t TraceSetupEpoch;             // 1 + the trace recorder epoch the setup was recorded in, 0 after a setter
+#ifdef GlobalHist_ENABLE_STATS
+    GlobalHist_STATS Stats;                   // Processing thread only
+    GlobalHist_STATS_PUBLISHED StatsPublished; // Copy of Stats for DisplayGheGetStatsSnapshot
+#endif
+};
 
 
 void DisplayInitializeAlgorithm(GlobalHist_CONTEXT *pGhe,GlobalHist_ARGS *GheArgs );
+void DisplayInitializeAlgorithmState(GlobalHist_CONTEXT *pGheContext);
 void DisplayInitializeTemporalIIRFilterParams(GlobalHist_CONTEXT *pGheContext);
 double Apply1DLUT(double InVal, double *pLUT, double MaxIndex);
 
 void DisplayGheAlgorithm(GlobalHist_CONTEXT *pGheContext,GlobalHist_ARGS *GheArgs);
+
+// LutTarget stage of one frame, computed ahead of the filter, see GHE_Clip.h
+typedef struct _GlobalHist_LUT_TARGET_RESULT
+{
+    uint32_t LutTarget[GlobalHist_IET_LUT_LENGTH];
+    double FramePower;
+    uint32_t TotalNumOfPixel;
+    bool IsEnhanced;                 // FALSE for solid color, LutTarget is the identity LUT
+} GlobalHist_LUT_TARGET_RESULT;
+
+// The target DisplayGheAlgorithm computes for pHistogram on this context. Returns FALSE when it
+// can depend on earlier frames: with a lossy LUT cache key or in single precision.
+bool DisplayGheComputeLutTarget(const GlobalHist_CONTEXT *pGheContext, const uint32_t *pHistogram, GlobalHist_LUT_TARGET_RESULT *pTarget);
+// DisplayGheAlgorithm with the target from DisplayGheComputeLutTarget. The LUT cache is neither
+// read nor filled. Returns TRUE when the filter snapped to the target, the temporal state then
+// only depends on this frame and the filter clock.
+bool DisplayGheAlgorithmWithTarget(GlobalHist_CONTEXT *pGheContext, GlobalHist_ARGS *GheArgs, const GlobalHist_LUT_TARGET_RESULT *pTarget);
 bool TemporalSmoothenIET(GlobalHist_CONTEXT *pGheContext,GlobalHist_ARGS *GheArgs);
 bool IsTargetIETReached(GlobalHist_CONTEXT *pGheContext);
 void DisplaySetDietReg(GlobalHist_CONTEXT *pGheContext, GlobalHist_ARGS *GheArgs);
@@ -135,6 +198,19 @@ double DisplayPcPhaseCoordinatorTemporalIIRFilterNthOrder(double FilterCoefficie
 double GetSRGBDecodingValue(double input);
 double EstimateProbabilityOfFullScreenSolidColor(double *pPowerHistogram, double TotalPower);
 double GetRelativeFrameBrightnessChange(GlobalHist_CONTEXT* pGheContext,  uint32_t* pPrevHist);
+
+// Shared by every bin count, see GHE_Engine.h
+double DisplayGheGetRelativeBrightnessChange(double FramePowerPrev, double FramePowerCurr);
+
+// Temporal filter timing. Advance once per frame with its timestamp, frames without one are taken
+// GlobalHist_SMOOTHENING_SAMPLING_PERIOD apart. A raised cut off frequency is kept for at least
+// SMOOTHENING_MIN_STABLE_CUT_OFF_FREQUNCY_DURATION so one scene change converges at one speed.
+// The coefficient comes from a table over CutOffFreq * SamplingPeriod, so it costs the same at any refresh rate.
+void DisplayGheInitializeFilterClock(GlobalHist_FILTER_CLOCK *pClock);
+void DisplayGheSetFilterClockLimits(GlobalHist_FILTER_CLOCK *pClock, const GlobalHist_CFG *pCfg);
+void DisplayGheAdvanceFilterClock(GlobalHist_FILTER_CLOCK *pClock, uint64_t TimestampNs);
+double DisplayGheGetCutOffFrequency(GlobalHist_FILTER_CLOCK *pClock, double RelativeBrightnessChange, double MinCutoffFreq, double MaxCutoffFreq);
+double DisplayGheGetIIRFilterCoefficient(double CutOffFreq, double SamplingPeriod);
 #endif
 
 
@@ -0,0 +1,407 @@
+#include "GHE_Batch.h"
+#include "GHE_Cpu.h"
+#include "GHE_DeGamma.h"
+
+#define BATCH_LANES GlobalHist_BATCH_BLOCK
+
+GlobalHist_BATCH_CONTEXT *DisplayGheCreateBatch(uint32_t StreamCount)
+{
+    GlobalHist_BATCH_CONTEXT *pBatch;
+    uint32_t StreamStride;
+    size_t EntryCount;
+    const double IetLutStepSize = 1.0 / (double)GlobalHist_MAX_IET_INDEX;
+
+    if (0 == StreamCount)
+    {
+        return NULL;
+    }
+
+    pBatch = (GlobalHist_BATCH_CONTEXT *)calloc(1, sizeof(GlobalHist_BATCH_CONTEXT));
+
+    if (NULL == pBatch)
+    {
+        return NULL;
+    }
+
+    StreamStride = (StreamCount + BATCH_LANES - 1) / BATCH_LANES * BATCH_LANES;
+    pBatch->StreamCount  = StreamCount;
+    pBatch->StreamStride = StreamStride;
+
+    pBatch->pPrevHistogram = (uint32_t *)calloc((size_t)GlobalHist_BIN_COUNT * StreamStride, sizeof(uint32_t));
+    pBatch->pPrevFramePower = (double *)calloc(StreamStride, sizeof(double));
+    pBatch->pFilterClock   = (GlobalHist_FILTER_CLOCK *)calloc(StreamStride, sizeof(GlobalHist_FILTER_CLOCK));
+    pBatch->pLutTarget     = (uint32_t *)calloc((size_t)GlobalHist_IET_LUT_LENGTH * StreamStride, sizeof(uint32_t));
+    pBatch->pLutApplied    = (uint32_t *)calloc((size_t)GlobalHist_IET_LUT_LENGTH * StreamStride, sizeof(uint32_t));
+    pBatch->pIETHistory    = (double *)calloc((size_t)GlobalHist_IET_LUT_LENGTH * GlobalHist_IIR_FILTER_ORDER * StreamStride, sizeof(double));
+
+    if ((NULL == pBatch->pPrevHistogram) || (NULL == pBatch->pPrevFramePower) || (NULL == pBatch->pFilterClock) || (NULL == pBatch->pLutTarget) ||
+        (NULL == pBatch->pLutApplied) || (NULL == pBatch->pIETHistory))
+    {
+        DisplayGheDestroyBatch(pBatch);
+        return NULL;
+    }
+
+    // Same initial state as DisplayInitializeAlgorithmState on a zeroed context
+    EntryCount = (size_t)GlobalHist_IET_LUT_LENGTH * StreamStride;
+    for (size_t Count = 0; Count < EntryCount; Count++)
+    {
+        pBatch->pLutTarget[Count]  = GlobalHist_IET_SCALE_FACTOR;
+        pBatch->pLutApplied[Count] = GlobalHist_IET_SCALE_FACTOR;
+    }
+
+    for (size_t Count = 0; Count < EntryCount * GlobalHist_IIR_FILTER_ORDER; Count++)
+    {
+        pBatch->pIETHistory[Count] = GlobalHist_IET_SCALE_FACTOR;
+    }
+
+    for (uint32_t Stream = 0; Stream < StreamStride; Stream++)
+    {
+        DisplayGheInitializeFilterClock(&pBatch->pFilterClock[Stream]);
+    }
+
+    pBatch->pDeGammaLUT = DisplayGheGetDeGammaLUT(GlobalHist_TRANSFER_SRGB, GlobalHist_BIN_COUNT);
+
+    // Interpolation positions used by Apply1DLUT never change, resolve them once
+    for (uint32_t IetIndex = 1; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        double BinIndexNormalized = (double)IetIndex * IetLutStepSize;
+        double DIndex = BinIndexNormalized * (double)GlobalHist_MAX_BIN_INDEX;
+
+        pBatch->IetBinNormalized[IetIndex] = BinIndexNormalized;
+        pBatch->IetIndex1[IetIndex]        = (uint32_t)DIndex;
+        pBatch->IetIndex2[IetIndex]        = (uint32_t)(ceil(DIndex));
+        pBatch->IetInterpolator[IetIndex]  = DIndex - (double)pBatch->IetIndex1[IetIndex];
+    }
+
+    pBatch->MinCutoffFreq      = MILLIUNIT_TO_UNIT((double)DD_MIN(GlobalHist_SMOOTHENING_MIN_SPEED_DEFAULT, GlobalHist_SMOOTHENING_MAX_SPEED_DEFAULT));
+    pBatch->MaxCutoffFreq      = MILLIUNIT_TO_UNIT((double)DD_MAX(GlobalHist_SMOOTHENING_MIN_SPEED_DEFAULT, GlobalHist_SMOOTHENING_MAX_SPEED_DEFAULT));
+    pBatch->MinimumStepPercent = GlobalHist_SMOOTHENING_TOLERANCE_DEFAULT;
+
+    return pBatch;
+}
+
+void DisplayGheDestroyBatch(GlobalHist_BATCH_CONTEXT *pBatch)
+{
+    if (NULL == pBatch)
+    {
+        return;
+    }
+
+    free(pBatch->pPrevHistogram);
+    free(pBatch->pPrevFramePower);
+    free(pBatch->pFilterClock);
+    free(pBatch->pLutTarget);
+    free(pBatch->pLutApplied);
+    free(pBatch->pIETHistory);
+    free(pBatch);
+}
+
+// Processes BATCH_LANES streams starting at FirstStream. Every loop runs over lanes innermost
+// with a constant trip count so that it vectorizes; per stream branches of the scalar path
+// (solid color early out, target reached snap) become per lane selects.
+GlobalHist_ISA_BODY void BatchProcessBlockBody(GlobalHist_BATCH_CONTEXT *pBatch, GlobalHist_ARGS *pGheArgs, uint32_t FirstStream, uint32_t ActiveStreams)
+{
+    const uint32_t Stride = pBatch->StreamStride;
+    const double MaxHistBinIndex = GlobalHist_MAX_BIN_INDEX;
+    const double HistBinStepSize = 1.0 / MaxHistBinIndex;
+    const double MaxSlope = GlobalHist_MAX_SLOPE;
+    const double MinSlope = GlobalHist_MIN_SLOPE;
+    const double MinimumStepPercent = pBatch->MinimumStepPercent;
+    const double WindowSizeToProbabilityMapping[SOLID_COLOR_SEARCH_WINDOW_SIZE] = SOLID_COLOR_WINDOW_PROBABILITY;
+
+    uint32_t Histogram[GlobalHist_BIN_COUNT][BATCH_LANES];
+    uint32_t CumulativeHistogram[GlobalHist_BIN_COUNT][BATCH_LANES];
+    double PowerPrefix[GlobalHist_BIN_COUNT + 1][BATCH_LANES];
+    double EnhancementTable[GlobalHist_BIN_COUNT][BATCH_LANES];
+    double FilteredEnhancementTable[GlobalHist_BIN_COUNT][BATCH_LANES];
+    uint32_t TotalNumOfPixel[BATCH_LANES];
+    double SumPower[BATCH_LANES];
+    double SolidColorProbability[BATCH_LANES];
+    double SolidColorThreshold[BATCH_LANES];
+    double CdfNormalizingFactor[BATCH_LANES];
+    double FilterCoefficient[BATCH_LANES];
+    int32_t IsSolidColor[BATCH_LANES];
+    int32_t IsTargetReached[BATCH_LANES];
+    int64_t IsKeepState[BATCH_LANES];
+    int64_t IsSnapToTarget[BATCH_LANES];
+    uint32_t KeepStateMask[BATCH_LANES];
+
+    uint32_t *pPrevHistogram = pBatch->pPrevHistogram + FirstStream;
+    double *pPrevFramePower  = pBatch->pPrevFramePower + FirstStream;
+    GlobalHist_FILTER_CLOCK *pFilterClock = pBatch->pFilterClock + FirstStream;
+    uint32_t *pLutTarget     = pBatch->pLutTarget + FirstStream;
+    uint32_t *pLutApplied    = pBatch->pLutApplied + FirstStream;
+    double *pIETHistory      = pBatch->pIETHistory + FirstStream;
+
+    // Transpose input so bin k of every stream is contiguous. Idle lanes see an empty frame,
+    // which is classified as solid color and leaves their state untouched.
+    for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+    {
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            Histogram[BinIndex][Lane] = (Lane < ActiveStreams) ? pGheArgs[Lane].Histogram[BinIndex] : 0;
+        }
+    }
+
+    // Cumulative histogram and power prefix sums, one pass as in the engine's Analyze
+    for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+    {
+        TotalNumOfPixel[Lane] = 0;
+        PowerPrefix[0][Lane]  = 0;
+    }
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        const double BinWeight = pBatch->pDeGammaLUT[BinIndex];
+
+        for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+        {
+            TotalNumOfPixel[Lane] += Histogram[BinIndex][Lane];
+            CumulativeHistogram[BinIndex][Lane] = TotalNumOfPixel[Lane];
+
+            PowerPrefix[BinIndex + 1][Lane] = PowerPrefix[BinIndex][Lane] + BinWeight * (double)Histogram[BinIndex][Lane];
+        }
+    }
+
+    // Solid color estimation. The smallest window holding the threshold power decides, window
+    // power being a difference of prefix sums like in the engine's EstimateSolidColor.
+    for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+    {
+        SumPower[Lane]              = PowerPrefix[GlobalHist_BIN_COUNT][Lane];
+        SolidColorProbability[Lane] = 0;
+        SolidColorThreshold[Lane]   = SOLID_COLOR_POWER_THRESHOLD * SumPower[Lane];
+    }
+
+    for (uint32_t N = 1; N <= SOLID_COLOR_SEARCH_WINDOW_SIZE; N++)
+    {
+        const double Probability = WindowSizeToProbabilityMapping[N - 1];
+
+        for (uint32_t BinIndex = 0; BinIndex < (GlobalHist_BIN_COUNT - N + 1); BinIndex++)
+        {
+            for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+            {
+                double Sum = PowerPrefix[BinIndex + N][Lane] - PowerPrefix[BinIndex][Lane];
+                int32_t IsHit = (Sum >= SolidColorThreshold[Lane]) & (0 == SolidColorProbability[Lane]);
+
+                SolidColorProbability[Lane] = IsHit ? Probability : SolidColorProbability[Lane];
+            }
+        }
+    }
+
+    for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+    {
+        double CDFRange = (double)CumulativeHistogram[GlobalHist_MAX_BIN_INDEX][Lane] - (double)Histogram[0][Lane];
+
+        IsSolidColor[Lane]         = (1 == SolidColorProbability[Lane]);
+        CdfNormalizingFactor[Lane] = (CDFRange > 0) ? (1.0 / CDFRange) : 0;
+        EnhancementTable[0][Lane]  = ((double)CumulativeHistogram[0][Lane] - (double)Histogram[0][Lane]) * CdfNormalizingFactor[Lane];
+    }
+
+    // Normalized CDF with slope clamp. Sequential over bins, parallel over streams.
+    for (uint32_t BinIndex = 1; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+        {
+            double OutVal = ((double)CumulativeHistogram[BinIndex][Lane] - (double)Histogram[0][Lane]) * CdfNormalizingFactor[Lane];
+            double PrevSampleVal = EnhancementTable[BinIndex - 1][Lane];
+            double Slope = MaxHistBinIndex * (OutVal - PrevSampleVal);
+
+            Slope = DD_MAX(Slope, MinSlope);
+            Slope = DD_MIN(Slope, MaxSlope);
+
+            OutVal = PrevSampleVal + Slope * HistBinStepSize;
+            OutVal = DD_MIN(OutVal, 1.0);
+
+            EnhancementTable[BinIndex][Lane] = OutVal;
+        }
+    }
+
+    for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+    {
+        FilteredEnhancementTable[0][Lane] = EnhancementTable[0][Lane];
+        FilteredEnhancementTable[GlobalHist_MAX_BIN_INDEX][Lane] = EnhancementTable[GlobalHist_MAX_BIN_INDEX][Lane];
+    }
+
+    for (uint32_t BinIndex = 1; BinIndex < GlobalHist_MAX_BIN_INDEX; BinIndex++)
+    {
+        for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+        {
+            FilteredEnhancementTable[BinIndex][Lane] = 0.333333 * (EnhancementTable[BinIndex - 1][Lane] + EnhancementTable[BinIndex][Lane] + EnhancementTable[BinIndex + 1][Lane]);
+        }
+    }
+
+    // Convert to IET LUT. Solid color streams get the identity LUT.
+    for (uint32_t IetIndex = 1; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        const double BinIndexNormalized = pBatch->IetBinNormalized[IetIndex];
+        const double MaxIetVal = 1.0 / BinIndexNormalized;
+        const double Interpolator = pBatch->IetInterpolator[IetIndex];
+        const double *pVal1 = FilteredEnhancementTable[pBatch->IetIndex1[IetIndex]];
+        const double *pVal2 = FilteredEnhancementTable[pBatch->IetIndex2[IetIndex]];
+        uint32_t *pTarget = pLutTarget + (size_t)IetIndex * Stride;
+
+        for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+        {
+            double IetVal = pVal1[Lane] + Interpolator * (pVal2[Lane] - pVal1[Lane]);
+
+            IetVal = IetVal / BinIndexNormalized;
+            IetVal = DD_MIN(IetVal, MaxIetVal);
+
+            IetVal = (double)GlobalHist_IET_SCALE_FACTOR * IetVal + 0.5;
+            IetVal = DD_MIN(IetVal, GlobalHist_IET_MAX_VAL);
+            IetVal = DD_MAX(IetVal, GlobalHist_IET_SCALE_FACTOR);
+
+            pTarget[Lane] = IsSolidColor[Lane] ? GlobalHist_IET_SCALE_FACTOR : (uint32_t)(int32_t)IetVal;
+        }
+    }
+
+    for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+    {
+        pLutTarget[Lane] = pLutTarget[Stride + Lane];
+        IsTargetReached[Lane] = TRUE;
+    }
+
+    // IsTargetIETReached
+    for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        const uint32_t *pTarget  = pLutTarget + (size_t)IetIndex * Stride;
+        const uint32_t *pApplied = pLutApplied + (size_t)IetIndex * Stride;
+
+        for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+        {
+            int32_t Delta = (int32_t)pApplied[Lane] - (int32_t)pTarget[Lane];
+
+            IsTargetReached[Lane] &= ((double)(100 * DD_ABS(Delta)) <= MinimumStepPercent * (double)pTarget[Lane]);
+        }
+    }
+
+    // Solid color streams keep their whole temporal state, the others either snap or filter
+    for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+    {
+        IsKeepState[Lane]    = IsSolidColor[Lane] ? -1 : 0;
+        KeepStateMask[Lane]  = IsSolidColor[Lane] ? 0xFFFFFFFF : 0;
+        IsSnapToTarget[Lane] = (IsSolidColor[Lane] | (0 == IsTargetReached[Lane])) ? 0 : -1;
+    }
+
+    // CalculateIIRFilterCoefficient against the cached power of the previous histogram. The clock
+    // advances on every frame, the cut off frequency hold only moves on streams that filter.
+    for (uint32_t Lane = 0; Lane < ActiveStreams; Lane++)
+    {
+        DisplayGheAdvanceFilterClock(&pFilterClock[Lane], pGheArgs[Lane].TimestampNs);
+        FilterCoefficient[Lane] = 0;
+
+        if ((0 == IsKeepState[Lane]) && (0 == IsSnapToTarget[Lane]))
+        {
+            double CutOffFreq = DisplayGheGetCutOffFrequency(&pFilterClock[Lane], DisplayGheGetRelativeBrightnessChange(pPrevFramePower[Lane], SumPower[Lane]),
+                                                             pBatch->MinCutoffFreq, pBatch->MaxCutoffFreq);
+
+            FilterCoefficient[Lane] = DisplayGheGetIIRFilterCoefficient(CutOffFreq, pFilterClock[Lane].SamplingPeriod);
+        }
+    }
+
+    for (uint32_t Lane = ActiveStreams; Lane < BATCH_LANES; Lane++)
+    {
+        FilterCoefficient[Lane] = 0;
+    }
+
+    // Temporal IIR across streams, or snap to target where it has been reached
+    for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        const uint32_t *pTarget = pLutTarget + (size_t)IetIndex * Stride;
+        uint32_t *pApplied = pLutApplied + (size_t)IetIndex * Stride;
+        double *pHistory = pIETHistory + (size_t)IetIndex * GlobalHist_IIR_FILTER_ORDER * Stride;
+
+        for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+        {
+            const double Target = (double)pTarget[Lane];
+            double AdjustedValue = Target;
+            uint32_t IetVal;
+
+            for (uint32_t FilterOrder = 0; FilterOrder < GlobalHist_IIR_FILTER_ORDER; FilterOrder++)
+            {
+                double *pTap = &pHistory[(size_t)FilterOrder * Stride];
+                double Tap = pTap[Lane];
+
+                AdjustedValue = FilterCoefficient[Lane] * AdjustedValue;
+                AdjustedValue += (1 - FilterCoefficient[Lane]) * Tap;
+
+                Tap = IsKeepState[Lane] ? Tap : AdjustedValue;
+                Tap = IsSnapToTarget[Lane] ? Target : Tap;
+                pTap[Lane] = Tap;
+            }
+
+            IetVal = (uint32_t)(int32_t)AdjustedValue;
+            IetVal = DD_MIN(IetVal, GlobalHist_IET_MAX_VAL);
+            IetVal = IsSnapToTarget[Lane] ? pTarget[Lane] : IetVal;
+
+            pApplied[Lane] = (pApplied[Lane] & KeepStateMask[Lane]) | (IetVal & ~KeepStateMask[Lane]);
+        }
+    }
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        uint32_t *pPrev = pPrevHistogram + (size_t)BinIndex * Stride;
+
+        for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+        {
+            pPrev[Lane] = (pPrev[Lane] & KeepStateMask[Lane]) | (Histogram[BinIndex][Lane] & ~KeepStateMask[Lane]);
+        }
+    }
+
+    for (uint32_t Lane = 0; Lane < BATCH_LANES; Lane++)
+    {
+        pPrevFramePower[Lane] = IsKeepState[Lane] ? pPrevFramePower[Lane] : SumPower[Lane];
+    }
+
+    // DisplaySetDietReg
+    for (uint32_t Lane = 0; Lane < ActiveStreams; Lane++)
+    {
+        pGheArgs[Lane].IsProgramDiet = TRUE;
+
+        for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+        {
+            pGheArgs[Lane].DietFactor[IetIndex] = pLutApplied[(size_t)IetIndex * Stride + Lane];
+        }
+    }
+}
+
+typedef void (*PFN_GlobalHistBATCHBLOCK)(GlobalHist_BATCH_CONTEXT *pBatch, GlobalHist_ARGS *pGheArgs, uint32_t FirstStream, uint32_t ActiveStreams);
+
+static void BatchProcessBlock(GlobalHist_BATCH_CONTEXT *pBatch, GlobalHist_ARGS *pGheArgs, uint32_t FirstStream, uint32_t ActiveStreams)
+{
+    BatchProcessBlockBody(pBatch, pGheArgs, FirstStream, ActiveStreams);
+}
+
+#if GlobalHist_HAS_ISA_DISPATCH
+
+GlobalHist_TARGET_AVX2 static void BatchProcessBlockAvx2(GlobalHist_BATCH_CONTEXT *pBatch, GlobalHist_ARGS *pGheArgs, uint32_t FirstStream, uint32_t ActiveStreams)
+{
+    BatchProcessBlockBody(pBatch, pGheArgs, FirstStream, ActiveStreams);
+}
+
+GlobalHist_TARGET_AVX512 static void BatchProcessBlockAvx512(GlobalHist_BATCH_CONTEXT *pBatch, GlobalHist_ARGS *pGheArgs, uint32_t FirstStream, uint32_t ActiveStreams)
+{
+    BatchProcessBlockBody(pBatch, pGheArgs, FirstStream, ActiveStreams);
+}
+
+static const PFN_GlobalHistBATCHBLOCK BatchProcessBlockIsa[GlobalHist_ISA_COUNT] = { BatchProcessBlock, BatchProcessBlockAvx2, BatchProcessBlockAvx512 };
+
+#else
+
+static const PFN_GlobalHistBATCHBLOCK BatchProcessBlockIsa[GlobalHist_ISA_COUNT] = { BatchProcessBlock, BatchProcessBlock, BatchProcessBlock };
+
+#endif
+
+void DisplayGheBatchProcess(GlobalHist_BATCH_CONTEXT *pBatch, GlobalHist_ARGS *pGheArgs, uint32_t StreamCount)
+{
+    PFN_GlobalHistBATCHBLOCK pfnBlock = BatchProcessBlockIsa[DisplayGheGetIsa()];
+
+    StreamCount = DD_MIN(StreamCount, pBatch->StreamCount);
+
+    for (uint32_t FirstStream = 0; FirstStream < StreamCount; FirstStream += BATCH_LANES)
+    {
+        uint32_t ActiveStreams = DD_MIN(StreamCount - FirstStream, BATCH_LANES);
+
+        pfnBlock(pBatch, &pGheArgs[FirstStream], FirstStream, ActiveStreams);
+    }
+}
@@ -0,0 +1,49 @@
+/**
+ *
+ * @file  GHE_Batch.h
+ * @brief  Batched GHE entry point processing many independent streams per call
+ *
+ */
+
+#ifndef _DISPLAY_GHEBATCH_H_
+#define _DISPLAY_GHEBATCH_H_
+
+#include "GHE_Algorithm.h"
+
+#define GlobalHist_BATCH_BLOCK 32 // Streams processed together by one pass of the batch kernels
+
+// Per stream state stored structure-of-arrays: entry k of every stream is contiguous,
+// so every stage of the algorithm runs across streams instead of across bins.
+typedef struct _GlobalHist_BATCH_CONTEXT
+{
+    uint32_t StreamCount;  // Number of streams the batch was created for
+    uint32_t StreamStride; // StreamCount rounded up to GlobalHist_BATCH_BLOCK
+
+    const double *pDeGammaLUT; // Shared sRGB table, see GHE_DeGamma.h
+
+    // Histogram LUT to IET LUT interpolation, identical for every stream
+    double IetBinNormalized[GlobalHist_IET_LUT_LENGTH];
+    double IetInterpolator[GlobalHist_IET_LUT_LENGTH];
+    uint32_t IetIndex1[GlobalHist_IET_LUT_LENGTH];
+    uint32_t IetIndex2[GlobalHist_IET_LUT_LENGTH];
+
+    double MinCutoffFreq;      // In Hz
+    double MaxCutoffFreq;      // In Hz
+    double MinimumStepPercent;
+
+    uint32_t *pPrevHistogram; // [GlobalHist_BIN_COUNT][StreamStride]
+    double *pPrevFramePower;  // [StreamStride], power of the previous histogram
+    GlobalHist_FILTER_CLOCK *pFilterClock; // [StreamStride]
+    uint32_t *pLutTarget;     // [GlobalHist_IET_LUT_LENGTH][StreamStride]
+    uint32_t *pLutApplied;    // [GlobalHist_IET_LUT_LENGTH][StreamStride]
+    double *pIETHistory;      // [GlobalHist_IET_LUT_LENGTH][GlobalHist_IIR_FILTER_ORDER][StreamStride]
+} GlobalHist_BATCH_CONTEXT;
+
+GlobalHist_BATCH_CONTEXT *DisplayGheCreateBatch(uint32_t StreamCount);
+void DisplayGheDestroyBatch(GlobalHist_BATCH_CONTEXT *pBatch);
+
+// Runs one frame for streams [0, StreamCount). pGheArgs[i] feeds stream i and receives its DietFactor.
+// Results match DisplayGheProcessFrame on a per stream context bit for bit. PipeId is left untouched.
+void DisplayGheBatchProcess(GlobalHist_BATCH_CONTEXT *pBatch, GlobalHist_ARGS *pGheArgs, uint32_t StreamCount);
+
+#endif
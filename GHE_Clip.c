@@ -0,0 +1,187 @@
+#include "GHE_Algorithm.h"
+#include "GHE_Clip.h"
+#include "GHE_Engine.h"
+
+typedef struct _CLIP_FRAME
+{
+    GlobalHist_LUT_TARGET_RESULT Target;
+    bool IsSnapped;                  // The speculative run snapped to Target
+    GlobalHist_FILTER_CLOCK Clock;   // Of the speculative run after the frame
+} CLIP_FRAME;
+
+typedef struct _CLIP_JOB
+{
+    GlobalHist_CONTEXT *pGheContext;  // Runs chunk 0 and the correction pass
+    GlobalHist_CONTEXT *pSpeculative; // [ChunkCount], chunk 0 leaves its entry unused
+    GlobalHist_ARGS *pGheArgs;
+    CLIP_FRAME *pFrame;               // [FrameCount]
+    uint32_t FrameCount;
+    uint32_t ChunkCount;
+} CLIP_JOB;
+
+static uint32_t GetChunkStart(const CLIP_JOB *pJob, uint32_t Chunk)
+{
+    return (uint32_t)((uint64_t)pJob->FrameCount * Chunk / pJob->ChunkCount);
+}
+
+// DisplayGheProcessFrame with the target computed ahead, without the trace and the stats publish
+static bool ProcessClipFrame(GlobalHist_CONTEXT *pGheContext, GlobalHist_ARGS *GheArgs, const CLIP_FRAME *pFrame)
+{
+    bool IsSnapped;
+
+    memcpy(pGheContext->Histogram, GheArgs->Histogram, sizeof(pGheContext->Histogram));
+    pGheContext->Algorithm.ImageSize = (GheArgs->Resolution_X * GheArgs->Resolution_Y);
+
+    IsSnapped = DisplayGheAlgorithmWithTarget(pGheContext, GheArgs, &pFrame->Target);
+    pGheContext->GheFuncTable.pGheSetIet(pGheContext, GheArgs);
+
+    return IsSnapped;
+}
+
+// The state after a snap to the frame before the chunk, with the cut off frequency hold expired
+static void GuessChunkState(GlobalHist_CONTEXT *pGuess, const GlobalHist_ARGS *pPrevArgs, const GlobalHist_LUT_TARGET_RESULT *pPrevTarget)
+{
+    GlobalHist_TEMPORAL_FILTER_PARAMS *pFilterParams = &pGuess->FilterParams;
+
+    DisplayGheEngine_32_33_SnapToTarget(pPrevTarget->LutTarget, pGuess->ImageEnhancement.LutApplied, pFilterParams->IETHistory);
+    memcpy(pFilterParams->PrevHistogram, pPrevArgs->Histogram, sizeof(pFilterParams->PrevHistogram));
+
+    pFilterParams->PrevFramePower        = pPrevTarget->FramePower;
+    pFilterParams->Clock.PrevTimestampNs = pPrevArgs->TimestampNs;
+    pFilterParams->Clock.HeldCutOffFreq  = 0;
+    pFilterParams->Clock.HoldRemaining   = 0;
+    pGuess->ChangeDetection.IsConverged  = TRUE;
+}
+
+// Everything the next frame reads from the previous ones
+static void CopyTemporalState(GlobalHist_CONTEXT *pDst, const GlobalHist_CONTEXT *pSrc)
+{
+    memcpy(pDst->Histogram, pSrc->Histogram, sizeof(pDst->Histogram));
+    pDst->Algorithm        = pSrc->Algorithm;
+    pDst->ImageEnhancement = pSrc->ImageEnhancement;
+    pDst->FilterParams     = pSrc->FilterParams;
+    pDst->ChangeDetection.IsConverged = pSrc->ChangeDetection.IsConverged;
+}
+
+// Targets of the chunk, then the filter over them. Chunk 0 starts from the context and is exact,
+// the others start from GuessChunkState.
+static void RunChunk(void *pTaskContext, uint32_t Chunk)
+{
+    CLIP_JOB *pJob = (CLIP_JOB *)pTaskContext;
+    GlobalHist_CONTEXT *pChunkContext = (0 == Chunk) ? pJob->pGheContext : &pJob->pSpeculative[Chunk];
+    uint32_t Start = GetChunkStart(pJob, Chunk);
+    uint32_t End = GetChunkStart(pJob, Chunk + 1);
+
+    // Static content repeats its histogram, and with it the target, as the LUT cache would
+    for (uint32_t Frame = Start; Frame < End; Frame++)
+    {
+        const uint32_t *pHistogram = pJob->pGheArgs[Frame].Histogram;
+
+        if ((Frame > Start) && (0 == memcmp(pHistogram, pJob->pGheArgs[Frame - 1].Histogram, sizeof(pJob->pGheArgs[Frame].Histogram))))
+        {
+            pJob->pFrame[Frame].Target = pJob->pFrame[Frame - 1].Target;
+            continue;
+        }
+
+        DisplayGheComputeLutTarget(pChunkContext, pHistogram, &pJob->pFrame[Frame].Target);
+    }
+
+    if (0 != Chunk)
+    {
+        GlobalHist_LUT_TARGET_RESULT PrevTarget;
+
+        DisplayGheComputeLutTarget(pChunkContext, pJob->pGheArgs[Start - 1].Histogram, &PrevTarget);
+        GuessChunkState(pChunkContext, &pJob->pGheArgs[Start - 1], &PrevTarget);
+    }
+
+    for (uint32_t Frame = Start; Frame < End; Frame++)
+    {
+        CLIP_FRAME *pFrame = &pJob->pFrame[Frame];
+
+        pFrame->IsSnapped = ProcessClipFrame(pChunkContext, &pJob->pGheArgs[Frame], pFrame);
+        pFrame->Clock     = pChunkContext->FilterParams.Clock;
+    }
+}
+
+// Replays the chunk from the state the previous one ended in. Once both runs snapped on the same
+// frame with the same clock their states are equal, the speculative frames after it stand.
+static uint32_t CorrectChunk(CLIP_JOB *pJob, uint32_t Chunk)
+{
+    GlobalHist_CONTEXT *pGheContext = pJob->pGheContext;
+    uint32_t Start = GetChunkStart(pJob, Chunk);
+    uint32_t End = GetChunkStart(pJob, Chunk + 1);
+
+    for (uint32_t Frame = Start; Frame < End; Frame++)
+    {
+        const CLIP_FRAME *pFrame = &pJob->pFrame[Frame];
+        bool IsSnapped = ProcessClipFrame(pGheContext, &pJob->pGheArgs[Frame], pFrame);
+
+        if (IsSnapped && pFrame->IsSnapped && (0 == memcmp(&pGheContext->FilterParams.Clock, &pFrame->Clock, sizeof(pFrame->Clock))))
+        {
+            CopyTemporalState(pGheContext, &pJob->pSpeculative[Chunk]);
+            return Frame - Start + 1;
+        }
+    }
+
+    return End - Start;
+}
+
+void DisplayGheProcessClip(GlobalHist_CONTEXT *pGheContext, GlobalHist_ARGS *pGheArgs, uint32_t FrameCount, GlobalHist_THREAD_POOL *pPool,
+                           GlobalHist_CLIP_STATS *pStats)
+{
+    GlobalHist_LUT_TARGET_RESULT Probe;
+    CLIP_JOB Job;
+    uint32_t ReplayedFrames = 0;
+
+    Job.pGheContext  = pGheContext;
+    Job.pGheArgs     = pGheArgs;
+    Job.FrameCount   = FrameCount;
+    Job.ChunkCount   = DD_MAX(DD_MIN(DisplayGheGetThreadCount(pPool), FrameCount / GlobalHist_CLIP_MIN_CHUNK), 1);
+    Job.pFrame       = NULL;
+    Job.pSpeculative = NULL;
+
+    if ((0 != FrameCount) && DisplayGheComputeLutTarget(pGheContext, pGheArgs[0].Histogram, &Probe))
+    {
+        Job.pFrame       = (CLIP_FRAME *)malloc((size_t)FrameCount * sizeof(CLIP_FRAME));
+        Job.pSpeculative = (GlobalHist_CONTEXT *)malloc((size_t)Job.ChunkCount * sizeof(GlobalHist_CONTEXT));
+    }
+
+    // Targets that depend on the history, or no memory for the speculation
+    if ((NULL == Job.pFrame) || (NULL == Job.pSpeculative))
+    {
+        for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+        {
+            memcpy(pGheContext->Histogram, pGheArgs[Frame].Histogram, sizeof(pGheContext->Histogram));
+            pGheContext->Algorithm.ImageSize = (pGheArgs[Frame].Resolution_X * pGheArgs[Frame].Resolution_Y);
+
+            pGheContext->GheFuncTable.pGheAlgorithm(pGheContext, &pGheArgs[Frame]);
+            pGheContext->GheFuncTable.pGheSetIet(pGheContext, &pGheArgs[Frame]);
+        }
+
+        Job.ChunkCount = 1;
+    }
+    else
+    {
+        // Copies of the context, so every chunk sees its configuration and transfer function
+        for (uint32_t Chunk = 1; Chunk < Job.ChunkCount; Chunk++)
+        {
+            memcpy(&Job.pSpeculative[Chunk], pGheContext, sizeof(GlobalHist_CONTEXT));
+        }
+
+        DisplayGheThreadPoolRun(pPool, Job.ChunkCount, RunChunk, &Job);
+
+        for (uint32_t Chunk = 1; Chunk < Job.ChunkCount; Chunk++)
+        {
+            ReplayedFrames += CorrectChunk(&Job, Chunk);
+        }
+    }
+
+    if (NULL != pStats)
+    {
+        pStats->ChunkCount     = Job.ChunkCount;
+        pStats->ReplayedFrames = ReplayedFrames;
+    }
+
+    free(Job.pFrame);
+    free(Job.pSpeculative);
+}
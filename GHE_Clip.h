@@ -0,0 +1,42 @@
+/**
+ *
+ * @file  GHE_Clip.h
+ * @brief  Offline processing of a whole clip on all cores, identical to DisplayGheProcessFrame frame by frame
+ *
+ * The LutTarget of every frame only depends on its histogram, so the clip is cut into one chunk
+ * per thread and every chunk computes its targets in parallel. The temporal filter is a recurrence
+ * from frame to frame, but a snap to the target resets it to a function of that frame alone, apart
+ * from the filter clock. Every chunk but the first therefore runs the filter speculatively from a
+ * guess: snapped to the target of the frame before it, with an expired cut off frequency hold.
+ *
+ * A correction pass then walks the chunks in order. It replays a chunk from the true state the
+ * previous one ended in until the replay and the speculative run snap on the same frame with the
+ * same filter clock. From there the speculative frames are the sequential ones, and the chunk's
+ * end state carries over. Content that snaps often converges within a few frames; a chunk that
+ * never snaps is replayed whole, which is the sequential cost.
+ *
+ */
+
+#ifndef _DISPLAY_GHECLIP_H_
+#define _DISPLAY_GHECLIP_H_
+
+#include "DisplayPc.h"
+#include "GHE_ThreadPool.h"
+
+#define GlobalHist_CLIP_MIN_CHUNK 256 // Fewest frames a chunk is cut to
+
+typedef struct _GlobalHist_CLIP_STATS
+{
+    uint32_t ChunkCount;     // 1 when the clip ran sequentially
+    uint32_t ReplayedFrames; // Frames the correction pass ran again
+} GlobalHist_CLIP_STATS;
+
+// Runs pGheArgs[0, FrameCount) through pGheContext on pPool, as FrameCount calls of
+// DisplayGheProcessFrame in order would: every DietFactor, PipeId and IsProgramDiet and the
+// temporal state the context is left in are the same. The frames are not traced or published to
+// GHE_Stats.h, and the parallel path bypasses the LUT cache. With a lossy cache key or single
+// precision the targets depend on the history, the clip then runs sequentially. pStats may be NULL.
+void DisplayGheProcessClip(GlobalHist_CONTEXT *pGheContext, GlobalHist_ARGS *pGheArgs, uint32_t FrameCount, GlobalHist_THREAD_POOL *pPool,
+                           GlobalHist_CLIP_STATS *pStats);
+
+#endif
@@ -0,0 +1,76 @@
+#include <strings.h>
+
+#include "GHE_Algorithm.h"
+#include "GHE_Cpu.h"
+
+static const char *IsaName[GlobalHist_ISA_COUNT] = { "baseline", "avx2", "avx512" };
+
+// Read by every dispatched kernel. Anything running before the constructor sees the baseline.
+static GlobalHist_ISA HostIsa = GlobalHist_ISA_BASELINE;
+static GlobalHist_ISA SelectedIsa = GlobalHist_ISA_BASELINE;
+
+#if GlobalHist_HAS_ISA_DISPATCH
+
+// __builtin_cpu_supports also checks that the OS saves the AVX and AVX-512 register state
+static GlobalHist_ISA DetectHostIsa(void)
+{
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("bmi2"))
+    {
+        return GlobalHist_ISA_AVX512;
+    }
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2"))
+    {
+        return GlobalHist_ISA_AVX2;
+    }
+
+    return GlobalHist_ISA_BASELINE;
+}
+
+#else
+
+static GlobalHist_ISA DetectHostIsa(void)
+{
+    return GlobalHist_ISA_BASELINE;
+}
+
+#endif
+
+__attribute__((constructor)) static void SelectIsa(void)
+{
+    const char *pCap = getenv("GHE_ISA");
+
+    HostIsa = DetectHostIsa();
+    SelectedIsa = HostIsa;
+
+    if (NULL == pCap)
+    {
+        return;
+    }
+
+    for (uint32_t Isa = 0; Isa < GlobalHist_ISA_COUNT; Isa++)
+    {
+        if (0 == strcasecmp(pCap, IsaName[Isa]))
+        {
+            SelectedIsa = DD_MIN((GlobalHist_ISA)Isa, HostIsa);
+        }
+    }
+}
+
+GlobalHist_ISA DisplayGheGetIsa(void)
+{
+    return SelectedIsa;
+}
+
+GlobalHist_ISA DisplayGheGetHostIsa(void)
+{
+    return HostIsa;
+}
+
+const char *DisplayGheGetIsaName(GlobalHist_ISA Isa)
+{
+    return ((uint32_t)Isa < GlobalHist_ISA_COUNT) ? IsaName[Isa] : "unknown";
+}
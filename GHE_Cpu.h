@@ -0,0 +1,44 @@
+/**
+ *
+ * @file  GHE_Cpu.h
+ * @brief  Instruction set the hot kernels run with, selected once when the library is loaded
+ *
+ * The CDF / slope and IET conversion, the temporal IIR, the batch kernels and the histogram and
+ * DIET pixel kernels are compiled once per GlobalHist_ISA with GCC target attributes. The best
+ * level the host supports is picked at load time, so one binary runs on every x86-64 host.
+ * Setting the environment variable GHE_ISA to baseline, avx2 or avx512 caps the level, which is
+ * how the variants are compared against each other. Floating point contraction is disabled for
+ * the whole library, so every level produces the same DietFactor bit for bit.
+ *
+ */
+
+#ifndef _DISPLAY_GHECPU_H_
+#define _DISPLAY_GHECPU_H_
+
+#include "DisplayPc.h"
+
+typedef enum _GlobalHist_ISA
+{
+    GlobalHist_ISA_BASELINE = 0, // x86-64 with SSE2, or whatever the compiler targets elsewhere
+    GlobalHist_ISA_AVX2,
+    GlobalHist_ISA_AVX512,       // AVX-512 F, BW, DQ and VL
+    GlobalHist_ISA_COUNT
+} GlobalHist_ISA;
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define GlobalHist_HAS_ISA_DISPATCH 1
+#define GlobalHist_TARGET_AVX2 __attribute__((target("avx2,bmi,bmi2,popcnt")))
+#define GlobalHist_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl,avx2,bmi,bmi2,popcnt")))
+#else
+#define GlobalHist_HAS_ISA_DISPATCH 0
+#endif
+
+// Kernel bodies are written once as GlobalHist_ISA_BODY and wrapped per level, the wrapper's
+// target attribute decides the code generated for the inlined body
+#define GlobalHist_ISA_BODY static inline __attribute__((always_inline))
+
+GlobalHist_ISA DisplayGheGetIsa(void);
+GlobalHist_ISA DisplayGheGetHostIsa(void);
+const char *DisplayGheGetIsaName(GlobalHist_ISA Isa);
+
+#endif
@@ -0,0 +1,744 @@
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "GHE_Algorithm.h"
+#include "GHE_Daemon.h"
+
+#define DAEMON_MAGIC             0x44454847u // "GHED"
+#define DAEMON_VERSION           1
+#define DAEMON_RING_MASK         (GlobalHist_DAEMON_RING_SIZE - 1)
+#define DAEMON_RECLAIM_PERIOD_NS 1000000000ull // How often the daemon looks for clients that died
+#define DAEMON_READ_RETRIES      1024          // Torn reads before DisplayGheDaemonRead checks on the daemon
+#define DAEMON_CACHE_ALIGNED     __attribute__((aligned(64)))
+
+// Client slot states. Only a client moves a slot out of FREE and only the daemon back into it.
+#define DAEMON_SLOT_FREE    0
+#define DAEMON_SLOT_ACTIVE  1
+#define DAEMON_SLOT_CLOSING 2
+
+typedef struct _DAEMON_ENTRY
+{
+    uint64_t SubmitNs;
+    GlobalHist_ARGS Args;
+} DAEMON_ENTRY;
+
+typedef struct _DAEMON_SLOT
+{
+    // Owner
+    DAEMON_CACHE_ALIGNED atomic_uint State;
+    atomic_int Pid;
+
+    // Client side
+    DAEMON_CACHE_ALIGNED atomic_uint Head;     // Submitted frames
+    atomic_uint IsClientWaiting;
+
+    // Daemon side, the client sleeps on Completed
+    DAEMON_CACHE_ALIGNED atomic_uint Completed;
+
+    DAEMON_CACHE_ALIGNED DAEMON_ENTRY Ring[GlobalHist_DAEMON_RING_SIZE];
+} DAEMON_SLOT;
+
+// Same seqlock as the GHE service results: every field atomic, the daemon fills the slot Latest
+// does not point to and then flips Latest
+typedef struct _DAEMON_RESULT
+{
+    atomic_uint Sequence;
+    atomic_ullong FrameId;
+    atomic_ullong TimestampNs;
+    atomic_uint DietFactor[GlobalHist_IET_LUT_LENGTH];
+} DAEMON_RESULT;
+
+typedef struct _DAEMON_PIPE
+{
+    DAEMON_CACHE_ALIGNED atomic_uint Latest;
+    DAEMON_RESULT Result[2];
+} DAEMON_PIPE;
+
+// The shared memory segment. Magic is stored last, a client never sees a half initialized one.
+typedef struct _DAEMON_SHARED
+{
+    atomic_uint Magic;
+    uint32_t Version;
+    uint32_t Size;          // sizeof(DAEMON_SHARED)
+    uint32_t ArgsSize;      // sizeof(GlobalHist_ARGS)
+    int32_t DaemonPid;
+
+    // The daemon sleeps on Doorbell, every submission and Stop ring it
+    DAEMON_CACHE_ALIGNED atomic_uint Doorbell;
+    atomic_uint IsDaemonSleeping;
+    atomic_uint IsShutdown;
+
+    DAEMON_PIPE Pipe[GlobalHist_MAX_PIPES];
+    DAEMON_SLOT Slot[GlobalHist_DAEMON_MAX_CLIENTS];
+} DAEMON_SHARED;
+
+struct _GlobalHist_DAEMON
+{
+    DAEMON_SHARED *pShared;
+    char Name[NAME_MAX];
+    GlobalHist_CONTEXT *pContext[GlobalHist_MAX_PIPES];
+    uint64_t PipeFrames[GlobalHist_MAX_PIPES];
+    uint64_t SpinNs;
+    GlobalHist_DAEMON_STATS Stats;
+};
+
+struct _GlobalHist_DAEMON_CLIENT
+{
+    DAEMON_SHARED *pShared;
+    DAEMON_SLOT *pSlot;
+    uint32_t Head;          // Local copies, the client is the only writer of Head
+    uint32_t Consumed;      // Results released
+    uint64_t SpinNs;
+};
+
+static uint64_t GetTimeNs(void)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return (uint64_t)Now.tv_sec * 1000000000ull + (uint64_t)Now.tv_nsec;
+}
+
+// Shared, not FUTEX_PRIVATE: waiter and waker are in different processes
+static void FutexWait(atomic_uint *pWord, uint32_t Expected, uint64_t TimeoutNs)
+{
+    struct timespec Timeout = { (time_t)(TimeoutNs / 1000000000ull), (long)(TimeoutNs % 1000000000ull) };
+
+    syscall(SYS_futex, pWord, FUTEX_WAIT, Expected, &Timeout, NULL, 0);
+}
+
+static void FutexWake(atomic_uint *pWord)
+{
+    syscall(SYS_futex, pWord, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+}
+
+// Spinning only pays when the other side runs on another CPU
+static uint64_t GetSpinNs(void)
+{
+    return (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? GlobalHist_DAEMON_SPIN_NS : 0;
+}
+
+static void CpuRelax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+static void RingDoorbell(DAEMON_SHARED *pShared)
+{
+    atomic_fetch_add(&pShared->Doorbell, 1);
+
+    if (atomic_load(&pShared->IsDaemonSleeping))
+    {
+        FutexWake(&pShared->Doorbell);
+    }
+}
+
+static void Publish(DAEMON_PIPE *pPipe, uint64_t FrameId, const GlobalHist_ARGS *pGheArgs)
+{
+    uint32_t Index = atomic_load_explicit(&pPipe->Latest, memory_order_relaxed) ^ 1;
+    DAEMON_RESULT *pResult = &pPipe->Result[Index];
+    uint32_t Sequence = atomic_load_explicit(&pResult->Sequence, memory_order_relaxed);
+
+    atomic_store_explicit(&pResult->Sequence, Sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&pResult->FrameId, FrameId, memory_order_relaxed);
+    atomic_store_explicit(&pResult->TimestampNs, pGheArgs->TimestampNs, memory_order_relaxed);
+
+    for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        atomic_store_explicit(&pResult->DietFactor[IetIndex], pGheArgs->DietFactor[IetIndex], memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&pResult->Sequence, Sequence + 2, memory_order_release);
+    atomic_store_explicit(&pPipe->Latest, Index, memory_order_release);
+}
+
+// Runs one submitted frame. The args are copied out of the segment first, so a client writing
+// into an entry it already handed over can not change the PipeId under the daemon.
+static void ServeEntry(GlobalHist_DAEMON *pDaemon, DAEMON_ENTRY *pEntry)
+{
+    GlobalHist_ARGS Args = pEntry->Args;
+    uint32_t Pipe = (uint32_t)Args.PipeId;
+
+    if (Pipe >= GlobalHist_MAX_PIPES)
+    {
+        pEntry->Args.IsProgramDiet = FALSE;
+        pDaemon->Stats.Rejected++;
+        return;
+    }
+
+    DisplayGheProcessFrame(pDaemon->pContext[Pipe], &Args);
+    Publish(&pDaemon->pShared->Pipe[Pipe], ++pDaemon->PipeFrames[Pipe], &Args);
+
+    pEntry->Args.IsProgramDiet = Args.IsProgramDiet;
+    memcpy(pEntry->Args.DietFactor, Args.DietFactor, sizeof(Args.DietFactor));
+    pDaemon->Stats.Frames++;
+}
+
+static void ReleaseSlot(DAEMON_SLOT *pSlot)
+{
+    atomic_store(&pSlot->Completed, atomic_load(&pSlot->Head));
+    atomic_store(&pSlot->Pid, 0);
+    atomic_store(&pSlot->State, DAEMON_SLOT_FREE);
+}
+
+// TRUE while the daemon that created the segment runs and was not stopped
+static bool IsSharedDaemonAlive(DAEMON_SHARED *pShared)
+{
+    return !atomic_load(&pShared->IsShutdown) && ((0 == kill(pShared->DaemonPid, 0)) || (EPERM == errno));
+}
+
+// Opens the segment under pName when the daemon recorded in it no longer runs, returns -1 for one
+// of a running or stopping daemon, of another layout, or one still being set up: DaemonPid is
+// stored before Magic. A daemon that died before storing Magic leaves a segment to remove by hand.
+static int OpenStaleSegment(const char *pName)
+{
+    int Fd = shm_open(pName, O_RDONLY, 0);
+    struct stat FileStat;
+    bool IsStale = FALSE;
+
+    if (Fd < 0)
+    {
+        return -1;
+    }
+
+    if ((0 == fstat(Fd, &FileStat)) && ((size_t)FileStat.st_size == sizeof(DAEMON_SHARED)))
+    {
+        DAEMON_SHARED *pShared = (DAEMON_SHARED *)mmap(NULL, sizeof(DAEMON_SHARED), PROT_READ, MAP_SHARED, Fd, 0);
+
+        if (MAP_FAILED != pShared)
+        {
+            IsStale = (DAEMON_MAGIC == atomic_load(&pShared->Magic)) && (0 != pShared->DaemonPid) && (0 != kill(pShared->DaemonPid, 0)) &&
+                      (ESRCH == errno);
+            munmap(pShared, sizeof(DAEMON_SHARED));
+        }
+    }
+
+    if (!IsStale)
+    {
+        close(Fd);
+        return -1;
+    }
+
+    return Fd;
+}
+
+// TRUE when pName still refers to the segment open as Fd
+static bool IsSameSegment(const char *pName, int Fd)
+{
+    int NameFd = shm_open(pName, O_RDONLY, 0);
+    struct stat NameStat, FdStat;
+    bool IsSame;
+
+    if (NameFd < 0)
+    {
+        return FALSE;
+    }
+
+    IsSame = (0 == fstat(NameFd, &NameStat)) && (0 == fstat(Fd, &FdStat)) && (NameStat.st_dev == FdStat.st_dev) && (NameStat.st_ino == FdStat.st_ino);
+    close(NameFd);
+
+    return IsSame;
+}
+
+// One pass over all clients. Returns TRUE when any frame was served.
+static bool ServeClients(GlobalHist_DAEMON *pDaemon)
+{
+    DAEMON_SHARED *pShared = pDaemon->pShared;
+    bool IsAnyServed = FALSE;
+
+    for (uint32_t Index = 0; Index < GlobalHist_DAEMON_MAX_CLIENTS; Index++)
+    {
+        DAEMON_SLOT *pSlot = &pShared->Slot[Index];
+        uint32_t State = atomic_load_explicit(&pSlot->State, memory_order_acquire);
+        uint32_t Completed, Head;
+
+        if (DAEMON_SLOT_CLOSING == State)
+        {
+            ReleaseSlot(pSlot);
+            continue;
+        }
+
+        if (DAEMON_SLOT_ACTIVE != State)
+        {
+            continue;
+        }
+
+        Completed = atomic_load_explicit(&pSlot->Completed, memory_order_relaxed);
+        Head      = atomic_load_explicit(&pSlot->Head, memory_order_acquire);
+
+        // A Head further ahead than the ring is a broken client, serve what the ring can hold
+        if (Head - Completed > GlobalHist_DAEMON_RING_SIZE)
+        {
+            Head = Completed + GlobalHist_DAEMON_RING_SIZE;
+        }
+
+        if (Head == Completed)
+        {
+            continue;
+        }
+
+        for (; Completed != Head; Completed++)
+        {
+            ServeEntry(pDaemon, &pSlot->Ring[Completed & DAEMON_RING_MASK]);
+        }
+
+        atomic_store(&pSlot->Completed, Completed);
+
+        if (atomic_load(&pSlot->IsClientWaiting))
+        {
+            FutexWake(&pSlot->Completed);
+        }
+
+        IsAnyServed = TRUE;
+    }
+
+    return IsAnyServed;
+}
+
+// Frees the slots of clients that exited or crashed without disconnecting
+static void ReclaimSlots(GlobalHist_DAEMON *pDaemon)
+{
+    for (uint32_t Index = 0; Index < GlobalHist_DAEMON_MAX_CLIENTS; Index++)
+    {
+        DAEMON_SLOT *pSlot = &pDaemon->pShared->Slot[Index];
+        int32_t Pid = atomic_load(&pSlot->Pid);
+
+        if ((DAEMON_SLOT_ACTIVE == atomic_load(&pSlot->State)) && (0 != Pid) && (0 != kill(Pid, 0)) && (ESRCH == errno))
+        {
+            ReleaseSlot(pSlot);
+            pDaemon->Stats.Reclaimed++;
+        }
+    }
+}
+
+GlobalHist_DAEMON *DisplayGheCreateDaemon(const char *pName)
+{
+    GlobalHist_DAEMON *pDaemon;
+    DAEMON_SHARED *pShared;
+    int Fd;
+
+    if ((NULL == pName) || (strlen(pName) >= NAME_MAX))
+    {
+        return NULL;
+    }
+
+    pDaemon = (GlobalHist_DAEMON *)calloc(1, sizeof(GlobalHist_DAEMON));
+
+    if (NULL == pDaemon)
+    {
+        return NULL;
+    }
+
+    strcpy(pDaemon->Name, pName);
+    pDaemon->SpinNs = GetSpinNs();
+
+    // Contexts are private to the daemon and not registered, SetHistogramDataBin never sees them
+    for (uint32_t Pipe = 0; Pipe < GlobalHist_MAX_PIPES; Pipe++)
+    {
+        pDaemon->pContext[Pipe] = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+
+        if (NULL == pDaemon->pContext[Pipe])
+        {
+            DisplayGheDestroyDaemon(pDaemon);
+            return NULL;
+        }
+
+        pDaemon->pContext[Pipe]->Pipe = (PIPE_ID)Pipe;
+    }
+
+    Fd = shm_open(pName, O_RDWR | O_CREAT | O_EXCL, 0660);
+
+    // A segment left by a daemon that died is replaced, never reused, any other one fails the
+    // create. The name is only unlinked while it still refers to the stale segment, so a daemon
+    // that replaced it first keeps its own.
+    if ((Fd < 0) && (EEXIST == errno))
+    {
+        int StaleFd = OpenStaleSegment(pName);
+
+        if (StaleFd >= 0)
+        {
+            if (IsSameSegment(pName, StaleFd))
+            {
+                shm_unlink(pName);
+            }
+
+            close(StaleFd);
+            Fd = shm_open(pName, O_RDWR | O_CREAT | O_EXCL, 0660);
+        }
+    }
+
+    if (Fd < 0)
+    {
+        DisplayGheDestroyDaemon(pDaemon);
+        return NULL;
+    }
+
+    if (0 != ftruncate(Fd, sizeof(DAEMON_SHARED)))
+    {
+        close(Fd);
+        shm_unlink(pName);
+        DisplayGheDestroyDaemon(pDaemon);
+        return NULL;
+    }
+
+    pShared = (DAEMON_SHARED *)mmap(NULL, sizeof(DAEMON_SHARED), PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+    close(Fd);
+
+    if (MAP_FAILED == pShared)
+    {
+        shm_unlink(pName);
+        DisplayGheDestroyDaemon(pDaemon);
+        return NULL;
+    }
+
+    // ftruncate zeroed the segment: every slot is free and nothing is published
+    pShared->Version   = DAEMON_VERSION;
+    pShared->Size      = sizeof(DAEMON_SHARED);
+    pShared->ArgsSize  = sizeof(GlobalHist_ARGS);
+    pShared->DaemonPid = (int32_t)getpid();
+    atomic_store_explicit(&pShared->Magic, DAEMON_MAGIC, memory_order_release);
+
+    pDaemon->pShared = pShared;
+
+    return pDaemon;
+}
+
+void DisplayGheDestroyDaemon(GlobalHist_DAEMON *pDaemon)
+{
+    if (NULL == pDaemon)
+    {
+        return;
+    }
+
+    if (NULL != pDaemon->pShared)
+    {
+        // Clients still waiting see the shutdown instead of sleeping out their timeout
+        DisplayGheDaemonStop(pDaemon);
+        shm_unlink(pDaemon->Name);
+        munmap(pDaemon->pShared, sizeof(DAEMON_SHARED));
+    }
+
+    for (uint32_t Pipe = 0; Pipe < GlobalHist_MAX_PIPES; Pipe++)
+    {
+        DisplayGheDestroyContext(pDaemon->pContext[Pipe]);
+    }
+
+    free(pDaemon);
+}
+
+GlobalHist_CONTEXT *DisplayGheDaemonGetContext(GlobalHist_DAEMON *pDaemon, PIPE_ID Pipe)
+{
+    return ((uint32_t)Pipe < GlobalHist_MAX_PIPES) ? pDaemon->pContext[Pipe] : NULL;
+}
+
+void DisplayGheDaemonRun(GlobalHist_DAEMON *pDaemon)
+{
+    DAEMON_SHARED *pShared = pDaemon->pShared;
+    uint64_t IdleSinceNs = GetTimeNs();
+    uint64_t ReclaimNs = IdleSinceNs;
+
+    while (!atomic_load_explicit(&pShared->IsShutdown, memory_order_acquire))
+    {
+        uint32_t Doorbell = atomic_load(&pShared->Doorbell);
+        uint64_t Now;
+
+        if (ServeClients(pDaemon))
+        {
+            IdleSinceNs = GetTimeNs();
+            continue;
+        }
+
+        Now = GetTimeNs();
+
+        if (Now - ReclaimNs >= DAEMON_RECLAIM_PERIOD_NS)
+        {
+            ReclaimSlots(pDaemon);
+            ReclaimNs = Now;
+        }
+
+        if (Now - IdleSinceNs < pDaemon->SpinNs)
+        {
+            CpuRelax();
+            continue;
+        }
+
+        // A submission after the Doorbell load above either changed Doorbell, so the wait returns
+        // at once, or saw IsDaemonSleeping and wakes it
+        atomic_store(&pShared->IsDaemonSleeping, 1);
+
+        if (Doorbell == atomic_load(&pShared->Doorbell))
+        {
+            FutexWait(&pShared->Doorbell, Doorbell, DAEMON_RECLAIM_PERIOD_NS);
+            pDaemon->Stats.Sleeps++;
+        }
+
+        atomic_store(&pShared->IsDaemonSleeping, 0);
+        IdleSinceNs = GetTimeNs();
+    }
+}
+
+void DisplayGheDaemonStop(GlobalHist_DAEMON *pDaemon)
+{
+    atomic_store(&pDaemon->pShared->IsShutdown, 1);
+    atomic_fetch_add(&pDaemon->pShared->Doorbell, 1);
+    FutexWake(&pDaemon->pShared->Doorbell);
+}
+
+void DisplayGheDaemonGetStats(GlobalHist_DAEMON *pDaemon, GlobalHist_DAEMON_STATS *pStats)
+{
+    *pStats = pDaemon->Stats;
+    pStats->Clients = 0;
+
+    for (uint32_t Index = 0; Index < GlobalHist_DAEMON_MAX_CLIENTS; Index++)
+    {
+        pStats->Clients += (DAEMON_SLOT_ACTIVE == atomic_load(&pDaemon->pShared->Slot[Index].State));
+    }
+}
+
+GlobalHist_DAEMON_CLIENT *DisplayGheDaemonConnect(const char *pName)
+{
+    GlobalHist_DAEMON_CLIENT *pClient;
+    DAEMON_SHARED *pShared;
+    int Fd = shm_open(pName, O_RDWR, 0);
+    struct stat FileStat;
+
+    if (Fd < 0)
+    {
+        return NULL;
+    }
+
+    if ((0 != fstat(Fd, &FileStat)) || ((size_t)FileStat.st_size != sizeof(DAEMON_SHARED)))
+    {
+        close(Fd);
+        return NULL;
+    }
+
+    pShared = (DAEMON_SHARED *)mmap(NULL, sizeof(DAEMON_SHARED), PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+    close(Fd);
+
+    if (MAP_FAILED == pShared)
+    {
+        return NULL;
+    }
+
+    pClient = (GlobalHist_DAEMON_CLIENT *)calloc(1, sizeof(GlobalHist_DAEMON_CLIENT));
+
+    if ((NULL == pClient) || (DAEMON_MAGIC != atomic_load_explicit(&pShared->Magic, memory_order_acquire)) || (DAEMON_VERSION != pShared->Version) ||
+        (sizeof(DAEMON_SHARED) != pShared->Size) || (sizeof(GlobalHist_ARGS) != pShared->ArgsSize))
+    {
+        free(pClient);
+        munmap(pShared, sizeof(DAEMON_SHARED));
+        return NULL;
+    }
+
+    for (uint32_t Index = 0; Index < GlobalHist_DAEMON_MAX_CLIENTS; Index++)
+    {
+        DAEMON_SLOT *pSlot = &pShared->Slot[Index];
+        uint32_t State = DAEMON_SLOT_FREE;
+
+        if (atomic_compare_exchange_strong(&pSlot->State, &State, DAEMON_SLOT_ACTIVE))
+        {
+            // The daemon left Completed equal to Head when it freed the slot
+            atomic_store(&pSlot->Pid, (int32_t)getpid());
+            atomic_store(&pSlot->IsClientWaiting, 0);
+
+            pClient->pShared  = pShared;
+            pClient->pSlot    = pSlot;
+            pClient->Head     = atomic_load(&pSlot->Head);
+            pClient->Consumed = pClient->Head;
+            pClient->SpinNs   = GetSpinNs();
+
+            return pClient;
+        }
+    }
+
+    free(pClient);
+    munmap(pShared, sizeof(DAEMON_SHARED));
+    return NULL;
+}
+
+void DisplayGheDaemonDisconnect(GlobalHist_DAEMON_CLIENT *pClient)
+{
+    if (NULL == pClient)
+    {
+        return;
+    }
+
+    // The daemon frees the slot once it is done with any frame still in flight
+    atomic_store(&pClient->pSlot->State, DAEMON_SLOT_CLOSING);
+    RingDoorbell(pClient->pShared);
+
+    munmap(pClient->pShared, sizeof(DAEMON_SHARED));
+    free(pClient);
+}
+
+GlobalHist_ARGS *DisplayGheDaemonBeginSubmit(GlobalHist_DAEMON_CLIENT *pClient)
+{
+    if (pClient->Head - pClient->Consumed >= GlobalHist_DAEMON_RING_SIZE)
+    {
+        return NULL;
+    }
+
+    return &pClient->pSlot->Ring[pClient->Head & DAEMON_RING_MASK].Args;
+}
+
+void DisplayGheDaemonEndSubmit(GlobalHist_DAEMON_CLIENT *pClient)
+{
+    pClient->pSlot->Ring[pClient->Head & DAEMON_RING_MASK].SubmitNs = GetTimeNs();
+    atomic_store_explicit(&pClient->pSlot->Head, ++pClient->Head, memory_order_release);
+    RingDoorbell(pClient->pShared);
+}
+
+const GlobalHist_ARGS *DisplayGheDaemonWaitResult(GlobalHist_DAEMON_CLIENT *pClient, uint64_t TimeoutNs)
+{
+    DAEMON_SLOT *pSlot = pClient->pSlot;
+    uint64_t StartNs, Now;
+    uint32_t Completed;
+
+    if (pClient->Consumed == pClient->Head)
+    {
+        return NULL;
+    }
+
+    StartNs = GetTimeNs();
+    Now     = StartNs;
+
+    for (;;)
+    {
+        Completed = atomic_load_explicit(&pSlot->Completed, memory_order_acquire);
+
+        // Completed passed Consumed, the oldest frame in flight is done
+        if (Completed - pClient->Consumed - 1 < GlobalHist_DAEMON_RING_SIZE)
+        {
+            return &pSlot->Ring[pClient->Consumed & DAEMON_RING_MASK].Args;
+        }
+
+        if ((Now - StartNs >= TimeoutNs) || atomic_load_explicit(&pClient->pShared->IsShutdown, memory_order_acquire))
+        {
+            return NULL;
+        }
+
+        if (Now - StartNs < pClient->SpinNs)
+        {
+            CpuRelax();
+        }
+        else
+        {
+            // Same handshake as the doorbell: the daemon stores Completed before it checks
+            // IsClientWaiting, the client sets it before it checks Completed
+            atomic_store(&pSlot->IsClientWaiting, 1);
+
+            if (Completed == atomic_load(&pSlot->Completed))
+            {
+                FutexWait(&pSlot->Completed, Completed, TimeoutNs - (Now - StartNs));
+            }
+
+            atomic_store(&pSlot->IsClientWaiting, 0);
+        }
+
+        Now = GetTimeNs();
+    }
+}
+
+void DisplayGheDaemonReleaseResult(GlobalHist_DAEMON_CLIENT *pClient)
+{
+    if (pClient->Consumed != pClient->Head)
+    {
+        pClient->Consumed++;
+    }
+}
+
+bool DisplayGheDaemonProcessFrame(GlobalHist_DAEMON_CLIENT *pClient, GlobalHist_ARGS *pGheArgs, uint64_t TimeoutNs)
+{
+    GlobalHist_ARGS *pEntry;
+    const GlobalHist_ARGS *pResult;
+
+    // Frames of an earlier call that timed out come back first, they are dropped
+    while (pClient->Consumed != pClient->Head)
+    {
+        if (NULL == DisplayGheDaemonWaitResult(pClient, TimeoutNs))
+        {
+            return FALSE;
+        }
+
+        DisplayGheDaemonReleaseResult(pClient);
+    }
+
+    pEntry = DisplayGheDaemonBeginSubmit(pClient);
+    *pEntry = *pGheArgs;
+    DisplayGheDaemonEndSubmit(pClient);
+
+    pResult = DisplayGheDaemonWaitResult(pClient, TimeoutNs);
+
+    if (NULL == pResult)
+    {
+        // The entry is still the daemon's, the next call waits for it
+        return FALSE;
+    }
+
+    pGheArgs->IsProgramDiet = pResult->IsProgramDiet;
+    memcpy(pGheArgs->DietFactor, pResult->DietFactor, sizeof(pGheArgs->DietFactor));
+    DisplayGheDaemonReleaseResult(pClient);
+
+    return TRUE;
+}
+
+bool DisplayGheDaemonRead(GlobalHist_DAEMON_CLIENT *pClient, PIPE_ID Pipe, GlobalHist_SERVICE_RESULT *pResult)
+{
+    DAEMON_PIPE *pPipe;
+
+    if ((uint32_t)Pipe >= GlobalHist_MAX_PIPES)
+    {
+        return FALSE;
+    }
+
+    pPipe = &pClient->pShared->Pipe[Pipe];
+
+    for (uint32_t Retry = 1;; Retry++)
+    {
+        DAEMON_RESULT *pSlot = &pPipe->Result[atomic_load_explicit(&pPipe->Latest, memory_order_acquire)];
+        uint32_t Sequence = atomic_load_explicit(&pSlot->Sequence, memory_order_acquire);
+
+        if (0 == (Sequence & 1))
+        {
+            pResult->FrameId     = atomic_load_explicit(&pSlot->FrameId, memory_order_relaxed);
+            pResult->TimestampNs = atomic_load_explicit(&pSlot->TimestampNs, memory_order_relaxed);
+
+            for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+            {
+                pResult->DietFactor[IetIndex] = atomic_load_explicit(&pSlot->DietFactor[IetIndex], memory_order_relaxed);
+            }
+
+            atomic_thread_fence(memory_order_acquire);
+
+            if (Sequence == atomic_load_explicit(&pSlot->Sequence, memory_order_relaxed))
+            {
+                return (0 != pResult->FrameId);
+            }
+        }
+
+        // A running daemon finishes its publish within nanoseconds, one that died in the middle of
+        // it leaves the sequence odd for good
+        if ((0 == Retry % DAEMON_READ_RETRIES) && !IsSharedDaemonAlive(pClient->pShared))
+        {
+            return FALSE;
+        }
+
+        CpuRelax();
+    }
+}
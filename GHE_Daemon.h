@@ -0,0 +1,85 @@
+/**
+ *
+ * @file  GHE_Daemon.h
+ * @brief  Cross process GHE daemon: per pipe contexts shared by every process through one shared memory segment
+ *
+ * The daemon creates the POSIX shared memory object and owns one context per pipe. A client claims
+ * one of GlobalHist_DAEMON_MAX_CLIENTS slots, each holding a ring of GlobalHist_ARGS. The client
+ * fills the histogram straight into its ring entry, the daemon runs the frame through the context
+ * of its pipe and writes the DietFactor back into the same entry. Nothing is serialized and no
+ * socket is involved, wakeups in both directions are futexes on counters in the segment. With more
+ * than one CPU both sides spin for GlobalHist_DAEMON_SPIN_NS before they sleep, so back to back
+ * frames never pay for a wakeup.
+ *
+ * Frames of all clients for a pipe run through the same context, in the order the daemon finds
+ * them. Every finished DietFactor is also published per pipe, monitors that never submit read it
+ * with DisplayGheDaemonRead. Linux only, the wakeups are futexes.
+ *
+ */
+
+#ifndef _DISPLAY_GHEDAEMON_H_
+#define _DISPLAY_GHEDAEMON_H_
+
+#include "DisplayPc.h"
+#include "GHE_Service.h"
+
+#define GlobalHist_DAEMON_DEFAULT_NAME "/dpst-ghe"
+#define GlobalHist_DAEMON_MAX_CLIENTS  16
+#define GlobalHist_DAEMON_RING_SIZE    8       // Frames in flight per client, power of two
+#define GlobalHist_DAEMON_SPIN_NS      50000   // Busy wait before sleeping on the futex, multi CPU hosts only
+
+typedef struct _GlobalHist_DAEMON GlobalHist_DAEMON;
+typedef struct _GlobalHist_DAEMON_CLIENT GlobalHist_DAEMON_CLIENT;
+
+typedef struct _GlobalHist_DAEMON_STATS
+{
+    uint64_t Frames;
+    uint64_t Rejected;      // PipeId outside A..D, completed without running the algorithm
+    uint64_t Sleeps;        // Futex waits of the daemon
+    uint64_t Reclaimed;     // Slots of clients that exited without disconnecting
+    uint32_t Clients;       // Connected right now
+} GlobalHist_DAEMON_STATS;
+
+// Daemon side. Create fails while the daemon that created the segment under pName still runs and
+// replaces a segment left behind by one that died, clients still mapping that one have to connect
+// again. Contexts start with the default GlobalHist_CFG and the sRGB transfer function, configure
+// them through DisplayGheDaemonGetContext before Run.
+GlobalHist_DAEMON *DisplayGheCreateDaemon(const char *pName);
+void DisplayGheDestroyDaemon(GlobalHist_DAEMON *pDaemon);
+GlobalHist_CONTEXT *DisplayGheDaemonGetContext(GlobalHist_DAEMON *pDaemon, PIPE_ID Pipe);
+
+// Serves clients on the calling thread until DisplayGheDaemonStop. Stop only touches the segment,
+// so it is async signal safe and also works on a copy of the daemon in a forked process.
+void DisplayGheDaemonRun(GlobalHist_DAEMON *pDaemon);
+void DisplayGheDaemonStop(GlobalHist_DAEMON *pDaemon);
+void DisplayGheDaemonGetStats(GlobalHist_DAEMON *pDaemon, GlobalHist_DAEMON_STATS *pStats);
+
+// Client side. Connect returns NULL when no daemon segment exists under pName, it was built
+// with a different GlobalHist_ARGS layout or all slots are taken. One thread per client.
+GlobalHist_DAEMON_CLIENT *DisplayGheDaemonConnect(const char *pName);
+void DisplayGheDaemonDisconnect(GlobalHist_DAEMON_CLIENT *pClient);
+
+// Zero copy submission. BeginSubmit returns the next ring entry, in shared memory, or NULL while
+// GlobalHist_DAEMON_RING_SIZE frames are submitted and not released. Fill PipeId, Histogram and
+// the rest of the args there, EndSubmit hands the entry to the daemon. The entry must not be
+// touched again until its result is waited for.
+GlobalHist_ARGS *DisplayGheDaemonBeginSubmit(GlobalHist_DAEMON_CLIENT *pClient);
+void DisplayGheDaemonEndSubmit(GlobalHist_DAEMON_CLIENT *pClient);
+
+// Results come back in submission order, in the entry the frame was submitted in. WaitResult
+// returns it once processed, NULL when nothing is in flight or TimeoutNs passed. The entry stays
+// valid until ReleaseResult.
+const GlobalHist_ARGS *DisplayGheDaemonWaitResult(GlobalHist_DAEMON_CLIENT *pClient, uint64_t TimeoutNs);
+void DisplayGheDaemonReleaseResult(GlobalHist_DAEMON_CLIENT *pClient);
+
+// DisplayGheProcessFrame through the daemon: submits a copy of *pGheArgs, waits and copies the
+// DietFactor and IsProgramDiet back. Returns FALSE on a timeout, the frame may still be processed.
+// Results of frames still in flight, from a call that timed out, are waited for and dropped first.
+bool DisplayGheDaemonProcessFrame(GlobalHist_DAEMON_CLIENT *pClient, GlobalHist_ARGS *pGheArgs, uint64_t TimeoutNs);
+
+// Newest DietFactor the daemon produced for the pipe, from any client. FrameId counts the
+// frames of the pipe. Returns FALSE while nothing was published for the pipe yet, or when the
+// daemon died or stopped with a publish for the pipe unfinished.
+bool DisplayGheDaemonRead(GlobalHist_DAEMON_CLIENT *pClient, PIPE_ID Pipe, GlobalHist_SERVICE_RESULT *pResult);
+
+#endif
@@ -0,0 +1,68 @@
+#include "GHE_Algorithm.h"
+#include "GHE_DeGamma.h"
+#include "GHE_DeGammaTables.h"
+
+// SMPTE ST 2084
+#define PQ_M1 (2610.0 / 16384.0)
+#define PQ_M2 (2523.0 / 4096.0 * 128.0)
+#define PQ_C1 (3424.0 / 4096.0)
+#define PQ_C2 (2413.0 / 4096.0 * 32.0)
+#define PQ_C3 (2392.0 / 4096.0 * 32.0)
+
+// ARIB STD-B67
+#define HLG_A 0.17883277
+#define HLG_B 0.28466892 // 1 - 4 * HLG_A
+#define HLG_C 0.55991073 // 0.5 - HLG_A * ln(4 * HLG_A)
+
+static const char *const TransferFunctionName[GlobalHist_TRANSFER_COUNT] = { "srgb", "gamma22", "pq", "hlg" };
+
+static double GetPQDecodingValue(double Input)
+{
+    double Power = pow(Input, 1.0 / PQ_M2);
+
+    return pow(DD_MAX(Power - PQ_C1, 0.0) / (PQ_C2 - PQ_C3 * Power), 1.0 / PQ_M1);
+}
+
+static double GetHLGDecodingValue(double Input)
+{
+    if (Input <= 0.5)
+    {
+        return Input * Input / 3.0;
+    }
+
+    return (exp((Input - HLG_C) / HLG_A) + HLG_B) / 12.0;
+}
+
+double DisplayGheGetDecodingValue(GlobalHist_TRANSFER_FUNCTION TransferFunction, double Input)
+{
+    switch (TransferFunction)
+    {
+    case GlobalHist_TRANSFER_SRGB:    return GetSRGBDecodingValue(Input);
+    case GlobalHist_TRANSFER_GAMMA22: return pow(Input, 2.2);
+    case GlobalHist_TRANSFER_PQ:      return GetPQDecodingValue(Input);
+    case GlobalHist_TRANSFER_HLG:     return GetHLGDecodingValue(Input);
+    default:                          return 0.0;
+    }
+}
+
+const double *DisplayGheGetDeGammaLUT(GlobalHist_TRANSFER_FUNCTION TransferFunction, uint32_t BinCount)
+{
+    uint32_t SizeIndex = 0;
+
+    if ((uint32_t)TransferFunction >= GlobalHist_TRANSFER_COUNT)
+    {
+        return NULL;
+    }
+
+    while ((SizeIndex < GlobalHist_DEGAMMA_BIN_COUNTS) && (((uint32_t)GlobalHist_DEGAMMA_MIN_BINS << SizeIndex) != BinCount))
+    {
+        SizeIndex++;
+    }
+
+    return (SizeIndex < GlobalHist_DEGAMMA_BIN_COUNTS) ? DeGammaTables[TransferFunction][SizeIndex] : NULL;
+}
+
+const char *DisplayGheGetTransferFunctionName(GlobalHist_TRANSFER_FUNCTION TransferFunction)
+{
+    return ((uint32_t)TransferFunction < GlobalHist_TRANSFER_COUNT) ? TransferFunctionName[TransferFunction] : "unknown";
+}
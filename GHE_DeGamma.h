@@ -0,0 +1,36 @@
+/**
+ *
+ * @file  GHE_DeGamma.h
+ * @brief  Decoding tables of the supported transfer functions, built ahead of time and shared read only
+ *
+ * Entry i of a table for Bins bins is the linear light of the encoded value i / (Bins - 1), for
+ * every GlobalHist_TRANSFER_FUNCTION and the bin counts of GHE_Engine.h. Contexts point at them,
+ * nothing is computed or allocated per context.
+ *
+ * The tables live in GHE_DeGammaTables.h, written by tools/ghe_degamma_gen from
+ * DisplayGheGetDecodingValue. Regenerate it after changing a curve:
+ *
+ *   ghe_degamma_gen > GHE_DeGammaTables.h
+ *
+ * ghe_degamma_gen -c checks the compiled in tables against the curves bit for bit.
+ *
+ */
+
+#ifndef _DISPLAY_GHEDEGAMMA_H_
+#define _DISPLAY_GHEDEGAMMA_H_
+
+#include "DisplayPc.h"
+
+#define GlobalHist_DEGAMMA_MIN_BINS   32  // Tables exist for every power of two bin count in between
+#define GlobalHist_DEGAMMA_MAX_BINS   256
+#define GlobalHist_DEGAMMA_BIN_COUNTS 4
+
+// Decoded linear light of Input in [0, 1], from the formula. For tools, contexts use the tables.
+double DisplayGheGetDecodingValue(GlobalHist_TRANSFER_FUNCTION TransferFunction, double Input);
+
+// NULL for an unknown transfer function or a bin count without a table
+const double *DisplayGheGetDeGammaLUT(GlobalHist_TRANSFER_FUNCTION TransferFunction, uint32_t BinCount);
+
+const char *DisplayGheGetTransferFunctionName(GlobalHist_TRANSFER_FUNCTION TransferFunction);
+
+#endif
@@ -0,0 +1,553 @@
+// Generated by tools/ghe_degamma_gen.c, see GHE_DeGamma.h. Do not edit.
+
+static const double DeGamma_srgb_32[32] =
+{
+    0, 0.0024967542195146308, 0.0053705373494325435, 0.0095294785823544347,
+    0.01513350723396306, 0.022298883005035328, 0.031130089909484151, 0.041722573919128626,
+    0.054164573402652981, 0.068538412909151303, 0.084921456646811805, 0.10338683447877332,
+    0.1240040094060311, 0.14683923082122899, 0.1719559031258607, 0.19941489015347055,
+    0.229274769922375, 0.26159205028716875, 0.29642135334252956, 0.33381557452228633,
+    0.37382602096395201, 0.41650253270397164, 0.461893589520877, 0.51004640567832793,
+    0.56100701438715239, 0.6148203434699, 0.67153028344832866, 0.73117974906585881,
+    0.79381073509042488, 0.85946436710880525, 0.92818094791427697, 1,
+};
+
+static const double DeGamma_srgb_64[64] =
+{
+    0, 0.0012285616000786278, 0.0024571232001572556, 0.0037251284123534434,
+    0.005260758034525294, 0.0071134697343294825, 0.0092996426826649527, 0.011834527866346161,
+    0.014732434535234781, 0.018006871152616219, 0.021670654931460271, 0.025735998901224622,
+    0.030214582429486832, 0.035117609260553989, 0.040455855938811784, 0.046239712692440968,
+    0.052479218312503934, 0.059184090184148871, 0.066363750356205925, 0.074027348338291554,
+    0.082183781168341366, 0.090841711183407683, 0.10000958184251507, 0.10969563188539266,
+    0.11990790806009589, 0.13065427661238635, 0.14194243369771065, 0.15377991485084588,
+    0.16617410362736346, 0.17913223951396434, 0.19266142519066012, 0.20676863321610686,
+    0.22146071219766902, 0.23674439249963117, 0.25262629153609895, 0.2691129186892926,
+    0.28621067988898324, 0.3039258818845646, 0.32226473623761309, 0.3412333630596398,
+    0.36083779451701464, 0.38108397812267941, 0.40197777983219579, 0.42352498695987878,
+    0.44573131092917617, 0.46860238987005981, 0.49214379107496931, 0.51636101332375195,
+    0.54125948908708688, 0.56684458661700921, 0.59312161193239354, 0.62009581070656583,
+    0.64777237006359878, 0.6761564202892999, 0.70525303646239668, 0.73506724001098445,
+    0.76560400019890007, 0.79686823554630815, 0.82886481518847277, 0.86159856017636882,
+    0.8950742447225335, 0.9292965973952958, 0.96427030226429411, 1,
+};
+
+static const double DeGamma_srgb_128[128] =
+{
+    0, 0.00060944394334609101, 0.001218887886692182, 0.001828331830038273,
+    0.002437775773384364, 0.0030472197167304553, 0.0036925455055653832, 0.0044121990449535421,
+    0.0052076448670930744, 0.0060810070098439879, 0.0070343259678435797, 0.0080695669247945207,
+    0.0091886267428342491, 0.010393339954768202, 0.011685483946034487, 0.013066783470704779,
+    0.014538914614515543, 0.016103508294515814, 0.017762153367161575, 0.019516399403039963,
+    0.021367759175792672, 0.023317710904461459, 0.025367700281850872, 0.027519142316190636,
+    0.029773423009086111, 0.032131900889247, 0.034595908418613493, 0.037166753285127321,
+    0.039845719594423477, 0.042634068971067994, 0.045533041578581464, 0.048543857066313562,
+    0.051667715450239009, 0.054905797933893954, 0.058259267674942883, 0.061729270502239322,
+    0.065316935587700048, 0.069023376076843196, 0.072849689681430713, 0.07679695923729718,
+    0.080866253230135784, 0.085058626291733566, 0.089375119668908681, 0.093816761667185139,
+    0.098384568071051434, 0.10307954254248128, 0.10790267699924161, 0.11285495197438164,
+    0.11793733695817445, 0.12315079072367482, 0.12849626163696204, 0.13397468795304579,
+    0.13958699809833827, 0.14533411094052145, 0.15121693604657543, 0.15723637392967552,
+    0.16339331628561155, 0.16968864621933605, 0.17612323846220176, 0.18269795958041135,
+    0.18941366817516353, 0.19627121507494613, 0.20327144352039758, 0.21041518934212772,
+    0.2177032811318643, 0.22513654040726705, 0.23271578177072963, 0.24044181306246745,
+    0.24831543550817431, 0.25633744386150997, 0.26450862654166463, 0.27282976576623597,
+    0.2813016376796334, 0.2899250124772188, 0.29870065452537359, 0.30762932247767844,
+    0.31671176938737622, 0.325948742816279, 0.33534098494027736, 0.34488923265159283,
+    0.3545942176579126, 0.36445666657853715, 0.37447730103766341, 0.38465683775492054,
+    0.39499598863326818, 0.40549546084436372, 0.41615595691149804, 0.42697817479019362,
+    0.43796280794655684, 0.44911054543346834, 0.46042207196469581, 0.47189806798700301,
+    0.48353920975033354, 0.49534616937613651, 0.50731961492390343, 0.51946021045597912,
+    0.53176861610071047, 0.54424548811398676, 0.55689147893923407, 0.56970723726591155,
+    0.58269340808656411, 0.59585063275247885, 0.60917954902799132, 0.62268079114349184,
+    0.6363549898471651, 0.65020277245551394, 0.6642247629027016, 0.67842158178874989,
+    0.69279384642663344, 0.70734217088829987, 0.72206716604965526, 0.73696943963454031,
+    0.75204959625773327, 0.76730823746700849, 0.78274596178427547, 0.79836336474583147,
+    0.81416103894174885, 0.83013957405442784, 0.84629955689633107, 0.86264157144693498,
+    0.87916619888891034, 0.89587401764355779, 0.91276560340552104, 0.92984152917679697,
+    0.94710236530005854, 0.96454867949131673, 0.98218103687193192, 1,
+};
+
+static const double DeGamma_srgb_256[256] =
+{
+    0, 0.00030352698354883752, 0.00060705396709767503, 0.00091058095064651249,
+    0.0012141079341953501, 0.0015176349177441874, 0.001821161901293025, 0.0021246888848418626,
+    0.0024282158683907001, 0.0027317428519395373, 0.0030352698354883748, 0.0033465357638991608,
+    0.0036765073240474359, 0.0040247170184963066, 0.0043914420374102934, 0.0047769534806937292,
+    0.005181516702338386, 0.0056053916242027229, 0.0060488330228570539, 0.0065120907925944752,
+    0.0069954101872653869, 0.0074990320432261753, 0.0080231929853849943, 0.0085681256180693069,
+    0.0091340587022207872, 0.0097212173202378491, 0.010329823029626936, 0.010960094006488246,
+    0.011612245179743885, 0.012286488356915872, 0.012983032342173012, 0.013702083047289686,
+    0.014443843596092545, 0.015208514422912702, 0.015996293365509631, 0.016807375752887384,
+    0.017641954488384078, 0.01850022012837969, 0.019382360956935723, 0.020288563056652401,
+    0.021219010376003555, 0.022173884793387375, 0.02315336617811041, 0.024157632448504756,
+    0.02518685962736163, 0.026241221894849887, 0.027320891639074894, 0.028426039504420793,
+    0.0295568344378088, 0.030713443732993628, 0.031896033073011532, 0.033104766570885055,
+    0.03433980680868217, 0.035601314875020322, 0.036889450401100039, 0.038204371595346502,
+    0.039546235276732837, 0.04091519690685317, 0.042311410620809675, 0.043735029256973465,
+    0.045186204385675541, 0.046665086336880074, 0.048171824226889419, 0.049706565984127232,
+    0.051269458374043238, 0.052860647023180246, 0.054480276442442348, 0.056128490049600091,
+    0.057805430191067229, 0.059511238162981199, 0.061246054231617608, 0.063010017653167674,
+    0.064803266692905773, 0.066625938643772892, 0.068478169844400166, 0.070360095696595876,
+    0.072271850682317479, 0.074213568380149628, 0.076185381481307851, 0.078187421805186327,
+    0.080219820314468324, 0.082282707129814794, 0.084376211544148788, 0.086500462036549763,
+    0.088655586285772942, 0.090841711183407683, 0.093058962846687451, 0.095307466630964705,
+    0.097587347141862457, 0.099898728247113891, 0.10224173308810128, 0.10461648409110419,
+    0.10702310297826761, 0.10946171077829933, 0.1119324278369056, 0.11443537382697373,
+    0.11697066775851084, 0.11953842798834562, 0.12213877222960183, 0.12477181756095049,
+    0.12743768043564743, 0.13013647669036429, 0.13286832155381798, 0.13563332965520566,
+    0.13843161503245183, 0.14126329114027164, 0.14412847085805772, 0.14702726649759498,
+    0.14995978981060856, 0.15292615199615017, 0.1559264637078274, 0.15896083506088041,
+    0.16202937563911099, 0.16513219450166761, 0.16826940018969075, 0.17144110073282259,
+    0.17464740365558504, 0.17788841598362912, 0.18116424424986022, 0.184474994500441,
+    0.18782077230067787, 0.19120168274079138, 0.1946178304415758, 0.19806931955994886,
+    0.20155625379439707, 0.20507873639031693, 0.20863687014525575, 0.21223075741405523,
+    0.21586050011389926, 0.21952619972926921, 0.2232279573168085, 0.22696587351009836,
+    0.23074004852434901, 0.23455058216100522, 0.238397573812271, 0.24228112246555486,
+    0.24620132670783548, 0.25015828472995344, 0.25415209433082675, 0.25818285292159582,
+    0.26225065752969623, 0.26635560480286247, 0.27049779101306581, 0.27467731206038465,
+    0.2788942634768104, 0.28314874042999211, 0.28744083772691748, 0.29177064981753587,
+    0.296138270798321, 0.3005437944157765, 0.30498731406988627, 0.30946892281750854,
+    0.31398871337571754, 0.31854677812509186, 0.32314320911295075, 0.32777809805654218,
+    0.33245153634617935, 0.33716361504833037, 0.34191442490866092, 0.3467040563550296,
+    0.35153259950043936, 0.35640014414594351, 0.3613067797835095, 0.36625259559883949,
+    0.37123768047414896, 0.3762621229909065, 0.38132601143253014, 0.38642943378704903,
+    0.39157247774972326, 0.39675523072562685, 0.40197777983219579, 0.4072402119017367,
+    0.41254261348390375, 0.41788507084813747, 0.42326766998607168, 0.42869049661390662,
+    0.43415363617474895, 0.43965717384091879, 0.44520119451622786, 0.45078578283822346,
+    0.4564110231804045, 0.46207699965440707, 0.46778379611215898, 0.47353149614800955,
+    0.4793201831008268, 0.48514994005607037, 0.49102084984783562, 0.49693299506087041,
+    0.50288645803256871, 0.50888132085493376, 0.51491766537652139, 0.5209955732043543,
+    0.52711512570581309, 0.53327640401050524, 0.53947948901210718, 0.5457244613701866,
+    0.55201140151200001, 0.55834038963426791, 0.56471150570492923, 0.57112482946487308,
+    0.57758044042965062, 0.5840784178911641, 0.59061884091933692, 0.59720178836376336,
+    0.60382733885533779, 0.61049557080786476, 0.61720656241965111, 0.62396039167507611,
+    0.63075713634614683, 0.63759687399403264, 0.64447968197058214, 0.65140563741982416,
+    0.65837481727944824, 0.66538729828227205, 0.67244315695768753, 0.67954246963309384,
+    0.6866853124353135, 0.69387176129198991, 0.70110189193297312, 0.70837577989168676,
+    0.71569350050648073, 0.72305512892196933, 0.73046074009035367, 0.73791040877273084,
+    0.74540420954038744, 0.75294221677607787, 0.76052450467529242, 0.76815114724750699,
+    0.77582221831742337, 0.78353779152619352, 0.79129794033263023, 0.79910273801440901,
+    0.8069522576692516, 0.81484657221610124, 0.82278575439628354, 0.83076987677465464,
+    0.83879901174074001, 0.84687323150985805, 0.85499260812423383, 0.86315721345410235,
+    0.87136711919879717, 0.87962239688783173, 0.88792311788196632, 0.89626935337426639,
+    0.90466117439114901, 0.9130986517934192, 0.92158185627729461, 0.93011085837542373,
+    0.938685728457888, 0.94730653673319987, 0.95597335324928612, 0.96468624789446511,
+    0.97344529039841254, 0.98225055033311715, 0.99110209711382979, 1,
+};
+
+static const double DeGamma_gamma22_32[32] =
+{
+    0, 0.00052360558896827629, 0.0024058595148604509, 0.0058704451410004866,
+    0.01105442746829666, 0.018060854050160002, 0.026973482706270386, 0.037863430697554254,
+    0.050792810593065653, 0.065816956273138952, 0.082985893349041343, 0.10234536540666299,
+    0.12393758085293508, 0.14780177464763283, 0.17397464222729928, 0.20249068217548094,
+    0.233382471895722, 0.26668089292310704, 0.30241531760746604, 0.34061376564501394,
+    0.38130303671201277, 0.4245088238993816, 0.47025581153681695, 0.51856776018696971,
+    0.5694675809923142, 0.62297740110819189, 0.67911862161351333, 0.73791196902693756,
+    0.79937754135078565, 0.86353484940301606, 0.93040285406880974, 1,
+};
+
+static const double DeGamma_gamma22_64[64] =
+{
+    0, 0.00011001471833674479, 0.00050549490391552359, 0.0012334386460065264,
+    0.0023226446583485853, 0.0037947642521626961, 0.0056673957746298693, 0.0079554816663858514,
+    0.010672072393150682, 0.013828794151030216, 0.017436157816243372, 0.021503774569082052,
+    0.026040512813737912, 0.031054616203715735, 0.036553794813545995, 0.042545297137194106,
+    0.049035968009685842, 0.056032295947293205, 0.063540452371524128, 0.071566324497969694,
+    0.080115543203949841, 0.089193506862247821, 0.098805401894926523, 0.10895622063144667,
+    0.11965077692967982, 0.13089371992403895, 0.14268954619309016, 0.15504261058361202,
+    0.16795713588487776, 0.18143722151291247, 0.19548685133741978, 0.21010990076236608,
+    0.22531014315365347, 0.24109125569300566, 0.25745682472545095, 0.27441035065808644,
+    0.2919552524597489, 0.31009487180447981, 0.32883247689600725, 0.34817126600568682,
+    0.36811437075228431, 0.38866485914851889, 0.40982573843632336, 0.43159995773023008,
+    0.45399041048609218, 0.47699993681044378, 0.50063132562414725, 0.52488731669253119,
+    0.54977060253296162, 0.57528383020967755, 0.6014296030247448, 0.62821048211312702,
+    0.65562898794910451, 0.68368760177059984, 0.71238876692736408, 0.74173489015844685,
+    0.77172834280389035, 0.80237146195516329, 0.83366655154846092, 0.86561588340465601,
+    0.89822169821937614, 0.93148620650639546, 0.9654115894972809, 1,
+};
+
+static const double DeGamma_gamma22_128[128] =
+{
+    0, 2.3530535666926072e-05, 0.00010811795045118818, 0.00026381444675414639,
+    0.00049677964731572319, 0.00081164445024322403, 0.0012121728840437636, 0.0017015609177444509,
+    0.0022825998546703143, 0.0029577763677527164, 0.0037293385793474576, 0.0045993421800392068,
+    0.0055696839914923324, 0.0066421272103568156, 0.0078183209085611848, 0.0090998154327169047,
+    0.010488074792705046, 0.011984486787048131, 0.013590371392346605, 0.015306987797721147,
+    0.017135540365293619, 0.01907718372787353, 0.021133027185118058, 0.023304138523121746,
+    0.02559154735552225, 0.027996248064023937, 0.030519202400871682, 0.03316134180395848,
+    0.035923569466012634, 0.038806762192033051, 0.041811772073354167, 0.044939428002079097,
+    0.04819053704586463, 0.05156588569998171, 0.055066241031063563, 0.058692351724879653,
+    0.06244494904874924, 0.06632474773776785, 0.070332446812807883, 0.074468730337232336,
+    0.078734268118392292, 0.083129716359237715, 0.087655718264738128, 0.092312904607264226,
+    0.097101894254610951, 0.10202329466393595, 0.10707770234453194, 0.11226570329204347,
+    0.11758787339646853, 0.12304477882604736, 0.1286369763889329, 0.13436501387435304,
+    0.14022943037481148, 0.14623075659073001, 0.15236951511880609, 0.15864622072524456,
+    0.16506138060492173, 0.1716154946274458, 0.17830905557099799, 0.18514254934476304,
+    0.19211645520069162, 0.19923124593527861, 0.20648738808198383, 0.21388534209487586,
+    0.22142556252403353, 0.22910849818319837, 0.23693459231013653, 0.24490428272013295,
+    0.25301800195301183, 0.26127617741404768, 0.26967923150910661, 0.27822758177433499,
+    0.28692164100068773, 0.29576181735357315, 0.30474851448786905, 0.31388213165855089,
+    0.32316306382715554, 0.33259170176429054, 0.34216843214838638, 0.3518936376608755,
+    0.36176769707797096, 0.37179098535920879, 0.38196387373290597, 0.39228672977867801,
+    0.40275991750715301, 0.41338379743700826, 0.42415872666945054, 0.43508505896025551,
+    0.44616314478947061, 0.45739333142888533, 0.46877596300736407, 0.48031138057413264,
+    0.49199992216010408, 0.5038419228373251, 0.51583771477662221, 0.52798762730351867,
+    0.54029198695249214, 0.55275111751964068, 0.56536534011381856, 0.57813497320630136,
+    0.59106033267903868, 0.60414173187154674, 0.61737948162649259, 0.63077389033402131,
+    0.64432526397486878, 0.65803390616230883, 0.67190011818297368, 0.68592419903659074,
+    0.70010644547467371, 0.71444715203820397, 0.72894661109433989, 0.74360511287218556,
+    0.75842294549765243, 0.77340039502744462, 0.78853774548219802, 0.80383527887880057,
+    0.81929327526192131, 0.83491201273477544, 0.85069176748914688, 0.86663281383469815,
+    0.88273542422758433, 0.8989998692983967, 0.91542641787945711, 0.93201533703148198,
+    0.94876689206963682, 0.96568134658899896, 0.98275896248944805, 1,
+};
+
+static const double DeGamma_gamma22_256[256] =
+{
+    0, 5.0770519006617594e-06, 2.3328004666098932e-05, 5.69217657121931e-05,
+    0.00010718736234124402, 0.00017512397750302669, 0.00026154375454849144, 0.0003671362698159426,
+    0.00049250378719143263, 0.00063818284216702193, 0.00080465849951305828, 0.00099237430407432526,
+    0.0012017395224384016, 0.001433134589671864, 0.0016869153167892836, 0.0019634162133964697,
+    0.0022629531607064341, 0.0025858255962341679, 0.0029323183239383624, 0.0033027030320036382,
+    0.0036972395789001307, 0.0041161770932827534, 0.00455975492252602, 0.0050282034568555354,
+    0.0055217448502396585, 0.0060405936548498127, 0.0065849573825816849, 0.0071550370045730324,
+    0.0077510273976606099, 0.0083731177451485811, 0.0090214918980121312, 0.0096963287016582286,
+    0.010397802292555288, 0.01112608236838324, 0.011881334434813665, 0.012663720031582098,
+    0.013473396940142641, 0.014310519374884059, 0.015175238159625197, 0.016067700890886875,
+    0.016988052089250045, 0.017936433339950226, 0.018912983423721504, 0.01991783843878572,
+    0.020951131914781092, 0.022012994919336532, 0.023103556157921437, 0.024222942067534239,
+    0.025371276904734584, 0.026548682828472905, 0.027755279978126032, 0.028991186547107816,
+    0.030256518852388652, 0.03155139140022644, 0.032875916948383828, 0.034230206565081953,
+    0.035614369684918767, 0.037028514161960194, 0.038472746320194637, 0.039947171001525582,
+    0.041451891611462462, 0.042987010162657102, 0.04455262731642138, 0.046148842422350948,
+    0.047775753556170641, 0.049433457555907959, 0.051122050056493375, 0.052841625522879028,
+    0.054592277281760339, 0.056374097551979752, 0.058187177473685438, 0.060031607136313232,
+    0.061907475605455758, 0.063814870948677244, 0.065753880260330064, 0.067724589685424316,
+    0.0697270844425988, 0.071761448846239084, 0.073827766327784608, 0.07592611945626479,
+    0.078056589958101885, 0.080219258736215049, 0.082414205888459199, 0.084641510725429456,
+    0.086901251787660339, 0.089193506862247821, 0.091518352998919486, 0.093875866525577764,
+    0.09626612306333969, 0.098689197541094453, 0.10114516420959986, 0.10363409665513738,
+    0.10615606781274391, 0.10871114997903854, 0.11129941482466024, 0.11392093340633272,
+    0.11657577617857154, 0.11926401300504741, 0.12198571316961944, 0.1247409453870513,
+    0.12752977781342206, 0.13035227805624436, 0.13320851318429969, 0.13609854973720245,
+    0.13902245373470251, 0.14198029068573553, 0.14497212559723086, 0.14799802298268516,
+    0.15105804687051058, 0.15415226081216518, 0.15728072789007341, 0.16044351072534352,
+    0.16364067148528988, 0.16687227189076551, 0.17013837322331238, 0.173439036332135,
+    0.17677432164090326, 0.18014428915439032, 0.18354899846495082, 0.18698850875884424,
+    0.19046287882240931, 0.19397216704809314, 0.19751643144034017, 0.20109572962134564,
+    0.20471011883667684, 0.20835965596076741, 0.21204439750228771, 0.215764399609395,
+    0.21951971807486789, 0.22331040834112742, 0.2271365255051489, 0.23099812432326744,
+    0.23489525921588011, 0.23882798427204829, 0.24279635325400195, 0.24680041960155044,
+    0.25084023643640047, 0.2549158565663851, 0.25902733248960613, 0.2631747163984916,
+    0.26735806018377201, 0.2715774154383751, 0.27583283346124515, 0.28012436526108492,
+    0.28445206156002445, 0.2888159727972186, 0.29321614913237454, 0.29765264044921119,
+    0.30212549635885272, 0.3066347662031576, 0.31118049905798434, 0.31576274373639712,
+    0.32038154879181041, 0.32503696252107628, 0.32972903296751488, 0.33445780792388924,
+    0.33922333493532669, 0.34402566130218676, 0.34886483408287899, 0.35374090009662945,
+    0.35865390592619889, 0.36360389792055325, 0.36859092219748707, 0.37361502464620194,
+    0.3786762509298402, 0.38377464648797521, 0.38891025653905886, 0.39408312608282897,
+    0.39929329990267437, 0.40454082256796181, 0.40982573843632336, 0.41514809165590655,
+    0.42050792616758714, 0.42590528570714575, 0.43134021380740961, 0.43681275380035939,
+    0.44232294881920181, 0.44787084180040992, 0.45345647548573059, 0.45907989242416009,
+    0.46474113497388941, 0.47044024530421841, 0.47617726539744021, 0.48195223705069778,
+    0.48776520187781053, 0.49361620131107364, 0.49950527660303012, 0.50543246882821602,
+    0.51139781888487945, 0.51740136749667331, 0.52344315521432472, 0.52952322241727723,
+    0.5356416093153108, 0.54179835595013692, 0.54799350219697185, 0.5542270877660852,
+    0.56049915220432811, 0.56680973489663822, 0.57315887506752328, 0.5795466117825252,
+    0.58597298394966135, 0.59243803032084663, 0.59894178949329602, 0.60548429991090724,
+    0.6120655998656237, 0.61868572749877959, 0.62534472080242653, 0.6320426176206414,
+    0.63877945565081684, 0.64555527244493449, 0.65237010541082108, 0.65922399181338731,
+    0.66611696877585058, 0.67304907328094188, 0.68002034217209539, 0.68703081215462491,
+    0.69408051979688223, 0.70116950153140212, 0.70829779365603229, 0.71546543233504833,
+    0.72267245360025456, 0.7299188933520705, 0.73720478736060513, 0.74453017126671495,
+    0.75189508058305088, 0.75929955069509114, 0.7667436168621613, 0.7742273142184416,
+    0.78175067777396212, 0.78931374241558583, 0.79691654290797809, 0.80455911389456691,
+    0.81224148989848954, 0.81996370532352791, 0.82772579445503369, 0.83552779146084089,
+    0.84336973039216934, 0.8512516451845149, 0.85917356965853231, 0.86713553752090478,
+    0.87513758236520489, 0.88317973767274527, 0.89126203681341876, 0.89938451304652944,
+    0.90754719952161378, 0.9157501292792527, 0.92399333525187322, 0.93227685026454277,
+    0.94060070703575305, 0.94896493817819516, 0.95736957619952678, 0.96581465350313012,
+    0.97430020238886128, 0.98282625505379129, 0.99139284359293989, 1,
+};
+
+static const double DeGamma_pq_32[32] =
+{
+    0, 2.3018510564466225e-06, 1.0850082825761409e-05, 2.9785043361214596e-05,
+    6.4914312071005751e-05, 0.00012422808100333803, 0.00021862102796984829, 0.00036284264542749194,
+    0.00057674848784250346, 0.00088694991572716049, 0.0013289926076334819, 0.0019502383342098377,
+    0.0028136846222831858, 0.0040030390269472542, 0.0056294772717970024, 0.0078406695223240362,
+    0.010832873598063198, 0.014867192417904051, 0.020291510536212264, 0.027570212139684181,
+    0.037324614529845243, 0.050388235900596462, 0.067882715449267231, 0.091322658211821561,
+    0.12276124859175398, 0.16499371496351178, 0.22184347493883869, 0.29856734937590179,
+    0.40243363875007659, 0.54355332474081397, 0.73608533415706279, 1,
+};
+
+static const double DeGamma_pq_64[64] =
+{
+    0, 5.5206098434052567e-07, 2.2255014705765971e-06, 5.3740646745377756e-06,
+    1.0444881050997789e-05, 1.7968468101206449e-05, 2.8569597892242609e-05, 4.2981458535710765e-05,
+    6.2062170439349405e-05, 8.6813745194280127e-05, 0.0001184037856502249, 0.00015819031500763519,
+    0.00020775019200064331, 0.00026891164048889373, 0.00034379150175584952, 0.0004348379097679496,
+    0.00054487919608836718, 0.00067717995461123509, 0.00083550533966372635, 0.0010241948376599709,
+    0.0012482469463183231, 0.0015134164211075718, 0.0018263260115500949, 0.0021945949167521089,
+    0.0026269865477302904, 0.0031335786028346018, 0.0037259589526360245, 0.0044174514048477987,
+    0.0052233760934569428, 0.0061613500274306692, 0.00725163426480921, 0.0085175352736851367,
+    0.009985869333473377, 0.011687500355327536, 0.013657963304147586, 0.015938187540270588,
+    0.018575336931372841, 0.021623786592631172, 0.025146259690441618, 0.029215152006583305,
+    0.033914077044923684, 0.039339670540676233, 0.045603700509291405, 0.05283553769988876,
+    0.061185051805007822, 0.070826011402021827, 0.081960080826030596, 0.09482152557071323,
+    0.10968276008888864, 0.12686089888959184, 0.14672550468760184, 0.16970776739837551,
+    0.19631139666430883, 0.22712557044224743, 0.26284035560155916, 0.30426510677730595,
+    0.35235046104464524, 0.40821468358425811, 0.47317529003862641, 0.54878708318088731,
+    0.63688800560436576, 0.73965454018906729, 0.85966880381881661, 1,
+};
+
+static const double DeGamma_pq_128[128] =
+{
+    0, 1.4922258252943239e-07, 5.4371021837114875e-07, 1.209742706956773e-06,
+    2.1887844115911401e-06, 3.5280217985408132e-06, 5.2794365295384178e-06, 7.4997768142525223e-06,
+    1.0250772373558044e-05, 1.3599447505605356e-05, 1.7618488694283733e-05, 2.2386651870456644e-05,
+    2.7989204308246413e-05, 3.4518400066973036e-05, 4.207398965490903e-05, 5.0763765487356636e-05,
+    6.0704145233569705e-05, 7.2020795501666769e-05, 8.4849298590194806e-05, 9.9335865284046071e-05,
+    0.00011563809691277934, 0.00013392580013357595, 0.00015438185815567425, 0.00017720316239258247,
+    0.00020260160881591734, 0.00023080516359298719, 0.00026205900292078111, 0.00029662673232490572,
+    0.00033479169107448689, 0.00037685834777592588, 0.00042315379365164685, 0.00047402934048740514,
+    0.00052986223074569846, 0.00059105746789718365, 0.00065804977561762759, 0.00073130569514269538,
+    0.00081132583076369948, 0.00089864725419763519, 0.0009938460793673656, 0.0010975402200000632,
+    0.0012103923433871419, 0.0013331130346635259, 0.001466464187052538, 0.0016112626347071016,
+    0.0017683840460459787, 0.0019387670968642112, 0.0021234179439807333, 0.0023234150217935233,
+    0.0025399141858506689, 0.0027741542294238562, 0.0030274628011014971, 0.0033012627536211162,
+    0.0035970789565381196, 0.0039165456079065649, 0.0042614140829369679, 0.0046335613606245472,
+    0.0050349990726137883, 0.0054678832221195846, 0.005934524624578272, 0.0064374001258862504,
+    0.0069791646586028037, 0.0075626642014401252, 0.0081909497126884702, 0.0088672921140396047,
+    0.0095951984075843856, 0.010378429015606457, 0.01122101644026777, 0.012127285348372006,
+    0.013101874195242894, 0.014149758511336158, 0.015276275985688759, 0.016487153491700515,
+    0.017788536213136467, 0.019187019041846772, 0.020689680433372087, 0.022304118922815482,
+    0.024038492520872316, 0.025901561229148322, 0.027902732934865622, 0.030052112967995141,
+    0.032360557628877518, 0.034839732021855016, 0.037502172560403293, 0.040361354542106966,
+    0.043431765227745632, 0.04672898289823843, 0.050269762406305415, 0.054072127787118646,
+    0.058155472544190026, 0.062540668283796105, 0.067250182433854264, 0.072308205852102944,
+    0.077740791203991813, 0.083576003074129518, 0.089844080866459466, 0.096577615649458895,
+    0.10381174221365605, 0.1115843477310005, 0.11993629854102894, 0.12891168673742506,
+    0.13855809839302269, 0.14892690544318801, 0.16007358344800524, 0.1720580576756045,
+    0.18494508019499623, 0.19880464093789094, 0.21371241599102667, 0.22975025671373092,
+    0.24700672364564916, 0.26557766958098544, 0.28556687664111541, 0.30708675268497326,
+    0.33025909295994499, 0.35521591352297122, 0.38210036366073852, 0.41106772531412972,
+    0.44228650838144612, 0.47593965173991643, 0.51222584090821677, 0.55136095447690503,
+    0.59357965278467595, 0.63913712382778831, 0.6883110030795716, 0.74140348579356685,
+    0.79874365248531232, 0.86069003067424232, 0.92763341864569271, 1,
+};
+
+static const double DeGamma_pq_256[256] =
+{
+    0, 4.3372525484373671e-08, 1.4816417475849167e-07, 3.1250270702287523e-07,
+    5.3960915089249324e-07, 8.3385145984224506e-07, 1.2001750312611283e-06, 1.6439247816794412e-06,
+    2.1707758169437878e-06, 2.7867045793143226e-06, 3.4979779470651215e-06, 4.3111513208908719e-06,
+    5.2330716545707331e-06, 6.2708834356800071e-06, 7.4320365641138626e-06, 8.7242955441490833e-06,
+    1.015574965303632e-05, 1.1734823886550898e-05, 1.3470290561636746e-05, 1.5371281504229651e-05,
+    1.7447300780124434e-05, 1.9708237945817738e-05, 2.2164381808773437e-05, 2.4826434695013338e-05,
+    2.7705527227819989e-05, 3.0813233625494321e-05, 3.4161587529225907e-05, 3.7763098374443205e-05,
+    4.1630768320881688e-05, 4.5778109758120108e-05, 5.0219163404581602e-05, 5.4968517019183792e-05,
+    6.0041324745819059e-05, 6.545332711179197e-05, 7.12208717023221e-05, 7.7360934534084698e-05,
+    8.3891142151661007e-05, 9.0829794471698356e-05, 9.8195888400492729e-05, 0.00010600914225160346,
+    0.00011429002099110357, 0.00012305976233908166, 0.00013234040375689339, 0.00014215481035090839,
+    0.00015252670372437245, 0.00016348069181026497, 0.00017504229971914862, 0.00018723800163716664,
+    0.000200095253810629, 0.00021364252865493908, 0.00022790935002690201, 0.00024292632970075468,
+    0.00025872520509003226, 0.00027533887825834552, 0.00029280145626419893, 0.00031114829288628448,
+    0.00033041603177739142, 0.00035064265109691848, 0.00037186750967358584, 0.00039413139475206473,
+    0.00041747657137870565, 0.0004419468334841912, 0.00046758755672246787, 0.00049444575312761554,
+    0.00052257012765277581, 0.00055201113665730107, 0.00058282104841079975, 0.00061505400568527058,
+    0.00064876609050906428, 0.00068401539115924871, 0.00072086207147140969, 0.00075936844254933784,
+    0.00079959903695950958, 0.00084162068549897546, 0.0008855025966279618, 0.00093131643866190277,
+    0.00097913642482246629, 0.0010290394012477983, 0.001081104938069864, 0.0011354154236670067,
+    0.0011920561622068028, 0.0012511154745965291, 0.0013126848029645349, 0.001376858818798466,
+    0.0014437355348737473, 0.0015134164211075718, 0.0015860065244815307, 0.001661614593179472,
+    0.0017403532050935156, 0.0018223389008572997, 0.0019076923215701628, 0.0019965383513837541,
+    0.0020890062651281213, 0.0021852298811617676, 0.0022853477196352716, 0.0023895031663685312,
+    0.0024978446425471153, 0.0026105257804496618, 0.0027277056054314584, 0.0028495487243910753,
+    0.0029762255209632498, 0.0031079123576826526, 0.0032447917853800383, 0.0033870527600760735,
+    0.003534890867653667, 0.0036885085565966434, 0.0038481153790962323, 0.0040139282408362606,
+    0.0041861716597838203, 0.0043650780343188304, 0.0045508879210585124, 0.0047438503227340365,
+    0.0049442229865029044, 0.0051522727130878885, 0.0053682756771528629, 0.0055925177593388791,
+    0.0058252948904023907, 0.006066913407917705, 0.0063176904260159039, 0.006577954218663422,
+    0.0068480446169908605, 0.0071283134212118369, 0.0074191248276925126, 0.0077208558717475929,
+    0.0080338968867709921, 0.0083586519803314739, 0.0086955395278815722, 0.0090449926847650658,
+    0.0094074599172327186, 0.0097834055531979981, 0.010173310353502621, 0.010577672104491308,
+    0.01099700623272782, 0.011431846442709927, 0.011882745378493759, 0.012350275310160176,
+    0.012835028846099642, 0.01333761967212937, 0.013858683318510609, 0.014398877955958182,
+    0.014958885221798736, 0.01553941107746935, 0.016141186698603337, 0.016764969399004778,
+    0.017411543589863847, 0.018081721775620067, 0.01877634558794886, 0.019496286859388114,
+    0.020242448738225921, 0.021015766846291188, 0.021817210481388512, 0.022647783866191051,
+    0.023508527445472025, 0.024400519233637025, 0.02532487621463066, 0.02628275579631165,
+    0.027275357321580256, 0.02830392363855104, 0.029369742732208354, 0.030474149420078294,
+    0.031618527114565996, 0.032804309654708617, 0.034032983210237754, 0.035306088260932469,
+    0.036625221654438753, 0.037992038745782081, 0.039408255622049845, 0.040875651415764165,
+    0.042396070710725028, 0.043971426044155784, 0.045603700509291405, 0.047294950462628313,
+    0.049047308340246482, 0.050862985587906362, 0.052744275709741308, 0.054693557440601948,
+    0.056713298047356031, 0.058806056764729137, 0.060974488371370227, 0.063221346912342338,
+    0.065549489574232331, 0.067961880719584353, 0.070461596087537173, 0.07305182716796671,
+    0.075735885756624904, 0.078517208699281582, 0.081399362833128819, 0.084386050134174134,
+    0.08748111307956638, 0.090688540234645801, 0.094012472074327835, 0.09745720704957872,
+    0.10102720790965436, 0.10472710829169933, 0.10856171958955996, 0.11253603811443755,
+    0.11665525256060427, 0.12092475178968642, 0.12535013294824321, 0.12993720993364694,
+    0.13469202222405111, 0.13962084408923259, 0.14473019419955643, 0.15002684565153082,
+    0.15551783642892847, 0.1612104803196294, 0.16711237830961423, 0.17323143047547121,
+    0.17957584839949051, 0.18615416813118929, 0.19297526372087387, 0.20004836135241874,
+    0.20738305410300739, 0.21498931735978705, 0.22287752492433635, 0.23105846583763398,
+    0.23954336195988057, 0.24834388634100696, 0.25747218242023934, 0.26694088409367489,
+    0.27676313669258512, 0.28695261891594748, 0.29752356576315625, 0.30849079251650363,
+    0.31986971982328255, 0.33167639993251502, 0.34392754414201854, 0.35664055151561475,
+    0.36983353893351678, 0.38352537254123148, 0.39773570066690322, 0.41248498827990465,
+    0.42779455306786712, 0.44368660321284303, 0.46018427695300751, 0.47731168401835727,
+    0.49509394903669957, 0.51355725700888488, 0.53272890095946446, 0.55263733187283925,
+    0.57331221103310748, 0.59478446489021386, 0.61708634258359374, 0.64025147626000189,
+    0.66431494433073301, 0.68931333782239801, 0.71528482998090548, 0.74226924930133586,
+    0.77030815616236725, 0.79944492325667471, 0.82972482001749492, 0.8611951012544502,
+    0.89390510022240011, 0.92790632636189629, 0.9632525679602747, 1,
+};
+
+static const double DeGamma_hlg_32[32] =
+{
+    0, 0.00034686090877558093, 0.0013874436351023237, 0.0031217481789802288,
+    0.0055497745404092949, 0.0086715227193895246, 0.012486992715920915, 0.016996184530003466,
+    0.02219909816163718, 0.028095733610822054, 0.034686090877558098, 0.041970169961845306,
+    0.049947970863683661, 0.058619493583073175, 0.067984738120013863, 0.078043704474505732,
+    0.088959581251036035, 0.10185526046613662, 0.11730007753056011, 0.13579793019691525,
+    0.15795232359885161, 0.18448606002007895, 0.21626482081474965, 0.25432540985553664,
+    0.2999095799712766, 0.35450454598491232, 0.4198915061173914, 0.4982037548016125,
+    0.59199628287683848, 0.70432913591767576, 0.83886725032028142, 1.0000000243666087,
+};
+
+static const double DeGamma_hlg_64[64] =
+{
+    0, 8.3984210968337947e-05, 0.00033593684387335179, 0.00075585789871504148,
+    0.0013437473754934072, 0.0020996052742084485, 0.0030234315948601659, 0.0041152263374485592,
+    0.0053749895019736286, 0.0068027210884353739, 0.0083984210968337941, 0.010162089527168891,
+    0.012093726379440664, 0.014193331653649112, 0.016460905349794237, 0.018896447467876037,
+    0.021499958007894514, 0.024271436969849666, 0.027210884353741496, 0.030318300159569999,
+    0.033593684387335176, 0.037037037037037035, 0.040648358108675564, 0.044427647602250771,
+    0.048374905517762655, 0.05249013185521121, 0.056773326614596449, 0.061224489795918359,
+    0.065843621399176946, 0.070630721424372211, 0.075585789871504147, 0.080708826740572767,
+    0.086038416974646828, 0.091822416977654253, 0.098143271918244637, 0.10505081119196728,
+    0.1125994892215193, 0.12084881473901765, 0.12986381991306775, 0.1397155730189138,
+    0.15048173869321954, 0.16224719019015343, 0.17510467846539604, 0.18915556336268033,
+    0.20451061266705203, 0.2212908753240507, 0.23962863570868853, 0.25966845646704456,
+    0.28156831815154254, 0.30550086463403364, 0.33165476411468836, 0.36023619645598209,
+    0.39147047856692235, 0.42560384065096035, 0.46290536732033621, 0.50366911887930799,
+    0.54821644949904336, 0.59689854055911551, 0.6500991691267729, 0.70823773339882357,
+    0.77177255895669727, 0.84120451189898982, 0.917080947335009, 1.0000000243666087,
+};
+
+static const double DeGamma_hlg_128[128] =
+{
+    0, 2.0666708000082665e-05, 8.2666832000330662e-05, 0.00018600037200074398,
+    0.00033066732800132265, 0.00051666770000206668, 0.00074400148800297591, 0.0010126686920040506,
+    0.0013226693120052906, 0.001674003348006696, 0.0020666708000082667, 0.0025006716680100027,
+    0.0029760059520119037, 0.0034926736520139706, 0.0040506747680162025, 0.0046500093000185995,
+    0.0052906772480211623, 0.0059726786120238894, 0.0066960133920267841, 0.0074606815880298438,
+    0.0082666832000330669, 0.0091140182280364541, 0.010002686672040011, 0.010932688532043731,
+    0.011904023808047615, 0.012916692500051665, 0.013970694608055882, 0.015066030132060267,
+    0.01620269907206481, 0.017380701428069519, 0.018600037200074398, 0.019860706388079446,
+    0.021162708992084649, 0.022506045012090022, 0.023890714448095558, 0.025316717300101269,
+    0.026784053568107136, 0.028292723252113169, 0.029842726352119375, 0.031434062868125737,
+    0.033066732800132267, 0.034740736148138961, 0.036456072912145816, 0.038212743092152855,
+    0.040010746688160043, 0.041850083700167399, 0.043730754128174926, 0.045652757972182607,
+    0.047616095232190458, 0.049620765908198479, 0.051666770000206662, 0.053754107508215021,
+    0.055882778432223529, 0.058052782772232199, 0.060264120528241066, 0.062516791700250068,
+    0.06481079628825924, 0.067146134292268581, 0.069522805712278077, 0.071940810548287756,
+    0.074400148800297591, 0.076900820468307596, 0.079442825552317783, 0.082026164052328113,
+    0.084660221277817749, 0.087403261091472881, 0.090269775432051766, 0.093265322351873972,
+    0.09639571009207426, 0.099667008344540939, 0.10308556002079639, 0.10665799355063953,
+    0.11039123573439576, 0.11429252517369541, 0.11836942630682179, 0.12262984407584303,
+    0.12708203925396669, 0.13173464446283592, 0.13659668091082469, 0.14167757588478633,
+    0.14698718102917133, 0.15253579144795706, 0.15833416566642711, 0.16439354649150503,
+    0.17072568281109046, 0.17734285237466516, 0.18425788559933906, 0.19148419044749734,
+    0.19903577842428222, 0.20692729174532018, 0.21517403172737012, 0.2237919884569414,
+    0.23279787179440825, 0.2422091437737344, 0.25204405246063338, 0.26232166733480972,
+    0.27306191626488857, 0.2842856241477259, 0.29601455328701937, 0.30827144558951108,
+    0.32108006666060168, 0.33446525188487225, 0.34845295458086362, 0.36307029632348481,
+    0.37834561953162033, 0.39430854242290397, 0.41099001644221334, 0.42842238627523699,
+    0.44663945256347715, 0.46567653744228998, 0.48557055302904123, 0.50636007299416852,
+    0.52808540735392728, 0.55078868062983932, 0.5745139135263917, 0.5993071082853545,
+    0.62521633788221942, 0.65229183923770284, 0.68058611062504992, 0.71015401346200713,
+    0.74105287868483494, 0.77334261791061254, 0.80708583960337699, 0.84234797046933529,
+    0.87919738231653399, 0.91770552462495258, 0.95794706308408495, 1.0000000243666087,
+};
+
+static const double DeGamma_hlg_256[256] =
+{
+    0, 5.1262334999359212e-06, 2.0504933999743685e-05, 4.6136101499423294e-05,
+    8.201973599897474e-05, 0.00012815583749839805, 0.00018454440599769317, 0.00025118544149686019,
+    0.00032807894399589896, 0.00041522491349480964, 0.00051262334999359219, 0.00062027425349224649,
+    0.0007381776239907727, 0.00086633346148917072, 0.0010047417659874408, 0.0011534025374855825,
+    0.0013123157759835958, 0.0014814814814814814, 0.0016608996539792386, 0.0018505702934768678,
+    0.0020504933999743688, 0.0022606689734717416, 0.0024810970139689859, 0.0027117775214661028,
+    0.0029527104959630908, 0.0032038959374599513, 0.0034653338459566829, 0.0037370242214532869,
+    0.004018967063949763, 0.0043111623734461103, 0.00461361014994233, 0.0049263103934384213,
+    0.0052492631039343833, 0.005582468281430217, 0.0059259259259259256, 0.0062796360374215059,
+    0.0066435986159169543, 0.007017813661412276, 0.007402281173907471, 0.0077970011534025385,
+    0.008201973599897475, 0.0086171985133922831, 0.0090426758938869662, 0.0094784057413815209,
+    0.0099243880558759438, 0.01038062283737024, 0.010847110085864411, 0.011323849801358454,
+    0.011810841983852363, 0.012308086633346147, 0.012815583749839805, 0.013333333333333336,
+    0.013861335383826731, 0.014399589901320002, 0.014948096885813148, 0.015506856337306167,
+    0.016075868255799052, 0.016655132641291807, 0.017244649493784441, 0.017844418813276947,
+    0.01845444059976932, 0.019074714853261562, 0.019705241573753685, 0.020346020761245677,
+    0.020997052415737533, 0.021658336537229265, 0.022329873125720868, 0.023011662181212356,
+    0.023703703703703703, 0.02440599769319492, 0.025118544149686024, 0.025841343073176985,
+    0.026574394463667817, 0.027317698321158528, 0.028071254645649104, 0.028835063437139565,
+    0.029609124695629884, 0.030393438421120078, 0.031188004613610154, 0.031992823273100095,
+    0.0328078943995899, 0.033633217993079577, 0.034468794053569132, 0.035314622581058573,
+    0.036170703575547865, 0.037037037037037035, 0.037913622965526084, 0.038800461361014997,
+    0.039697552223503775, 0.040604895552992439, 0.04152249134948096, 0.042450339612969373,
+    0.043388440343457645, 0.044336793540945781, 0.045295399205433816, 0.046264257336921695,
+    0.047243367935409453, 0.048232731000897089, 0.04923234653338459, 0.050242214532871976,
+    0.05126233499935922, 0.052292707932846343, 0.053333333333333344, 0.054384211200820202,
+    0.055445341535306926, 0.056516724336793535, 0.057598359605280008, 0.058690247340766367,
+    0.059792387543252591, 0.060904780212738686, 0.062027425349224667, 0.063160322952710499,
+    0.064303473023196209, 0.06545687556068179, 0.06662053056516723, 0.067794438036652568,
+    0.068978597975137765, 0.070173010380622833, 0.071377675253107786, 0.072592592592592597,
+    0.07381776239907728, 0.075053184672561821, 0.076298859413046247, 0.077554786620530572,
+    0.078820966295014741, 0.080097398436498782, 0.081384083044982708, 0.082681020120466492,
+    0.083990524197040395, 0.0853267220664609, 0.086692544634945426, 0.088088648708506564,
+    0.089515705655132269, 0.090974401727637891, 0.092465438393675936, 0.093989532673062773,
+    0.095547417482583927, 0.097139841988443984, 0.098767571966530812, 0.100431390170667,
+    0.10213209670902591, 0.10387050942889287, 0.10564746430995746, 0.10746381586632488,
+    0.10932043755744054, 0.11121822220812512, 0.11315808243792229, 0.11514095109996532,
+    0.11716778172957383, 0.11923954900279636, 0.12135724920511903, 0.1235219007105663,
+    0.12573454447142351, 0.12799624451881683, 0.13030808847439213, 0.13267118807333753,
+    0.13508667969900237, 0.13755572492936871, 0.14007951109563913, 0.1426592518532083,
+    0.14529618776529404, 0.14799158689950762, 0.15074674543765074, 0.15356298829903228,
+    0.15644166977760446, 0.15938417419322484, 0.16239191655735738, 0.16546634325353282,
+    0.16860893273289557, 0.171821196225171, 0.17510467846539604, 0.17846095843676169,
+    0.18189165012992536, 0.18539840331915733, 0.18898290435569562, 0.19264687697869007,
+    0.19639208314412546, 0.20022032387212296, 0.20413344011302692, 0.2081333136326935,
+    0.21222186791740702, 0.21640106909885923, 0.22067292689963533, 0.22503949559966419,
+    0.22950287502409331, 0.23406521155306761, 0.23872869915389502, 0.24349558043609631,
+    0.24836814772984664, 0.25334874418832615, 0.2584397649145122, 0.26364365811295226,
+    0.26896292626707308, 0.274400127342592, 0.27995787601760885, 0.28563884493996999,
+    0.29144576601250932, 0.29738143170678449, 0.3034486964059388, 0.30965047777733729,
+    0.31598975817563385, 0.3224695860769462, 0.32909307754482781, 0.33586341772874134,
+    0.34278386239575576, 0.34985773949620019, 0.35708845076403306, 0.36447947335268943,
+    0.37203436150719899, 0.37975674827337508, 0.38765034724489861, 0.39571895434913595,
+    0.40396644967255052, 0.41239679932658485, 0.42101405735491054, 0.42982236768296561,
+    0.4388259661107124, 0.44802918234957795, 0.4574364421045552, 0.46705226920246595,
+    0.4768812877674094, 0.48692822444444145, 0.49719791067255709, 0.50769528500806504,
+    0.51842539549947386, 0.52939340211503205, 0.54060457922408856, 0.55206431813346679,
+    0.56377812968007335, 0.57575164688098701, 0.58799062764230015, 0.60050095752802213,
+    0.61328865259036813, 0.62635986226279849, 0.63972087231720132, 0.65337810788663553,
+    0.66733813655509433, 0.68160767151576651, 0.6961935747993252, 0.71110286057378724,
+    0.72634269851753197, 0.74192041726710656, 0.75784350794146993, 0.77411962774437215,
+    0.79075660364660372, 0.80776243614988175, 0.82514530313418355, 0.84291356379038473,
+    0.86107576264008057, 0.87964063364453515, 0.89861710440472631, 0.91801430045451238,
+    0.93784154964898037, 0.95810838665008646, 0.97882455751175168, 1.0000000243666087,
+};
+
+static const double *const DeGammaTables[GlobalHist_TRANSFER_COUNT][GlobalHist_DEGAMMA_BIN_COUNTS] =
+{
+    { DeGamma_srgb_32, DeGamma_srgb_64, DeGamma_srgb_128, DeGamma_srgb_256 },
+    { DeGamma_gamma22_32, DeGamma_gamma22_64, DeGamma_gamma22_128, DeGamma_gamma22_256 },
+    { DeGamma_pq_32, DeGamma_pq_64, DeGamma_pq_128, DeGamma_pq_256 },
+    { DeGamma_hlg_32, DeGamma_hlg_64, DeGamma_hlg_128, DeGamma_hlg_256 },
+};
@@ -0,0 +1,19 @@
+#include "GHE_Engine.h"
+
+#define GHE_ENGINE_IMPLEMENTATION
+
+#define GHE_ENGINE_BINS 32
+#define GHE_ENGINE_IETS 33
+#include "GHE_EngineTemplate.h"
+
+#define GHE_ENGINE_BINS 64
+#define GHE_ENGINE_IETS 65
+#include "GHE_EngineTemplate.h"
+
+#define GHE_ENGINE_BINS 128
+#define GHE_ENGINE_IETS 129
+#include "GHE_EngineTemplate.h"
+
+#define GHE_ENGINE_BINS 256
+#define GHE_ENGINE_IETS 257
+#include "GHE_EngineTemplate.h"
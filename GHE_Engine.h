@@ -0,0 +1,77 @@
+/**
+ *
+ * @file  GHE_Engine.h
+ * @brief  GHE algorithm specialized at compile time on histogram bin count and IET length
+ *
+ * Every instantiation gets its own context type GlobalHist_ENGINE_<Bins>_<Iets>_CONTEXT and
+ * functions DisplayGheEngine_<Bins>_<Iets>_<Stage>. Loops run over compile-time bounds and are
+ * fully unrolled, so step sizes and interpolation positions fold to constants. The 32/33
+ * instantiation is what DisplayGheAlgorithm runs for GlobalHist_CONTEXT. ComputeLutTarget and
+ * TemporalFilter run the GHE_Cpu.h variant selected at load time, on the 256 bit vectors below.
+ *
+ */
+
+#ifndef _DISPLAY_GHEENGINE_H_
+#define _DISPLAY_GHEENGINE_H_
+
+#include "GHE_Algorithm.h"
+#include "GHE_Cpu.h"
+#include "GHE_DeGamma.h"
+
+#define GHE_ENGINE_NAME_(Prefix, Bins, Iets, Suffix) Prefix##_##Bins##_##Iets##_##Suffix
+#define GHE_ENGINE_NAME(Prefix, Bins, Iets, Suffix) GHE_ENGINE_NAME_(Prefix, Bins, Iets, Suffix)
+#define GHE_PRAGMA(x) _Pragma(#x)
+#define GHE_UNROLL_(n) GHE_PRAGMA(GCC unroll n)
+#define GHE_UNROLL(n) GHE_UNROLL_(n)
+
+// 256 bit vectors for the stage kernels: one register on AVX2 and AVX-512, two SSE2 registers on
+// the baseline. Comparisons give all ones lanes and selects are bitwise, so GHE_MIN / GHE_MAX
+// pick exactly what the scalar DD_MIN / DD_MAX ternaries pick, NaN included.
+typedef double GHE_VECTOR_F64 __attribute__((vector_size(32)));
+typedef int64_t GHE_MASK_F64 __attribute__((vector_size(32)));
+typedef uint32_t GHE_VECTOR_U32X4 __attribute__((vector_size(16)));  // Integer lanes of a GHE_VECTOR_F64
+typedef int32_t GHE_VECTOR_I32X4 __attribute__((vector_size(16)));
+typedef float GHE_VECTOR_F32 __attribute__((vector_size(32)));
+typedef int32_t GHE_MASK_F32 __attribute__((vector_size(32)));
+typedef uint32_t GHE_VECTOR_U32 __attribute__((vector_size(32)));
+typedef float GHE_VECTOR_F32X4 __attribute__((vector_size(16)));
+
+#define GHE_LANES_F64 4
+#define GHE_LANES_F32 8
+
+#define GHE_SELECT(Type, MaskType, Mask, a, b) ((Type)(((Mask) & (MaskType)(a)) | (~(Mask) & (MaskType)(b))))
+#define GHE_MIN_F64(a, b) GHE_SELECT(GHE_VECTOR_F64, GHE_MASK_F64, (a) < (b), a, b)
+#define GHE_MAX_F64(a, b) GHE_SELECT(GHE_VECTOR_F64, GHE_MASK_F64, (a) < (b), b, a)
+#define GHE_MIN_F32(a, b) GHE_SELECT(GHE_VECTOR_F32, GHE_MASK_F32, (a) < (b), a, b)
+#define GHE_MAX_F32(a, b) GHE_SELECT(GHE_VECTOR_F32, GHE_MASK_F32, (a) < (b), b, a)
+
+// Unaligned vector load and store, the memcpy compiles to one move
+#define GHE_LOAD(pVector, pSource) memcpy((pVector), (pSource), sizeof(*(pVector)))
+#define GHE_STORE(pDest, Vector) memcpy((pDest), &(Vector), sizeof(Vector))
+
+// Inclusive prefix sum of the eight lanes in three shifted adds, Zero supplies the shifted in lanes
+#define GHE_SCAN8(Type, MaskType, Vector, Zero)                                                          \
+    do                                                                                                   \
+    {                                                                                                    \
+        (Vector) += __builtin_shuffle((Vector), (Zero), (MaskType){ 8, 0, 1, 2, 3, 4, 5, 6 });          \
+        (Vector) += __builtin_shuffle((Vector), (Zero), (MaskType){ 8, 8, 0, 1, 2, 3, 4, 5 });          \
+        (Vector) += __builtin_shuffle((Vector), (Zero), (MaskType){ 8, 8, 8, 8, 0, 1, 2, 3 });          \
+    } while (0)
+
+#define GHE_ENGINE_BINS 32
+#define GHE_ENGINE_IETS 33
+#include "GHE_EngineTemplate.h"
+
+#define GHE_ENGINE_BINS 64
+#define GHE_ENGINE_IETS 65
+#include "GHE_EngineTemplate.h"
+
+#define GHE_ENGINE_BINS 128
+#define GHE_ENGINE_IETS 129
+#include "GHE_EngineTemplate.h"
+
+#define GHE_ENGINE_BINS 256
+#define GHE_ENGINE_IETS 257
+#include "GHE_EngineTemplate.h"
+
+#endif
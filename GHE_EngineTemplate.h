@@ -0,0 +1,786 @@
+/**
+ *
+ * @file  GHE_EngineTemplate.h
+ * @brief  Body of the compile-time specialized GHE engine
+ *
+ * Included once per instantiation with GHE_ENGINE_BINS and GHE_ENGINE_IETS defined, first from
+ * GHE_Engine.h for the declarations and then from GHE_Engine.c with GHE_ENGINE_IMPLEMENTATION
+ * defined for the function bodies. No include guard on purpose.
+ *
+ */
+
+#if !defined(GHE_ENGINE_BINS) || !defined(GHE_ENGINE_IETS)
+#error "GHE_ENGINE_BINS and GHE_ENGINE_IETS must be defined before including GHE_EngineTemplate.h"
+#endif
+
+#define GHE_ENGINE_MAX_BIN_INDEX (GHE_ENGINE_BINS - 1)
+#define GHE_ENGINE_MAX_IET_INDEX (GHE_ENGINE_IETS - 1)
+#define GHE_ENGINE_FN(Name) GHE_ENGINE_NAME(DisplayGheEngine, GHE_ENGINE_BINS, GHE_ENGINE_IETS, Name)
+#define GHE_ENGINE_CONTEXT GHE_ENGINE_NAME(GlobalHist_ENGINE, GHE_ENGINE_BINS, GHE_ENGINE_IETS, CONTEXT)
+#define GHE_ENGINE_ANALYSIS GHE_ENGINE_NAME(GlobalHist_ENGINE, GHE_ENGINE_BINS, GHE_ENGINE_IETS, ANALYSIS)
+
+#ifndef GHE_ENGINE_IMPLEMENTATION
+
+// Everything the algorithm needs from one frame, gathered in a single pass over the bins
+typedef struct
+{
+    uint32_t Cdf[GHE_ENGINE_BINS];
+    double PowerPrefix[GHE_ENGINE_BINS + 1]; // PowerPrefix[i] is the power of bins [0, i)
+    double FramePower;                        // PowerPrefix[GHE_ENGINE_BINS]
+    uint32_t TotalNumOfPixel;
+    uint32_t MinSlopeClamps;                  // Clamp events of ComputeLutTarget, counted with GlobalHist_ENABLE_STATS only
+    uint32_t MaxSlopeClamps;
+    uint32_t IetMaxClamps;
+} GHE_ENGINE_ANALYSIS;
+
+typedef struct
+{
+    uint32_t Histogram[GHE_ENGINE_BINS];
+    uint32_t PrevHistogram[GHE_ENGINE_BINS];
+    double PrevFramePower;     // Power of PrevHistogram
+    uint32_t LutTarget[GHE_ENGINE_IETS];
+    uint32_t LutApplied[GHE_ENGINE_IETS];
+    double IETHistory[GlobalHist_IIR_FILTER_ORDER][GHE_ENGINE_IETS]; // One row per tap, so the filter runs across entries
+    const double *pDeGammaLUT; // Shared table, see GHE_DeGamma.h
+    double MinCutoffFreq;      // In Hz
+    double MaxCutoffFreq;      // In Hz
+    double MinimumStepPercent;
+    double MinSlope;
+    double MaxSlope;
+    GlobalHist_FILTER_CLOCK FilterClock;
+} GHE_ENGINE_CONTEXT;
+
+// Stand-alone engine for this bin count
+void GHE_ENGINE_FN(Initialize)(GHE_ENGINE_CONTEXT *pEngine);
+// As DisplayGheSetTransferFunction, sRGB after Initialize
+bool GHE_ENGINE_FN(SetTransferFunction)(GHE_ENGINE_CONTEXT *pEngine, GlobalHist_TRANSFER_FUNCTION TransferFunction);
+// As DisplayGheSetConfig, the defaults after Initialize
+bool GHE_ENGINE_FN(SetConfig)(GHE_ENGINE_CONTEXT *pEngine, const GlobalHist_CFG *pCfg);
+// TimestampNs as GlobalHist_ARGS.TimestampNs, 0 when unknown
+void GHE_ENGINE_FN(Process)(GHE_ENGINE_CONTEXT *pEngine, const uint32_t *pHistogram, uint64_t TimestampNs, uint32_t *pDietFactor);
+
+// Stages, shared with the GlobalHist_CONTEXT path for the 32/33 instantiation.
+// ComputeLutTarget returns FALSE for solid color, in which case pLutTarget is the identity LUT.
+// pAnalysis receives the frame analysis either way. ComputeLutTargetSingle is the same stage in
+// float with twice the lanes and a vector power prefix scan, LutTarget within one LSB of the double one.
+void GHE_ENGINE_FN(Analyze)(const uint32_t *pHistogram, const double *pDeGammaLUT, GHE_ENGINE_ANALYSIS *pAnalysis);
+bool GHE_ENGINE_FN(ComputeLutTarget)(const uint32_t *pHistogram, const double *pDeGammaLUT, double MinSlope, double MaxSlope, uint32_t *pLutTarget,
+                                     GHE_ENGINE_ANALYSIS *pAnalysis);
+bool GHE_ENGINE_FN(ComputeLutTargetSingle)(const uint32_t *pHistogram, const double *pDeGammaLUT, double MinSlope, double MaxSlope, uint32_t *pLutTarget,
+                                           GHE_ENGINE_ANALYSIS *pAnalysis);
+double GHE_ENGINE_FN(EstimateSolidColor)(const double *pPowerPrefix, double TotalPower);
+double GHE_ENGINE_FN(GetFramePower)(const uint32_t *pHistogram, const double *pDeGammaLUT);
+bool GHE_ENGINE_FN(IsTargetReached)(const uint32_t *pLutApplied, const uint32_t *pLutTarget, double MinimumStepPercent);
+void GHE_ENGINE_FN(TemporalFilter)(double FilterCoefficient, const uint32_t *pLutTarget, uint32_t *pLutApplied, double (*pIETHistory)[GHE_ENGINE_IETS]);
+void GHE_ENGINE_FN(SnapToTarget)(const uint32_t *pLutTarget, uint32_t *pLutApplied, double (*pIETHistory)[GHE_ENGINE_IETS]);
+
+#else
+
+// The IET conversion reads histogram entries i - 1 and i for IET entry i, which holds while the
+// IET LUT has one more entry than there are bins
+_Static_assert(GHE_ENGINE_IETS == GHE_ENGINE_BINS + 1, "IET conversion expects GHE_ENGINE_BINS + 1 IET entries");
+_Static_assert(0 == GHE_ENGINE_BINS % GHE_LANES_F32, "Stage kernels expect whole vectors of bins");
+
+void GHE_ENGINE_FN(Initialize)(GHE_ENGINE_CONTEXT *pEngine)
+{
+    memset(pEngine, 0, sizeof(*pEngine));
+
+    pEngine->pDeGammaLUT = DisplayGheGetDeGammaLUT(GlobalHist_TRANSFER_SRGB, GHE_ENGINE_BINS);
+
+    GHE_UNROLL(GHE_ENGINE_IETS)
+    for (uint32_t IetIndex = 0; IetIndex < GHE_ENGINE_IETS; IetIndex++)
+    {
+        pEngine->LutTarget[IetIndex]  = GlobalHist_IET_SCALE_FACTOR;
+        pEngine->LutApplied[IetIndex] = GlobalHist_IET_SCALE_FACTOR;
+
+        for (uint32_t FilterOrder = 0; FilterOrder < GlobalHist_IIR_FILTER_ORDER; FilterOrder++)
+        {
+            pEngine->IETHistory[FilterOrder][IetIndex] = GlobalHist_IET_SCALE_FACTOR;
+        }
+    }
+
+    pEngine->MinCutoffFreq      = MILLIUNIT_TO_UNIT((double)DD_MIN(GlobalHist_SMOOTHENING_MIN_SPEED_DEFAULT, GlobalHist_SMOOTHENING_MAX_SPEED_DEFAULT));
+    pEngine->MaxCutoffFreq      = MILLIUNIT_TO_UNIT((double)DD_MAX(GlobalHist_SMOOTHENING_MIN_SPEED_DEFAULT, GlobalHist_SMOOTHENING_MAX_SPEED_DEFAULT));
+    pEngine->MinimumStepPercent = GlobalHist_SMOOTHENING_TOLERANCE_DEFAULT;
+    pEngine->MinSlope           = GlobalHist_MIN_SLOPE;
+    pEngine->MaxSlope           = GlobalHist_MAX_SLOPE;
+
+    DisplayGheInitializeFilterClock(&pEngine->FilterClock);
+}
+
+bool GHE_ENGINE_FN(SetConfig)(GHE_ENGINE_CONTEXT *pEngine, const GlobalHist_CFG *pCfg)
+{
+    if (FALSE == DisplayGheIsValidConfig(pCfg))
+    {
+        return FALSE;
+    }
+
+    pEngine->MinCutoffFreq      = DD_MIN(pCfg->MinIIRCutOffFreq, pCfg->MaxIIRCutOffFreq);
+    pEngine->MaxCutoffFreq      = DD_MAX(pCfg->MinIIRCutOffFreq, pCfg->MaxIIRCutOffFreq);
+    pEngine->MinimumStepPercent = pCfg->MinimumStepPercent;
+    pEngine->MinSlope           = pCfg->MinSlope;
+    pEngine->MaxSlope           = pCfg->MaxSlope;
+    DisplayGheSetFilterClockLimits(&pEngine->FilterClock, pCfg);
+
+    return TRUE;
+}
+
+bool GHE_ENGINE_FN(SetTransferFunction)(GHE_ENGINE_CONTEXT *pEngine, GlobalHist_TRANSFER_FUNCTION TransferFunction)
+{
+    const double *pDeGammaLUT = DisplayGheGetDeGammaLUT(TransferFunction, GHE_ENGINE_BINS);
+
+    if (NULL == pDeGammaLUT)
+    {
+        return FALSE;
+    }
+
+    pEngine->pDeGammaLUT    = pDeGammaLUT;
+    pEngine->PrevFramePower = GHE_ENGINE_FN(GetFramePower)(pEngine->PrevHistogram, pDeGammaLUT);
+
+    return TRUE;
+}
+
+GlobalHist_ISA_BODY void GHE_ENGINE_FN(AnalyzeBody)(const uint32_t *pHistogram, const double *pDeGammaLUT, GHE_ENGINE_ANALYSIS *pAnalysis)
+{
+    const GHE_VECTOR_U32 Zero = { 0 };
+    GHE_VECTOR_U32 Carry = { 0 };
+    double SumPower = 0;
+
+    // Cumulative histogram eight bins at a time, integer adds give the same sums in any order
+    GHE_UNROLL(GHE_ENGINE_BINS / GHE_LANES_F32)
+    for (uint32_t BinIndex = 0; BinIndex < GHE_ENGINE_BINS; BinIndex += GHE_LANES_F32)
+    {
+        GHE_VECTOR_U32 Cdf;
+
+        GHE_LOAD(&Cdf, pHistogram + BinIndex);
+        GHE_SCAN8(GHE_VECTOR_U32, GHE_VECTOR_U32, Cdf, Zero);
+        Cdf += Carry;
+        GHE_STORE(pAnalysis->Cdf + BinIndex, Cdf);
+
+        Carry = __builtin_shuffle(Cdf, (GHE_VECTOR_U32){ 7, 7, 7, 7, 7, 7, 7, 7 });
+    }
+
+    // The power prefix is summed in bin order. A tree order changes the low bits of the frame
+    // power, and with them the brightness change and solid color decisions.
+    pAnalysis->PowerPrefix[0] = 0;
+
+    GHE_UNROLL(GHE_ENGINE_BINS)
+    for (uint32_t BinIndex = 0; BinIndex < GHE_ENGINE_BINS; BinIndex++)
+    {
+        SumPower += pDeGammaLUT[BinIndex] * (double)pHistogram[BinIndex];
+        pAnalysis->PowerPrefix[BinIndex + 1] = SumPower;
+    }
+
+    pAnalysis->FramePower = SumPower;
+    pAnalysis->TotalNumOfPixel = pAnalysis->Cdf[GHE_ENGINE_MAX_BIN_INDEX];
+}
+
+void GHE_ENGINE_FN(Analyze)(const uint32_t *pHistogram, const double *pDeGammaLUT, GHE_ENGINE_ANALYSIS *pAnalysis)
+{
+    GHE_ENGINE_FN(AnalyzeBody)(pHistogram, pDeGammaLUT, pAnalysis);
+}
+
+// Power of every window is a difference of two prefix sums, so each window size is one vector
+// sweep over the window ends. The prefix is copied behind SOLID_COLOR_SEARCH_WINDOW_SIZE zeros: a
+// window running off the front then is the window [0, End) of a smaller size that was already
+// tested, so it never decides. The smallest window size holding the threshold power decides, as
+// in EstimateProbabilityOfFullScreenSolidColor.
+GlobalHist_ISA_BODY double GHE_ENGINE_FN(EstimateSolidColorBody)(const double *pPowerPrefix, double TotalPower)
+{
+    const double SolidColorPowerThreshold = SOLID_COLOR_POWER_THRESHOLD * TotalPower;
+    const double WindowSizeToProbabilityMapping[SOLID_COLOR_SEARCH_WINDOW_SIZE] = SOLID_COLOR_WINDOW_PROBABILITY;
+    double Prefix[SOLID_COLOR_SEARCH_WINDOW_SIZE + GHE_ENGINE_BINS + 1];
+
+    memset(Prefix, 0, SOLID_COLOR_SEARCH_WINDOW_SIZE * sizeof(double));
+    memcpy(Prefix + SOLID_COLOR_SEARCH_WINDOW_SIZE, pPowerPrefix, (GHE_ENGINE_BINS + 1) * sizeof(double));
+
+    for (uint32_t N = 1; N <= SOLID_COLOR_SEARCH_WINDOW_SIZE; N++)
+    {
+        GHE_MASK_F64 IsHit = { 0 };
+
+        GHE_UNROLL(GHE_ENGINE_BINS / GHE_LANES_F64)
+        for (uint32_t End = 1; End <= GHE_ENGINE_BINS; End += GHE_LANES_F64)
+        {
+            GHE_VECTOR_F64 EndPower, StartPower;
+
+            GHE_LOAD(&EndPower, Prefix + SOLID_COLOR_SEARCH_WINDOW_SIZE + End);
+            GHE_LOAD(&StartPower, Prefix + SOLID_COLOR_SEARCH_WINDOW_SIZE + End - N);
+            IsHit |= ((EndPower - StartPower) >= SolidColorPowerThreshold);
+        }
+
+        if (0 != (IsHit[0] | IsHit[1] | IsHit[2] | IsHit[3]))
+        {
+            return WindowSizeToProbabilityMapping[N - 1];
+        }
+    }
+
+    return 0;
+}
+
+// Everything but the slope clamp runs on vectors. The clamp is a chain through the previous output
+// and stays scalar; the normalized CDF it reads and the smoothing and IET conversion after it are
+// independent per entry. Every entry sees the operations of the scalar code in the same order.
+GlobalHist_ISA_BODY bool GHE_ENGINE_FN(ComputeLutTargetBody)(const uint32_t *pHistogram, const double *pDeGammaLUT, double MinSlope, double MaxSlope, uint32_t *pLutTarget,
+                                                             GHE_ENGINE_ANALYSIS *pAnalysis)
+{
+    double EnhancementTable[GHE_ENGINE_BINS];
+    double FilteredEnhancementTable[GHE_ENGINE_BINS + 1]; // Last entry repeated, see the IET conversion
+    double Histogram0, CDFRange, CdfNormalizingFactor;
+
+    const double MaxHistBinIndex = GHE_ENGINE_MAX_BIN_INDEX;
+    const double IetLutStepSize = 1.0 / (double)GHE_ENGINE_MAX_IET_INDEX;
+    const double HistBinStepSize = 1.0 / MaxHistBinIndex;
+    const double LowSlope = DD_MIN(MinSlope, MaxSlope);
+    const GHE_VECTOR_F64 Lane = { 0, 1, 2, 3 };
+    const GHE_VECTOR_F64 IetScaleFactor = (GHE_VECTOR_F64){ 0 } + GlobalHist_IET_SCALE_FACTOR;
+    const GHE_VECTOR_F64 IetMaxVal = (GHE_VECTOR_F64){ 0 } + GlobalHist_IET_MAX_VAL;
+
+    GHE_ENGINE_FN(AnalyzeBody)(pHistogram, pDeGammaLUT, pAnalysis);
+
+    pAnalysis->MinSlopeClamps = 0;
+    pAnalysis->MaxSlopeClamps = 0;
+    pAnalysis->IetMaxClamps   = 0;
+
+    // Do not modify pixel values for Solid Color
+    if (1 == GHE_ENGINE_FN(EstimateSolidColorBody)(pAnalysis->PowerPrefix, pAnalysis->FramePower))
+    {
+        GHE_UNROLL(GHE_ENGINE_IETS)
+        for (uint32_t IetIndex = 0; IetIndex < GHE_ENGINE_IETS; IetIndex++)
+        {
+            pLutTarget[IetIndex] = GlobalHist_IET_SCALE_FACTOR;
+        }
+
+        return FALSE;
+    }
+
+    Histogram0 = pHistogram[0];
+    CDFRange = (double)pAnalysis->Cdf[GHE_ENGINE_MAX_BIN_INDEX] - Histogram0;
+    CdfNormalizingFactor = 1.0 / CDFRange;
+
+    GHE_UNROLL(GHE_ENGINE_BINS / GHE_LANES_F64)
+    for (uint32_t BinIndex = 0; BinIndex < GHE_ENGINE_BINS; BinIndex += GHE_LANES_F64)
+    {
+        GHE_VECTOR_U32X4 Cdf;
+        GHE_VECTOR_F64 OutVal;
+
+        GHE_LOAD(&Cdf, pAnalysis->Cdf + BinIndex);
+        OutVal = (__builtin_convertvector(Cdf, GHE_VECTOR_F64) - Histogram0) * CdfNormalizingFactor;
+        GHE_STORE(EnhancementTable + BinIndex, OutVal);
+    }
+
+    // Slope clamped CDF. The three outcomes of the clamp are computed side by side and the slope
+    // only picks one, which takes the comparisons off the chain through PrevSampleVal.
+    // LowSlope is what DD_MIN(DD_MAX(Slope, MinSlope), MaxSlope) gives for Slope < MinSlope.
+    GHE_UNROLL(GHE_ENGINE_BINS)
+    for (uint32_t BinIndex = 1; BinIndex < GHE_ENGINE_BINS; BinIndex++)
+    {
+        double PrevSampleVal = EnhancementTable[BinIndex - 1];
+        double Slope = MaxHistBinIndex * (EnhancementTable[BinIndex] - PrevSampleVal);
+        double OutVal = PrevSampleVal + Slope * HistBinStepSize;
+        double LowOutVal = PrevSampleVal + LowSlope * HistBinStepSize;
+        double HighOutVal = PrevSampleVal + MaxSlope * HistBinStepSize;
+
+#ifdef GlobalHist_ENABLE_STATS
+        pAnalysis->MinSlopeClamps += (Slope < MinSlope);
+        pAnalysis->MaxSlopeClamps += (Slope > MaxSlope);
+#endif
+        OutVal = (Slope < MaxSlope) ? OutVal : HighOutVal;
+        OutVal = (Slope < MinSlope) ? LowOutVal : OutVal;
+        EnhancementTable[BinIndex] = DD_MIN(OutVal, 1.0);
+    }
+
+    // 3 tap smoothing. No filtering for the 0th and last values of the IET, the last vector is
+    // moved back to end at the last filtered bin and recomputes a few of them.
+    FilteredEnhancementTable[0] = EnhancementTable[0];
+
+    GHE_UNROLL(GHE_ENGINE_BINS / GHE_LANES_F64)
+    for (uint32_t Start = 1; Start < GHE_ENGINE_MAX_BIN_INDEX; Start += GHE_LANES_F64)
+    {
+        const uint32_t BinIndex = DD_MIN(Start, GHE_ENGINE_MAX_BIN_INDEX - GHE_LANES_F64);
+        GHE_VECTOR_F64 Prev, Curr, Next, Filtered;
+
+        GHE_LOAD(&Prev, EnhancementTable + BinIndex - 1);
+        GHE_LOAD(&Curr, EnhancementTable + BinIndex);
+        GHE_LOAD(&Next, EnhancementTable + BinIndex + 1);
+        Filtered = 0.333333 * (Prev + Curr + Next);
+        GHE_STORE(FilteredEnhancementTable + BinIndex, Filtered);
+    }
+
+    FilteredEnhancementTable[GHE_ENGINE_MAX_BIN_INDEX] = EnhancementTable[GHE_ENGINE_MAX_BIN_INDEX];
+    FilteredEnhancementTable[GHE_ENGINE_BINS]          = EnhancementTable[GHE_ENGINE_MAX_BIN_INDEX];
+
+    // Histogram LUT to IET LUT. IET entry i samples between bins i - 1 and i, the last one exactly
+    // at the last bin, so the interpolation reads two neighbouring vectors instead of gathering.
+    // The positions and weights are the ones Apply1DLUT computes and fold to constants.
+    GHE_UNROLL(GHE_ENGINE_BINS / GHE_LANES_F64)
+    for (uint32_t IetIndex = 1; IetIndex < GHE_ENGINE_IETS; IetIndex += GHE_LANES_F64)
+    {
+        const GHE_VECTOR_F64 Index = Lane + (double)IetIndex;
+        const GHE_VECTOR_F64 BinIndexNormalized = Index * IetLutStepSize;
+        const GHE_VECTOR_F64 Interpolator = BinIndexNormalized * MaxHistBinIndex - (Index - 1.0);
+        const GHE_VECTOR_F64 IetCap = 1.0 / BinIndexNormalized;
+        GHE_VECTOR_F64 Val1, Val2, IetVal;
+        GHE_VECTOR_U32X4 Lut;
+
+        GHE_LOAD(&Val1, FilteredEnhancementTable + IetIndex - 1);
+        GHE_LOAD(&Val2, FilteredEnhancementTable + IetIndex);
+
+        IetVal = Val1 + Interpolator * (Val2 - Val1);
+        IetVal = IetVal / BinIndexNormalized;           // Compute sample for multiplier LUT
+        IetVal = GHE_MIN_F64(IetVal, IetCap);           // Cap IET val to the value that will not cause clipping.
+
+        IetVal = (double)GlobalHist_IET_SCALE_FACTOR * IetVal + 0.5;
+#ifdef GlobalHist_ENABLE_STATS
+        {
+            GHE_MASK_F64 IsClamped = (IetVal > GlobalHist_IET_MAX_VAL);
+
+            pAnalysis->IetMaxClamps -= (uint32_t)(IsClamped[0] + IsClamped[1] + IsClamped[2] + IsClamped[3]);
+        }
+#endif
+        IetVal = GHE_MIN_F64(IetVal, IetMaxVal);
+        IetVal = GHE_MAX_F64(IetVal, IetScaleFactor);   // Never dim any pixel
+
+        Lut = (GHE_VECTOR_U32X4)__builtin_convertvector(IetVal, GHE_VECTOR_I32X4);
+        GHE_STORE(pLutTarget + IetIndex, Lut);
+    }
+
+    pLutTarget[0] = pLutTarget[1]; // 0th multiplier sample can't be computed. Extend 1st sample to the 0th
+
+    return TRUE;
+}
+
+// ComputeLutTargetBody in float. Eight lanes per vector, and both prefix sums are in-register
+// scans: the power prefix in tree order, which the double path can not afford.
+GlobalHist_ISA_BODY bool GHE_ENGINE_FN(ComputeLutTargetSingleBody)(const uint32_t *pHistogram, const double *pDeGammaLUT, double MinSlope, double MaxSlope, uint32_t *pLutTarget,
+                                                                   GHE_ENGINE_ANALYSIS *pAnalysis)
+{
+    float PowerPrefix[SOLID_COLOR_SEARCH_WINDOW_SIZE + GHE_ENGINE_BINS + 1]; // Behind zeros, as in EstimateSolidColorBody
+    float EnhancementTable[GHE_ENGINE_BINS];
+    float FilteredEnhancementTable[GHE_ENGINE_BINS + 1];
+    float SolidColorPowerThreshold, SolidColorProbability = 0;
+    float Histogram0, CdfNormalizingFactor;
+
+    const float MaxHistBinIndex = GHE_ENGINE_MAX_BIN_INDEX;
+    const float IetLutStepSize = 1.0f / (float)GHE_ENGINE_MAX_IET_INDEX;
+    const float HistBinStepSize = 1.0f / MaxHistBinIndex;
+    const float SingleMinSlope = (float)MinSlope;
+    const float SingleMaxSlope = (float)MaxSlope;
+    const float LowStep = DD_MIN(SingleMinSlope, SingleMaxSlope) * HistBinStepSize;
+    const float HighStep = SingleMaxSlope * HistBinStepSize;
+    const float WindowSizeToProbabilityMapping[SOLID_COLOR_SEARCH_WINDOW_SIZE] = SOLID_COLOR_WINDOW_PROBABILITY;
+    const GHE_VECTOR_U32 ZeroCount = { 0 };
+    const GHE_VECTOR_F32 Zero = { 0 };
+    const GHE_VECTOR_F32 Lane = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    const GHE_VECTOR_F32 IetScaleFactor = Zero + GlobalHist_IET_SCALE_FACTOR;
+    const GHE_VECTOR_F32 IetMaxVal = Zero + GlobalHist_IET_MAX_VAL;
+    GHE_VECTOR_U32 CdfCarry = { 0 };
+    GHE_VECTOR_F32 PowerCarry = { 0 };
+
+    pAnalysis->MinSlopeClamps = 0;
+    pAnalysis->MaxSlopeClamps = 0;
+    pAnalysis->IetMaxClamps   = 0;
+
+    memset(PowerPrefix, 0, (SOLID_COLOR_SEARCH_WINDOW_SIZE + 1) * sizeof(float));
+
+    GHE_UNROLL(GHE_ENGINE_BINS / GHE_LANES_F32)
+    for (uint32_t BinIndex = 0; BinIndex < GHE_ENGINE_BINS; BinIndex += GHE_LANES_F32)
+    {
+        GHE_VECTOR_U32 Count, Cdf;
+        GHE_VECTOR_F64 DeGammaLow, DeGammaHigh;
+        GHE_VECTOR_F32X4 SingleLow, SingleHigh;
+        GHE_VECTOR_F32 DeGamma, Power;
+
+        GHE_LOAD(&Count, pHistogram + BinIndex);
+        GHE_LOAD(&DeGammaLow, pDeGammaLUT + BinIndex);
+        GHE_LOAD(&DeGammaHigh, pDeGammaLUT + BinIndex + GHE_LANES_F64);
+        SingleLow  = __builtin_convertvector(DeGammaLow, GHE_VECTOR_F32X4);
+        SingleHigh = __builtin_convertvector(DeGammaHigh, GHE_VECTOR_F32X4);
+        DeGamma    = __builtin_shufflevector(SingleLow, SingleHigh, 0, 1, 2, 3, 4, 5, 6, 7);
+
+        Power = DeGamma * __builtin_convertvector(Count, GHE_VECTOR_F32);
+        GHE_SCAN8(GHE_VECTOR_F32, GHE_MASK_F32, Power, Zero);
+        Power += PowerCarry;
+        GHE_STORE(PowerPrefix + SOLID_COLOR_SEARCH_WINDOW_SIZE + 1 + BinIndex, Power);
+        PowerCarry = __builtin_shuffle(Power, (GHE_MASK_F32){ 7, 7, 7, 7, 7, 7, 7, 7 });
+
+        Cdf = Count;
+        GHE_SCAN8(GHE_VECTOR_U32, GHE_VECTOR_U32, Cdf, ZeroCount);
+        Cdf += CdfCarry;
+        GHE_STORE(pAnalysis->Cdf + BinIndex, Cdf);
+        CdfCarry = __builtin_shuffle(Cdf, (GHE_VECTOR_U32){ 7, 7, 7, 7, 7, 7, 7, 7 });
+    }
+
+    for (uint32_t BinIndex = 0; BinIndex <= GHE_ENGINE_BINS; BinIndex++)
+    {
+        pAnalysis->PowerPrefix[BinIndex] = PowerPrefix[SOLID_COLOR_SEARCH_WINDOW_SIZE + BinIndex];
+    }
+
+    pAnalysis->FramePower      = pAnalysis->PowerPrefix[GHE_ENGINE_BINS];
+    pAnalysis->TotalNumOfPixel = pAnalysis->Cdf[GHE_ENGINE_MAX_BIN_INDEX];
+
+    SolidColorPowerThreshold = (float)SOLID_COLOR_POWER_THRESHOLD * PowerPrefix[SOLID_COLOR_SEARCH_WINDOW_SIZE + GHE_ENGINE_BINS];
+
+    for (uint32_t N = 1; (N <= SOLID_COLOR_SEARCH_WINDOW_SIZE) && (0 == SolidColorProbability); N++)
+    {
+        GHE_MASK_F32 IsHit = { 0 };
+        int32_t IsAnyHit = 0;
+
+        GHE_UNROLL(GHE_ENGINE_BINS / GHE_LANES_F32)
+        for (uint32_t End = 1; End <= GHE_ENGINE_BINS; End += GHE_LANES_F32)
+        {
+            GHE_VECTOR_F32 EndPower, StartPower;
+
+            GHE_LOAD(&EndPower, PowerPrefix + SOLID_COLOR_SEARCH_WINDOW_SIZE + End);
+            GHE_LOAD(&StartPower, PowerPrefix + SOLID_COLOR_SEARCH_WINDOW_SIZE + End - N);
+            IsHit |= ((EndPower - StartPower) >= SolidColorPowerThreshold);
+        }
+
+        for (uint32_t Lane = 0; Lane < GHE_LANES_F32; Lane++)
+        {
+            IsAnyHit |= IsHit[Lane];
+        }
+
+        SolidColorProbability = IsAnyHit ? WindowSizeToProbabilityMapping[N - 1] : 0;
+    }
+
+    // Do not modify pixel values for Solid Color
+    if (1 == SolidColorProbability)
+    {
+        GHE_UNROLL(GHE_ENGINE_IETS)
+        for (uint32_t IetIndex = 0; IetIndex < GHE_ENGINE_IETS; IetIndex++)
+        {
+            pLutTarget[IetIndex] = GlobalHist_IET_SCALE_FACTOR;
+        }
+
+        return FALSE;
+    }
+
+    Histogram0 = pHistogram[0];
+    CdfNormalizingFactor = 1.0f / ((float)pAnalysis->Cdf[GHE_ENGINE_MAX_BIN_INDEX] - Histogram0);
+
+    GHE_UNROLL(GHE_ENGINE_BINS / GHE_LANES_F32)
+    for (uint32_t BinIndex = 0; BinIndex < GHE_ENGINE_BINS; BinIndex += GHE_LANES_F32)
+    {
+        GHE_VECTOR_U32 Cdf;
+        GHE_VECTOR_F32 OutVal;
+
+        GHE_LOAD(&Cdf, pAnalysis->Cdf + BinIndex);
+        OutVal = (__builtin_convertvector(Cdf, GHE_VECTOR_F32) - Histogram0) * CdfNormalizingFactor;
+        OutVal = GHE_MIN_F32(OutVal, Zero + 1.0f);
+        GHE_STORE(EnhancementTable + BinIndex, OutVal);
+    }
+
+    // The slope clamp as a clamp of the sample, between Prev + LowStep and Prev + HighStep and
+    // below 1, so the serial chain is an add, a min and a max deep. Equal to the double path's
+    // selects up to float rounding.
+    GHE_UNROLL(GHE_ENGINE_BINS)
+    for (uint32_t BinIndex = 1; BinIndex < GHE_ENGINE_BINS; BinIndex++)
+    {
+        float PrevSampleVal = EnhancementTable[BinIndex - 1];
+        float OutVal = EnhancementTable[BinIndex];
+        float LowOutVal = DD_MIN(PrevSampleVal + LowStep, 1.0f);
+        float HighOutVal = PrevSampleVal + HighStep;
+
+#ifdef GlobalHist_ENABLE_STATS
+        pAnalysis->MinSlopeClamps += (MaxHistBinIndex * (OutVal - PrevSampleVal) < SingleMinSlope);
+        pAnalysis->MaxSlopeClamps += (MaxHistBinIndex * (OutVal - PrevSampleVal) > SingleMaxSlope);
+#endif
+        OutVal = DD_MIN(OutVal, HighOutVal);
+        EnhancementTable[BinIndex] = DD_MAX(OutVal, LowOutVal);
+    }
+
+    FilteredEnhancementTable[0] = EnhancementTable[0];
+
+    GHE_UNROLL(GHE_ENGINE_BINS / GHE_LANES_F32)
+    for (uint32_t Start = 1; Start < GHE_ENGINE_MAX_BIN_INDEX; Start += GHE_LANES_F32)
+    {
+        const uint32_t BinIndex = DD_MIN(Start, GHE_ENGINE_MAX_BIN_INDEX - GHE_LANES_F32);
+        GHE_VECTOR_F32 Prev, Curr, Next, Filtered;
+
+        GHE_LOAD(&Prev, EnhancementTable + BinIndex - 1);
+        GHE_LOAD(&Curr, EnhancementTable + BinIndex);
+        GHE_LOAD(&Next, EnhancementTable + BinIndex + 1);
+        Filtered = 0.333333f * (Prev + Curr + Next);
+        GHE_STORE(FilteredEnhancementTable + BinIndex, Filtered);
+    }
+
+    FilteredEnhancementTable[GHE_ENGINE_MAX_BIN_INDEX] = EnhancementTable[GHE_ENGINE_MAX_BIN_INDEX];
+    FilteredEnhancementTable[GHE_ENGINE_BINS]          = EnhancementTable[GHE_ENGINE_MAX_BIN_INDEX];
+
+    GHE_UNROLL(GHE_ENGINE_BINS / GHE_LANES_F32)
+    for (uint32_t IetIndex = 1; IetIndex < GHE_ENGINE_IETS; IetIndex += GHE_LANES_F32)
+    {
+        const GHE_VECTOR_F32 Index = Lane + (float)IetIndex;
+        const GHE_VECTOR_F32 BinIndexNormalized = Index * IetLutStepSize;
+        const GHE_VECTOR_F32 Interpolator = BinIndexNormalized * MaxHistBinIndex - (Index - 1.0f);
+        const GHE_VECTOR_F32 IetCap = 1.0f / BinIndexNormalized;
+        GHE_VECTOR_F32 Val1, Val2, IetVal;
+        GHE_VECTOR_U32 Lut;
+
+        GHE_LOAD(&Val1, FilteredEnhancementTable + IetIndex - 1);
+        GHE_LOAD(&Val2, FilteredEnhancementTable + IetIndex);
+
+        IetVal = Val1 + Interpolator * (Val2 - Val1);
+        IetVal = IetVal / BinIndexNormalized;
+        IetVal = GHE_MIN_F32(IetVal, IetCap);
+
+        IetVal = (float)GlobalHist_IET_SCALE_FACTOR * IetVal + 0.5f;
+#ifdef GlobalHist_ENABLE_STATS
+        {
+            GHE_MASK_F32 IsClamped = (IetVal > GlobalHist_IET_MAX_VAL);
+
+            for (uint32_t Lane = 0; Lane < GHE_LANES_F32; Lane++)
+            {
+                pAnalysis->IetMaxClamps -= (uint32_t)IsClamped[Lane];
+            }
+        }
+#endif
+        IetVal = GHE_MIN_F32(IetVal, IetMaxVal);
+        IetVal = GHE_MAX_F32(IetVal, IetScaleFactor);
+
+        Lut = (GHE_VECTOR_U32)__builtin_convertvector(IetVal, GHE_MASK_F32);
+        GHE_STORE(pLutTarget + IetIndex, Lut);
+    }
+
+    pLutTarget[0] = pLutTarget[1];
+
+    return TRUE;
+}
+
+double GHE_ENGINE_FN(GetFramePower)(const uint32_t *pHistogram, const double *pDeGammaLUT)
+{
+    double FramePower = 0;
+
+    GHE_UNROLL(GHE_ENGINE_BINS)
+    for (uint32_t BinIndex = 0; BinIndex < GHE_ENGINE_BINS; BinIndex++)
+    {
+        FramePower += pDeGammaLUT[BinIndex] * (double)pHistogram[BinIndex];
+    }
+
+    return FramePower;
+}
+
+bool GHE_ENGINE_FN(IsTargetReached)(const uint32_t *pLutApplied, const uint32_t *pLutTarget, double MinimumStepPercent)
+{
+    bool IsReached = TRUE;
+
+    // |Delta| / Target <= Percent / 100, cross multiplied so there is no divide. Targets are never
+    // below GlobalHist_IET_SCALE_FACTOR and both products are exact, so the result is unchanged.
+    // Integer delta, as the int abs() of IsTargetIETReached truncates it
+    GHE_UNROLL(GHE_ENGINE_IETS)
+    for (uint32_t IetIndex = 0; IetIndex < GHE_ENGINE_IETS; IetIndex++)
+    {
+        int32_t Delta = (int32_t)pLutApplied[IetIndex] - (int32_t)pLutTarget[IetIndex];
+
+        IsReached &= ((double)(100 * DD_ABS(Delta)) <= MinimumStepPercent * (double)pLutTarget[IetIndex]);
+    }
+
+    return IsReached;
+}
+
+// One tap at a time across all entries: a tap of IETHistory is a row, so every step is a
+// contiguous vector. Entries past the last whole vector take the same arithmetic one at a time.
+GlobalHist_ISA_BODY void GHE_ENGINE_FN(TemporalFilterBody)(double FilterCoefficient, const uint32_t *pLutTarget, uint32_t *pLutApplied, double (*pIETHistory)[GHE_ENGINE_IETS])
+{
+    const GHE_VECTOR_U32X4 IetMaxVal = { GlobalHist_IET_MAX_VAL, GlobalHist_IET_MAX_VAL, GlobalHist_IET_MAX_VAL, GlobalHist_IET_MAX_VAL };
+    uint32_t IetIndex = 0;
+
+    GHE_UNROLL(GHE_ENGINE_IETS / GHE_LANES_F64)
+    for (; IetIndex + GHE_LANES_F64 <= GHE_ENGINE_IETS; IetIndex += GHE_LANES_F64)
+    {
+        GHE_VECTOR_U32X4 Target, IetVal;
+        GHE_VECTOR_F64 AdjustedValue;
+
+        GHE_LOAD(&Target, pLutTarget + IetIndex);
+        AdjustedValue = __builtin_convertvector(Target, GHE_VECTOR_F64);
+
+        for (uint32_t FilterOrder = 0; FilterOrder < GlobalHist_IIR_FILTER_ORDER; FilterOrder++)
+        {
+            GHE_VECTOR_F64 Tap;
+
+            GHE_LOAD(&Tap, pIETHistory[FilterOrder] + IetIndex);
+            AdjustedValue = FilterCoefficient * AdjustedValue;
+            AdjustedValue += (1 - FilterCoefficient) * Tap;
+            GHE_STORE(pIETHistory[FilterOrder] + IetIndex, AdjustedValue);
+        }
+
+        IetVal = __builtin_convertvector(AdjustedValue, GHE_VECTOR_U32X4);
+        IetVal = GHE_SELECT(GHE_VECTOR_U32X4, GHE_VECTOR_I32X4, IetVal < IetMaxVal, IetVal, IetMaxVal);
+        GHE_STORE(pLutApplied + IetIndex, IetVal);
+    }
+
+    for (; IetIndex < GHE_ENGINE_IETS; IetIndex++)
+    {
+        double AdjustedValue = pLutTarget[IetIndex];
+        uint32_t IetVal;
+
+        for (uint32_t FilterOrder = 0; FilterOrder < GlobalHist_IIR_FILTER_ORDER; FilterOrder++)
+        {
+            AdjustedValue = FilterCoefficient * AdjustedValue;
+            AdjustedValue += (1 - FilterCoefficient) * pIETHistory[FilterOrder][IetIndex];
+            pIETHistory[FilterOrder][IetIndex] = AdjustedValue;
+        }
+
+        IetVal = (uint32_t)AdjustedValue;
+        pLutApplied[IetIndex] = DD_MIN(IetVal, GlobalHist_IET_MAX_VAL);
+    }
+}
+
+#if GlobalHist_HAS_ISA_DISPATCH
+
+GlobalHist_TARGET_AVX2 static double GHE_ENGINE_FN(EstimateSolidColorAvx2)(const double *pPowerPrefix, double TotalPower)
+{
+    return GHE_ENGINE_FN(EstimateSolidColorBody)(pPowerPrefix, TotalPower);
+}
+
+GlobalHist_TARGET_AVX512 static double GHE_ENGINE_FN(EstimateSolidColorAvx512)(const double *pPowerPrefix, double TotalPower)
+{
+    return GHE_ENGINE_FN(EstimateSolidColorBody)(pPowerPrefix, TotalPower);
+}
+
+GlobalHist_TARGET_AVX2 static bool GHE_ENGINE_FN(ComputeLutTargetAvx2)(const uint32_t *pHistogram, const double *pDeGammaLUT, double MinSlope, double MaxSlope, uint32_t *pLutTarget,
+                                                                       GHE_ENGINE_ANALYSIS *pAnalysis)
+{
+    return GHE_ENGINE_FN(ComputeLutTargetBody)(pHistogram, pDeGammaLUT, MinSlope, MaxSlope, pLutTarget, pAnalysis);
+}
+
+GlobalHist_TARGET_AVX512 static bool GHE_ENGINE_FN(ComputeLutTargetAvx512)(const uint32_t *pHistogram, const double *pDeGammaLUT, double MinSlope, double MaxSlope, uint32_t *pLutTarget,
+                                                                           GHE_ENGINE_ANALYSIS *pAnalysis)
+{
+    return GHE_ENGINE_FN(ComputeLutTargetBody)(pHistogram, pDeGammaLUT, MinSlope, MaxSlope, pLutTarget, pAnalysis);
+}
+
+GlobalHist_TARGET_AVX2 static bool GHE_ENGINE_FN(ComputeLutTargetSingleAvx2)(const uint32_t *pHistogram, const double *pDeGammaLUT, double MinSlope, double MaxSlope,
+                                                                             uint32_t *pLutTarget, GHE_ENGINE_ANALYSIS *pAnalysis)
+{
+    return GHE_ENGINE_FN(ComputeLutTargetSingleBody)(pHistogram, pDeGammaLUT, MinSlope, MaxSlope, pLutTarget, pAnalysis);
+}
+
+GlobalHist_TARGET_AVX512 static bool GHE_ENGINE_FN(ComputeLutTargetSingleAvx512)(const uint32_t *pHistogram, const double *pDeGammaLUT, double MinSlope, double MaxSlope,
+                                                                                 uint32_t *pLutTarget, GHE_ENGINE_ANALYSIS *pAnalysis)
+{
+    return GHE_ENGINE_FN(ComputeLutTargetSingleBody)(pHistogram, pDeGammaLUT, MinSlope, MaxSlope, pLutTarget, pAnalysis);
+}
+
+GlobalHist_TARGET_AVX2 static void GHE_ENGINE_FN(TemporalFilterAvx2)(double FilterCoefficient, const uint32_t *pLutTarget, uint32_t *pLutApplied, double (*pIETHistory)[GHE_ENGINE_IETS])
+{
+    GHE_ENGINE_FN(TemporalFilterBody)(FilterCoefficient, pLutTarget, pLutApplied, pIETHistory);
+}
+
+GlobalHist_TARGET_AVX512 static void GHE_ENGINE_FN(TemporalFilterAvx512)(double FilterCoefficient, const uint32_t *pLutTarget, uint32_t *pLutApplied, double (*pIETHistory)[GHE_ENGINE_IETS])
+{
+    GHE_ENGINE_FN(TemporalFilterBody)(FilterCoefficient, pLutTarget, pLutApplied, pIETHistory);
+}
+
+#endif
+
+double GHE_ENGINE_FN(EstimateSolidColor)(const double *pPowerPrefix, double TotalPower)
+{
+#if GlobalHist_HAS_ISA_DISPATCH
+    switch (DisplayGheGetIsa())
+    {
+    case GlobalHist_ISA_AVX512: return GHE_ENGINE_FN(EstimateSolidColorAvx512)(pPowerPrefix, TotalPower);
+    case GlobalHist_ISA_AVX2:   return GHE_ENGINE_FN(EstimateSolidColorAvx2)(pPowerPrefix, TotalPower);
+    default:                    break;
+    }
+#endif
+
+    return GHE_ENGINE_FN(EstimateSolidColorBody)(pPowerPrefix, TotalPower);
+}
+
+bool GHE_ENGINE_FN(ComputeLutTarget)(const uint32_t *pHistogram, const double *pDeGammaLUT, double MinSlope, double MaxSlope, uint32_t *pLutTarget,
+                                     GHE_ENGINE_ANALYSIS *pAnalysis)
+{
+#if GlobalHist_HAS_ISA_DISPATCH
+    switch (DisplayGheGetIsa())
+    {
+    case GlobalHist_ISA_AVX512: return GHE_ENGINE_FN(ComputeLutTargetAvx512)(pHistogram, pDeGammaLUT, MinSlope, MaxSlope, pLutTarget, pAnalysis);
+    case GlobalHist_ISA_AVX2:   return GHE_ENGINE_FN(ComputeLutTargetAvx2)(pHistogram, pDeGammaLUT, MinSlope, MaxSlope, pLutTarget, pAnalysis);
+    default:                    break;
+    }
+#endif
+
+    return GHE_ENGINE_FN(ComputeLutTargetBody)(pHistogram, pDeGammaLUT, MinSlope, MaxSlope, pLutTarget, pAnalysis);
+}
+
+bool GHE_ENGINE_FN(ComputeLutTargetSingle)(const uint32_t *pHistogram, const double *pDeGammaLUT, double MinSlope, double MaxSlope, uint32_t *pLutTarget,
+                                           GHE_ENGINE_ANALYSIS *pAnalysis)
+{
+#if GlobalHist_HAS_ISA_DISPATCH
+    switch (DisplayGheGetIsa())
+    {
+    case GlobalHist_ISA_AVX512: return GHE_ENGINE_FN(ComputeLutTargetSingleAvx512)(pHistogram, pDeGammaLUT, MinSlope, MaxSlope, pLutTarget, pAnalysis);
+    case GlobalHist_ISA_AVX2:   return GHE_ENGINE_FN(ComputeLutTargetSingleAvx2)(pHistogram, pDeGammaLUT, MinSlope, MaxSlope, pLutTarget, pAnalysis);
+    default:                    break;
+    }
+#endif
+
+    return GHE_ENGINE_FN(ComputeLutTargetSingleBody)(pHistogram, pDeGammaLUT, MinSlope, MaxSlope, pLutTarget, pAnalysis);
+}
+
+void GHE_ENGINE_FN(TemporalFilter)(double FilterCoefficient, const uint32_t *pLutTarget, uint32_t *pLutApplied, double (*pIETHistory)[GHE_ENGINE_IETS])
+{
+#if GlobalHist_HAS_ISA_DISPATCH
+    switch (DisplayGheGetIsa())
+    {
+    case GlobalHist_ISA_AVX512: GHE_ENGINE_FN(TemporalFilterAvx512)(FilterCoefficient, pLutTarget, pLutApplied, pIETHistory); return;
+    case GlobalHist_ISA_AVX2:   GHE_ENGINE_FN(TemporalFilterAvx2)(FilterCoefficient, pLutTarget, pLutApplied, pIETHistory);   return;
+    default:                    break;
+    }
+#endif
+
+    GHE_ENGINE_FN(TemporalFilterBody)(FilterCoefficient, pLutTarget, pLutApplied, pIETHistory);
+}
+
+void GHE_ENGINE_FN(SnapToTarget)(const uint32_t *pLutTarget, uint32_t *pLutApplied, double (*pIETHistory)[GHE_ENGINE_IETS])
+{
+    memcpy(pLutApplied, pLutTarget, GHE_ENGINE_IETS * sizeof(uint32_t));
+
+    for (uint32_t FilterOrder = 0; FilterOrder < GlobalHist_IIR_FILTER_ORDER; FilterOrder++)
+    {
+        GHE_UNROLL(GHE_ENGINE_IETS)
+        for (uint32_t IetIndex = 0; IetIndex < GHE_ENGINE_IETS; IetIndex++)
+        {
+            pIETHistory[FilterOrder][IetIndex] = pLutTarget[IetIndex];
+        }
+    }
+}
+
+void GHE_ENGINE_FN(Process)(GHE_ENGINE_CONTEXT *pEngine, const uint32_t *pHistogram, uint64_t TimestampNs, uint32_t *pDietFactor)
+{
+    GHE_ENGINE_ANALYSIS Analysis;
+
+    memcpy(pEngine->Histogram, pHistogram, sizeof(pEngine->Histogram));
+    DisplayGheAdvanceFilterClock(&pEngine->FilterClock, TimestampNs);
+
+    if (GHE_ENGINE_FN(ComputeLutTarget)(pEngine->Histogram, pEngine->pDeGammaLUT, pEngine->MinSlope, pEngine->MaxSlope, pEngine->LutTarget, &Analysis))
+    {
+        if (GHE_ENGINE_FN(IsTargetReached)(pEngine->LutApplied, pEngine->LutTarget, pEngine->MinimumStepPercent))
+        {
+            GHE_ENGINE_FN(SnapToTarget)(pEngine->LutTarget, pEngine->LutApplied, pEngine->IETHistory);
+        }
+        else
+        {
+            double CutOffFreq = DisplayGheGetCutOffFrequency(&pEngine->FilterClock, DisplayGheGetRelativeBrightnessChange(pEngine->PrevFramePower, Analysis.FramePower),
+                                                             pEngine->MinCutoffFreq, pEngine->MaxCutoffFreq);
+            double FilterCoefficient = DisplayGheGetIIRFilterCoefficient(CutOffFreq, pEngine->FilterClock.SamplingPeriod);
+
+            GHE_ENGINE_FN(TemporalFilter)(FilterCoefficient, pEngine->LutTarget, pEngine->LutApplied, pEngine->IETHistory);
+        }
+
+        memcpy(pEngine->PrevHistogram, pEngine->Histogram, sizeof(pEngine->PrevHistogram));
+        pEngine->PrevFramePower = Analysis.FramePower;
+    }
+
+    memcpy(pDietFactor, pEngine->LutApplied, sizeof(pEngine->LutApplied));
+}
+
+#endif
+
+#undef GHE_ENGINE_MAX_BIN_INDEX
+#undef GHE_ENGINE_MAX_IET_INDEX
+#undef GHE_ENGINE_FN
+#undef GHE_ENGINE_CONTEXT
+#undef GHE_ENGINE_ANALYSIS
+#undef GHE_ENGINE_BINS
+#undef GHE_ENGINE_IETS
@@ -0,0 +1,308 @@
+#include "GHE_FixedPoint.h"
+
+#define GlobalHist_FIXED_MIN_SLOPE  19661                                  // GlobalHist_MIN_SLOPE in Q16
+#define GlobalHist_FIXED_MAX_SLOPE  (7 * GlobalHist_FIXED_ONE)            // GlobalHist_MAX_SLOPE in Q16
+#define GlobalHist_FIXED_OMEGA     452751ull                              // 2 * PI per milli Hz per ns, in Q56
+#define GlobalHist_FIXED_SAMPLING_PERIOD_NS 33222591ull                    // GlobalHist_SMOOTHENING_SAMPLING_PERIOD
+#define GlobalHist_FIXED_PHASE_PERIOD_NS    (PHASE_GlobalHist_PERIOD * 1000000ull)
+#define GlobalHist_FIXED_HOLD_NS            ((int64_t)SMOOTHENING_MIN_STABLE_CUT_OFF_FREQUNCY_DURATION * 1000000)
+
+// The sRGB table of GHE_DeGamma.h for 32 bins in Q16
+static const uint32_t DeGammaLUT[GlobalHist_BIN_COUNT] =
+{
+        0,   164,   352,   625,   992,  1461,  2040,  2734,
+     3550,  4492,  5565,  6776,  8127,  9623, 11269, 13069,
+    15026, 17144, 19426, 21877, 24499, 27296, 30271, 33426,
+    36766, 40293, 44009, 47919, 52023, 56326, 60829, 65536,
+};
+
+void DisplayGheFixedInitialize(GlobalHist_FIXED_CONTEXT *pFixed)
+{
+    memset(pFixed, 0, sizeof(*pFixed));
+
+    for (uint32_t Count = 0; Count < GlobalHist_IET_LUT_LENGTH; Count++)
+    {
+        pFixed->LutTarget[Count]  = GlobalHist_IET_SCALE_FACTOR;
+        pFixed->LutApplied[Count] = GlobalHist_IET_SCALE_FACTOR;
+
+        for (uint32_t FilterOrder = 0; FilterOrder < GlobalHist_IIR_FILTER_ORDER; FilterOrder++)
+        {
+            pFixed->IETHistory[Count][FilterOrder] = GlobalHist_IET_SCALE_FACTOR << GlobalHist_FIXED_FRACTION_BITS;
+        }
+    }
+
+    pFixed->MinCutOffFreqInMilliHz = DD_MIN(GlobalHist_SMOOTHENING_MIN_SPEED_DEFAULT, GlobalHist_SMOOTHENING_MAX_SPEED_DEFAULT);
+    pFixed->MaxCutOffFreqInMilliHz = DD_MAX(GlobalHist_SMOOTHENING_MIN_SPEED_DEFAULT, GlobalHist_SMOOTHENING_MAX_SPEED_DEFAULT);
+    pFixed->MinimumStepPercent     = GlobalHist_SMOOTHENING_TOLERANCE_DEFAULT;
+    pFixed->SamplingPeriodNs       = GlobalHist_FIXED_SAMPLING_PERIOD_NS;
+}
+
+// Only windows of one or two bins map to a probability of 1 in EstimateProbabilityOfFullScreenSolidColor
+static bool IsSolidColor(const uint64_t *pPowerDistribution, uint64_t TotalPower)
+{
+    const uint64_t Threshold = 19 * TotalPower; // SOLID_COLOR_POWER_THRESHOLD, both sides scaled by 20
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        uint64_t WindowPower = pPowerDistribution[BinIndex];
+
+        if (20 * WindowPower >= Threshold)
+        {
+            return TRUE;
+        }
+
+        if (BinIndex < GlobalHist_MAX_BIN_INDEX)
+        {
+            WindowPower += pPowerDistribution[BinIndex + 1];
+
+            if (20 * WindowPower >= Threshold)
+            {
+                return TRUE;
+            }
+        }
+    }
+
+    return FALSE;
+}
+
+bool DisplayGheFixedComputeLutTarget(const uint32_t *pHistogram, uint32_t *pLutTarget)
+{
+    uint32_t TotalNumOfPixel = 0;
+    uint32_t Cdf[GlobalHist_BIN_COUNT];
+    uint64_t PowerDistribution[GlobalHist_BIN_COUNT];
+    uint64_t SumPower = 0;
+    int64_t EnhancementTable[GlobalHist_BIN_COUNT];         // Q16
+    int64_t FilteredEnhancementTable[GlobalHist_BIN_COUNT]; // Q16
+    uint64_t CDFRange;
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        TotalNumOfPixel += pHistogram[BinIndex];
+        Cdf[BinIndex] = TotalNumOfPixel;
+
+        PowerDistribution[BinIndex] = (uint64_t)DeGammaLUT[BinIndex] * pHistogram[BinIndex];
+        SumPower += PowerDistribution[BinIndex];
+    }
+
+    // Do not modify pixel values for Solid Color. This also covers an empty CDF range, as a
+    // frame with every pixel in bin 0 has no power.
+    if (IsSolidColor(PowerDistribution, SumPower))
+    {
+        for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+        {
+            pLutTarget[IetIndex] = GlobalHist_IET_SCALE_FACTOR;
+        }
+
+        return FALSE;
+    }
+
+    CDFRange = Cdf[GlobalHist_MAX_BIN_INDEX] - pHistogram[0];
+    EnhancementTable[0] = 0;
+
+    // Slope clamping on the normalized CDF. Dividing Slope by the bin count gives back OutVal
+    // exactly whenever the slope is not clamped.
+    for (uint32_t BinIndex = 1; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        int64_t OutVal = (int64_t)((((uint64_t)(Cdf[BinIndex] - pHistogram[0]) << GlobalHist_FIXED_FRACTION_BITS) + CDFRange / 2) / CDFRange);
+        int64_t PrevSampleVal = EnhancementTable[BinIndex - 1];
+        int64_t Slope = GlobalHist_MAX_BIN_INDEX * (OutVal - PrevSampleVal);
+
+        Slope = DD_MAX(Slope, GlobalHist_FIXED_MIN_SLOPE);
+        Slope = DD_MIN(Slope, GlobalHist_FIXED_MAX_SLOPE);
+
+        OutVal = PrevSampleVal + (Slope + GlobalHist_MAX_BIN_INDEX / 2) / GlobalHist_MAX_BIN_INDEX;
+        EnhancementTable[BinIndex] = DD_MIN(OutVal, GlobalHist_FIXED_ONE);
+    }
+
+    //No filtering for 0th and last values of the IET.
+    FilteredEnhancementTable[0] = EnhancementTable[0];
+    FilteredEnhancementTable[GlobalHist_MAX_BIN_INDEX] = EnhancementTable[GlobalHist_MAX_BIN_INDEX];
+
+    for (uint32_t BinIndex = 1; BinIndex < GlobalHist_MAX_BIN_INDEX; BinIndex++)
+    {
+        FilteredEnhancementTable[BinIndex] = (EnhancementTable[BinIndex - 1] + EnhancementTable[BinIndex] + EnhancementTable[BinIndex + 1] + 1) / 3;
+    }
+
+    // IET entry k samples the table at k * 31 / 32, kept in units of 1/32 bin so the interpolation
+    // is exact. With V the interpolated value, the 1.9 sample is V / (k / 32) rounded.
+    for (uint32_t IetIndex = 1; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        uint32_t Position = IetIndex * GlobalHist_MAX_BIN_INDEX;
+        uint32_t Index1 = Position / GlobalHist_MAX_IET_INDEX;
+        uint32_t Index2 = DD_MIN(Index1 + 1, GlobalHist_MAX_BIN_INDEX);
+        int64_t Interpolator = Position % GlobalHist_MAX_IET_INDEX;
+        int64_t ScaledVal;
+        uint64_t IetVal;
+
+        ScaledVal = GlobalHist_MAX_IET_INDEX * FilteredEnhancementTable[Index1] + Interpolator * (FilteredEnhancementTable[Index2] - FilteredEnhancementTable[Index1]);
+        ScaledVal = DD_MIN(ScaledVal, (int64_t)GlobalHist_MAX_IET_INDEX << GlobalHist_FIXED_FRACTION_BITS); // Cap IET val to the value that will not cause clipping.
+
+        IetVal = ((uint64_t)ScaledVal * 2 * GlobalHist_IET_SCALE_FACTOR + ((uint64_t)IetIndex << GlobalHist_FIXED_FRACTION_BITS)) /
+                 ((uint64_t)IetIndex << (GlobalHist_FIXED_FRACTION_BITS + 1));
+        IetVal = DD_MIN(IetVal, GlobalHist_IET_MAX_VAL);
+        IetVal = DD_MAX(IetVal, GlobalHist_IET_SCALE_FACTOR); // Never dim any pixel
+
+        pLutTarget[IetIndex] = (uint32_t)IetVal;
+    }
+
+    pLutTarget[0] = pLutTarget[1]; // 0th multiplier sample can't be computed. Extend 1st sample to the 0th
+
+    return TRUE;
+}
+
+uint64_t DisplayGheFixedGetFramePower(const uint32_t *pHistogram)
+{
+    uint64_t FramePower = 0;
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        FramePower += (uint64_t)DeGammaLUT[BinIndex] * pHistogram[BinIndex];
+    }
+
+    return FramePower;
+}
+
+bool DisplayGheFixedIsTargetReached(const uint32_t *pLutApplied, const uint32_t *pLutTarget, uint32_t MinimumStepPercent)
+{
+    for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        uint64_t IETDelta = DD_DIFF(pLutApplied[IetIndex], pLutTarget[IetIndex]);
+
+        if (100 * IETDelta > (uint64_t)MinimumStepPercent * pLutTarget[IetIndex])
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+// Returns the cut off frequency in milli Hz, Q16
+int64_t DisplayGheFixedGetCutOffFrequency(uint64_t FramePowerPrev, uint64_t FramePowerCurr,
+                                          uint32_t MinCutOffFreqInMilliHz, uint32_t MaxCutOffFreqInMilliHz)
+{
+    uint64_t RelativeChange = 0; // Q16
+    int64_t CutOffFreq;          // Milli Hz in Q16
+
+    if (FramePowerPrev > 0)
+    {
+        uint64_t PowerDelta = DD_DIFF(FramePowerCurr, FramePowerPrev);
+
+        if (PowerDelta >= FramePowerPrev)
+        {
+            RelativeChange = GlobalHist_FIXED_ONE;
+        }
+        else
+        {
+            // Keep PowerDelta << 16 within 64 bits
+            while (FramePowerPrev >= (1ull << 47))
+            {
+                FramePowerPrev >>= 1;
+                PowerDelta >>= 1;
+            }
+
+            RelativeChange = (PowerDelta << GlobalHist_FIXED_FRACTION_BITS) / FramePowerPrev;
+        }
+    }
+    else if (FramePowerPrev != FramePowerCurr)
+    {
+        RelativeChange = GlobalHist_FIXED_ONE;
+    }
+
+    CutOffFreq = ((int64_t)MinCutOffFreqInMilliHz << GlobalHist_FIXED_FRACTION_BITS) +
+                 ((int64_t)MaxCutOffFreqInMilliHz - (int64_t)MinCutOffFreqInMilliHz) * (int64_t)RelativeChange;
+
+    return DD_MAX(CutOffFreq, 0);
+}
+
+// Returns the temporal filter coefficient in Q16 for a cut off frequency in milli Hz, Q16
+uint32_t DisplayGheFixedGetIIRFilterCoefficient(int64_t CutOffFreq, uint64_t SamplingPeriodNs)
+{
+    uint64_t MilliHzNs = ((uint64_t)CutOffFreq * SamplingPeriodNs) >> GlobalHist_FIXED_FRACTION_BITS;
+    uint64_t OmegaT = (MilliHzNs * GlobalHist_FIXED_OMEGA) >> 24; // Q32
+
+    return (uint32_t)(((OmegaT << GlobalHist_FIXED_FRACTION_BITS) + (1ull << 31)) / ((1ull << 32) + OmegaT));
+}
+
+static void TemporalFilter(GlobalHist_FIXED_CONTEXT *pFixed, uint32_t FilterCoefficient)
+{
+    for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        int64_t AdjustedValue = (int64_t)pFixed->LutTarget[IetIndex] << GlobalHist_FIXED_FRACTION_BITS;
+
+        // c * x + (1 - c) * h written as h + c * (x - h)
+        for (uint32_t FilterOrder = 0; FilterOrder < GlobalHist_IIR_FILTER_ORDER; FilterOrder++)
+        {
+            int64_t History = pFixed->IETHistory[IetIndex][FilterOrder];
+
+            AdjustedValue = History + ((FilterCoefficient * (AdjustedValue - History) + (1 << (GlobalHist_FIXED_FRACTION_BITS - 1))) >> GlobalHist_FIXED_FRACTION_BITS);
+            pFixed->IETHistory[IetIndex][FilterOrder] = (uint32_t)AdjustedValue;
+        }
+
+        pFixed->LutApplied[IetIndex] = DD_MIN((uint32_t)(AdjustedValue >> GlobalHist_FIXED_FRACTION_BITS), GlobalHist_IET_MAX_VAL);
+    }
+}
+
+// DisplayGheAdvanceFilterClock
+static void AdvanceFilterClock(GlobalHist_FIXED_CONTEXT *pFixed, uint64_t TimestampNs)
+{
+    uint64_t SamplingPeriodNs = GlobalHist_FIXED_SAMPLING_PERIOD_NS;
+
+    if ((0 != TimestampNs) && (0 != pFixed->PrevTimestampNs))
+    {
+        SamplingPeriodNs = (TimestampNs > pFixed->PrevTimestampNs) ? (TimestampNs - pFixed->PrevTimestampNs) : 0;
+        SamplingPeriodNs = DD_MIN(SamplingPeriodNs, GlobalHist_FIXED_PHASE_PERIOD_NS);
+    }
+
+    pFixed->PrevTimestampNs   = TimestampNs;
+    pFixed->SamplingPeriodNs  = SamplingPeriodNs;
+    pFixed->HoldRemainingNs  -= (int64_t)SamplingPeriodNs;
+}
+
+// DisplayGheGetCutOffFrequency
+static int64_t HoldCutOffFrequency(GlobalHist_FIXED_CONTEXT *pFixed, int64_t CutOffFreq)
+{
+    if ((pFixed->HoldRemainingNs > 0) && (CutOffFreq < pFixed->HeldCutOffFreq))
+    {
+        return pFixed->HeldCutOffFreq;
+    }
+
+    pFixed->HeldCutOffFreq  = CutOffFreq;
+    pFixed->HoldRemainingNs = GlobalHist_FIXED_HOLD_NS;
+
+    return CutOffFreq;
+}
+
+void DisplayGheFixedProcess(GlobalHist_FIXED_CONTEXT *pFixed, GlobalHist_ARGS *GheArgs)
+{
+    AdvanceFilterClock(pFixed, GheArgs->TimestampNs);
+
+    if (DisplayGheFixedComputeLutTarget(GheArgs->Histogram, pFixed->LutTarget))
+    {
+        if (DisplayGheFixedIsTargetReached(pFixed->LutApplied, pFixed->LutTarget, pFixed->MinimumStepPercent))
+        {
+            memcpy(pFixed->LutApplied, pFixed->LutTarget, sizeof(pFixed->LutApplied));
+
+            for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+            {
+                for (uint32_t FilterOrder = 0; FilterOrder < GlobalHist_IIR_FILTER_ORDER; FilterOrder++)
+                {
+                    pFixed->IETHistory[IetIndex][FilterOrder] = pFixed->LutTarget[IetIndex] << GlobalHist_FIXED_FRACTION_BITS;
+                }
+            }
+        }
+        else
+        {
+            int64_t CutOffFreq = HoldCutOffFrequency(pFixed, DisplayGheFixedGetCutOffFrequency(DisplayGheFixedGetFramePower(pFixed->PrevHistogram),
+                                                                                               DisplayGheFixedGetFramePower(GheArgs->Histogram),
+                                                                                               pFixed->MinCutOffFreqInMilliHz, pFixed->MaxCutOffFreqInMilliHz));
+
+            TemporalFilter(pFixed, DisplayGheFixedGetIIRFilterCoefficient(CutOffFreq, pFixed->SamplingPeriodNs));
+        }
+
+        memcpy(pFixed->PrevHistogram, GheArgs->Histogram, sizeof(pFixed->PrevHistogram));
+    }
+
+    GheArgs->IsProgramDiet = TRUE;
+    memcpy(GheArgs->DietFactor, pFixed->LutApplied, sizeof(GheArgs->DietFactor));
+}
@@ -0,0 +1,49 @@
+/**
+ *
+ * @file  GHE_FixedPoint.h
+ * @brief  Integer only GHE pipeline for cores without fast double precision math
+ *
+ */
+
+#ifndef _DISPLAY_GHEFIXEDPOINT_H_
+#define _DISPLAY_GHEFIXEDPOINT_H_
+
+#include "GHE_Algorithm.h"
+
+#define GlobalHist_FIXED_FRACTION_BITS 16                                   // Every fraction below is Q16
+#define GlobalHist_FIXED_ONE           (1u << GlobalHist_FIXED_FRACTION_BITS)
+
+// State kept across frames. Needs no allocation, the caller owns the memory.
+typedef struct _GlobalHist_FIXED_CONTEXT
+{
+    uint32_t PrevHistogram[GlobalHist_BIN_COUNT];
+    uint32_t LutTarget[GlobalHist_IET_LUT_LENGTH];
+    uint32_t LutApplied[GlobalHist_IET_LUT_LENGTH];
+    uint32_t IETHistory[GlobalHist_IET_LUT_LENGTH][GlobalHist_IIR_FILTER_ORDER]; // 1.9 values in Q16
+
+    uint32_t MinCutOffFreqInMilliHz;
+    uint32_t MaxCutOffFreqInMilliHz;
+    uint32_t MinimumStepPercent;
+
+    uint64_t PrevTimestampNs;        // As GlobalHist_FILTER_CLOCK
+    uint64_t SamplingPeriodNs;
+    int64_t HeldCutOffFreq;          // Milli Hz in Q16
+    int64_t HoldRemainingNs;
+} GlobalHist_FIXED_CONTEXT;
+
+void DisplayGheFixedInitialize(GlobalHist_FIXED_CONTEXT *pFixed);
+
+// Fixed-point counterpart of DisplayGheProcessFrame. Uses only integer adds, multiplies, shifts and
+// a handful of divides per frame: no pow, ceil or double math. Results track the double path to
+// within a couple of 1.9 LSBs, see tools/ghe_fixed_diff.c. PipeId is left untouched.
+void DisplayGheFixedProcess(GlobalHist_FIXED_CONTEXT *pFixed, GlobalHist_ARGS *GheArgs);
+
+// Stages, exposed for the differential harness
+bool DisplayGheFixedComputeLutTarget(const uint32_t *pHistogram, uint32_t *pLutTarget);
+bool DisplayGheFixedIsTargetReached(const uint32_t *pLutApplied, const uint32_t *pLutTarget, uint32_t MinimumStepPercent);
+int64_t DisplayGheFixedGetCutOffFrequency(uint64_t FramePowerPrev, uint64_t FramePowerCurr,
+                                          uint32_t MinCutOffFreqInMilliHz, uint32_t MaxCutOffFreqInMilliHz);
+uint32_t DisplayGheFixedGetIIRFilterCoefficient(int64_t CutOffFreq, uint64_t SamplingPeriodNs);
+uint64_t DisplayGheFixedGetFramePower(const uint32_t *pHistogram);
+
+#endif
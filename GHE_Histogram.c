@@ -0,0 +1,398 @@
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "GHE_Algorithm.h"
+#include "GHE_Cpu.h"
+#include "GHE_Histogram.h"
+
+#define HISTOGRAM_SUB_COUNT 4            // Interleaved sub-histograms, breaks store-to-load chains on repeated bins
+#define HISTOGRAM_CHUNK_PIXELS 256       // Pixels binned per kernel call
+#define HISTOGRAM_MIN_BAND_PIXELS 65536  // Below this a band is not worth handing to another thread
+#define HISTOGRAM_BIN_SHIFT(Bpc) ((Bpc) - GlobalHist_BIN_COUNT_LOG2)
+
+// Converts PixelCount pixels to bin indices
+typedef void (*PFN_GlobalHistBINNER)(const uint8_t *pSrc, uint32_t PixelCount, uint8_t *pBins);
+
+typedef struct _HISTOGRAM_JOB
+{
+    const GlobalHist_FRAME *pFrame;
+    PFN_GlobalHistBINNER pfnBinner;
+    uint32_t BytesPerPixel;
+    uint32_t RowsPerBand;
+    uint32_t BandHistogram[GlobalHist_MAX_HISTOGRAM_BANDS][GlobalHist_BIN_COUNT];
+} HISTOGRAM_JOB;
+
+typedef struct _TILE_HISTOGRAM_JOB
+{
+    const GlobalHist_FRAME *pFrame;
+    PFN_GlobalHistBINNER pfnBinner;
+    uint32_t BytesPerPixel;
+    uint32_t TilesX;
+    uint32_t TilesY;
+    uint32_t (*pHistogram)[GlobalHist_BIN_COUNT];
+} TILE_HISTOGRAM_JOB;
+
+static void BinRGB888(const uint8_t *pSrc, uint32_t PixelCount, uint8_t *pBins)
+{
+    for (uint32_t Pixel = 0; Pixel < PixelCount; Pixel++, pSrc += 3)
+    {
+        uint8_t MaxVal = DD_MAX(DD_MAX(pSrc[0], pSrc[1]), pSrc[2]);
+        pBins[Pixel] = MaxVal >> HISTOGRAM_BIN_SHIFT(8);
+    }
+}
+
+static void BinRGBA8888(const uint8_t *pSrc, uint32_t PixelCount, uint8_t *pBins)
+{
+    uint32_t Pixel = 0;
+
+#if defined(__SSE2__)
+    const __m128i LowByte = _mm_set1_epi32(0xFF);
+
+    for (; Pixel + 8 <= PixelCount; Pixel += 8)
+    {
+        __m128i Val0 = _mm_loadu_si128((const __m128i *)(pSrc + Pixel * 4));
+        __m128i Val1 = _mm_loadu_si128((const __m128i *)(pSrc + Pixel * 4 + 16));
+        __m128i Max0 = _mm_max_epu8(_mm_max_epu8(Val0, _mm_srli_epi32(Val0, 8)), _mm_srli_epi32(Val0, 16));
+        __m128i Max1 = _mm_max_epu8(_mm_max_epu8(Val1, _mm_srli_epi32(Val1, 8)), _mm_srli_epi32(Val1, 16));
+
+        Max0 = _mm_srli_epi32(_mm_and_si128(Max0, LowByte), HISTOGRAM_BIN_SHIFT(8));
+        Max1 = _mm_srli_epi32(_mm_and_si128(Max1, LowByte), HISTOGRAM_BIN_SHIFT(8));
+        Max0 = _mm_packs_epi32(Max0, Max1);
+        Max0 = _mm_packus_epi16(Max0, Max0);
+        _mm_storel_epi64((__m128i *)(pBins + Pixel), Max0);
+    }
+#endif
+
+    for (; Pixel < PixelCount; Pixel++)
+    {
+        const uint8_t *pPixel = pSrc + Pixel * 4;
+        uint8_t MaxVal = DD_MAX(DD_MAX(pPixel[0], pPixel[1]), pPixel[2]);
+        pBins[Pixel] = MaxVal >> HISTOGRAM_BIN_SHIFT(8);
+    }
+}
+
+#if GlobalHist_HAS_ISA_DISPATCH
+
+GlobalHist_TARGET_AVX2 static void BinRGBA8888Avx2(const uint8_t *pSrc, uint32_t PixelCount, uint8_t *pBins)
+{
+    const __m256i LowByte = _mm256_set1_epi32(0xFF);
+    uint32_t Pixel = 0;
+
+    for (; Pixel + 8 <= PixelCount; Pixel += 8)
+    {
+        __m256i Val = _mm256_loadu_si256((const __m256i *)(pSrc + Pixel * 4));
+        __m256i MaxVal = _mm256_max_epu8(Val, _mm256_srli_epi32(Val, 8));
+        MaxVal = _mm256_max_epu8(MaxVal, _mm256_srli_epi32(Val, 16));
+        MaxVal = _mm256_srli_epi32(_mm256_and_si256(MaxVal, LowByte), HISTOGRAM_BIN_SHIFT(8));
+
+        // 32 bit lanes down to bytes
+        MaxVal = _mm256_packus_epi32(MaxVal, MaxVal);
+        MaxVal = _mm256_packus_epi16(MaxVal, MaxVal);
+        *(uint32_t *)(pBins + Pixel)     = (uint32_t)_mm256_extract_epi32(MaxVal, 0);
+        *(uint32_t *)(pBins + Pixel + 4) = (uint32_t)_mm256_extract_epi32(MaxVal, 4);
+    }
+
+    BinRGBA8888(pSrc + Pixel * 4, PixelCount - Pixel, pBins + Pixel);
+}
+
+GlobalHist_TARGET_AVX512 static void BinRGBA8888Avx512(const uint8_t *pSrc, uint32_t PixelCount, uint8_t *pBins)
+{
+    const __m512i LowByte = _mm512_set1_epi32(0xFF);
+    uint32_t Pixel = 0;
+
+    for (; Pixel + 16 <= PixelCount; Pixel += 16)
+    {
+        __m512i Val = _mm512_loadu_si512((const void *)(pSrc + Pixel * 4));
+        __m512i MaxVal = _mm512_max_epu8(_mm512_max_epu8(Val, _mm512_srli_epi32(Val, 8)), _mm512_srli_epi32(Val, 16));
+
+        // Bin indices fit a byte, the truncating down convert packs them in pixel order
+        MaxVal = _mm512_srli_epi32(_mm512_and_si512(MaxVal, LowByte), HISTOGRAM_BIN_SHIFT(8));
+        _mm_storeu_si128((__m128i *)(pBins + Pixel), _mm512_cvtepi32_epi8(MaxVal));
+    }
+
+    BinRGBA8888Avx2(pSrc + Pixel * 4, PixelCount - Pixel, pBins + Pixel);
+}
+
+#endif
+
+static void BinY8(const uint8_t *pSrc, uint32_t PixelCount, uint8_t *pBins)
+{
+    uint32_t Pixel = 0;
+
+#if defined(__SSE2__)
+    const __m128i BinMask = _mm_set1_epi8((char)(GlobalHist_BIN_COUNT - 1));
+
+    for (; Pixel + 16 <= PixelCount; Pixel += 16)
+    {
+        __m128i Val = _mm_loadu_si128((const __m128i *)(pSrc + Pixel));
+        Val = _mm_and_si128(_mm_srli_epi16(Val, HISTOGRAM_BIN_SHIFT(8)), BinMask);
+        _mm_storeu_si128((__m128i *)(pBins + Pixel), Val);
+    }
+#endif
+
+    for (; Pixel < PixelCount; Pixel++)
+    {
+        pBins[Pixel] = pSrc[Pixel] >> HISTOGRAM_BIN_SHIFT(8);
+    }
+}
+
+static void BinYUYV(const uint8_t *pSrc, uint32_t PixelCount, uint8_t *pBins)
+{
+    uint32_t Pixel = 0;
+
+#if defined(__SSE2__)
+    const __m128i LumaMask = _mm_set1_epi16(0xFF);
+
+    for (; Pixel + 16 <= PixelCount; Pixel += 16)
+    {
+        __m128i Val0 = _mm_loadu_si128((const __m128i *)(pSrc + Pixel * 2));
+        __m128i Val1 = _mm_loadu_si128((const __m128i *)(pSrc + Pixel * 2 + 16));
+        Val0 = _mm_srli_epi16(_mm_and_si128(Val0, LumaMask), HISTOGRAM_BIN_SHIFT(8));
+        Val1 = _mm_srli_epi16(_mm_and_si128(Val1, LumaMask), HISTOGRAM_BIN_SHIFT(8));
+        _mm_storeu_si128((__m128i *)(pBins + Pixel), _mm_packus_epi16(Val0, Val1));
+    }
+#endif
+
+    for (; Pixel < PixelCount; Pixel++)
+    {
+        pBins[Pixel] = pSrc[Pixel * 2] >> HISTOGRAM_BIN_SHIFT(8);
+    }
+}
+
+static void BinRGBA1010102(const uint8_t *pSrc, uint32_t PixelCount, uint8_t *pBins)
+{
+    uint32_t Pixel = 0;
+
+#if defined(__SSE2__)
+    const __m128i ChannelMask = _mm_set1_epi32(0x3FF);
+
+    for (; Pixel + 8 <= PixelCount; Pixel += 8)
+    {
+        __m128i Val0 = _mm_loadu_si128((const __m128i *)(pSrc + Pixel * 4));
+        __m128i Val1 = _mm_loadu_si128((const __m128i *)(pSrc + Pixel * 4 + 16));
+
+        // Channels are below 2^15 with zero upper halves, so the signed 16 bit max is exact
+        __m128i Max0 = _mm_max_epi16(_mm_and_si128(Val0, ChannelMask), _mm_and_si128(_mm_srli_epi32(Val0, 10), ChannelMask));
+        __m128i Max1 = _mm_max_epi16(_mm_and_si128(Val1, ChannelMask), _mm_and_si128(_mm_srli_epi32(Val1, 10), ChannelMask));
+        Max0 = _mm_max_epi16(Max0, _mm_and_si128(_mm_srli_epi32(Val0, 20), ChannelMask));
+        Max1 = _mm_max_epi16(Max1, _mm_and_si128(_mm_srli_epi32(Val1, 20), ChannelMask));
+
+        Max0 = _mm_packs_epi32(_mm_srli_epi32(Max0, HISTOGRAM_BIN_SHIFT(10)), _mm_srli_epi32(Max1, HISTOGRAM_BIN_SHIFT(10)));
+        _mm_storel_epi64((__m128i *)(pBins + Pixel), _mm_packus_epi16(Max0, Max0));
+    }
+#endif
+
+    for (; Pixel < PixelCount; Pixel++)
+    {
+        uint32_t Val;
+        uint32_t MaxVal;
+
+        memcpy(&Val, pSrc + Pixel * 4, sizeof(Val));
+        MaxVal = DD_MAX(DD_MAX(Val & 0x3FF, (Val >> 10) & 0x3FF), (Val >> 20) & 0x3FF);
+        pBins[Pixel] = (uint8_t)(MaxVal >> HISTOGRAM_BIN_SHIFT(10));
+    }
+}
+
+// Shared by the 16 bit luma layouts, Shift moves the 10 bit value down to a bin index
+static inline void BinLuma16(const uint8_t *pSrc, uint32_t PixelCount, uint8_t *pBins, const int Shift)
+{
+    uint32_t Pixel = 0;
+
+#if defined(__SSE2__)
+    const __m128i BinMask = _mm_set1_epi16(GlobalHist_BIN_COUNT - 1);
+
+    for (; Pixel + 16 <= PixelCount; Pixel += 16)
+    {
+        __m128i Val0 = _mm_loadu_si128((const __m128i *)(pSrc + Pixel * 2));
+        __m128i Val1 = _mm_loadu_si128((const __m128i *)(pSrc + Pixel * 2 + 16));
+        Val0 = _mm_and_si128(_mm_srli_epi16(Val0, Shift), BinMask);
+        Val1 = _mm_and_si128(_mm_srli_epi16(Val1, Shift), BinMask);
+        _mm_storeu_si128((__m128i *)(pBins + Pixel), _mm_packus_epi16(Val0, Val1));
+    }
+#endif
+
+    for (; Pixel < PixelCount; Pixel++)
+    {
+        uint16_t Val;
+
+        memcpy(&Val, pSrc + Pixel * 2, sizeof(Val));
+        pBins[Pixel] = (uint8_t)((Val >> Shift) & (GlobalHist_BIN_COUNT - 1));
+    }
+}
+
+static void BinY10(const uint8_t *pSrc, uint32_t PixelCount, uint8_t *pBins)
+{
+    BinLuma16(pSrc, PixelCount, pBins, HISTOGRAM_BIN_SHIFT(10));
+}
+
+static void BinP010(const uint8_t *pSrc, uint32_t PixelCount, uint8_t *pBins)
+{
+    BinLuma16(pSrc, PixelCount, pBins, 16 - GlobalHist_BIN_COUNT_LOG2);
+}
+
+// Per GlobalHist_ISA, only RGBA8888 gains from wider vectors
+static const PFN_GlobalHistBINNER Binner[GlobalHist_ISA_COUNT][GlobalHist_PIXEL_FORMAT_COUNT] =
+{
+    { BinRGB888, BinRGBA8888,       BinY8, BinYUYV, BinRGBA1010102, BinY10, BinP010 },
+#if GlobalHist_HAS_ISA_DISPATCH
+    { BinRGB888, BinRGBA8888Avx2,   BinY8, BinYUYV, BinRGBA1010102, BinY10, BinP010 },
+    { BinRGB888, BinRGBA8888Avx512, BinY8, BinYUYV, BinRGBA1010102, BinY10, BinP010 },
+#else
+    { BinRGB888, BinRGBA8888,       BinY8, BinYUYV, BinRGBA1010102, BinY10, BinP010 },
+    { BinRGB888, BinRGBA8888,       BinY8, BinYUYV, BinRGBA1010102, BinY10, BinP010 },
+#endif
+};
+
+static const uint8_t BytesPerPixel[GlobalHist_PIXEL_FORMAT_COUNT] = { 3, 4, 1, 2, 4, 2, 2 };
+
+uint32_t DisplayGheGetBytesPerPixel(GlobalHist_PIXEL_FORMAT Format)
+{
+    return ((uint32_t)Format < GlobalHist_PIXEL_FORMAT_COUNT) ? BytesPerPixel[Format] : 0;
+}
+
+// Bins PixelCount pixels starting at pSrc into the interleaved sub-histograms
+static inline void CountSpan(PFN_GlobalHistBINNER pfnBinner, uint32_t BytesPerPixel, const uint8_t *pSrc, uint32_t PixelCount,
+                             uint32_t SubHistogram[HISTOGRAM_SUB_COUNT][GlobalHist_BIN_COUNT])
+{
+    uint8_t Bins[HISTOGRAM_CHUNK_PIXELS];
+
+    for (uint32_t Column = 0; Column < PixelCount; Column += HISTOGRAM_CHUNK_PIXELS)
+    {
+        uint32_t ChunkPixels = DD_MIN(PixelCount - Column, HISTOGRAM_CHUNK_PIXELS);
+        uint32_t Pixel = 0;
+
+        pfnBinner(pSrc + (size_t)Column * BytesPerPixel, ChunkPixels, Bins);
+
+        for (; Pixel + HISTOGRAM_SUB_COUNT <= ChunkPixels; Pixel += HISTOGRAM_SUB_COUNT)
+        {
+            SubHistogram[0][Bins[Pixel]]++;
+            SubHistogram[1][Bins[Pixel + 1]]++;
+            SubHistogram[2][Bins[Pixel + 2]]++;
+            SubHistogram[3][Bins[Pixel + 3]]++;
+        }
+
+        for (; Pixel < ChunkPixels; Pixel++)
+        {
+            SubHistogram[0][Bins[Pixel]]++;
+        }
+    }
+}
+
+static inline void FoldSubHistograms(uint32_t SubHistogram[HISTOGRAM_SUB_COUNT][GlobalHist_BIN_COUNT], uint32_t *pHistogram)
+{
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        pHistogram[BinIndex] = SubHistogram[0][BinIndex] + SubHistogram[1][BinIndex] +
+                               SubHistogram[2][BinIndex] + SubHistogram[3][BinIndex];
+    }
+}
+
+// Bins one row band into private sub-histograms and folds them into the band slot
+static void BuildBandHistogram(void *pTaskContext, uint32_t Band)
+{
+    HISTOGRAM_JOB *pJob = (HISTOGRAM_JOB *)pTaskContext;
+    const GlobalHist_FRAME *pFrame = pJob->pFrame;
+    uint32_t SubHistogram[HISTOGRAM_SUB_COUNT][GlobalHist_BIN_COUNT];
+    uint32_t FirstRow = Band * pJob->RowsPerBand;
+    uint32_t LastRow = DD_MIN(FirstRow + pJob->RowsPerBand, pFrame->Height);
+
+    memset(SubHistogram, 0, sizeof(SubHistogram));
+
+    for (uint32_t Row = FirstRow; Row < LastRow; Row++)
+    {
+        CountSpan(pJob->pfnBinner, pJob->BytesPerPixel, (const uint8_t *)pFrame->pData + (size_t)Row * pFrame->Stride, pFrame->Width, SubHistogram);
+    }
+
+    FoldSubHistograms(SubHistogram, pJob->BandHistogram[Band]);
+}
+
+// One task per tile, every tile writes its own histogram so nothing is merged afterwards
+static void BuildTileHistogram(void *pTaskContext, uint32_t Tile)
+{
+    TILE_HISTOGRAM_JOB *pJob = (TILE_HISTOGRAM_JOB *)pTaskContext;
+    const GlobalHist_FRAME *pFrame = pJob->pFrame;
+    uint32_t SubHistogram[HISTOGRAM_SUB_COUNT][GlobalHist_BIN_COUNT];
+    uint32_t TileX = Tile % pJob->TilesX, TileY = Tile / pJob->TilesX;
+    uint32_t FirstColumn = GlobalHist_TILE_START(TileX, pJob->TilesX, pFrame->Width);
+    uint32_t LastColumn = GlobalHist_TILE_START(TileX + 1, pJob->TilesX, pFrame->Width);
+    uint32_t FirstRow = GlobalHist_TILE_START(TileY, pJob->TilesY, pFrame->Height);
+    uint32_t LastRow = GlobalHist_TILE_START(TileY + 1, pJob->TilesY, pFrame->Height);
+
+    memset(SubHistogram, 0, sizeof(SubHistogram));
+
+    for (uint32_t Row = FirstRow; Row < LastRow; Row++)
+    {
+        const uint8_t *pRow = (const uint8_t *)pFrame->pData + (size_t)Row * pFrame->Stride;
+
+        CountSpan(pJob->pfnBinner, pJob->BytesPerPixel, pRow + (size_t)FirstColumn * pJob->BytesPerPixel, LastColumn - FirstColumn, SubHistogram);
+    }
+
+    FoldSubHistograms(SubHistogram, pJob->pHistogram[Tile]);
+}
+
+bool DisplayGheBuildHistogram(const GlobalHist_FRAME *pFrame, GlobalHist_ARGS *GheArgs, GlobalHist_THREAD_POOL *pPool)
+{
+    HISTOGRAM_JOB Job;
+    uint32_t BandCount, MinRowsPerBand;
+    uint32_t Bpp = DisplayGheGetBytesPerPixel(pFrame->Format);
+
+    if ((0 == Bpp) || (NULL == pFrame->pData) || (0 == pFrame->Width) || (0 == pFrame->Height) ||
+        ((uint64_t)pFrame->Width * Bpp > pFrame->Stride))
+    {
+        return FALSE;
+    }
+
+    // Enough bands to keep every thread busy, each band big enough to pay for the hand off
+    MinRowsPerBand = DD_MAX(1, HISTOGRAM_MIN_BAND_PIXELS / pFrame->Width);
+    BandCount = DD_MIN(DisplayGheGetThreadCount(pPool) * 2, GlobalHist_MAX_HISTOGRAM_BANDS);
+    BandCount = DD_MIN(BandCount, (pFrame->Height + MinRowsPerBand - 1) / MinRowsPerBand);
+    BandCount = DD_MAX(BandCount, 1);
+
+    Job.pFrame        = pFrame;
+    Job.pfnBinner     = Binner[DisplayGheGetIsa()][pFrame->Format];
+    Job.BytesPerPixel = Bpp;
+    Job.RowsPerBand   = (pFrame->Height + BandCount - 1) / BandCount;
+    BandCount         = (pFrame->Height + Job.RowsPerBand - 1) / Job.RowsPerBand;
+
+    DisplayGheThreadPoolRun(pPool, BandCount, BuildBandHistogram, &Job);
+
+    memset(GheArgs->Histogram, 0, sizeof(GheArgs->Histogram));
+
+    for (uint32_t Band = 0; Band < BandCount; Band++)
+    {
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            GheArgs->Histogram[BinIndex] += Job.BandHistogram[Band][BinIndex];
+        }
+    }
+
+    GheArgs->Resolution_X = pFrame->Width;
+    GheArgs->Resolution_Y = pFrame->Height;
+
+    return TRUE;
+}
+
+bool DisplayGheBuildTileHistograms(const GlobalHist_FRAME *pFrame, uint32_t TilesX, uint32_t TilesY,
+                                   uint32_t (*pHistogram)[GlobalHist_BIN_COUNT], GlobalHist_THREAD_POOL *pPool)
+{
+    TILE_HISTOGRAM_JOB Job;
+    uint32_t Bpp = DisplayGheGetBytesPerPixel(pFrame->Format);
+
+    if ((0 == Bpp) || (NULL == pFrame->pData) || (0 == TilesX) || (0 == TilesY) ||
+        (pFrame->Width < TilesX) || (pFrame->Height < TilesY) || ((uint64_t)pFrame->Width * Bpp > pFrame->Stride))
+    {
+        return FALSE;
+    }
+
+    Job.pFrame        = pFrame;
+    Job.pfnBinner     = Binner[DisplayGheGetIsa()][pFrame->Format];
+    Job.BytesPerPixel = Bpp;
+    Job.TilesX        = TilesX;
+    Job.TilesY        = TilesY;
+    Job.pHistogram    = pHistogram;
+
+    DisplayGheThreadPoolRun(pPool, TilesX * TilesY, BuildTileHistogram, &Job);
+
+    return TRUE;
+}
@@ -0,0 +1,55 @@
+/**
+ *
+ * @file  GHE_Histogram.h
+ * @brief  Software histogram engine feeding GlobalHist_ARGS::Histogram from frame buffers
+ *
+ */
+
+#ifndef _DISPLAY_GHEHISTOGRAM_H_
+#define _DISPLAY_GHEHISTOGRAM_H_
+
+#include "DisplayPc.h"
+#include "GHE_ThreadPool.h"
+
+#define GlobalHist_BIN_COUNT_LOG2 5        // log2(GlobalHist_BIN_COUNT)
+#define GlobalHist_MAX_HISTOGRAM_BANDS 64  // Upper bound of row bands a frame is split into
+
+// First pixel of tile Index when Size pixels are split into Count tiles
+#define GlobalHist_TILE_START(Index, Count, Size) ((uint32_t)(((uint64_t)(Index) * (Size)) / (Count)))
+
+// Pixel layouts the engine understands. RGB formats are binned on max(R, G, B) and YUV formats
+// on luma, the same value the display hardware histogram is collected on. Channel order inside
+// a pixel does not matter for the max, so BGR(A) buffers use the RGB(A) formats.
+typedef enum _GlobalHist_PIXEL_FORMAT
+{
+    GlobalHist_PIXEL_FORMAT_RGB888 = 0,  // 3 bytes per pixel
+    GlobalHist_PIXEL_FORMAT_RGBA8888,    // 4 bytes per pixel, alpha or padding in the last byte
+    GlobalHist_PIXEL_FORMAT_Y8,          // 8 bit luma plane of planar or semi-planar YUV (I420, NV12, ...)
+    GlobalHist_PIXEL_FORMAT_YUYV,        // Packed 4:2:2, luma in the even bytes
+    GlobalHist_PIXEL_FORMAT_RGBA1010102, // 32 bit little endian, 10 bit channels at bits 0, 10 and 20
+    GlobalHist_PIXEL_FORMAT_Y10,         // 16 bit luma plane, 10 bit value in the low bits (yuv420p10le)
+    GlobalHist_PIXEL_FORMAT_P010,        // 16 bit luma plane, 10 bit value in the high bits
+    GlobalHist_PIXEL_FORMAT_COUNT
+} GlobalHist_PIXEL_FORMAT;
+
+typedef struct _GlobalHist_FRAME
+{
+    const void *pData;               // First pixel of the first row
+    uint32_t Width;                  // In pixels
+    uint32_t Height;                 // In rows
+    uint32_t Stride;                 // Bytes between the starts of two rows
+    GlobalHist_PIXEL_FORMAT Format;
+} GlobalHist_FRAME;
+
+uint32_t DisplayGheGetBytesPerPixel(GlobalHist_PIXEL_FORMAT Format);
+
+// Fills GheArgs->Histogram and the resolution from pFrame. Large frames are split into row bands
+// that run on pPool, which may be NULL to stay on the calling thread. Returns FALSE on a bad frame.
+bool DisplayGheBuildHistogram(const GlobalHist_FRAME *pFrame, GlobalHist_ARGS *GheArgs, GlobalHist_THREAD_POOL *pPool);
+
+// Same binning over a TilesX x TilesY grid. pHistogram[TileY * TilesX + TileX] gets the pixels of
+// the tile, see GlobalHist_TILE_START for the tile boundaries. Tiles run in parallel on pPool.
+bool DisplayGheBuildTileHistograms(const GlobalHist_FRAME *pFrame, uint32_t TilesX, uint32_t TilesY,
+                                   uint32_t (*pHistogram)[GlobalHist_BIN_COUNT], GlobalHist_THREAD_POOL *pPool);
+
+#endif
@@ -0,0 +1,331 @@
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "GHE_Algorithm.h"
+#include "GHE_Cpu.h"
+#include "GHE_LutApply.h"
+
+#define DIET_INPUT_BITS 10                                              // IET is indexed with 10 bit values
+#define DIET_SEGMENT_SHIFT (DIET_INPUT_BITS - GlobalHist_BIN_COUNT_LOG2) // Input bits below the IET entry index
+#define DIET_FRACTION_BITS GlobalHist_DIET_FRACTION_BITS
+#define DIET_MIN_BAND_PIXELS 65536                                      // Below this a band is not worth handing to another thread
+
+typedef struct _DIET_JOB DIET_JOB;
+
+// Applies the LUT to Width pixels of one row
+typedef void (*PFN_GlobalHistDIETROW)(const DIET_JOB *pJob, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width);
+
+struct _DIET_JOB
+{
+    const GlobalHist_FRAME *pFrame;
+    uint8_t *pOutput;
+    uint32_t OutputStride;
+    uint32_t RowsPerBand;
+    PFN_GlobalHistDIETROW pfnRow;
+
+    uint16_t Factor[1 << DIET_INPUT_BITS];    // Interpolated multiplier per max channel / luma value
+    uint16_t Output[1 << DIET_INPUT_BITS];    // Luma formats: final output value per input value
+    uint64_t FactorPattern[256];              // RGBA8888: multiplier replicated on the three color lanes, alpha x1
+};
+
+static inline uint32_t ApplyFactor(uint32_t Value, uint32_t Factor, uint32_t MaxValue)
+{
+    uint32_t Result = (Value * Factor + (1 << (DIET_FRACTION_BITS - 1))) >> DIET_FRACTION_BITS;
+    return DD_MIN(Result, MaxValue);
+}
+
+static void DietRowRGB888(const DIET_JOB *pJob, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    for (uint32_t Pixel = 0; Pixel < Width; Pixel++, pSrc += 3, pDst += 3)
+    {
+        uint8_t R = pSrc[0], G = pSrc[1], B = pSrc[2];
+        uint32_t Factor = pJob->Factor[DD_MAX(DD_MAX(R, G), B)];
+
+        pDst[0] = (uint8_t)ApplyFactor(R, Factor, 255);
+        pDst[1] = (uint8_t)ApplyFactor(G, Factor, 255);
+        pDst[2] = (uint8_t)ApplyFactor(B, Factor, 255);
+    }
+}
+
+static void DietRowRGBA8888(const DIET_JOB *pJob, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    uint32_t Pixel = 0;
+
+#if defined(__SSE2__)
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i LowByte = _mm_set1_epi32(0xFF);
+    const __m128i One = _mm_set1_epi16(1);
+
+    for (; Pixel + 4 <= Width; Pixel += 4)
+    {
+        __m128i Val = _mm_loadu_si128((const __m128i *)(pSrc + Pixel * 4));
+        __m128i MaxVal = _mm_max_epu8(_mm_max_epu8(Val, _mm_srli_epi32(Val, 8)), _mm_srli_epi32(Val, 16));
+        __m128i FactorLo, FactorHi, Lo, Hi;
+        uint32_t MaxChannel[4];
+
+        _mm_storeu_si128((__m128i *)MaxChannel, _mm_and_si128(MaxVal, LowByte));
+        FactorLo = _mm_set_epi64x((long long)pJob->FactorPattern[MaxChannel[1]], (long long)pJob->FactorPattern[MaxChannel[0]]);
+        FactorHi = _mm_set_epi64x((long long)pJob->FactorPattern[MaxChannel[3]], (long long)pJob->FactorPattern[MaxChannel[2]]);
+
+        // (c << 8) * f >> 16 is c * f / 256, one more rounding shift gives (c * f + 256) >> 9
+        Lo = _mm_mulhi_epu16(_mm_slli_epi16(_mm_unpacklo_epi8(Val, Zero), 8), FactorLo);
+        Hi = _mm_mulhi_epu16(_mm_slli_epi16(_mm_unpackhi_epi8(Val, Zero), 8), FactorHi);
+        Lo = _mm_srli_epi16(_mm_add_epi16(Lo, One), 1);
+        Hi = _mm_srli_epi16(_mm_add_epi16(Hi, One), 1);
+
+        _mm_storeu_si128((__m128i *)(pDst + Pixel * 4), _mm_packus_epi16(Lo, Hi));
+    }
+#endif
+
+    for (; Pixel < Width; Pixel++)
+    {
+        const uint8_t *pIn = pSrc + Pixel * 4;
+        uint8_t *pOut = pDst + Pixel * 4;
+        uint8_t R = pIn[0], G = pIn[1], B = pIn[2];
+        uint32_t Factor = pJob->Factor[DD_MAX(DD_MAX(R, G), B)];
+
+        pOut[0] = (uint8_t)ApplyFactor(R, Factor, 255);
+        pOut[1] = (uint8_t)ApplyFactor(G, Factor, 255);
+        pOut[2] = (uint8_t)ApplyFactor(B, Factor, 255);
+        pOut[3] = pIn[3];
+    }
+}
+
+#if GlobalHist_HAS_ISA_DISPATCH
+
+GlobalHist_TARGET_AVX2 static void DietRowRGBA8888Avx2(const DIET_JOB *pJob, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    const __m256i LowByte = _mm256_set1_epi32(0xFF);
+    const __m256i One = _mm256_set1_epi16(1);
+    const __m256i Zero = _mm256_setzero_si256();
+    const long long *pPattern = (const long long *)pJob->FactorPattern;
+    uint32_t Pixel = 0;
+
+    for (; Pixel + 8 <= Width; Pixel += 8)
+    {
+        __m256i Val = _mm256_loadu_si256((const __m256i *)(pSrc + Pixel * 4));
+        __m256i MaxVal = _mm256_max_epu8(_mm256_max_epu8(Val, _mm256_srli_epi32(Val, 8)), _mm256_srli_epi32(Val, 16));
+        __m256i Lo, Hi, FactorLo, FactorHi;
+
+        // unpack works per 128 bit lane: Lo holds pixels 0, 1, 4, 5 and Hi holds 2, 3, 6, 7
+        MaxVal = _mm256_and_si256(MaxVal, LowByte);
+        MaxVal = _mm256_permutevar8x32_epi32(MaxVal, _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7));
+        FactorLo = _mm256_i32gather_epi64(pPattern, _mm256_castsi256_si128(MaxVal), 8);
+        FactorHi = _mm256_i32gather_epi64(pPattern, _mm256_extracti128_si256(MaxVal, 1), 8);
+
+        Lo = _mm256_mulhi_epu16(_mm256_slli_epi16(_mm256_unpacklo_epi8(Val, Zero), 8), FactorLo);
+        Hi = _mm256_mulhi_epu16(_mm256_slli_epi16(_mm256_unpackhi_epi8(Val, Zero), 8), FactorHi);
+        Lo = _mm256_srli_epi16(_mm256_add_epi16(Lo, One), 1);
+        Hi = _mm256_srli_epi16(_mm256_add_epi16(Hi, One), 1);
+
+        _mm256_storeu_si256((__m256i *)(pDst + Pixel * 4), _mm256_packus_epi16(Lo, Hi));
+    }
+
+    DietRowRGBA8888(pJob, pSrc + Pixel * 4, pDst + Pixel * 4, Width - Pixel);
+}
+
+GlobalHist_TARGET_AVX512 static void DietRowRGBA8888Avx512(const DIET_JOB *pJob, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    const __m512i LowByte = _mm512_set1_epi32(0xFF);
+    const __m512i One = _mm512_set1_epi16(1);
+    const __m512i Zero = _mm512_setzero_si512();
+    const __m512i LoHiOrder = _mm512_setr_epi32(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+    uint32_t Pixel = 0;
+
+    for (; Pixel + 16 <= Width; Pixel += 16)
+    {
+        __m512i Val = _mm512_loadu_si512((const void *)(pSrc + Pixel * 4));
+        __m512i MaxVal = _mm512_max_epu8(_mm512_max_epu8(Val, _mm512_srli_epi32(Val, 8)), _mm512_srli_epi32(Val, 16));
+        __m512i Lo, Hi, FactorLo, FactorHi;
+
+        // As in the AVX2 kernel, per 128 bit lane Lo holds pixels 0, 1 and Hi pixels 2, 3
+        MaxVal = _mm512_permutexvar_epi32(LoHiOrder, _mm512_and_si512(MaxVal, LowByte));
+        FactorLo = _mm512_i32gather_epi64(_mm512_castsi512_si256(MaxVal), (const void *)pJob->FactorPattern, 8);
+        FactorHi = _mm512_i32gather_epi64(_mm512_extracti64x4_epi64(MaxVal, 1), (const void *)pJob->FactorPattern, 8);
+
+        Lo = _mm512_mulhi_epu16(_mm512_slli_epi16(_mm512_unpacklo_epi8(Val, Zero), 8), FactorLo);
+        Hi = _mm512_mulhi_epu16(_mm512_slli_epi16(_mm512_unpackhi_epi8(Val, Zero), 8), FactorHi);
+        Lo = _mm512_srli_epi16(_mm512_add_epi16(Lo, One), 1);
+        Hi = _mm512_srli_epi16(_mm512_add_epi16(Hi, One), 1);
+
+        _mm512_storeu_si512((void *)(pDst + Pixel * 4), _mm512_packus_epi16(Lo, Hi));
+    }
+
+    DietRowRGBA8888Avx2(pJob, pSrc + Pixel * 4, pDst + Pixel * 4, Width - Pixel);
+}
+
+#endif
+
+static void DietRowY8(const DIET_JOB *pJob, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    for (uint32_t Pixel = 0; Pixel < Width; Pixel++)
+    {
+        pDst[Pixel] = (uint8_t)pJob->Output[pSrc[Pixel]];
+    }
+}
+
+static void DietRowYUYV(const DIET_JOB *pJob, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    for (uint32_t Pixel = 0; Pixel < Width; Pixel++)
+    {
+        pDst[Pixel * 2]     = (uint8_t)pJob->Output[pSrc[Pixel * 2]];
+        pDst[Pixel * 2 + 1] = pSrc[Pixel * 2 + 1];
+    }
+}
+
+static void DietRowRGBA1010102(const DIET_JOB *pJob, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    for (uint32_t Pixel = 0; Pixel < Width; Pixel++)
+    {
+        uint32_t Val, R, G, B, Factor;
+
+        memcpy(&Val, pSrc + Pixel * 4, sizeof(Val));
+        R = Val & 0x3FF;
+        G = (Val >> 10) & 0x3FF;
+        B = (Val >> 20) & 0x3FF;
+        Factor = pJob->Factor[DD_MAX(DD_MAX(R, G), B)];
+
+        Val = (Val & 0xC0000000) | ApplyFactor(R, Factor, 0x3FF) | (ApplyFactor(G, Factor, 0x3FF) << 10) | (ApplyFactor(B, Factor, 0x3FF) << 20);
+        memcpy(pDst + Pixel * 4, &Val, sizeof(Val));
+    }
+}
+
+static void DietRowY10(const DIET_JOB *pJob, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    for (uint32_t Pixel = 0; Pixel < Width; Pixel++)
+    {
+        uint16_t Val;
+
+        memcpy(&Val, pSrc + Pixel * 2, sizeof(Val));
+        Val = pJob->Output[Val & 0x3FF];
+        memcpy(pDst + Pixel * 2, &Val, sizeof(Val));
+    }
+}
+
+static void DietRowP010(const DIET_JOB *pJob, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    for (uint32_t Pixel = 0; Pixel < Width; Pixel++)
+    {
+        uint16_t Val;
+
+        memcpy(&Val, pSrc + Pixel * 2, sizeof(Val));
+        Val = (uint16_t)(pJob->Output[Val >> 6] << 6);
+        memcpy(pDst + Pixel * 2, &Val, sizeof(Val));
+    }
+}
+
+// Per GlobalHist_ISA, only RGBA8888 gains from wider vectors
+static const PFN_GlobalHistDIETROW DietRow[GlobalHist_ISA_COUNT][GlobalHist_PIXEL_FORMAT_COUNT] =
+{
+    { DietRowRGB888, DietRowRGBA8888,       DietRowY8, DietRowYUYV, DietRowRGBA1010102, DietRowY10, DietRowP010 },
+#if GlobalHist_HAS_ISA_DISPATCH
+    { DietRowRGB888, DietRowRGBA8888Avx2,   DietRowY8, DietRowYUYV, DietRowRGBA1010102, DietRowY10, DietRowP010 },
+    { DietRowRGB888, DietRowRGBA8888Avx512, DietRowY8, DietRowYUYV, DietRowRGBA1010102, DietRowY10, DietRowP010 },
+#else
+    { DietRowRGB888, DietRowRGBA8888,       DietRowY8, DietRowYUYV, DietRowRGBA1010102, DietRowY10, DietRowP010 },
+    { DietRowRGB888, DietRowRGBA8888,       DietRowY8, DietRowYUYV, DietRowRGBA1010102, DietRowY10, DietRowP010 },
+#endif
+};
+
+static const uint8_t BitsPerChannel[GlobalHist_PIXEL_FORMAT_COUNT] = { 8, 8, 8, 8, 10, 10, 10 };
+
+// Hardware style interpolation between the two IET entries enclosing a 10 bit input
+static uint32_t InterpolateDietFactor(const uint32_t *pDietFactor, uint32_t Value)
+{
+    uint32_t Segment  = Value >> DIET_SEGMENT_SHIFT;
+    uint32_t Fraction = Value & ((1 << DIET_SEGMENT_SHIFT) - 1);
+    uint32_t Factor1  = DD_MIN(pDietFactor[Segment], GlobalHist_IET_MAX_VAL);
+    uint32_t Factor2  = DD_MIN(pDietFactor[Segment + 1], GlobalHist_IET_MAX_VAL);
+
+    return (Factor1 * ((1 << DIET_SEGMENT_SHIFT) - Fraction) + Factor2 * Fraction + (1 << (DIET_SEGMENT_SHIFT - 1))) >> DIET_SEGMENT_SHIFT;
+}
+
+uint32_t DisplayGheGetBitsPerChannel(GlobalHist_PIXEL_FORMAT Format)
+{
+    return ((uint32_t)Format < GlobalHist_PIXEL_FORMAT_COUNT) ? BitsPerChannel[Format] : 0;
+}
+
+void DisplayGheBuildDietFactorTable(const uint32_t DietFactor[GlobalHist_IET_LUT_LENGTH], uint32_t Bpc, uint16_t *pFactor)
+{
+    for (uint32_t Value = 0; Value < (1u << Bpc); Value++)
+    {
+        uint32_t Value10 = (Value << (DIET_INPUT_BITS - Bpc)) | (Value >> (2 * Bpc - DIET_INPUT_BITS));
+
+        pFactor[Value] = (uint16_t)InterpolateDietFactor(DietFactor, Value10);
+    }
+}
+
+static void BuildDietTables(DIET_JOB *pJob, const uint32_t *pDietFactor, uint32_t Bpc)
+{
+    uint32_t Levels = 1 << Bpc;
+    uint32_t MaxValue = Levels - 1;
+
+    for (uint32_t Value = 0; Value < Levels; Value++)
+    {
+        // Expand to 10 bit by bit replication so that full scale maps to full scale
+        uint32_t Value10 = (Value << (DIET_INPUT_BITS - Bpc)) | (Value >> (2 * Bpc - DIET_INPUT_BITS));
+        uint32_t Factor = InterpolateDietFactor(pDietFactor, Value10);
+
+        pJob->Factor[Value] = (uint16_t)Factor;
+        pJob->Output[Value] = (uint16_t)ApplyFactor(Value, Factor, MaxValue);
+    }
+
+    if (8 == Bpc)
+    {
+        for (uint32_t Value = 0; Value < Levels; Value++)
+        {
+            uint64_t Factor = pJob->Factor[Value];
+            pJob->FactorPattern[Value] = ((uint64_t)(1 << DIET_FRACTION_BITS) << 48) | (Factor << 32) | (Factor << 16) | Factor;
+        }
+    }
+}
+
+static void ApplyDietBand(void *pTaskContext, uint32_t Band)
+{
+    DIET_JOB *pJob = (DIET_JOB *)pTaskContext;
+    const GlobalHist_FRAME *pFrame = pJob->pFrame;
+    uint32_t FirstRow = Band * pJob->RowsPerBand;
+    uint32_t LastRow = DD_MIN(FirstRow + pJob->RowsPerBand, pFrame->Height);
+
+    for (uint32_t Row = FirstRow; Row < LastRow; Row++)
+    {
+        pJob->pfnRow(pJob,
+                     (const uint8_t *)pFrame->pData + (size_t)Row * pFrame->Stride,
+                     pJob->pOutput + (size_t)Row * pJob->OutputStride,
+                     pFrame->Width);
+    }
+}
+
+bool DisplayGheApplyDiet(const GlobalHist_FRAME *pFrame, void *pOutput, uint32_t OutputStride,
+                         const uint32_t DietFactor[GlobalHist_IET_LUT_LENGTH], GlobalHist_THREAD_POOL *pPool)
+{
+    DIET_JOB Job;
+    uint32_t BandCount, MinRowsPerBand;
+    uint32_t Bpp = DisplayGheGetBytesPerPixel(pFrame->Format);
+
+    if ((0 == Bpp) || (NULL == pFrame->pData) || (NULL == pOutput) || (0 == pFrame->Width) || (0 == pFrame->Height) ||
+        ((uint64_t)pFrame->Width * Bpp > pFrame->Stride) || ((uint64_t)pFrame->Width * Bpp > OutputStride))
+    {
+        return FALSE;
+    }
+
+    Job.pFrame       = pFrame;
+    Job.pOutput      = (uint8_t *)pOutput;
+    Job.OutputStride = OutputStride;
+    Job.pfnRow       = DietRow[DisplayGheGetIsa()][pFrame->Format];
+
+    BuildDietTables(&Job, DietFactor, BitsPerChannel[pFrame->Format]);
+
+    MinRowsPerBand = DD_MAX(1, DIET_MIN_BAND_PIXELS / pFrame->Width);
+    BandCount = DisplayGheGetThreadCount(pPool) * 2;
+    BandCount = DD_MIN(BandCount, (pFrame->Height + MinRowsPerBand - 1) / MinRowsPerBand);
+    BandCount = DD_MAX(BandCount, 1);
+
+    Job.RowsPerBand = (pFrame->Height + BandCount - 1) / BandCount;
+    BandCount       = (pFrame->Height + Job.RowsPerBand - 1) / Job.RowsPerBand;
+
+    DisplayGheThreadPoolRun(pPool, BandCount, ApplyDietBand, &Job);
+
+    return TRUE;
+}
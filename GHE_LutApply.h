@@ -0,0 +1,35 @@
+/**
+ *
+ * @file  GHE_LutApply.h
+ * @brief  Software application of the DIET multiplier LUT to frame buffers
+ *
+ */
+
+#ifndef _DISPLAY_GHELUTAPPLY_H_
+#define _DISPLAY_GHELUTAPPLY_H_
+
+#include "DisplayPc.h"
+#include "GHE_Histogram.h"
+#include "GHE_ThreadPool.h"
+
+#define GlobalHist_DIET_FRACTION_BITS 9 // Applied multipliers are 1.9 fixed point
+
+// Does in software what the display hardware does with GlobalHist_ARGS::DietFactor.
+// Every pixel is indexed by the same max(R, G, B) / luma value the histogram is built from,
+// expanded to 10 bit. The 1.9 multiplier is linearly interpolated between the two enclosing
+// IET entries and applied to the color channels with rounding and saturation. Alpha and chroma
+// are passed through.
+//
+// pOutput may be pFrame->pData with the same stride for in-place operation. pOutput gets the
+// same format and size as pFrame. Returns FALSE on a bad frame.
+bool DisplayGheApplyDiet(const GlobalHist_FRAME *pFrame, void *pOutput, uint32_t OutputStride,
+                         const uint32_t DietFactor[GlobalHist_IET_LUT_LENGTH], GlobalHist_THREAD_POOL *pPool);
+
+// Channel depth of Format, 0 for an unknown format
+uint32_t DisplayGheGetBitsPerChannel(GlobalHist_PIXEL_FORMAT Format);
+
+// The multiplier DisplayGheApplyDiet uses for every max channel / luma value of a Bpc bit
+// channel, pFactor has 1 << Bpc entries. For callers blending several LUTs per pixel.
+void DisplayGheBuildDietFactorTable(const uint32_t DietFactor[GlobalHist_IET_LUT_LENGTH], uint32_t Bpc, uint16_t *pFactor);
+
+#endif
@@ -0,0 +1,424 @@
+#include "GHE_Algorithm.h"
+#include "GHE_Cpu.h"
+#include "GHE_DeGamma.h"
+#include "GHE_Engine.h"
+#include "GHE_MultiChannel.h"
+
+#define CHANNEL_LANES 4 // GlobalHist_CHANNEL_COUNT rounded up to a vector, the spare lane sees an empty frame
+
+// One lane per channel. Four lanes are too few for the loop vectorizer, so the kernel is written
+// on vector types directly: one AVX2 / AVX-512 VL register, two SSE2 registers on the baseline.
+// Comparisons give all ones lanes, selects are bitwise so they match the scalar ternaries exactly.
+typedef double CHANNEL_DOUBLE __attribute__((vector_size(CHANNEL_LANES * sizeof(double))));
+typedef int64_t CHANNEL_MASK __attribute__((vector_size(CHANNEL_LANES * sizeof(int64_t))));
+typedef uint32_t CHANNEL_UINT __attribute__((vector_size(CHANNEL_LANES * sizeof(uint32_t))));
+typedef int32_t CHANNEL_INT __attribute__((vector_size(CHANNEL_LANES * sizeof(int32_t))));
+
+#define CHANNEL_SELECT(Mask, a, b)   ((CHANNEL_DOUBLE)(((Mask) & (CHANNEL_MASK)(a)) | (~(Mask) & (CHANNEL_MASK)(b))))
+#define CHANNEL_SELECT_U(Mask, a, b) ((((CHANNEL_UINT)__builtin_convertvector(Mask, CHANNEL_INT)) & (a)) | \
+                                      (~((CHANNEL_UINT)__builtin_convertvector(Mask, CHANNEL_INT)) & (b)))
+#define CHANNEL_MIN(a, b)            CHANNEL_SELECT((a) < (b), a, b) // DD_MIN
+#define CHANNEL_MAX(a, b)            CHANNEL_SELECT((a) < (b), b, a) // DD_MAX
+#define CHANNEL_TO_DOUBLE(v)         __builtin_convertvector(v, CHANNEL_DOUBLE)
+
+// Per channel state interleaved: entry k of every channel is one vector
+struct _GlobalHist_MULTI_CHANNEL_CONTEXT
+{
+    CHANNEL_UINT PrevHistogram[GlobalHist_BIN_COUNT];
+    CHANNEL_DOUBLE PrevFramePower;                              // Linked, the power of the mean PrevHistogram in every lane
+    CHANNEL_UINT LutTarget[GlobalHist_IET_LUT_LENGTH];
+    CHANNEL_UINT LutApplied[GlobalHist_IET_LUT_LENGTH];
+    CHANNEL_DOUBLE IETHistory[GlobalHist_IET_LUT_LENGTH][GlobalHist_IIR_FILTER_ORDER];
+    GlobalHist_FILTER_CLOCK Clock[GlobalHist_CHANNEL_COUNT];    // Linked, Clock[0] only
+
+    PIPE_ID Pipe;
+    GlobalHist_CHANNEL_MODE Mode;
+    const double *pDeGammaLUT;
+    uint32_t MinCutOffFreqInMilliHz;
+    uint32_t MaxCutOffFreqInMilliHz;
+    double MinimumStepPercent;
+    double MinSlope;
+    double MaxSlope;
+
+    GlobalHist_TRANSFER_FUNCTION TransferFunction;
+    GlobalHist_CFG GheCfg;
+    GlobalHist_MULTI_CHANNEL_STATS Stats;
+};
+
+GlobalHist_MULTI_CHANNEL_CONTEXT *DisplayGheCreateMultiChannel(PIPE_ID Pipe, GlobalHist_CHANNEL_MODE Mode)
+{
+    GlobalHist_MULTI_CHANNEL_CONTEXT *pContext;
+    GlobalHist_CFG Cfg;
+
+    if ((GlobalHist_CHANNELS_INDEPENDENT != Mode) && (GlobalHist_CHANNELS_LINKED != Mode))
+    {
+        return NULL;
+    }
+
+    // Vector members want their natural alignment, malloc only guarantees 16 bytes
+    if (0 != posix_memalign((void **)&pContext, 64, sizeof(GlobalHist_MULTI_CHANNEL_CONTEXT)))
+    {
+        return NULL;
+    }
+
+    memset(pContext, 0, sizeof(GlobalHist_MULTI_CHANNEL_CONTEXT));
+    pContext->Pipe = Pipe;
+    pContext->Mode = Mode;
+
+    // Same initial state as DisplayInitializeAlgorithmState on a zeroed context
+    for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        pContext->LutTarget[IetIndex]  = (CHANNEL_UINT){ 0 } + GlobalHist_IET_SCALE_FACTOR;
+        pContext->LutApplied[IetIndex] = (CHANNEL_UINT){ 0 } + GlobalHist_IET_SCALE_FACTOR;
+
+        for (uint32_t FilterOrder = 0; FilterOrder < GlobalHist_IIR_FILTER_ORDER; FilterOrder++)
+        {
+            pContext->IETHistory[IetIndex][FilterOrder] = (CHANNEL_DOUBLE){ 0 } + GlobalHist_IET_SCALE_FACTOR;
+        }
+    }
+
+    for (uint32_t Channel = 0; Channel < GlobalHist_CHANNEL_COUNT; Channel++)
+    {
+        DisplayGheInitializeFilterClock(&pContext->Clock[Channel]);
+    }
+
+    pContext->TransferFunction = GlobalHist_TRANSFER_SRGB;
+    pContext->pDeGammaLUT      = DisplayGheGetDeGammaLUT(GlobalHist_TRANSFER_SRGB, GlobalHist_BIN_COUNT);
+
+    DisplayGheGetDefaultConfig(&Cfg);
+    DisplayGheMultiChannelSetConfig(pContext, &Cfg);
+
+    return pContext;
+}
+
+void DisplayGheDestroyMultiChannel(GlobalHist_MULTI_CHANNEL_CONTEXT *pContext)
+{
+    free(pContext);
+}
+
+bool DisplayGheMultiChannelSetConfig(GlobalHist_MULTI_CHANNEL_CONTEXT *pContext, const GlobalHist_CFG *pCfg)
+{
+    if (FALSE == DisplayGheIsValidConfig(pCfg))
+    {
+        return FALSE;
+    }
+
+    pContext->GheCfg                 = *pCfg;
+    pContext->MinCutOffFreqInMilliHz = (uint32_t)(pCfg->MinIIRCutOffFreq * 1000 + 0.5);
+    pContext->MaxCutOffFreqInMilliHz = (uint32_t)(pCfg->MaxIIRCutOffFreq * 1000 + 0.5);
+    pContext->MinimumStepPercent     = pCfg->MinimumStepPercent;
+    pContext->MinSlope               = pCfg->MinSlope;
+    pContext->MaxSlope               = pCfg->MaxSlope;
+
+    for (uint32_t Channel = 0; Channel < GlobalHist_CHANNEL_COUNT; Channel++)
+    {
+        DisplayGheSetFilterClockLimits(&pContext->Clock[Channel], pCfg);
+    }
+
+    return TRUE;
+}
+
+bool DisplayGheMultiChannelSetTransferFunction(GlobalHist_MULTI_CHANNEL_CONTEXT *pContext, GlobalHist_TRANSFER_FUNCTION TransferFunction)
+{
+    const double *pDeGammaLUT = DisplayGheGetDeGammaLUT(TransferFunction, GlobalHist_BIN_COUNT);
+    uint32_t Histogram[GlobalHist_CHANNEL_COUNT][GlobalHist_BIN_COUNT];
+    double MeanPower = 0;
+
+    if (NULL == pDeGammaLUT)
+    {
+        return FALSE;
+    }
+
+    // The previous frame power was weighted with the old curve
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        double MeanBin = 0;
+
+        for (uint32_t Channel = 0; Channel < GlobalHist_CHANNEL_COUNT; Channel++)
+        {
+            Histogram[Channel][BinIndex] = pContext->PrevHistogram[BinIndex][Channel];
+            MeanBin += (double)Histogram[Channel][BinIndex];
+        }
+
+        // In the order of the power prefix sums of MultiChannelProcessBody
+        MeanPower += pDeGammaLUT[BinIndex] * (MeanBin / GlobalHist_CHANNEL_COUNT);
+    }
+
+    for (uint32_t Channel = 0; Channel < GlobalHist_CHANNEL_COUNT; Channel++)
+    {
+        pContext->PrevFramePower[Channel] = (GlobalHist_CHANNELS_LINKED == pContext->Mode) ? MeanPower :
+                                            DisplayGheEngine_32_33_GetFramePower(Histogram[Channel], pDeGammaLUT);
+    }
+
+    pContext->TransferFunction = TransferFunction;
+    pContext->pDeGammaLUT      = pDeGammaLUT;
+
+    return TRUE;
+}
+
+// One frame of every channel, the stages and arithmetic of GHE_Batch.c with a lane per channel.
+// Linked contexts compute the statistics in lane 0 from the mean histogram and broadcast them.
+GlobalHist_ISA_BODY void MultiChannelProcessBody(GlobalHist_MULTI_CHANNEL_CONTEXT *pContext, GlobalHist_MULTI_CHANNEL_ARGS *pArgs)
+{
+    const bool IsLinked = (GlobalHist_CHANNELS_LINKED == pContext->Mode);
+    const uint32_t ClockCount = IsLinked ? 1 : GlobalHist_CHANNEL_COUNT;
+    const CHANNEL_MASK Broadcast = { 0, 0, 0, 3 }; // Lane 0 to the channel lanes, the spare lane keeps its own
+    const double MaxHistBinIndex = GlobalHist_MAX_BIN_INDEX;
+    const double IetLutStepSize = 1.0 / (double)GlobalHist_MAX_IET_INDEX;
+    const double HistBinStepSize = 1.0 / MaxHistBinIndex;
+    const CHANNEL_DOUBLE MaxSlope = (CHANNEL_DOUBLE){ 0 } + pContext->MaxSlope;
+    const CHANNEL_DOUBLE MinSlope = (CHANNEL_DOUBLE){ 0 } + pContext->MinSlope;
+    const CHANNEL_DOUBLE One = (CHANNEL_DOUBLE){ 0 } + 1.0;
+    const CHANNEL_DOUBLE IetScaleFactor = (CHANNEL_DOUBLE){ 0 } + GlobalHist_IET_SCALE_FACTOR;
+    const CHANNEL_DOUBLE IetMaxVal = (CHANNEL_DOUBLE){ 0 } + GlobalHist_IET_MAX_VAL;
+    const double MinimumStepPercent = pContext->MinimumStepPercent;
+    const double MinCutoffFreq = MILLIUNIT_TO_UNIT((double)DD_MIN(pContext->MinCutOffFreqInMilliHz, pContext->MaxCutOffFreqInMilliHz));
+    const double MaxCutoffFreq = MILLIUNIT_TO_UNIT((double)DD_MAX(pContext->MinCutOffFreqInMilliHz, pContext->MaxCutOffFreqInMilliHz));
+    const double WindowSizeToProbabilityMapping[SOLID_COLOR_SEARCH_WINDOW_SIZE] = SOLID_COLOR_WINDOW_PROBABILITY;
+
+    CHANNEL_UINT Histogram[GlobalHist_BIN_COUNT];
+    CHANNEL_UINT CumulativeHistogram[GlobalHist_BIN_COUNT];
+    CHANNEL_DOUBLE PowerPrefix[GlobalHist_BIN_COUNT + 1];
+    CHANNEL_DOUBLE EnhancementTable[GlobalHist_BIN_COUNT];
+    CHANNEL_DOUBLE FilteredEnhancementTable[GlobalHist_BIN_COUNT];
+    CHANNEL_UINT TotalNumOfPixel = { 0 };
+    CHANNEL_DOUBLE SumPower, SolidColorProbability = { 0 }, SolidColorThreshold, Histogram0, CDFRange, CdfNormalizingFactor;
+    CHANNEL_DOUBLE FilterCoefficient = { 0 };
+    CHANNEL_MASK IsSolidColor, IsTargetReached = ~(CHANNEL_MASK){ 0 }, IsSnapToTarget;
+
+    // Interleave the channels with their cumulative histogram and power prefix sums, one pass as
+    // in the engine's Analyze. The spare lane sees an empty frame, which is classified as solid
+    // color and leaves its state untouched.
+    PowerPrefix[0] = (CHANNEL_DOUBLE){ 0 };
+
+    GHE_UNROLL(GlobalHist_BIN_COUNT)
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        CHANNEL_UINT Bin = { pArgs->Histogram[0][BinIndex], pArgs->Histogram[1][BinIndex], pArgs->Histogram[2][BinIndex], 0 };
+        // 3 * h / 3 is exact, three identical linked channels see the statistics of one
+        CHANNEL_DOUBLE StatisticsBin = IsLinked ? (CHANNEL_DOUBLE){ ((double)Bin[0] + (double)Bin[1] + (double)Bin[2]) / GlobalHist_CHANNEL_COUNT, 0, 0, 0 } :
+                                                  CHANNEL_TO_DOUBLE(Bin);
+
+        Histogram[BinIndex] = Bin;
+        TotalNumOfPixel += Bin;
+        CumulativeHistogram[BinIndex] = TotalNumOfPixel;
+
+        PowerPrefix[BinIndex + 1] = PowerPrefix[BinIndex] + pContext->pDeGammaLUT[BinIndex] * StatisticsBin;
+    }
+
+    // Solid color estimation. The smallest window holding the threshold power decides, the hits of
+    // one window size are OR reduced without a dependency between bins.
+    SumPower            = PowerPrefix[GlobalHist_BIN_COUNT];
+    SolidColorThreshold = SOLID_COLOR_POWER_THRESHOLD * SumPower;
+
+    for (uint32_t N = 1; N <= SOLID_COLOR_SEARCH_WINDOW_SIZE; N++)
+    {
+        CHANNEL_MASK IsHit = { 0 };
+
+        GHE_UNROLL(GlobalHist_BIN_COUNT)
+        for (uint32_t BinIndex = 0; BinIndex < (GlobalHist_BIN_COUNT - N + 1); BinIndex++)
+        {
+            IsHit |= ((PowerPrefix[BinIndex + N] - PowerPrefix[BinIndex]) >= SolidColorThreshold);
+        }
+
+        SolidColorProbability = CHANNEL_SELECT(IsHit & (0 == SolidColorProbability), (CHANNEL_DOUBLE){ 0 } + WindowSizeToProbabilityMapping[N - 1],
+                                               SolidColorProbability);
+    }
+
+    if (IsLinked)
+    {
+        SumPower              = __builtin_shuffle(SumPower, Broadcast);
+        SolidColorProbability = __builtin_shuffle(SolidColorProbability, Broadcast);
+    }
+
+    IsSolidColor         = (1 == SolidColorProbability);
+    Histogram0           = CHANNEL_TO_DOUBLE(Histogram[0]);
+    CDFRange             = CHANNEL_TO_DOUBLE(CumulativeHistogram[GlobalHist_MAX_BIN_INDEX]) - Histogram0;
+    CdfNormalizingFactor = CHANNEL_SELECT(CDFRange > 0, One / CDFRange, (CHANNEL_DOUBLE){ 0 });
+    EnhancementTable[0]  = (CHANNEL_TO_DOUBLE(CumulativeHistogram[0]) - Histogram0) * CdfNormalizingFactor;
+
+    // Slope clamped CDF, with the 3 tap smoothing of bin i - 1 done as soon as bin i is known
+    FilteredEnhancementTable[0] = EnhancementTable[0];
+
+    GHE_UNROLL(GlobalHist_BIN_COUNT)
+    for (uint32_t BinIndex = 1; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        CHANNEL_DOUBLE OutVal = (CHANNEL_TO_DOUBLE(CumulativeHistogram[BinIndex]) - Histogram0) * CdfNormalizingFactor;
+        CHANNEL_DOUBLE PrevSampleVal = EnhancementTable[BinIndex - 1];
+        CHANNEL_DOUBLE Slope = MaxHistBinIndex * (OutVal - PrevSampleVal);
+
+        Slope = CHANNEL_MAX(Slope, MinSlope);
+        Slope = CHANNEL_MIN(Slope, MaxSlope);
+
+        OutVal = PrevSampleVal + Slope * HistBinStepSize;
+        OutVal = CHANNEL_MIN(OutVal, One);
+
+        EnhancementTable[BinIndex] = OutVal;
+
+        if (BinIndex >= 2)
+        {
+            FilteredEnhancementTable[BinIndex - 1] = 0.333333 * (EnhancementTable[BinIndex - 2] + EnhancementTable[BinIndex - 1] + EnhancementTable[BinIndex]);
+        }
+    }
+
+    FilteredEnhancementTable[GlobalHist_MAX_BIN_INDEX] = EnhancementTable[GlobalHist_MAX_BIN_INDEX];
+
+    // Convert to IET LUT. Solid color channels get the identity LUT. Once unrolled the sample
+    // positions, interpolation indices and weights are compile-time constants.
+    GHE_UNROLL(GlobalHist_IET_LUT_LENGTH)
+    for (uint32_t IetIndex = 1; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        const double BinIndexNormalized = (double)IetIndex * IetLutStepSize;
+        const double DIndex = BinIndexNormalized * MaxHistBinIndex;
+        const uint32_t Index1 = (uint32_t)DIndex;
+        const uint32_t Index2 = (uint32_t)(ceil(DIndex));
+        const double Interpolator = DIndex - (double)Index1;
+        CHANNEL_DOUBLE IetVal;
+
+        IetVal = FilteredEnhancementTable[Index1] + Interpolator * (FilteredEnhancementTable[Index2] - FilteredEnhancementTable[Index1]);
+        IetVal = IetVal / BinIndexNormalized;
+        IetVal = CHANNEL_MIN(IetVal, (CHANNEL_DOUBLE){ 0 } + 1.0 / BinIndexNormalized);
+
+        IetVal = (double)GlobalHist_IET_SCALE_FACTOR * IetVal + 0.5;
+        IetVal = CHANNEL_MIN(IetVal, IetMaxVal);
+        IetVal = CHANNEL_MAX(IetVal, IetScaleFactor);
+        IetVal = CHANNEL_SELECT(IsSolidColor, IetScaleFactor, IetVal);
+
+        pContext->LutTarget[IetIndex] = (CHANNEL_UINT)__builtin_convertvector(IetVal, CHANNEL_INT);
+    }
+
+    pContext->LutTarget[0] = pContext->LutTarget[1];
+
+    // IsTargetIETReached
+    GHE_UNROLL(GlobalHist_IET_LUT_LENGTH)
+    for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        CHANNEL_INT Delta = (CHANNEL_INT)pContext->LutApplied[IetIndex] - (CHANNEL_INT)pContext->LutTarget[IetIndex];
+        CHANNEL_INT IsNegative = (Delta < 0);
+
+        Delta = (IsNegative & -Delta) | (~IsNegative & Delta);
+        IsTargetReached &= (__builtin_convertvector(100 * Delta, CHANNEL_DOUBLE) <= MinimumStepPercent * CHANNEL_TO_DOUBLE(pContext->LutTarget[IetIndex]));
+    }
+
+    // Linked channels snap together once every one of them is there
+    if (IsLinked)
+    {
+        IsTargetReached = (CHANNEL_MASK){ 0 } + (IsTargetReached[0] & IsTargetReached[1] & IsTargetReached[2]);
+    }
+
+    // Solid color channels keep their whole temporal state, the others either snap or filter
+    IsSnapToTarget = ~IsSolidColor & IsTargetReached;
+
+    pContext->Stats.FramesProcessed++;
+
+    for (uint32_t Channel = 0; Channel < GlobalHist_CHANNEL_COUNT; Channel++)
+    {
+        pContext->Stats.SolidColorFrames[Channel]    += (0 != IsSolidColor[Channel]);
+        pContext->Stats.TargetReachedFrames[Channel] += (0 != IsSnapToTarget[Channel]);
+    }
+
+    // One clock per channel, or the shared one. The clock advances on every frame, the cut off
+    // frequency hold only moves when the channel filters.
+    for (uint32_t Lane = 0; Lane < ClockCount; Lane++)
+    {
+        GlobalHist_FILTER_CLOCK *pClock = &pContext->Clock[Lane];
+
+        DisplayGheAdvanceFilterClock(pClock, pArgs->TimestampNs);
+
+        if ((0 == IsSolidColor[Lane]) && (0 == IsSnapToTarget[Lane]))
+        {
+            double CutOffFreq = DisplayGheGetCutOffFrequency(pClock, DisplayGheGetRelativeBrightnessChange(pContext->PrevFramePower[Lane], SumPower[Lane]),
+                                                             MinCutoffFreq, MaxCutoffFreq);
+
+            FilterCoefficient[Lane] = DisplayGheGetIIRFilterCoefficient(CutOffFreq, pClock->SamplingPeriod);
+        }
+    }
+
+    if (IsLinked)
+    {
+        FilterCoefficient = __builtin_shuffle(FilterCoefficient, Broadcast);
+    }
+
+    // Temporal IIR across channels, or snap to target where it has been reached
+    GHE_UNROLL(GlobalHist_IET_LUT_LENGTH)
+    for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        const CHANNEL_DOUBLE Target = CHANNEL_TO_DOUBLE(pContext->LutTarget[IetIndex]);
+        CHANNEL_DOUBLE AdjustedValue = Target;
+        CHANNEL_UINT IetVal;
+
+        for (uint32_t FilterOrder = 0; FilterOrder < GlobalHist_IIR_FILTER_ORDER; FilterOrder++)
+        {
+            CHANNEL_DOUBLE Tap = pContext->IETHistory[IetIndex][FilterOrder];
+
+            AdjustedValue = FilterCoefficient * AdjustedValue;
+            AdjustedValue += (1 - FilterCoefficient) * Tap;
+
+            Tap = CHANNEL_SELECT(IsSolidColor, Tap, AdjustedValue);
+            Tap = CHANNEL_SELECT(IsSnapToTarget, Target, Tap);
+            pContext->IETHistory[IetIndex][FilterOrder] = Tap;
+        }
+
+        IetVal = (CHANNEL_UINT)__builtin_convertvector(AdjustedValue, CHANNEL_INT);
+        IetVal = ((CHANNEL_UINT)(IetVal < GlobalHist_IET_MAX_VAL) & IetVal) | ((CHANNEL_UINT)(IetVal >= GlobalHist_IET_MAX_VAL) & GlobalHist_IET_MAX_VAL);
+        IetVal = CHANNEL_SELECT_U(IsSnapToTarget, pContext->LutTarget[IetIndex], IetVal);
+
+        pContext->LutApplied[IetIndex] = CHANNEL_SELECT_U(IsSolidColor, pContext->LutApplied[IetIndex], IetVal);
+    }
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        pContext->PrevHistogram[BinIndex] = CHANNEL_SELECT_U(IsSolidColor, pContext->PrevHistogram[BinIndex], Histogram[BinIndex]);
+    }
+
+    pContext->PrevFramePower = CHANNEL_SELECT(IsSolidColor, pContext->PrevFramePower, SumPower);
+
+    // DisplaySetDietReg
+    pArgs->PipeId        = pContext->Pipe;
+    pArgs->IsProgramDiet = TRUE;
+
+    for (uint32_t Channel = 0; Channel < GlobalHist_CHANNEL_COUNT; Channel++)
+    {
+        for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+        {
+            pArgs->DietFactor[Channel][IetIndex] = pContext->LutApplied[IetIndex][Channel];
+        }
+    }
+}
+
+typedef void (*PFN_GlobalHistMULTICHANNEL)(GlobalHist_MULTI_CHANNEL_CONTEXT *pContext, GlobalHist_MULTI_CHANNEL_ARGS *pArgs);
+
+static void MultiChannelProcess(GlobalHist_MULTI_CHANNEL_CONTEXT *pContext, GlobalHist_MULTI_CHANNEL_ARGS *pArgs)
+{
+    MultiChannelProcessBody(pContext, pArgs);
+}
+
+#if GlobalHist_HAS_ISA_DISPATCH
+
+GlobalHist_TARGET_AVX2 static void MultiChannelProcessAvx2(GlobalHist_MULTI_CHANNEL_CONTEXT *pContext, GlobalHist_MULTI_CHANNEL_ARGS *pArgs)
+{
+    MultiChannelProcessBody(pContext, pArgs);
+}
+
+GlobalHist_TARGET_AVX512 static void MultiChannelProcessAvx512(GlobalHist_MULTI_CHANNEL_CONTEXT *pContext, GlobalHist_MULTI_CHANNEL_ARGS *pArgs)
+{
+    MultiChannelProcessBody(pContext, pArgs);
+}
+
+static const PFN_GlobalHistMULTICHANNEL MultiChannelProcessIsa[GlobalHist_ISA_COUNT] = { MultiChannelProcess, MultiChannelProcessAvx2, MultiChannelProcessAvx512 };
+
+#else
+
+static const PFN_GlobalHistMULTICHANNEL MultiChannelProcessIsa[GlobalHist_ISA_COUNT] = { MultiChannelProcess, MultiChannelProcess, MultiChannelProcess };
+
+#endif
+
+void DisplayGheMultiChannelProcess(GlobalHist_MULTI_CHANNEL_CONTEXT *pContext, GlobalHist_MULTI_CHANNEL_ARGS *pArgs)
+{
+    MultiChannelProcessIsa[DisplayGheGetIsa()](pContext, pArgs);
+}
+
+void DisplayGheMultiChannelGetStats(const GlobalHist_MULTI_CHANNEL_CONTEXT *pContext, GlobalHist_MULTI_CHANNEL_STATS *pStats)
+{
+    *pStats = pContext->Stats;
+}
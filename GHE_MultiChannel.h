@@ -0,0 +1,66 @@
+/**
+ *
+ * @file  GHE_MultiChannel.h
+ * @brief  Three channel GHE, R/G/B or luma/chroma histograms equalized in one call
+ *
+ * The three histograms are interleaved bin by bin, so every stage of the algorithm runs across the
+ * channels in one vectorized pass instead of three calls through DisplayGheProcessFrame.
+ *
+ * GlobalHist_CHANNELS_INDEPENDENT equalizes every channel on its own, each DietFactor matches a
+ * context of its own fed with that channel bit for bit. GlobalHist_CHANNELS_LINKED computes the
+ * frame statistics once, on the mean of the three histograms: frame power, the solid color
+ * decision, the filter clock and cut off frequency and the target reached test are shared. The
+ * curves stay per channel, but all channels start, filter and snap on the same frames, so a
+ * transition never shifts the color balance. Three identical channels equalize as in
+ * GlobalHist_CHANNELS_INDEPENDENT, bit for bit.
+ *
+ */
+
+#ifndef _DISPLAY_GHEMULTICHANNEL_H_
+#define _DISPLAY_GHEMULTICHANNEL_H_
+
+#include "DisplayPc.h"
+
+#define GlobalHist_CHANNEL_COUNT 3
+
+typedef enum _GlobalHist_CHANNEL_MODE
+{
+    GlobalHist_CHANNELS_INDEPENDENT = 0,
+    GlobalHist_CHANNELS_LINKED      = 1,
+} GlobalHist_CHANNEL_MODE;
+
+typedef struct _DD_GlobalHist_MULTI_CHANNEL_ARGS
+{
+    PIPE_ID PipeId;
+    bool IsProgramDiet;
+    uint32_t DietFactor[GlobalHist_CHANNEL_COUNT][GlobalHist_IET_LUT_LENGTH];
+    uint32_t Histogram[GlobalHist_CHANNEL_COUNT][GlobalHist_BIN_COUNT];
+    uint64_t TimestampNs;   // Monotonic time the histograms were sampled at, 0 when unknown
+} GlobalHist_MULTI_CHANNEL_ARGS;
+
+// Per channel counts since the context was created, as the GHE_Stats.h counters of the same names
+typedef struct _GlobalHist_MULTI_CHANNEL_STATS
+{
+    uint64_t FramesProcessed;
+    uint64_t SolidColorFrames[GlobalHist_CHANNEL_COUNT];    // The channel kept its temporal state
+    uint64_t TargetReachedFrames[GlobalHist_CHANNEL_COUNT]; // The channel snapped to its target
+} GlobalHist_MULTI_CHANNEL_STATS;
+
+typedef struct _GlobalHist_MULTI_CHANNEL_CONTEXT GlobalHist_MULTI_CHANNEL_CONTEXT;
+
+// Contexts start with the default GlobalHist_CFG and the sRGB transfer function and are not
+// registered for Pipe, SetHistogramDataBin never sees them.
+GlobalHist_MULTI_CHANNEL_CONTEXT *DisplayGheCreateMultiChannel(PIPE_ID Pipe, GlobalHist_CHANNEL_MODE Mode);
+void DisplayGheDestroyMultiChannel(GlobalHist_MULTI_CHANNEL_CONTEXT *pContext);
+
+// Same contract as DisplayGheSetConfig and DisplayGheSetTransferFunction, for all channels
+bool DisplayGheMultiChannelSetConfig(GlobalHist_MULTI_CHANNEL_CONTEXT *pContext, const GlobalHist_CFG *pCfg);
+bool DisplayGheMultiChannelSetTransferFunction(GlobalHist_MULTI_CHANNEL_CONTEXT *pContext, GlobalHist_TRANSFER_FUNCTION TransferFunction);
+
+// Runs one frame of all channels, DietFactor[c] is the LUT of Histogram[c]
+void DisplayGheMultiChannelProcess(GlobalHist_MULTI_CHANNEL_CONTEXT *pContext, GlobalHist_MULTI_CHANNEL_ARGS *pArgs);
+
+// Must not run concurrently with DisplayGheMultiChannelProcess on the same context
+void DisplayGheMultiChannelGetStats(const GlobalHist_MULTI_CHANNEL_CONTEXT *pContext, GlobalHist_MULTI_CHANNEL_STATS *pStats);
+
+#endif
@@ -0,0 +1,330 @@
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#include "GHE_Algorithm.h"
+#include "GHE_Service.h"
+
+#define SERVICE_RING_MASK (GlobalHist_SERVICE_RING_SIZE - 1)
+#define SERVICE_CACHE_ALIGNED __attribute__((aligned(64))) // Keeps producer, consumer and reader state off each other's lines
+
+typedef struct _SERVICE_FRAME
+{
+    uint64_t FrameId;
+    uint64_t SubmitNs;
+    GlobalHist_ARGS Args;
+} SERVICE_FRAME;
+
+// Seqlock protected result. Every field is atomic so a torn read is a retry, never a data race.
+typedef struct _SERVICE_SLOT
+{
+    atomic_uint Sequence;      // Odd while the slot is written
+    atomic_ullong FrameId;
+    atomic_ullong TimestampNs;
+    atomic_uint DietFactor[GlobalHist_IET_LUT_LENGTH];
+} SERVICE_SLOT;
+
+typedef struct _SERVICE_PIPE
+{
+    // Producer side
+    SERVICE_CACHE_ALIGNED atomic_uint Head;
+    uint64_t LastFrameId;
+    atomic_ullong Submitted;
+    atomic_ullong Dropped;
+
+    // Consumer side, only written by the owning worker
+    SERVICE_CACHE_ALIGNED atomic_uint Tail;
+    GlobalHist_CONTEXT *pContext;
+    atomic_ullong Published;
+    atomic_ullong MaxLatencyNs;
+    atomic_ullong TotalLatencyNs;
+
+    // Reader side. The worker fills the slot Latest does not point to and then flips Latest.
+    SERVICE_CACHE_ALIGNED atomic_uint Latest;
+    SERVICE_SLOT Slot[2];
+
+    SERVICE_CACHE_ALIGNED SERVICE_FRAME Ring[GlobalHist_SERVICE_RING_SIZE];
+} SERVICE_PIPE;
+
+typedef struct _SERVICE_WORKER
+{
+    GlobalHist_SERVICE *pService;
+    uint32_t Index;
+    pthread_t Thread;
+    sem_t Wake;               // Posted once per submitted frame
+    bool IsStarted;
+} SERVICE_WORKER;
+
+struct _GlobalHist_SERVICE
+{
+    SERVICE_PIPE Pipe[GlobalHist_MAX_PIPES];
+    SERVICE_WORKER Worker[GlobalHist_MAX_PIPES];
+    uint32_t WorkerCount;
+    atomic_bool IsShutdown;
+};
+
+static uint64_t GetTimeNs(void)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return (uint64_t)Now.tv_sec * 1000000000ull + (uint64_t)Now.tv_nsec;
+}
+
+static void Publish(SERVICE_PIPE *pPipe, uint64_t FrameId, const GlobalHist_ARGS *pGheArgs)
+{
+    uint32_t Index = atomic_load_explicit(&pPipe->Latest, memory_order_relaxed) ^ 1;
+    SERVICE_SLOT *pSlot = &pPipe->Slot[Index];
+    uint32_t Sequence = atomic_load_explicit(&pSlot->Sequence, memory_order_relaxed);
+
+    atomic_store_explicit(&pSlot->Sequence, Sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&pSlot->FrameId, FrameId, memory_order_relaxed);
+    atomic_store_explicit(&pSlot->TimestampNs, pGheArgs->TimestampNs, memory_order_relaxed);
+
+    for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        atomic_store_explicit(&pSlot->DietFactor[IetIndex], pGheArgs->DietFactor[IetIndex], memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&pSlot->Sequence, Sequence + 2, memory_order_release);
+    atomic_store_explicit(&pPipe->Latest, Index, memory_order_release);
+}
+
+// Runs every queued frame of the pipe through its context
+static void DrainPipe(SERVICE_PIPE *pPipe)
+{
+    uint32_t Tail = atomic_load_explicit(&pPipe->Tail, memory_order_relaxed);
+
+    while (Tail != atomic_load_explicit(&pPipe->Head, memory_order_acquire))
+    {
+        SERVICE_FRAME Frame = pPipe->Ring[Tail & SERVICE_RING_MASK];
+        uint64_t LatencyNs;
+
+        // The copy is taken, hand the entry back to the producer before the algorithm runs
+        atomic_store_explicit(&pPipe->Tail, ++Tail, memory_order_release);
+
+        DisplayGheProcessFrame(pPipe->pContext, &Frame.Args);
+        Publish(pPipe, Frame.FrameId, &Frame.Args);
+
+        LatencyNs = GetTimeNs() - Frame.SubmitNs;
+        atomic_store_explicit(&pPipe->Published, atomic_load_explicit(&pPipe->Published, memory_order_relaxed) + 1, memory_order_relaxed);
+        atomic_store_explicit(&pPipe->TotalLatencyNs, atomic_load_explicit(&pPipe->TotalLatencyNs, memory_order_relaxed) + LatencyNs, memory_order_relaxed);
+
+        if (LatencyNs > atomic_load_explicit(&pPipe->MaxLatencyNs, memory_order_relaxed))
+        {
+            atomic_store_explicit(&pPipe->MaxLatencyNs, LatencyNs, memory_order_relaxed);
+        }
+    }
+}
+
+static void *WorkerMain(void *pArg)
+{
+    SERVICE_WORKER *pWorker = (SERVICE_WORKER *)pArg;
+    GlobalHist_SERVICE *pService = pWorker->pService;
+
+    for (;;)
+    {
+        while (0 != sem_wait(&pWorker->Wake))
+        {
+            // Interrupted by a signal
+        }
+
+        if (atomic_load_explicit(&pService->IsShutdown, memory_order_acquire))
+        {
+            return NULL;
+        }
+
+        for (uint32_t Pipe = pWorker->Index; Pipe < GlobalHist_MAX_PIPES; Pipe += pService->WorkerCount)
+        {
+            DrainPipe(&pService->Pipe[Pipe]);
+        }
+    }
+}
+
+GlobalHist_SERVICE *DisplayGheCreateService(uint32_t WorkerCount)
+{
+    GlobalHist_SERVICE *pService;
+
+    if (0 != posix_memalign((void **)&pService, 64, sizeof(GlobalHist_SERVICE)))
+    {
+        return NULL;
+    }
+
+    memset(pService, 0, sizeof(GlobalHist_SERVICE));
+    pService->WorkerCount = DD_MAX(DD_MIN(WorkerCount, GlobalHist_MAX_PIPES), 1);
+
+    // Contexts are private to the service and not registered, SetHistogramDataBin never sees them
+    for (uint32_t Pipe = 0; Pipe < GlobalHist_MAX_PIPES; Pipe++)
+    {
+        pService->Pipe[Pipe].pContext = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+
+        if (NULL == pService->Pipe[Pipe].pContext)
+        {
+            DisplayGheDestroyService(pService);
+            return NULL;
+        }
+
+        pService->Pipe[Pipe].pContext->Pipe = (PIPE_ID)Pipe;
+    }
+
+    for (uint32_t Index = 0; Index < pService->WorkerCount; Index++)
+    {
+        SERVICE_WORKER *pWorker = &pService->Worker[Index];
+
+        pWorker->pService = pService;
+        pWorker->Index    = Index;
+
+        if (0 != sem_init(&pWorker->Wake, 0, 0))
+        {
+            DisplayGheDestroyService(pService);
+            return NULL;
+        }
+
+        if (0 != pthread_create(&pWorker->Thread, NULL, WorkerMain, pWorker))
+        {
+            sem_destroy(&pWorker->Wake);
+            DisplayGheDestroyService(pService);
+            return NULL;
+        }
+
+        pWorker->IsStarted = TRUE;
+    }
+
+    return pService;
+}
+
+void DisplayGheDestroyService(GlobalHist_SERVICE *pService)
+{
+    if (NULL == pService)
+    {
+        return;
+    }
+
+    atomic_store_explicit(&pService->IsShutdown, TRUE, memory_order_release);
+
+    for (uint32_t Index = 0; Index < pService->WorkerCount; Index++)
+    {
+        SERVICE_WORKER *pWorker = &pService->Worker[Index];
+
+        if (pWorker->IsStarted)
+        {
+            sem_post(&pWorker->Wake);
+            pthread_join(pWorker->Thread, NULL);
+            sem_destroy(&pWorker->Wake);
+        }
+    }
+
+    for (uint32_t Pipe = 0; Pipe < GlobalHist_MAX_PIPES; Pipe++)
+    {
+        DisplayGheDestroyContext(pService->Pipe[Pipe].pContext);
+    }
+
+    free(pService);
+}
+
+bool DisplayGheServiceSubmit(GlobalHist_SERVICE *pService, const GlobalHist_ARGS *pGheArgs)
+{
+    SERVICE_PIPE *pPipe;
+    SERVICE_FRAME *pFrame;
+    uint32_t Head;
+
+    if ((uint32_t)pGheArgs->PipeId >= GlobalHist_MAX_PIPES)
+    {
+        return FALSE;
+    }
+
+    pPipe = &pService->Pipe[pGheArgs->PipeId];
+    Head  = atomic_load_explicit(&pPipe->Head, memory_order_relaxed);
+
+    pPipe->LastFrameId++;
+    atomic_fetch_add_explicit(&pPipe->Submitted, 1, memory_order_relaxed);
+
+    if (Head - atomic_load_explicit(&pPipe->Tail, memory_order_acquire) >= GlobalHist_SERVICE_RING_SIZE)
+    {
+        atomic_fetch_add_explicit(&pPipe->Dropped, 1, memory_order_relaxed);
+        return FALSE;
+    }
+
+    pFrame = &pPipe->Ring[Head & SERVICE_RING_MASK];
+    pFrame->FrameId  = pPipe->LastFrameId;
+    pFrame->SubmitNs = GetTimeNs();
+    pFrame->Args     = *pGheArgs;
+
+    atomic_store_explicit(&pPipe->Head, Head + 1, memory_order_release);
+    sem_post(&pService->Worker[(uint32_t)pGheArgs->PipeId % pService->WorkerCount].Wake);
+
+    return TRUE;
+}
+
+bool DisplayGheServiceRead(GlobalHist_SERVICE *pService, PIPE_ID Pipe, GlobalHist_SERVICE_RESULT *pResult)
+{
+    SERVICE_PIPE *pPipe;
+
+    if ((uint32_t)Pipe >= GlobalHist_MAX_PIPES)
+    {
+        return FALSE;
+    }
+
+    pPipe = &pService->Pipe[Pipe];
+
+    // The newest slot is only rewritten after the worker published into the other one, so a retry
+    // always finds a complete result without waiting for the worker.
+    for (;;)
+    {
+        SERVICE_SLOT *pSlot = &pPipe->Slot[atomic_load_explicit(&pPipe->Latest, memory_order_acquire)];
+        uint32_t Sequence = atomic_load_explicit(&pSlot->Sequence, memory_order_acquire);
+
+        if (Sequence & 1)
+        {
+            continue;
+        }
+
+        pResult->FrameId     = atomic_load_explicit(&pSlot->FrameId, memory_order_relaxed);
+        pResult->TimestampNs = atomic_load_explicit(&pSlot->TimestampNs, memory_order_relaxed);
+
+        for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+        {
+            pResult->DietFactor[IetIndex] = atomic_load_explicit(&pSlot->DietFactor[IetIndex], memory_order_relaxed);
+        }
+
+        atomic_thread_fence(memory_order_acquire);
+
+        if (Sequence == atomic_load_explicit(&pSlot->Sequence, memory_order_relaxed))
+        {
+            return (0 != pResult->FrameId);
+        }
+    }
+}
+
+void DisplayGheServiceGetStats(GlobalHist_SERVICE *pService, PIPE_ID Pipe, GlobalHist_SERVICE_STATS *pStats)
+{
+    SERVICE_PIPE *pPipe;
+
+    memset(pStats, 0, sizeof(*pStats));
+
+    if ((uint32_t)Pipe >= GlobalHist_MAX_PIPES)
+    {
+        return;
+    }
+
+    pPipe = &pService->Pipe[Pipe];
+    pStats->Submitted      = atomic_load_explicit(&pPipe->Submitted, memory_order_relaxed);
+    pStats->Dropped        = atomic_load_explicit(&pPipe->Dropped, memory_order_relaxed);
+    pStats->Published      = atomic_load_explicit(&pPipe->Published, memory_order_relaxed);
+    pStats->MaxLatencyNs   = atomic_load_explicit(&pPipe->MaxLatencyNs, memory_order_relaxed);
+    pStats->TotalLatencyNs = atomic_load_explicit(&pPipe->TotalLatencyNs, memory_order_relaxed);
+}
+
+bool DisplayGheServiceGetAlgorithmStats(GlobalHist_SERVICE *pService, PIPE_ID Pipe, GlobalHist_STATS *pStats)
+{
+    if ((uint32_t)Pipe >= GlobalHist_MAX_PIPES)
+    {
+        memset(pStats, 0, sizeof(*pStats));
+        return FALSE;
+    }
+
+    return DisplayGheGetStatsSnapshot(pService->Pipe[Pipe].pContext, pStats);
+}
@@ -0,0 +1,58 @@
+/**
+ *
+ * @file  GHE_Service.h
+ * @brief  Asynchronous GHE service: histograms in through per pipe rings, DietFactor out through seqlocks
+ *
+ * DisplayGheServiceSubmit copies a frame into the single producer / single consumer ring of its
+ * pipe and wakes the worker that owns the pipe. It takes no lock, allocates nothing and does no
+ * double math, so it can sit on the vblank path. Pipe p is owned by worker p % WorkerCount: every
+ * ring has one consumer and every context is only touched by one thread.
+ *
+ * Every finished DietFactor is published per pipe into one of two seqlocked slots. The register
+ * programming side copies the newest complete slot with DisplayGheServiceRead and never waits for
+ * a worker that is in the middle of publishing.
+ *
+ */
+
+#ifndef _DISPLAY_GHESERVICE_H_
+#define _DISPLAY_GHESERVICE_H_
+
+#include "DisplayPc.h"
+#include "GHE_Stats.h"
+
+#define GlobalHist_SERVICE_RING_SIZE 8 // Frames queued per pipe, power of two
+
+typedef struct _GlobalHist_SERVICE GlobalHist_SERVICE;
+
+typedef struct _GlobalHist_SERVICE_RESULT
+{
+    uint64_t FrameId;       // 1 based submission count of the frame, 0 while nothing was published
+    uint64_t TimestampNs;   // GlobalHist_ARGS.TimestampNs of the frame
+    uint32_t DietFactor[GlobalHist_IET_LUT_LENGTH];
+} GlobalHist_SERVICE_RESULT;
+
+typedef struct _GlobalHist_SERVICE_STATS
+{
+    uint64_t Submitted;
+    uint64_t Dropped;        // Ring was full, the frame never reached the algorithm
+    uint64_t Published;
+    uint64_t MaxLatencyNs;   // Submit to publish
+    uint64_t TotalLatencyNs;
+} GlobalHist_SERVICE_STATS;
+
+// WorkerCount is clamped to [1, GlobalHist_MAX_PIPES]. Contexts of all pipes are created here,
+// so nothing is allocated once frames flow. Queued frames are dropped on destroy.
+GlobalHist_SERVICE *DisplayGheCreateService(uint32_t WorkerCount);
+void DisplayGheDestroyService(GlobalHist_SERVICE *pService);
+
+// Pipes A..D only, at most one producer thread per pipe. Returns FALSE when the frame was dropped.
+bool DisplayGheServiceSubmit(GlobalHist_SERVICE *pService, const GlobalHist_ARGS *pGheArgs);
+
+// Any thread. Returns FALSE while nothing was published for the pipe yet.
+bool DisplayGheServiceRead(GlobalHist_SERVICE *pService, PIPE_ID Pipe, GlobalHist_SERVICE_RESULT *pResult);
+void DisplayGheServiceGetStats(GlobalHist_SERVICE *pService, PIPE_ID Pipe, GlobalHist_SERVICE_STATS *pStats);
+
+// DisplayGheGetStatsSnapshot of the context the service runs for the pipe
+bool DisplayGheServiceGetAlgorithmStats(GlobalHist_SERVICE *pService, PIPE_ID Pipe, GlobalHist_STATS *pStats);
+
+#endif
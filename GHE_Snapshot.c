@@ -0,0 +1,224 @@
+#include "GHE_Algorithm.h"
+#include "GHE_Snapshot.h"
+
+static const char SnapshotMagic[4] = { 'G', 'H', 'E', 'S' };
+
+static uint8_t *PutU16(uint8_t *pOut, uint32_t Value)
+{
+    pOut[0] = (uint8_t)Value;
+    pOut[1] = (uint8_t)(Value >> 8);
+    return pOut + 2;
+}
+
+static uint8_t *PutU32(uint8_t *pOut, uint32_t Value)
+{
+    pOut = PutU16(pOut, Value & 0xFFFF);
+    return PutU16(pOut, Value >> 16);
+}
+
+static uint8_t *PutU64(uint8_t *pOut, uint64_t Value)
+{
+    pOut = PutU32(pOut, (uint32_t)Value);
+    return PutU32(pOut, (uint32_t)(Value >> 32));
+}
+
+// Doubles travel as their IEEE 754 bits, so a restore is exact
+static uint8_t *PutF64(uint8_t *pOut, double Value)
+{
+    uint64_t Bits;
+
+    memcpy(&Bits, &Value, sizeof(Bits));
+    return PutU64(pOut, Bits);
+}
+
+static uint32_t GetU16(const uint8_t **ppIn)
+{
+    const uint8_t *pIn = *ppIn;
+
+    *ppIn = pIn + 2;
+    return (uint32_t)pIn[0] | ((uint32_t)pIn[1] << 8);
+}
+
+static uint32_t GetU32(const uint8_t **ppIn)
+{
+    uint32_t Low = GetU16(ppIn);
+
+    return Low | (GetU16(ppIn) << 16);
+}
+
+static uint64_t GetU64(const uint8_t **ppIn)
+{
+    uint64_t Low = GetU32(ppIn);
+
+    return Low | ((uint64_t)GetU32(ppIn) << 32);
+}
+
+static double GetF64(const uint8_t **ppIn)
+{
+    uint64_t Bits = GetU64(ppIn);
+    double Value;
+
+    memcpy(&Value, &Bits, sizeof(Value));
+    return Value;
+}
+
+// FNV-1a over the whole snapshot but its checksum field
+static uint32_t GetChecksum(const uint8_t *pSnapshot)
+{
+    uint32_t Hash = 2166136261u;
+
+    for (size_t Index = 0; Index < GlobalHist_SNAPSHOT_SIZE; Index++)
+    {
+        if ((Index - GlobalHist_SNAPSHOT_CHECKSUM_OFFSET) >= 4)
+        {
+            Hash = (Hash ^ pSnapshot[Index]) * 16777619u;
+        }
+    }
+
+    return Hash;
+}
+
+size_t DisplayGheSaveSnapshot(const GlobalHist_CONTEXT *pGheContext, void *pBuffer, size_t BufferSize)
+{
+    const GlobalHist_IE *pEnhancement = &pGheContext->ImageEnhancement;
+    const GlobalHist_TEMPORAL_FILTER_PARAMS *pFilterParams = &pGheContext->FilterParams;
+    uint8_t *pStart = (uint8_t *)pBuffer;
+    uint8_t *pOut = pStart + GlobalHist_SNAPSHOT_HEADER_SIZE;
+
+    if ((NULL == pBuffer) || (BufferSize < GlobalHist_SNAPSHOT_SIZE))
+    {
+        return 0;
+    }
+
+    // LUT entries never exceed GlobalHist_IET_MAX_VAL
+    for (uint32_t Index = 0; Index < GlobalHist_IET_LUT_LENGTH; Index++)
+    {
+        pOut = PutU16(pOut, pEnhancement->LutApplied[Index]);
+    }
+
+    for (uint32_t Index = 0; Index < GlobalHist_IET_LUT_LENGTH; Index++)
+    {
+        pOut = PutU16(pOut, pEnhancement->LutTarget[Index]);
+    }
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        pOut = PutU32(pOut, pFilterParams->PrevHistogram[BinIndex]);
+    }
+
+    pOut = PutU64(pOut, pFilterParams->SmootheningIteration);
+    pOut = PutF64(pOut, pFilterParams->PrevFramePower);
+    pOut = PutF64(pOut, pFilterParams->TargetBoost);
+    pOut = PutF64(pOut, pFilterParams->Clock.HeldCutOffFreq);
+    pOut = PutF64(pOut, pFilterParams->Clock.HoldRemaining);
+
+    for (uint32_t Index = 0; Index < GlobalHist_IET_LUT_LENGTH; Index++)
+    {
+        for (uint32_t FilterOrder = 0; FilterOrder < GlobalHist_IIR_FILTER_ORDER; FilterOrder++)
+        {
+            pOut = PutF64(pOut, pFilterParams->IETHistory[FilterOrder][Index]);
+        }
+    }
+
+    memcpy(pStart, SnapshotMagic, sizeof(SnapshotMagic));
+    PutU16(pStart + 4, GlobalHist_SNAPSHOT_VERSION);
+    pStart[6] = GlobalHist_BIN_COUNT;
+    pStart[7] = GlobalHist_IET_LUT_LENGTH;
+    pStart[8] = GlobalHist_IIR_FILTER_ORDER;
+    pStart[9] = pGheContext->ChangeDetection.IsConverged ? GlobalHist_SNAPSHOT_FLAG_CONVERGED : 0;
+    PutU16(pStart + 10, 0);
+    PutU32(pStart + GlobalHist_SNAPSHOT_CHECKSUM_OFFSET, GetChecksum(pStart));
+
+    return GlobalHist_SNAPSHOT_SIZE;
+}
+
+// Values the filter can reach from any sane state: finite, and no negative power or hold
+static bool IsRestorableValue(double Value)
+{
+    return isfinite(Value) && (Value >= 0);
+}
+
+bool DisplayGheRestoreSnapshot(GlobalHist_CONTEXT *pGheContext, const void *pBuffer, size_t BufferSize)
+{
+    const uint8_t *pStart = (const uint8_t *)pBuffer;
+    const uint8_t *pIn = pStart + 4;
+    GlobalHist_TEMPORAL_FILTER_PARAMS FilterParams;
+    uint32_t LutApplied[GlobalHist_IET_LUT_LENGTH];
+    uint32_t LutTarget[GlobalHist_IET_LUT_LENGTH];
+    bool IsValid = TRUE;
+
+    if ((NULL == pBuffer) || (BufferSize < GlobalHist_SNAPSHOT_SIZE) || (0 != memcmp(pStart, SnapshotMagic, sizeof(SnapshotMagic))) ||
+        (GlobalHist_SNAPSHOT_VERSION != GetU16(&pIn)) || (GlobalHist_BIN_COUNT != pStart[6]) || (GlobalHist_IET_LUT_LENGTH != pStart[7]) ||
+        (GlobalHist_IIR_FILTER_ORDER != pStart[8]) || (0 != (pStart[9] & ~GlobalHist_SNAPSHOT_FLAG_CONVERGED)) || (0 != pStart[10]) ||
+        (0 != pStart[11]))
+    {
+        return FALSE;
+    }
+
+    pIn = pStart + GlobalHist_SNAPSHOT_CHECKSUM_OFFSET;
+
+    if (GetU32(&pIn) != GetChecksum(pStart))
+    {
+        return FALSE;
+    }
+
+    // Parsed into a copy, the context is only written once everything validated. A checksum match
+    // does not make a foreign snapshot sane.
+    FilterParams = pGheContext->FilterParams;
+
+    for (uint32_t Index = 0; Index < GlobalHist_IET_LUT_LENGTH; Index++)
+    {
+        LutApplied[Index] = GetU16(&pIn);
+    }
+
+    for (uint32_t Index = 0; Index < GlobalHist_IET_LUT_LENGTH; Index++)
+    {
+        LutTarget[Index] = GetU16(&pIn);
+
+        // The hardware register limit
+        IsValid &= (LutApplied[Index] <= GlobalHist_IET_MAX_VAL) && (LutTarget[Index] <= GlobalHist_IET_MAX_VAL);
+    }
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        FilterParams.PrevHistogram[BinIndex] = GetU32(&pIn);
+    }
+
+    // The cut off frequencies, the step tolerance and the clock limits come from GlobalHist_CFG and
+    // stay as DisplayGheSetConfig derived them, elapsed time restarts
+    FilterParams.SmootheningIteration = GetU64(&pIn);
+    FilterParams.PrevFramePower       = GetF64(&pIn);
+    FilterParams.TargetBoost          = GetF64(&pIn);
+
+    FilterParams.Clock.PrevTimestampNs = 0;
+    FilterParams.Clock.SamplingPeriod  = GlobalHist_SMOOTHENING_SAMPLING_PERIOD;
+    FilterParams.Clock.HeldCutOffFreq  = GetF64(&pIn);
+    FilterParams.Clock.HoldRemaining   = GetF64(&pIn);
+
+    IsValid &= IsRestorableValue(FilterParams.PrevFramePower) && IsRestorableValue(FilterParams.TargetBoost) &&
+               IsRestorableValue(FilterParams.Clock.HeldCutOffFreq) && IsRestorableValue(FilterParams.Clock.HoldRemaining);
+
+    for (uint32_t Index = 0; Index < GlobalHist_IET_LUT_LENGTH; Index++)
+    {
+        for (uint32_t FilterOrder = 0; FilterOrder < GlobalHist_IIR_FILTER_ORDER; FilterOrder++)
+        {
+            FilterParams.IETHistory[FilterOrder][Index] = GetF64(&pIn);
+            IsValid &= isfinite(FilterParams.IETHistory[FilterOrder][Index]);
+        }
+    }
+
+    if (!IsValid)
+    {
+        return FALSE;
+    }
+
+    memcpy(pGheContext->ImageEnhancement.LutApplied, LutApplied, sizeof(LutApplied));
+    memcpy(pGheContext->ImageEnhancement.LutTarget, LutTarget, sizeof(LutTarget));
+    pGheContext->FilterParams = FilterParams;
+
+    // The LUT converged under the setup of the saving context, which may not be this one. The
+    // first frame runs the algorithm, on the same setup that gives the LUT the fast path would keep.
+    pGheContext->ChangeDetection.IsConverged = FALSE;
+
+    return TRUE;
+}
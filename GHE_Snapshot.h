@@ -0,0 +1,54 @@
+/**
+ *
+ * @file  GHE_Snapshot.h
+ * @brief  Versioned snapshot of the per pipe runtime state, to warm start a context after a restart
+ *
+ * A fresh context starts from the identity LUT and takes many frames to ramp to its target, which
+ * shows as a brightness pulse after a driver or service restart. Saving the runtime state on the
+ * way down and restoring it into the new context continues the temporal filter where it stopped.
+ *
+ * A snapshot is GlobalHist_SNAPSHOT_SIZE bytes, all fields little endian:
+ *
+ *   char[4]  magic "GHES"
+ *   u16      GlobalHist_SNAPSHOT_VERSION
+ *   u8       GlobalHist_BIN_COUNT, GlobalHist_IET_LUT_LENGTH, GlobalHist_IIR_FILTER_ORDER, flags
+ *   u16      reserved, 0
+ *   u32      FNV-1a of every other byte of the snapshot
+ *   u16      LutApplied, LutTarget                          [GlobalHist_IET_LUT_LENGTH] each
+ *   u32      PrevHistogram                                  [GlobalHist_BIN_COUNT]
+ *   u64      SmootheningIteration
+ *   f64      PrevFramePower, TargetBoost, held cut off frequency, hold remaining
+ *   f64      IETHistory                                     [GlobalHist_IET_LUT_LENGTH][GlobalHist_IIR_FILTER_ORDER]
+ *
+ * Restored contexts continue bit for bit as the saved one would have, except that the first
+ * frame after a restore takes the default sampling period: timestamps from before the restart are
+ * on another clock. Setup the caller owns, the pipe, change detection settings, the transfer
+ * function, the precision and the GlobalHist_CFG with the filter limits derived from it, is not
+ * part of a snapshot. Neither are the LUT cache and the stats. The change detection fast path
+ * stays off until the restored context converges again, so a LUT the saving context converged on
+ * under another setup is not kept. IETHistory is written entry by entry whatever the in memory layout.
+ *
+ */
+
+#ifndef _DISPLAY_GHESNAPSHOT_H_
+#define _DISPLAY_GHESNAPSHOT_H_
+
+#include "DisplayPc.h"
+
+#define GlobalHist_SNAPSHOT_VERSION      2 // 2 dropped the GlobalHist_CFG derived cut off frequencies and step tolerance
+#define GlobalHist_SNAPSHOT_HEADER_SIZE  16
+#define GlobalHist_SNAPSHOT_FLAG_CONVERGED 0x01 // ChangeDetection.IsConverged was set, not restored
+#define GlobalHist_SNAPSHOT_CHECKSUM_OFFSET 12
+#define GlobalHist_SNAPSHOT_SIZE (GlobalHist_SNAPSHOT_HEADER_SIZE + 2 * 2 * GlobalHist_IET_LUT_LENGTH + 4 * GlobalHist_BIN_COUNT + 8 + \
+                                  8 * 4 + 8 * GlobalHist_IET_LUT_LENGTH * 3) // IETHistory is third order
+
+// Writes GlobalHist_SNAPSHOT_SIZE bytes to pBuffer. Returns the size, 0 when BufferSize is too small.
+// Must not run concurrently with DisplayGheProcessFrame on the same context.
+size_t DisplayGheSaveSnapshot(const GlobalHist_CONTEXT *pGheContext, void *pBuffer, size_t BufferSize);
+
+// Returns FALSE and leaves the context untouched for a snapshot of another version or build
+// configuration, a truncated or corrupt one, or one with values no context reaches: NaN or Inf
+// doubles, a negative power or hold, unknown flags or LUT entries above GlobalHist_IET_MAX_VAL.
+bool DisplayGheRestoreSnapshot(GlobalHist_CONTEXT *pGheContext, const void *pBuffer, size_t BufferSize);
+
+#endif
@@ -0,0 +1,149 @@
+#include <pthread.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "GHE_Algorithm.h"
+
+static pthread_once_t TicksPerSecondOnce = PTHREAD_ONCE_INIT;
+static uint64_t TicksPerSecond;
+
+static uint64_t GetTimeNs(void)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return (uint64_t)Now.tv_sec * 1000000000ull + (uint64_t)Now.tv_nsec;
+}
+
+uint64_t DisplayGheStatsReadTicks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return GetTimeNs();
+#endif
+}
+
+// TSC rate measured once against the monotonic clock over 10 ms
+static void CalibrateTicksPerSecond(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    struct timespec Delay = { 0, 10000000 };
+    uint64_t StartNs = GetTimeNs(), StartTicks = __rdtsc();
+    uint64_t ElapsedNs;
+
+    nanosleep(&Delay, NULL);
+
+    ElapsedNs = GetTimeNs() - StartNs;
+    TicksPerSecond = (uint64_t)((double)(__rdtsc() - StartTicks) * 1e9 / (double)DD_MAX(ElapsedNs, 1));
+#else
+    TicksPerSecond = 1000000000ull;
+#endif
+}
+
+uint64_t DisplayGheStatsGetTicksPerSecond(void)
+{
+    pthread_once(&TicksPerSecondOnce, CalibrateTicksPerSecond);
+
+    return TicksPerSecond;
+}
+
+void DisplayGheStatsAddTicks(GlobalHist_STATS *pStats, GlobalHist_STATS_STAGE Stage, uint64_t Ticks)
+{
+    pStats->StageCalls[Stage]++;
+    pStats->StageTicks[Stage] += Ticks;
+    pStats->StageMaxTicks[Stage] = DD_MAX(pStats->StageMaxTicks[Stage], Ticks);
+}
+
+// Called once per filtered frame. A run of filter steps ending in a snap to the target is one
+// convergence, binned by its length.
+void DisplayGheStatsCountFilterStep(GlobalHist_STATS *pStats, bool IsTargetReached)
+{
+    if (FALSE == IsTargetReached)
+    {
+        pStats->FilterSteps++;
+        pStats->CurrentFilterRun++;
+        return;
+    }
+
+    pStats->TargetReachedFrames++;
+
+    if (0 != pStats->CurrentFilterRun)
+    {
+        pStats->ConvergenceHistogram[DD_MIN(pStats->CurrentFilterRun, GlobalHist_STATS_CONVERGENCE_BUCKETS) - 1]++;
+        pStats->CurrentFilterRun = 0;
+    }
+}
+
+#ifdef GlobalHist_ENABLE_STATS
+
+void DisplayGhePublishStats(GlobalHist_CONTEXT *pGheContext)
+{
+    GlobalHist_STATS_PUBLISHED *pPublished = &pGheContext->StatsPublished;
+    const uint64_t *pWord = (const uint64_t *)&pGheContext->Stats;
+    uint32_t Sequence = atomic_load_explicit(&pPublished->Sequence, memory_order_relaxed);
+
+    // Change detection keeps these counters in every build
+    pGheContext->Stats.FastPathFrames = pGheContext->ChangeDetection.FastPathHits;
+    pGheContext->Stats.LutCacheHits   = pGheContext->ChangeDetection.CacheHits;
+    pGheContext->Stats.LutCacheMisses = pGheContext->ChangeDetection.CacheMisses;
+
+    atomic_store_explicit(&pPublished->Sequence, Sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    for (uint32_t WordIndex = 0; WordIndex < GlobalHist_STATS_WORDS; WordIndex++)
+    {
+        atomic_store_explicit(&pPublished->Word[WordIndex], pWord[WordIndex], memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&pPublished->Sequence, Sequence + 2, memory_order_release);
+}
+
+bool DisplayGheGetStatsSnapshot(GlobalHist_CONTEXT *pGheContext, GlobalHist_STATS *pStats)
+{
+    GlobalHist_STATS_PUBLISHED *pPublished = &pGheContext->StatsPublished;
+    uint64_t *pWord = (uint64_t *)pStats;
+
+    // Retry while the processing thread is publishing
+    for (;;)
+    {
+        uint32_t Sequence = atomic_load_explicit(&pPublished->Sequence, memory_order_acquire);
+
+        if (0 != (Sequence & 1))
+        {
+            continue;
+        }
+
+        for (uint32_t WordIndex = 0; WordIndex < GlobalHist_STATS_WORDS; WordIndex++)
+        {
+            pWord[WordIndex] = atomic_load_explicit(&pPublished->Word[WordIndex], memory_order_relaxed);
+        }
+
+        atomic_thread_fence(memory_order_acquire);
+
+        if (Sequence == atomic_load_explicit(&pPublished->Sequence, memory_order_relaxed))
+        {
+            return TRUE;
+        }
+    }
+}
+
+#else
+
+void DisplayGhePublishStats(GlobalHist_CONTEXT *pGheContext)
+{
+    (void)pGheContext;
+}
+
+bool DisplayGheGetStatsSnapshot(GlobalHist_CONTEXT *pGheContext, GlobalHist_STATS *pStats)
+{
+    (void)pGheContext;
+    memset(pStats, 0, sizeof(*pStats));
+
+    return FALSE;
+}
+
+#endif
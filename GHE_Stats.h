@@ -0,0 +1,89 @@
+/**
+ *
+ * @file  GHE_Stats.h
+ * @brief  Opt-in per context counters and stage timers, compiled in with -DGlobalHist_ENABLE_STATS
+ *
+ * Without GlobalHist_ENABLE_STATS every GlobalHist_STATS_* macro expands to nothing and the
+ * algorithm pays nothing. With it, the processing thread updates a private GlobalHist_STATS and
+ * publishes a copy at the end of every DisplayGheProcessFrame. DisplayGheGetStatsSnapshot reads
+ * that copy from any thread without stopping the pipe.
+ *
+ */
+
+#ifndef _DISPLAY_GHESTATS_H_
+#define _DISPLAY_GHESTATS_H_
+
+#include <stdatomic.h>
+
+#include "DisplayPc.h"
+
+#define GlobalHist_STATS_CONVERGENCE_BUCKETS 16 // Bucket i counts targets reached after i + 1 filter steps, the last one after 16 or more
+
+typedef enum _GlobalHist_STATS_STAGE
+{
+    GlobalHist_STATS_STAGE_FRAME = 0,       // Whole DisplayGheProcessFrame
+    GlobalHist_STATS_STAGE_LUT_TARGET,      // LutTarget from the cache or computed
+    GlobalHist_STATS_STAGE_TEMPORAL_FILTER, // TemporalSmoothenIET, target check and filter or snap
+    GlobalHist_STATS_STAGE_PROGRAM_DIET,    // DisplaySetDietReg
+    GlobalHist_STATS_STAGE_COUNT
+} GlobalHist_STATS_STAGE;
+
+// Only uint64_t members, published word by word
+typedef struct _GlobalHist_STATS
+{
+    uint64_t FramesProcessed;
+    uint64_t FastPathFrames;               // Histogram unchanged and filter converged, see DisplayGheSetChangeDetection
+    uint64_t LutCacheHits;
+    uint64_t LutCacheMisses;
+    uint64_t SolidColorFrames;             // Solid color early out of DisplayGheAlgorithm
+    uint64_t FilterSteps;                  // Frames where IsTargetIETReached was FALSE
+    uint64_t TargetReachedFrames;          // Frames snapped to the target
+    uint64_t ConvergenceHistogram[GlobalHist_STATS_CONVERGENCE_BUCKETS];
+    uint64_t CurrentFilterRun;             // Filter steps since the target was last reached
+    uint64_t MinSlopeClamps;               // Bins clamped to GlobalHist_CFG::MinSlope, over computed targets only
+    uint64_t MaxSlopeClamps;               // Bins clamped to GlobalHist_CFG::MaxSlope
+    uint64_t IetMaxClamps;                 // IET entries clamped to GlobalHist_IET_MAX_VAL
+    uint64_t StageCalls[GlobalHist_STATS_STAGE_COUNT];
+    uint64_t StageTicks[GlobalHist_STATS_STAGE_COUNT];
+    uint64_t StageMaxTicks[GlobalHist_STATS_STAGE_COUNT];
+} GlobalHist_STATS;
+
+#define GlobalHist_STATS_WORDS (sizeof(GlobalHist_STATS) / sizeof(uint64_t))
+
+// Seqlocked copy of GlobalHist_STATS
+typedef struct _GlobalHist_STATS_PUBLISHED
+{
+    atomic_uint Sequence;
+    atomic_ullong Word[GlobalHist_STATS_WORDS];
+} GlobalHist_STATS_PUBLISHED;
+
+#ifdef GlobalHist_ENABLE_STATS
+
+#define GlobalHist_STATS_COUNT(pGheContext, Field, Count) ((pGheContext)->Stats.Field += (Count))
+#define GlobalHist_STATS_TIMER_START(Name) uint64_t Name = DisplayGheStatsReadTicks()
+#define GlobalHist_STATS_TIMER_STOP(pGheContext, Stage, Name) DisplayGheStatsAddTicks(&(pGheContext)->Stats, Stage, DisplayGheStatsReadTicks() - (Name))
+#define GlobalHist_STATS_FILTER_STEP(pGheContext, IsTargetReached) DisplayGheStatsCountFilterStep(&(pGheContext)->Stats, IsTargetReached)
+#define GlobalHist_STATS_PUBLISH(pGheContext) DisplayGhePublishStats(pGheContext)
+
+#else
+
+#define GlobalHist_STATS_COUNT(pGheContext, Field, Count) ((void)0)
+#define GlobalHist_STATS_TIMER_START(Name) ((void)0)
+#define GlobalHist_STATS_TIMER_STOP(pGheContext, Stage, Name) ((void)0)
+#define GlobalHist_STATS_FILTER_STEP(pGheContext, IsTargetReached) ((void)0)
+#define GlobalHist_STATS_PUBLISH(pGheContext) ((void)0)
+
+#endif
+
+// Ticks are TSC cycles on x86 and nanoseconds elsewhere
+uint64_t DisplayGheStatsReadTicks(void);
+uint64_t DisplayGheStatsGetTicksPerSecond(void);
+void DisplayGheStatsAddTicks(GlobalHist_STATS *pStats, GlobalHist_STATS_STAGE Stage, uint64_t Ticks);
+void DisplayGheStatsCountFilterStep(GlobalHist_STATS *pStats, bool IsTargetReached);
+void DisplayGhePublishStats(GlobalHist_CONTEXT *pGheContext);
+
+// Monitoring. Copies the counters as of the last processed frame, from any thread, without
+// locking. Returns FALSE and zeroes pStats when the library was built without GlobalHist_ENABLE_STATS.
+bool DisplayGheGetStatsSnapshot(GlobalHist_CONTEXT *pGheContext, GlobalHist_STATS *pStats);
+
+#endif
@@ -0,0 +1,126 @@
+#include "GHE_Algorithm.h"
+#include "GHE_Stripe.h"
+
+struct _GlobalHist_STRIPE_CONTEXT
+{
+    GlobalHist_CONTEXT *pGheContext;
+    double ProvisionalFraction;
+    GlobalHist_ARGS Frame;               // Begin args, Histogram is the running sum of the stripes
+    uint64_t PixelCount;                 // Pixels merged so far
+    uint64_t ProvisionalPixelCount;      // Pixels after which the provisional LUT is computed, 0 for none
+    bool IsProvisionalValid;
+    uint32_t Provisional[GlobalHist_IET_LUT_LENGTH];
+    GlobalHist_CONTEXT Scratch;          // Copy of the context the provisional frame runs through
+};
+
+// DisplayGheProcessFrame on the scratch copy, without the stats and the trace recorder: the
+// provisional frame is not a frame of the pipe
+static void ComputeProvisional(GlobalHist_STRIPE_CONTEXT *pStripe)
+{
+    GlobalHist_CONTEXT *pScratch = &pStripe->Scratch;
+    GlobalHist_ARGS Args = pStripe->Frame;
+    uint64_t FramePixels = (uint64_t)Args.Resolution_X * Args.Resolution_Y;
+
+    // Scaled to the whole frame, the brightness change against the previous frame is then the
+    // one the complete frame will show
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        Args.Histogram[BinIndex] = (uint32_t)(((uint64_t)Args.Histogram[BinIndex] * FramePixels + pStripe->PixelCount / 2) / pStripe->PixelCount);
+    }
+
+    memcpy(pScratch, pStripe->pGheContext, sizeof(GlobalHist_CONTEXT));
+    memcpy(pScratch->Histogram, Args.Histogram, sizeof(Args.Histogram));
+    pScratch->Algorithm.ImageSize = Args.Resolution_X * Args.Resolution_Y;
+
+    pScratch->GheFuncTable.pGheAlgorithm(pScratch, &Args);
+    pScratch->GheFuncTable.pGheSetIet(pScratch, &Args);
+
+    memcpy(pStripe->Provisional, Args.DietFactor, sizeof(pStripe->Provisional));
+    pStripe->IsProvisionalValid = TRUE;
+}
+
+GlobalHist_STRIPE_CONTEXT *DisplayGheCreateStripeContext(GlobalHist_CONTEXT *pGheContext, double ProvisionalFraction)
+{
+    GlobalHist_STRIPE_CONTEXT *pStripe;
+
+    if ((NULL == pGheContext) || !((0 == ProvisionalFraction) || ((ProvisionalFraction > 0) && (ProvisionalFraction < 1))))
+    {
+        return NULL;
+    }
+
+    pStripe = (GlobalHist_STRIPE_CONTEXT *)calloc(1, sizeof(GlobalHist_STRIPE_CONTEXT));
+
+    if (NULL == pStripe)
+    {
+        return NULL;
+    }
+
+    pStripe->pGheContext         = pGheContext;
+    pStripe->ProvisionalFraction = ProvisionalFraction;
+
+    return pStripe;
+}
+
+void DisplayGheDestroyStripeContext(GlobalHist_STRIPE_CONTEXT *pStripe)
+{
+    free(pStripe);
+}
+
+void DisplayGheStripeBegin(GlobalHist_STRIPE_CONTEXT *pStripe, const GlobalHist_ARGS *pGheArgs)
+{
+    uint64_t FramePixels = (uint64_t)pGheArgs->Resolution_X * pGheArgs->Resolution_Y;
+
+    pStripe->Frame = *pGheArgs;
+    memset(pStripe->Frame.Histogram, 0, sizeof(pStripe->Frame.Histogram));
+
+    pStripe->PixelCount            = 0;
+    pStripe->IsProvisionalValid    = FALSE;
+    pStripe->ProvisionalPixelCount = 0;
+
+    if (pStripe->ProvisionalFraction > 0)
+    {
+        pStripe->ProvisionalPixelCount = DD_MAX((uint64_t)(pStripe->ProvisionalFraction * (double)FramePixels), 1);
+    }
+
+    // Unknown resolution, nothing to scale the partial histogram to
+    if (0 == FramePixels)
+    {
+        pStripe->ProvisionalPixelCount = 0;
+    }
+}
+
+bool DisplayGheStripeAdd(GlobalHist_STRIPE_CONTEXT *pStripe, const uint32_t *pStripeHistogram)
+{
+    uint32_t StripePixels = 0;
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        pStripe->Frame.Histogram[BinIndex] += pStripeHistogram[BinIndex];
+        StripePixels += pStripeHistogram[BinIndex];
+    }
+
+    pStripe->PixelCount += StripePixels;
+
+    if ((0 == pStripe->ProvisionalPixelCount) || pStripe->IsProvisionalValid || (pStripe->PixelCount < pStripe->ProvisionalPixelCount))
+    {
+        return FALSE;
+    }
+
+    ComputeProvisional(pStripe);
+
+    return TRUE;
+}
+
+const uint32_t *DisplayGheStripeGetProvisional(const GlobalHist_STRIPE_CONTEXT *pStripe)
+{
+    return pStripe->IsProvisionalValid ? pStripe->Provisional : NULL;
+}
+
+void DisplayGheStripeFinish(GlobalHist_STRIPE_CONTEXT *pStripe, GlobalHist_ARGS *pGheArgs)
+{
+    *pGheArgs = pStripe->Frame;
+    DisplayGheProcessFrame(pStripe->pGheContext, pGheArgs);
+
+    pStripe->PixelCount         = 0;
+    pStripe->IsProvisionalValid = FALSE;
+}
@@ -0,0 +1,47 @@
+/**
+ *
+ * @file  GHE_Stripe.h
+ * @brief  Stripe wise histogram accumulation: a frame's histogram merged as its stripes scan out
+ *
+ * The capture path hands in one partial histogram per horizontal stripe as soon as the stripe is
+ * scanned out. Stripes are merged into the running histogram and pixel count on arrival, so when
+ * the last one comes in only the per frame work of DisplayGheProcessFrame on GlobalHist_BIN_COUNT
+ * bins is left, whatever the resolution and stripe count. The result is bit for bit what
+ * DisplayGheProcessFrame gives for the summed histogram.
+ *
+ * Optionally a provisional DietFactor is computed once ProvisionalFraction of the frame's pixels
+ * arrived. The partial histogram is scaled to the full pixel count and run through a scratch copy
+ * of the context, so the provisional LUT sees the same brightness change the final one will and
+ * the context itself only ever sees complete frames.
+ *
+ */
+
+#ifndef _DISPLAY_GHESTRIPE_H_
+#define _DISPLAY_GHESTRIPE_H_
+
+#include "DisplayPc.h"
+
+typedef struct _GlobalHist_STRIPE_CONTEXT GlobalHist_STRIPE_CONTEXT;
+
+// Accumulates frames for pGheContext, which must outlive the stripe context. ProvisionalFraction
+// in (0, 1) enables the provisional DietFactor, 0 disables it. Returns NULL for any other value.
+GlobalHist_STRIPE_CONTEXT *DisplayGheCreateStripeContext(GlobalHist_CONTEXT *pGheContext, double ProvisionalFraction);
+void DisplayGheDestroyStripeContext(GlobalHist_STRIPE_CONTEXT *pStripe);
+
+// Starts a frame. PipeId, IsProgramDiet, the resolution and TimestampNs of pGheArgs are kept for
+// the frame, its Histogram is ignored. A frame still accumulating is dropped.
+void DisplayGheStripeBegin(GlobalHist_STRIPE_CONTEXT *pStripe, const GlobalHist_ARGS *pGheArgs);
+
+// Merges one stripe histogram. Returns TRUE when this stripe completed the provisional fraction,
+// DisplayGheStripeGetProvisional has the provisional DietFactor from then on.
+bool DisplayGheStripeAdd(GlobalHist_STRIPE_CONTEXT *pStripe, const uint32_t *pStripeHistogram);
+
+// Provisional DietFactor of the frame being accumulated, NULL before the fraction arrived or when
+// the resolution of the frame is unknown
+const uint32_t *DisplayGheStripeGetProvisional(const GlobalHist_STRIPE_CONTEXT *pStripe);
+
+// Runs the merged frame through the context. pGheArgs receives the args of DisplayGheStripeBegin
+// with the merged Histogram and the DietFactor, as from DisplayGheProcessFrame.
+void DisplayGheStripeFinish(GlobalHist_STRIPE_CONTEXT *pStripe, GlobalHist_ARGS *pGheArgs);
+
+#endif
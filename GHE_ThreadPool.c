@@ -0,0 +1,194 @@
+#include <pthread.h>
+#include <unistd.h>
+
+#include "GHE_Algorithm.h"
+#include "GHE_ThreadPool.h"
+
+#define GlobalHist_MAX_POOL_THREADS 256
+
+struct _GlobalHist_THREAD_POOL
+{
+    uint32_t ThreadCount;      // Worker threads plus the caller
+    pthread_t *pWorker;
+
+    pthread_mutex_t RunLock;   // Serializes DisplayGheThreadPoolRun callers
+    pthread_mutex_t Lock;
+    pthread_cond_t WorkReady;
+    pthread_cond_t WorkDone;
+
+    uint64_t Generation;       // Bumped for every run, workers wait for a change
+    bool IsShutdown;
+
+    PFN_GlobalHistTASK pfnTask;
+    void *pTaskContext;
+    uint32_t TaskCount;
+    uint32_t NextTask;         // Next task index to hand out, protected by Lock
+    uint32_t ActiveWorkers;    // Workers still inside the current run
+};
+
+// Pulls tasks of the current run until none are left
+static void RunPendingTasks(GlobalHist_THREAD_POOL *pPool)
+{
+    pthread_mutex_lock(&pPool->Lock);
+
+    while (pPool->NextTask < pPool->TaskCount)
+    {
+        uint32_t TaskIndex = pPool->NextTask++;
+
+        pthread_mutex_unlock(&pPool->Lock);
+        pPool->pfnTask(pPool->pTaskContext, TaskIndex);
+        pthread_mutex_lock(&pPool->Lock);
+    }
+
+    pthread_mutex_unlock(&pPool->Lock);
+}
+
+static void *WorkerMain(void *pArg)
+{
+    GlobalHist_THREAD_POOL *pPool = (GlobalHist_THREAD_POOL *)pArg;
+    uint64_t SeenGeneration = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&pPool->Lock);
+
+        while ((FALSE == pPool->IsShutdown) && (SeenGeneration == pPool->Generation))
+        {
+            pthread_cond_wait(&pPool->WorkReady, &pPool->Lock);
+        }
+
+        if (pPool->IsShutdown)
+        {
+            pthread_mutex_unlock(&pPool->Lock);
+            break;
+        }
+
+        SeenGeneration = pPool->Generation;
+        pthread_mutex_unlock(&pPool->Lock);
+
+        RunPendingTasks(pPool);
+
+        pthread_mutex_lock(&pPool->Lock);
+        if (0 == --pPool->ActiveWorkers)
+        {
+            pthread_cond_signal(&pPool->WorkDone);
+        }
+        pthread_mutex_unlock(&pPool->Lock);
+    }
+
+    return NULL;
+}
+
+GlobalHist_THREAD_POOL *DisplayGheCreateThreadPool(uint32_t ThreadCount)
+{
+    GlobalHist_THREAD_POOL *pPool;
+
+    if (0 == ThreadCount)
+    {
+        long OnlineCpus = sysconf(_SC_NPROCESSORS_ONLN);
+        ThreadCount = (OnlineCpus > 0) ? (uint32_t)OnlineCpus : 1;
+    }
+
+    ThreadCount = DD_MIN(ThreadCount, GlobalHist_MAX_POOL_THREADS);
+
+    pPool = (GlobalHist_THREAD_POOL *)calloc(1, sizeof(GlobalHist_THREAD_POOL));
+
+    if (NULL == pPool)
+    {
+        return NULL;
+    }
+
+    pPool->pWorker = (pthread_t *)calloc(ThreadCount, sizeof(pthread_t));
+
+    if (NULL == pPool->pWorker)
+    {
+        free(pPool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pPool->RunLock, NULL);
+    pthread_mutex_init(&pPool->Lock, NULL);
+    pthread_cond_init(&pPool->WorkReady, NULL);
+    pthread_cond_init(&pPool->WorkDone, NULL);
+
+    // The caller is one of the threads, only spawn the rest
+    pPool->ThreadCount = 1;
+    for (uint32_t Count = 1; Count < ThreadCount; Count++)
+    {
+        if (0 != pthread_create(&pPool->pWorker[Count - 1], NULL, WorkerMain, pPool))
+        {
+            break;
+        }
+
+        pPool->ThreadCount++;
+    }
+
+    return pPool;
+}
+
+void DisplayGheDestroyThreadPool(GlobalHist_THREAD_POOL *pPool)
+{
+    if (NULL == pPool)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&pPool->Lock);
+    pPool->IsShutdown = TRUE;
+    pthread_cond_broadcast(&pPool->WorkReady);
+    pthread_mutex_unlock(&pPool->Lock);
+
+    for (uint32_t Count = 1; Count < pPool->ThreadCount; Count++)
+    {
+        pthread_join(pPool->pWorker[Count - 1], NULL);
+    }
+
+    pthread_cond_destroy(&pPool->WorkDone);
+    pthread_cond_destroy(&pPool->WorkReady);
+    pthread_mutex_destroy(&pPool->Lock);
+    pthread_mutex_destroy(&pPool->RunLock);
+    free(pPool->pWorker);
+    free(pPool);
+}
+
+uint32_t DisplayGheGetThreadCount(GlobalHist_THREAD_POOL *pPool)
+{
+    return (NULL == pPool) ? 1 : pPool->ThreadCount;
+}
+
+void DisplayGheThreadPoolRun(GlobalHist_THREAD_POOL *pPool, uint32_t TaskCount, PFN_GlobalHistTASK pfnTask, void *pTaskContext)
+{
+    // Nothing to share, avoid waking the workers
+    if ((NULL == pPool) || (1 == pPool->ThreadCount) || (TaskCount <= 1))
+    {
+        for (uint32_t TaskIndex = 0; TaskIndex < TaskCount; TaskIndex++)
+        {
+            pfnTask(pTaskContext, TaskIndex);
+        }
+
+        return;
+    }
+
+    pthread_mutex_lock(&pPool->RunLock);
+
+    pthread_mutex_lock(&pPool->Lock);
+    pPool->pfnTask       = pfnTask;
+    pPool->pTaskContext  = pTaskContext;
+    pPool->TaskCount     = TaskCount;
+    pPool->NextTask      = 0;
+    pPool->ActiveWorkers = pPool->ThreadCount - 1;
+    pPool->Generation++;
+    pthread_cond_broadcast(&pPool->WorkReady);
+    pthread_mutex_unlock(&pPool->Lock);
+
+    RunPendingTasks(pPool);
+
+    pthread_mutex_lock(&pPool->Lock);
+    while (0 != pPool->ActiveWorkers)
+    {
+        pthread_cond_wait(&pPool->WorkDone, &pPool->Lock);
+    }
+    pthread_mutex_unlock(&pPool->Lock);
+
+    pthread_mutex_unlock(&pPool->RunLock);
+}
@@ -0,0 +1,27 @@
+/**
+ *
+ * @file  GHE_ThreadPool.h
+ * @brief  Minimal fork/join worker pool used to split frame buffer work across cores
+ *
+ */
+
+#ifndef _DISPLAY_GHETHREADPOOL_H_
+#define _DISPLAY_GHETHREADPOOL_H_
+
+#include "DisplayPc.h"
+
+// Task callback. Called once for every TaskIndex in [0, TaskCount), from any pool thread.
+typedef void (*PFN_GlobalHistTASK)(void *pTaskContext, uint32_t TaskIndex);
+
+typedef struct _GlobalHist_THREAD_POOL GlobalHist_THREAD_POOL;
+
+// ThreadCount includes the calling thread. 0 selects the number of online CPUs.
+GlobalHist_THREAD_POOL *DisplayGheCreateThreadPool(uint32_t ThreadCount);
+void DisplayGheDestroyThreadPool(GlobalHist_THREAD_POOL *pPool);
+uint32_t DisplayGheGetThreadCount(GlobalHist_THREAD_POOL *pPool);
+
+// Runs all tasks and returns once every one of them finished. The caller executes tasks too.
+// A NULL pool runs the tasks in order on the calling thread. Calls on one pool are serialized.
+void DisplayGheThreadPoolRun(GlobalHist_THREAD_POOL *pPool, uint32_t TaskCount, PFN_GlobalHistTASK pfnTask, void *pTaskContext);
+
+#endif
@@ -0,0 +1,524 @@
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "GHE_Algorithm.h"
+#include "GHE_Cpu.h"
+#include "GHE_LutApply.h"
+#include "GHE_Tiled.h"
+
+#define TILED_FACTOR_ENTRIES 1024       // Multipliers per tile, enough for 10 bit channels
+#define TILED_WEIGHT_BITS 8             // Bilinear weights are Q8
+#define TILED_WEIGHT_ONE (1 << TILED_WEIGHT_BITS)
+#define TILED_MIN_BAND_PIXELS 65536     // Below this a band is not worth handing to another thread
+
+// Applies the blended LUT to the Width columns of one segment of a row. pRow0 / pRow1 are the
+// vertically blended tables of its two tile columns, pWeight the horizontal weights.
+typedef void (*PFN_GlobalHistTILEDSEGMENT)(const uint32_t *pRow0, const uint32_t *pRow1, const uint16_t *pWeight,
+                                           const uint8_t *pSrc, uint8_t *pDst, uint32_t Width);
+
+// The two tiles a pixel column or row blends between and the weight of the second one
+typedef struct _TILED_BLEND
+{
+    uint16_t Tile0;
+    uint16_t Tile1;
+    uint16_t Weight1;
+} TILED_BLEND;
+
+// A run of columns blending between the same two tile columns
+typedef struct _TILED_SEGMENT
+{
+    uint32_t FirstColumn;
+    uint32_t EndColumn;
+    uint16_t Tile0;
+    uint16_t Tile1;
+} TILED_SEGMENT;
+
+struct _GlobalHist_TILED_CONTEXT
+{
+    uint32_t TilesX;
+    uint32_t TilesY;
+    uint32_t TileCount;
+    size_t ContextStride;                              // Bytes between two tile contexts
+    uint8_t *pContextMemory;                           // [TileCount] GlobalHist_CONTEXT, created in place
+    GlobalHist_ARGS *pArgs;                            // [TileCount], histogram in and DietFactor out
+    uint32_t (*pHistogram)[GlobalHist_BIN_COUNT];      // [TileCount], DisplayGheTiledProcessFrame only
+    uint16_t (*pFactor)[TILED_FACTOR_ENTRIES];         // [TileCount], apply multipliers of every tile
+    uint16_t *pColumnWeight;                           // [ColumnCapacity], Weight1 of every column
+    uint32_t ColumnCapacity;
+    TILED_SEGMENT Segment[GlobalHist_MAX_TILES + 1];   // Column runs of the last applied width
+    uint32_t SegmentCount;
+};
+
+typedef struct _TILED_APPLY_JOB
+{
+    GlobalHist_TILED_CONTEXT *pTiled;
+    const GlobalHist_FRAME *pFrame;
+    uint8_t *pOutput;
+    uint32_t OutputStride;
+    uint32_t RowsPerBand;
+    uint32_t FactorCount;           // 1 << Bpc of the frame
+    PFN_GlobalHistTILEDSEGMENT pfnSegment;
+} TILED_APPLY_JOB;
+
+static GlobalHist_CONTEXT *GetTileContext(GlobalHist_TILED_CONTEXT *pTiled, uint32_t Tile)
+{
+    return (GlobalHist_CONTEXT *)(pTiled->pContextMemory + Tile * pTiled->ContextStride);
+}
+
+GlobalHist_TILED_CONTEXT *DisplayGheCreateTiled(uint32_t TilesX, uint32_t TilesY)
+{
+    GlobalHist_TILED_CONTEXT *pTiled;
+
+    if ((0 == TilesX) || (0 == TilesY) || (TilesX > GlobalHist_MAX_TILES) || (TilesY > GlobalHist_MAX_TILES))
+    {
+        return NULL;
+    }
+
+    pTiled = (GlobalHist_TILED_CONTEXT *)calloc(1, sizeof(GlobalHist_TILED_CONTEXT));
+
+    if (NULL == pTiled)
+    {
+        return NULL;
+    }
+
+    pTiled->TilesX        = TilesX;
+    pTiled->TilesY        = TilesY;
+    pTiled->TileCount     = TilesX * TilesY;
+    pTiled->ContextStride = (DisplayGheGetContextSize() + GlobalHist_CONTEXT_ALIGNMENT - 1) & ~(size_t)(GlobalHist_CONTEXT_ALIGNMENT - 1);
+
+    pTiled->pContextMemory = (uint8_t *)malloc(pTiled->TileCount * pTiled->ContextStride);
+    pTiled->pArgs          = (GlobalHist_ARGS *)calloc(pTiled->TileCount, sizeof(GlobalHist_ARGS));
+    pTiled->pHistogram     = (uint32_t (*)[GlobalHist_BIN_COUNT])calloc(pTiled->TileCount, sizeof(*pTiled->pHistogram));
+    pTiled->pFactor        = (uint16_t (*)[TILED_FACTOR_ENTRIES])calloc(pTiled->TileCount, sizeof(*pTiled->pFactor));
+
+    if ((NULL == pTiled->pContextMemory) || (NULL == pTiled->pArgs) || (NULL == pTiled->pHistogram) || (NULL == pTiled->pFactor))
+    {
+        DisplayGheDestroyTiled(pTiled);
+        return NULL;
+    }
+
+    // Tile contexts are never registered to a pipe
+    for (uint32_t Tile = 0; Tile < pTiled->TileCount; Tile++)
+    {
+        DisplayGheCreateContextInPlace(GlobalHist_PIPE_ANY, GetTileContext(pTiled, Tile), pTiled->ContextStride);
+        pTiled->pArgs[Tile].PipeId = GlobalHist_PIPE_ANY;
+    }
+
+    return pTiled;
+}
+
+void DisplayGheDestroyTiled(GlobalHist_TILED_CONTEXT *pTiled)
+{
+    if (NULL == pTiled)
+    {
+        return;
+    }
+
+    free(pTiled->pContextMemory);
+    free(pTiled->pArgs);
+    free(pTiled->pHistogram);
+    free(pTiled->pFactor);
+    free(pTiled->pColumnWeight);
+    free(pTiled);
+}
+
+// DisplayGheProcessFrame without the trace recorder, which belongs to the display pipe
+static void ProcessTileRow(void *pTaskContext, uint32_t TileY)
+{
+    GlobalHist_TILED_CONTEXT *pTiled = (GlobalHist_TILED_CONTEXT *)pTaskContext;
+
+    for (uint32_t Tile = TileY * pTiled->TilesX; Tile < (TileY + 1) * pTiled->TilesX; Tile++)
+    {
+        GlobalHist_CONTEXT *pGheContext = GetTileContext(pTiled, Tile);
+        GlobalHist_ARGS *pGheArgs = &pTiled->pArgs[Tile];
+
+        memcpy(pGheContext->Histogram, pGheArgs->Histogram, sizeof(pGheContext->Histogram));
+        pGheContext->Algorithm.ImageSize = pGheArgs->Resolution_X * pGheArgs->Resolution_Y;
+
+        pGheContext->GheFuncTable.pGheAlgorithm(pGheContext, pGheArgs);
+        pGheContext->GheFuncTable.pGheSetIet(pGheContext, pGheArgs);
+
+        GlobalHist_STATS_COUNT(pGheContext, FramesProcessed, 1);
+        GlobalHist_STATS_PUBLISH(pGheContext);
+    }
+}
+
+void DisplayGheTiledProcessHistograms(GlobalHist_TILED_CONTEXT *pTiled, const uint32_t (*pHistogram)[GlobalHist_BIN_COUNT],
+                                      uint32_t Resolution_X, uint32_t Resolution_Y, uint64_t TimestampNs, GlobalHist_THREAD_POOL *pPool)
+{
+    for (uint32_t TileY = 0; TileY < pTiled->TilesY; TileY++)
+    {
+        for (uint32_t TileX = 0; TileX < pTiled->TilesX; TileX++)
+        {
+            uint32_t Tile = TileY * pTiled->TilesX + TileX;
+            GlobalHist_ARGS *pGheArgs = &pTiled->pArgs[Tile];
+
+            memcpy(pGheArgs->Histogram, pHistogram[Tile], sizeof(pGheArgs->Histogram));
+            pGheArgs->Resolution_X = GlobalHist_TILE_START(TileX + 1, pTiled->TilesX, Resolution_X) - GlobalHist_TILE_START(TileX, pTiled->TilesX, Resolution_X);
+            pGheArgs->Resolution_Y = GlobalHist_TILE_START(TileY + 1, pTiled->TilesY, Resolution_Y) - GlobalHist_TILE_START(TileY, pTiled->TilesY, Resolution_Y);
+            pGheArgs->TimestampNs  = TimestampNs;
+        }
+    }
+
+    DisplayGheThreadPoolRun(pPool, pTiled->TilesY, ProcessTileRow, pTiled);
+}
+
+bool DisplayGheTiledProcessFrame(GlobalHist_TILED_CONTEXT *pTiled, const GlobalHist_FRAME *pFrame, uint64_t TimestampNs,
+                                 GlobalHist_THREAD_POOL *pPool)
+{
+    if (FALSE == DisplayGheBuildTileHistograms(pFrame, pTiled->TilesX, pTiled->TilesY, pTiled->pHistogram, pPool))
+    {
+        return FALSE;
+    }
+
+    DisplayGheTiledProcessHistograms(pTiled, (const uint32_t (*)[GlobalHist_BIN_COUNT])pTiled->pHistogram,
+                                     pFrame->Width, pFrame->Height, TimestampNs, pPool);
+
+    return TRUE;
+}
+
+const uint32_t *DisplayGheTiledGetDietFactor(GlobalHist_TILED_CONTEXT *pTiled, uint32_t TileX, uint32_t TileY)
+{
+    if ((TileX >= pTiled->TilesX) || (TileY >= pTiled->TilesY))
+    {
+        return NULL;
+    }
+
+    return pTiled->pArgs[TileY * pTiled->TilesX + TileX].DietFactor;
+}
+
+// Tile centers sit at (Tile + 0.5) * Size / Count. Pixels outside the outermost centers take the
+// outermost tile unblended.
+static TILED_BLEND GetBlend(uint32_t Position, uint32_t Count, uint32_t Size)
+{
+    TILED_BLEND Blend;
+    int64_t Center = ((int64_t)(2 * Position + 1) * Count * TILED_WEIGHT_ONE) / (2 * (int64_t)Size) - TILED_WEIGHT_ONE / 2;
+    uint32_t Tile0 = (Center > 0) ? (uint32_t)(Center >> TILED_WEIGHT_BITS) : 0;
+
+    if ((Center <= 0) || (Tile0 >= Count - 1))
+    {
+        Blend.Tile0   = (uint16_t)DD_MIN(Tile0, Count - 1);
+        Blend.Tile1   = Blend.Tile0;
+        Blend.Weight1 = 0;
+    }
+    else
+    {
+        Blend.Tile0   = (uint16_t)Tile0;
+        Blend.Tile1   = (uint16_t)(Tile0 + 1);
+        Blend.Weight1 = (uint16_t)(Center & (TILED_WEIGHT_ONE - 1));
+    }
+
+    return Blend;
+}
+
+// Bilinear blend of four multipliers, the vertical half already done per row in pRow0 / pRow1
+static inline uint32_t BlendFactor(const uint32_t *pRow0, const uint32_t *pRow1, uint32_t WeightX, uint32_t Value)
+{
+    return (pRow0[Value] * (TILED_WEIGHT_ONE - WeightX) + pRow1[Value] * WeightX + (1 << (2 * TILED_WEIGHT_BITS - 1))) >> (2 * TILED_WEIGHT_BITS);
+}
+
+static inline uint32_t ApplyFactor(uint32_t Value, uint32_t Factor, uint32_t MaxValue)
+{
+    uint32_t Result = (Value * Factor + (1 << (GlobalHist_DIET_FRACTION_BITS - 1))) >> GlobalHist_DIET_FRACTION_BITS;
+    return DD_MIN(Result, MaxValue);
+}
+
+static void TiledSegmentRGB888(const uint32_t *pRow0, const uint32_t *pRow1, const uint16_t *pWeight, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    for (uint32_t Pixel = 0; Pixel < Width; Pixel++, pSrc += 3, pDst += 3)
+    {
+        uint8_t R = pSrc[0], G = pSrc[1], B = pSrc[2];
+        uint32_t Factor = BlendFactor(pRow0, pRow1, pWeight[Pixel], DD_MAX(DD_MAX(R, G), B));
+
+        pDst[0] = (uint8_t)ApplyFactor(R, Factor, 255);
+        pDst[1] = (uint8_t)ApplyFactor(G, Factor, 255);
+        pDst[2] = (uint8_t)ApplyFactor(B, Factor, 255);
+    }
+}
+
+static void TiledSegmentRGBA8888(const uint32_t *pRow0, const uint32_t *pRow1, const uint16_t *pWeight, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    for (uint32_t Pixel = 0; Pixel < Width; Pixel++, pSrc += 4, pDst += 4)
+    {
+        uint8_t R = pSrc[0], G = pSrc[1], B = pSrc[2], A = pSrc[3];
+        uint32_t Factor = BlendFactor(pRow0, pRow1, pWeight[Pixel], DD_MAX(DD_MAX(R, G), B));
+
+        pDst[0] = (uint8_t)ApplyFactor(R, Factor, 255);
+        pDst[1] = (uint8_t)ApplyFactor(G, Factor, 255);
+        pDst[2] = (uint8_t)ApplyFactor(B, Factor, 255);
+        pDst[3] = A;
+    }
+}
+
+#if GlobalHist_HAS_ISA_DISPATCH
+
+// Both gathers and the blend in 32 bit lanes, then the 16 bit channel multiply of the
+// DisplayGheApplyDiet RGBA8888 kernels with the alpha lane multiplied by 1.0
+GlobalHist_TARGET_AVX2 static void TiledSegmentRGBA8888Avx2(const uint32_t *pRow0, const uint32_t *pRow1, const uint16_t *pWeight,
+                                                            const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    const __m256i LowByte = _mm256_set1_epi32(0xFF);
+    const __m256i WeightOne = _mm256_set1_epi32(TILED_WEIGHT_ONE);
+    const __m256i Round = _mm256_set1_epi32(1 << (2 * TILED_WEIGHT_BITS - 1));
+    const __m256i AlphaFactor = _mm256_set1_epi32(1 << (GlobalHist_DIET_FRACTION_BITS + 16));
+    const __m256i One = _mm256_set1_epi16(1);
+    const __m256i Zero = _mm256_setzero_si256();
+    uint32_t Pixel = 0;
+
+    for (; Pixel + 8 <= Width; Pixel += 8)
+    {
+        __m256i Val = _mm256_loadu_si256((const __m256i *)(pSrc + Pixel * 4));
+        __m256i MaxVal = _mm256_max_epu8(_mm256_max_epu8(Val, _mm256_srli_epi32(Val, 8)), _mm256_srli_epi32(Val, 16));
+        __m256i Weight = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(pWeight + Pixel)));
+        __m256i Factor, ColorPair, ColorAlpha, Lo, Hi;
+
+        MaxVal = _mm256_and_si256(MaxVal, LowByte);
+        Factor = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_i32gather_epi32((const int *)pRow0, MaxVal, 4), _mm256_sub_epi32(WeightOne, Weight)),
+                                  _mm256_mullo_epi32(_mm256_i32gather_epi32((const int *)pRow1, MaxVal, 4), Weight));
+        Factor = _mm256_srli_epi32(_mm256_add_epi32(Factor, Round), 2 * TILED_WEIGHT_BITS);
+
+        // Per 128 bit lane unpacklo gives the 16 bit R, G, B, A factors of pixels 0, 1 and unpackhi
+        // those of 2, 3, the pixel order of the unpacked channels below
+        ColorPair = _mm256_or_si256(Factor, _mm256_slli_epi32(Factor, 16));
+        ColorAlpha = _mm256_or_si256(Factor, AlphaFactor);
+
+        Lo = _mm256_mulhi_epu16(_mm256_slli_epi16(_mm256_unpacklo_epi8(Val, Zero), 8), _mm256_unpacklo_epi32(ColorPair, ColorAlpha));
+        Hi = _mm256_mulhi_epu16(_mm256_slli_epi16(_mm256_unpackhi_epi8(Val, Zero), 8), _mm256_unpackhi_epi32(ColorPair, ColorAlpha));
+        Lo = _mm256_srli_epi16(_mm256_add_epi16(Lo, One), 1);
+        Hi = _mm256_srli_epi16(_mm256_add_epi16(Hi, One), 1);
+
+        _mm256_storeu_si256((__m256i *)(pDst + Pixel * 4), _mm256_packus_epi16(Lo, Hi));
+    }
+
+    TiledSegmentRGBA8888(pRow0, pRow1, pWeight + Pixel, pSrc + Pixel * 4, pDst + Pixel * 4, Width - Pixel);
+}
+
+GlobalHist_TARGET_AVX512 static void TiledSegmentRGBA8888Avx512(const uint32_t *pRow0, const uint32_t *pRow1, const uint16_t *pWeight,
+                                                                const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    const __m512i LowByte = _mm512_set1_epi32(0xFF);
+    const __m512i WeightOne = _mm512_set1_epi32(TILED_WEIGHT_ONE);
+    const __m512i Round = _mm512_set1_epi32(1 << (2 * TILED_WEIGHT_BITS - 1));
+    const __m512i AlphaFactor = _mm512_set1_epi32(1 << (GlobalHist_DIET_FRACTION_BITS + 16));
+    const __m512i One = _mm512_set1_epi16(1);
+    const __m512i Zero = _mm512_setzero_si512();
+    uint32_t Pixel = 0;
+
+    for (; Pixel + 16 <= Width; Pixel += 16)
+    {
+        __m512i Val = _mm512_loadu_si512((const void *)(pSrc + Pixel * 4));
+        __m512i MaxVal = _mm512_max_epu8(_mm512_max_epu8(Val, _mm512_srli_epi32(Val, 8)), _mm512_srli_epi32(Val, 16));
+        __m512i Weight = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *)(pWeight + Pixel)));
+        __m512i Factor, ColorPair, ColorAlpha, Lo, Hi;
+
+        MaxVal = _mm512_and_si512(MaxVal, LowByte);
+        Factor = _mm512_add_epi32(_mm512_mullo_epi32(_mm512_i32gather_epi32(MaxVal, (const void *)pRow0, 4), _mm512_sub_epi32(WeightOne, Weight)),
+                                  _mm512_mullo_epi32(_mm512_i32gather_epi32(MaxVal, (const void *)pRow1, 4), Weight));
+        Factor = _mm512_srli_epi32(_mm512_add_epi32(Factor, Round), 2 * TILED_WEIGHT_BITS);
+
+        ColorPair = _mm512_or_si512(Factor, _mm512_slli_epi32(Factor, 16));
+        ColorAlpha = _mm512_or_si512(Factor, AlphaFactor);
+
+        Lo = _mm512_mulhi_epu16(_mm512_slli_epi16(_mm512_unpacklo_epi8(Val, Zero), 8), _mm512_unpacklo_epi32(ColorPair, ColorAlpha));
+        Hi = _mm512_mulhi_epu16(_mm512_slli_epi16(_mm512_unpackhi_epi8(Val, Zero), 8), _mm512_unpackhi_epi32(ColorPair, ColorAlpha));
+        Lo = _mm512_srli_epi16(_mm512_add_epi16(Lo, One), 1);
+        Hi = _mm512_srli_epi16(_mm512_add_epi16(Hi, One), 1);
+
+        _mm512_storeu_si512((void *)(pDst + Pixel * 4), _mm512_packus_epi16(Lo, Hi));
+    }
+
+    TiledSegmentRGBA8888Avx2(pRow0, pRow1, pWeight + Pixel, pSrc + Pixel * 4, pDst + Pixel * 4, Width - Pixel);
+}
+
+#endif
+
+static void TiledSegmentY8(const uint32_t *pRow0, const uint32_t *pRow1, const uint16_t *pWeight, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    for (uint32_t Pixel = 0; Pixel < Width; Pixel++)
+    {
+        uint8_t Luma = pSrc[Pixel];
+
+        pDst[Pixel] = (uint8_t)ApplyFactor(Luma, BlendFactor(pRow0, pRow1, pWeight[Pixel], Luma), 255);
+    }
+}
+
+static void TiledSegmentYUYV(const uint32_t *pRow0, const uint32_t *pRow1, const uint16_t *pWeight, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    for (uint32_t Pixel = 0; Pixel < Width; Pixel++)
+    {
+        uint8_t Luma = pSrc[Pixel * 2];
+
+        pDst[Pixel * 2]     = (uint8_t)ApplyFactor(Luma, BlendFactor(pRow0, pRow1, pWeight[Pixel], Luma), 255);
+        pDst[Pixel * 2 + 1] = pSrc[Pixel * 2 + 1];
+    }
+}
+
+static void TiledSegmentRGBA1010102(const uint32_t *pRow0, const uint32_t *pRow1, const uint16_t *pWeight, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    for (uint32_t Pixel = 0; Pixel < Width; Pixel++)
+    {
+        uint32_t Val, R, G, B, Factor;
+
+        memcpy(&Val, pSrc + Pixel * 4, sizeof(Val));
+        R = Val & 0x3FF;
+        G = (Val >> 10) & 0x3FF;
+        B = (Val >> 20) & 0x3FF;
+        Factor = BlendFactor(pRow0, pRow1, pWeight[Pixel], DD_MAX(DD_MAX(R, G), B));
+
+        Val = (Val & 0xC0000000) | ApplyFactor(R, Factor, 0x3FF) | (ApplyFactor(G, Factor, 0x3FF) << 10) | (ApplyFactor(B, Factor, 0x3FF) << 20);
+        memcpy(pDst + Pixel * 4, &Val, sizeof(Val));
+    }
+}
+
+static void TiledSegmentY10(const uint32_t *pRow0, const uint32_t *pRow1, const uint16_t *pWeight, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    for (uint32_t Pixel = 0; Pixel < Width; Pixel++)
+    {
+        uint16_t Val;
+
+        memcpy(&Val, pSrc + Pixel * 2, sizeof(Val));
+        Val &= 0x3FF;
+        Val = (uint16_t)ApplyFactor(Val, BlendFactor(pRow0, pRow1, pWeight[Pixel], Val), 0x3FF);
+        memcpy(pDst + Pixel * 2, &Val, sizeof(Val));
+    }
+}
+
+static void TiledSegmentP010(const uint32_t *pRow0, const uint32_t *pRow1, const uint16_t *pWeight, const uint8_t *pSrc, uint8_t *pDst, uint32_t Width)
+{
+    for (uint32_t Pixel = 0; Pixel < Width; Pixel++)
+    {
+        uint16_t Val;
+
+        memcpy(&Val, pSrc + Pixel * 2, sizeof(Val));
+        Val >>= 6;
+        Val = (uint16_t)(ApplyFactor(Val, BlendFactor(pRow0, pRow1, pWeight[Pixel], Val), 0x3FF) << 6);
+        memcpy(pDst + Pixel * 2, &Val, sizeof(Val));
+    }
+}
+
+// Per GlobalHist_ISA, as the DisplayGheApplyDiet row kernels
+static const PFN_GlobalHistTILEDSEGMENT TiledSegment[GlobalHist_ISA_COUNT][GlobalHist_PIXEL_FORMAT_COUNT] =
+{
+    { TiledSegmentRGB888, TiledSegmentRGBA8888,       TiledSegmentY8, TiledSegmentYUYV, TiledSegmentRGBA1010102, TiledSegmentY10, TiledSegmentP010 },
+#if GlobalHist_HAS_ISA_DISPATCH
+    { TiledSegmentRGB888, TiledSegmentRGBA8888Avx2,   TiledSegmentY8, TiledSegmentYUYV, TiledSegmentRGBA1010102, TiledSegmentY10, TiledSegmentP010 },
+    { TiledSegmentRGB888, TiledSegmentRGBA8888Avx512, TiledSegmentY8, TiledSegmentYUYV, TiledSegmentRGBA1010102, TiledSegmentY10, TiledSegmentP010 },
+#else
+    { TiledSegmentRGB888, TiledSegmentRGBA8888,       TiledSegmentY8, TiledSegmentYUYV, TiledSegmentRGBA1010102, TiledSegmentY10, TiledSegmentP010 },
+    { TiledSegmentRGB888, TiledSegmentRGBA8888,       TiledSegmentY8, TiledSegmentYUYV, TiledSegmentRGBA1010102, TiledSegmentY10, TiledSegmentP010 },
+#endif
+};
+
+// The vertical blend depends only on the row, so it is done once per row and tile column over
+// the whole factor table. Every pixel is left with a horizontal blend of two table entries.
+static void ApplyTiledBand(void *pTaskContext, uint32_t Band)
+{
+    TILED_APPLY_JOB *pJob = (TILED_APPLY_JOB *)pTaskContext;
+    GlobalHist_TILED_CONTEXT *pTiled = pJob->pTiled;
+    const GlobalHist_FRAME *pFrame = pJob->pFrame;
+    uint32_t Bpp = DisplayGheGetBytesPerPixel(pFrame->Format);
+    uint32_t FirstRow = Band * pJob->RowsPerBand;
+    uint32_t LastRow = DD_MIN(FirstRow + pJob->RowsPerBand, pFrame->Height);
+    uint32_t RowFactor[GlobalHist_MAX_TILES][TILED_FACTOR_ENTRIES];
+
+    for (uint32_t Row = FirstRow; Row < LastRow; Row++)
+    {
+        const uint8_t *pSrc = (const uint8_t *)pFrame->pData + (size_t)Row * pFrame->Stride;
+        uint8_t *pDst = pJob->pOutput + (size_t)Row * pJob->OutputStride;
+        TILED_BLEND RowBlend = GetBlend(Row, pTiled->TilesY, pFrame->Height);
+        uint32_t WeightY = RowBlend.Weight1;
+
+        for (uint32_t TileX = 0; TileX < pTiled->TilesX; TileX++)
+        {
+            const uint16_t *pTop = pTiled->pFactor[RowBlend.Tile0 * pTiled->TilesX + TileX];
+            const uint16_t *pBottom = pTiled->pFactor[RowBlend.Tile1 * pTiled->TilesX + TileX];
+
+            for (uint32_t Value = 0; Value < pJob->FactorCount; Value++)
+            {
+                RowFactor[TileX][Value] = pTop[Value] * (TILED_WEIGHT_ONE - WeightY) + pBottom[Value] * WeightY;
+            }
+        }
+
+        for (uint32_t SegmentIndex = 0; SegmentIndex < pTiled->SegmentCount; SegmentIndex++)
+        {
+            const TILED_SEGMENT *pSegment = &pTiled->Segment[SegmentIndex];
+
+            pJob->pfnSegment(RowFactor[pSegment->Tile0], RowFactor[pSegment->Tile1], pTiled->pColumnWeight + pSegment->FirstColumn,
+                             pSrc + (size_t)pSegment->FirstColumn * Bpp, pDst + (size_t)pSegment->FirstColumn * Bpp,
+                             pSegment->EndColumn - pSegment->FirstColumn);
+        }
+    }
+}
+
+bool DisplayGheTiledApplyDiet(GlobalHist_TILED_CONTEXT *pTiled, const GlobalHist_FRAME *pFrame, void *pOutput, uint32_t OutputStride,
+                              GlobalHist_THREAD_POOL *pPool)
+{
+    TILED_APPLY_JOB Job;
+    uint32_t BandCount, MinRowsPerBand;
+    uint32_t Bpp = DisplayGheGetBytesPerPixel(pFrame->Format);
+    uint32_t Bpc = DisplayGheGetBitsPerChannel(pFrame->Format);
+
+    if ((0 == Bpp) || (NULL == pFrame->pData) || (NULL == pOutput) || (0 == pFrame->Width) || (0 == pFrame->Height) ||
+        ((uint64_t)pFrame->Width * Bpp > pFrame->Stride) || ((uint64_t)pFrame->Width * Bpp > OutputStride))
+    {
+        return FALSE;
+    }
+
+    if (pFrame->Width > pTiled->ColumnCapacity)
+    {
+        uint16_t *pColumnWeight = (uint16_t *)realloc(pTiled->pColumnWeight, pFrame->Width * sizeof(uint16_t));
+
+        if (NULL == pColumnWeight)
+        {
+            return FALSE;
+        }
+
+        pTiled->pColumnWeight  = pColumnWeight;
+        pTiled->ColumnCapacity = pFrame->Width;
+    }
+
+    // Tile0 only grows with the column, so equal tile pairs are contiguous
+    pTiled->SegmentCount = 0;
+
+    for (uint32_t Column = 0; Column < pFrame->Width; Column++)
+    {
+        TILED_BLEND Blend = GetBlend(Column, pTiled->TilesX, pFrame->Width);
+        TILED_SEGMENT *pSegment = (0 == Column) ? NULL : &pTiled->Segment[pTiled->SegmentCount - 1];
+
+        if ((NULL == pSegment) || (pSegment->Tile0 != Blend.Tile0) || (pSegment->Tile1 != Blend.Tile1))
+        {
+            pSegment = &pTiled->Segment[pTiled->SegmentCount++];
+            pSegment->FirstColumn = Column;
+            pSegment->Tile0       = Blend.Tile0;
+            pSegment->Tile1       = Blend.Tile1;
+        }
+
+        pSegment->EndColumn = Column + 1;
+        pTiled->pColumnWeight[Column] = Blend.Weight1;
+    }
+
+    for (uint32_t Tile = 0; Tile < pTiled->TileCount; Tile++)
+    {
+        DisplayGheBuildDietFactorTable(pTiled->pArgs[Tile].DietFactor, Bpc, pTiled->pFactor[Tile]);
+    }
+
+    Job.pTiled       = pTiled;
+    Job.pFrame       = pFrame;
+    Job.pOutput      = (uint8_t *)pOutput;
+    Job.OutputStride = OutputStride;
+    Job.FactorCount  = 1 << Bpc;
+    Job.pfnSegment   = TiledSegment[DisplayGheGetIsa()][pFrame->Format];
+
+    MinRowsPerBand = DD_MAX(1, TILED_MIN_BAND_PIXELS / pFrame->Width);
+    BandCount = DisplayGheGetThreadCount(pPool) * 2;
+    BandCount = DD_MIN(BandCount, (pFrame->Height + MinRowsPerBand - 1) / MinRowsPerBand);
+    BandCount = DD_MAX(BandCount, 1);
+
+    Job.RowsPerBand = (pFrame->Height + BandCount - 1) / BandCount;
+    BandCount       = (pFrame->Height + Job.RowsPerBand - 1) / Job.RowsPerBand;
+
+    DisplayGheThreadPoolRun(pPool, BandCount, ApplyTiledBand, &Job);
+
+    return TRUE;
+}
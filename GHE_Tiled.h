@@ -0,0 +1,48 @@
+/**
+ *
+ * @file  GHE_Tiled.h
+ * @brief  Tiled local histogram equalization: one GHE per tile of an M x N grid, blended bilinearly on apply
+ *
+ * Every tile owns a complete GlobalHist_CONTEXT, so slope clamping, solid color detection, change
+ * detection and the temporal filter all run per tile exactly as DisplayGheAlgorithm does for the
+ * whole frame. Tiles are independent and run in parallel, one thread pool task per tile row.
+ *
+ * DisplayGheTiledApplyDiet treats every tile LUT as sitting at the tile center and blends the
+ * multipliers of the four nearest centers per pixel, so tile borders never show.
+ *
+ */
+
+#ifndef _DISPLAY_GHETILED_H_
+#define _DISPLAY_GHETILED_H_
+
+#include "DisplayPc.h"
+#include "GHE_Histogram.h"
+#include "GHE_ThreadPool.h"
+
+#define GlobalHist_MAX_TILES 16 // Per axis
+
+typedef struct _GlobalHist_TILED_CONTEXT GlobalHist_TILED_CONTEXT;
+
+// TilesX and TilesY in [1, GlobalHist_MAX_TILES]. All memory the per frame calls need is
+// allocated here, except the per column blend table which grows with the widest frame applied.
+GlobalHist_TILED_CONTEXT *DisplayGheCreateTiled(uint32_t TilesX, uint32_t TilesY);
+void DisplayGheDestroyTiled(GlobalHist_TILED_CONTEXT *pTiled);
+
+// One frame from tile histograms gathered elsewhere, pHistogram[TileY * TilesX + TileX] with the
+// tile boundaries of GlobalHist_TILE_START. Resolution is the whole frame.
+void DisplayGheTiledProcessHistograms(GlobalHist_TILED_CONTEXT *pTiled, const uint32_t (*pHistogram)[GlobalHist_BIN_COUNT],
+                                      uint32_t Resolution_X, uint32_t Resolution_Y, uint64_t TimestampNs, GlobalHist_THREAD_POOL *pPool);
+
+// One frame from its pixels, the tile histograms are built on pPool. Returns FALSE on a bad frame.
+bool DisplayGheTiledProcessFrame(GlobalHist_TILED_CONTEXT *pTiled, const GlobalHist_FRAME *pFrame, uint64_t TimestampNs,
+                                 GlobalHist_THREAD_POOL *pPool);
+
+// DietFactor of a tile after the last processed frame
+const uint32_t *DisplayGheTiledGetDietFactor(GlobalHist_TILED_CONTEXT *pTiled, uint32_t TileX, uint32_t TileY);
+
+// Applies the tile LUTs with bilinear blending. Same conventions as DisplayGheApplyDiet, in-place
+// included. Returns FALSE on a bad frame.
+bool DisplayGheTiledApplyDiet(GlobalHist_TILED_CONTEXT *pTiled, const GlobalHist_FRAME *pFrame, void *pOutput, uint32_t OutputStride,
+                              GlobalHist_THREAD_POOL *pPool);
+
+#endif
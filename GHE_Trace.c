@@ -0,0 +1,487 @@
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "GHE_Algorithm.h"
+#include "GHE_Trace.h"
+
+#define TRACE_BUFFER_SIZE     (256 * 1024)
+#define TRACE_MAX_VARINT_SIZE 10
+#define TRACE_MAX_RECORD_SIZE (TRACE_MAX_VARINT_SIZE * (3 + GlobalHist_BIN_COUNT + GlobalHist_IET_LUT_LENGTH) + 2)
+
+static const char TraceMagic[8] = { 'G', 'H', 'E', 'T', 'R', 'A', 'C', 'E' };
+
+// Last record of one pipe, deltas are taken against it
+typedef struct _TRACE_PIPE_STATE
+{
+    uint32_t Histogram[GlobalHist_BIN_COUNT];
+    uint32_t DietFactor[GlobalHist_IET_LUT_LENGTH];
+    uint32_t Resolution_X;
+    uint32_t Resolution_Y;
+} TRACE_PIPE_STATE;
+
+struct _GlobalHist_TRACE_WRITER
+{
+    FILE *pFile;
+    pthread_mutex_t Lock;
+    bool IsWriteFailed;
+    uint64_t PrevTimestampNs;
+    TRACE_PIPE_STATE Pipe[GlobalHist_TRACE_PIPE_SLOTS];
+    uint32_t BufferUsed;
+    uint8_t Buffer[TRACE_BUFFER_SIZE];
+};
+
+struct _GlobalHist_TRACE_READER
+{
+    const uint8_t *pData;
+    uint64_t Size;
+    uint64_t Offset;
+    uint64_t PrevTimestampNs;
+    TRACE_PIPE_STATE Pipe[GlobalHist_TRACE_PIPE_SLOTS];
+    GlobalHist_TRACE_SETUP Setup[GlobalHist_TRACE_PIPE_SLOTS];
+    bool IsSetupChanged[GlobalHist_TRACE_PIPE_SLOTS];
+};
+
+static uint32_t GetPipeSlot(PIPE_ID Pipe)
+{
+    return ((uint32_t)Pipe < GlobalHist_MAX_PIPES) ? (uint32_t)Pipe : GlobalHist_MAX_PIPES;
+}
+
+static uint64_t ZigZagEncode(int64_t Value)
+{
+    return ((uint64_t)Value << 1) ^ (uint64_t)(Value >> 63);
+}
+
+static int64_t ZigZagDecode(uint64_t Value)
+{
+    return (int64_t)(Value >> 1) ^ -(int64_t)(Value & 1);
+}
+
+static uint8_t *PutVarint(uint8_t *pOut, uint64_t Value)
+{
+    while (Value >= 0x80)
+    {
+        *pOut++ = (uint8_t)(Value | 0x80);
+        Value >>= 7;
+    }
+
+    *pOut++ = (uint8_t)Value;
+    return pOut;
+}
+
+// Returns NULL when the varint runs past pEnd or is longer than 64 bits
+static const uint8_t *GetVarint(const uint8_t *pIn, const uint8_t *pEnd, uint64_t *pValue)
+{
+    uint64_t Value = 0;
+
+    for (uint32_t Shift = 0; (pIn < pEnd) && (Shift < 64); Shift += 7)
+    {
+        uint8_t Byte = *pIn++;
+
+        Value |= (uint64_t)(Byte & 0x7F) << Shift;
+
+        if (0 == (Byte & 0x80))
+        {
+            *pValue = Value;
+            return pIn;
+        }
+    }
+
+    return NULL;
+}
+
+static uint8_t *PutF64(uint8_t *pOut, double Value)
+{
+    uint64_t Bits;
+
+    memcpy(&Bits, &Value, sizeof(Bits));
+
+    for (uint32_t Byte = 0; Byte < 8; Byte++)
+    {
+        *pOut++ = (uint8_t)(Bits >> (8 * Byte));
+    }
+
+    return pOut;
+}
+
+static const uint8_t *GetF64(const uint8_t *pIn, double *pValue)
+{
+    uint64_t Bits = 0;
+
+    for (uint32_t Byte = 0; Byte < 8; Byte++)
+    {
+        Bits |= (uint64_t)pIn[Byte] << (8 * Byte);
+    }
+
+    memcpy(pValue, &Bits, sizeof(Bits));
+    return pIn + 8;
+}
+
+static void FlushBuffer(GlobalHist_TRACE_WRITER *pWriter)
+{
+    if ((0 != pWriter->BufferUsed) && (pWriter->BufferUsed != fwrite(pWriter->Buffer, 1, pWriter->BufferUsed, pWriter->pFile)))
+    {
+        pWriter->IsWriteFailed = TRUE;
+    }
+
+    pWriter->BufferUsed = 0;
+}
+
+GlobalHist_TRACE_WRITER *DisplayGheTraceOpenWriter(const char *pPath)
+{
+    GlobalHist_TRACE_WRITER *pWriter = (GlobalHist_TRACE_WRITER *)calloc(1, sizeof(GlobalHist_TRACE_WRITER));
+    uint8_t Header[GlobalHist_TRACE_HEADER_SIZE] = { 0 };
+
+    if (NULL == pWriter)
+    {
+        return NULL;
+    }
+
+    pWriter->pFile = fopen(pPath, "wb");
+
+    if (NULL == pWriter->pFile)
+    {
+        free(pWriter);
+        return NULL;
+    }
+
+    // Magic, then version, bin count and IET length as little endian u16
+    memcpy(Header, TraceMagic, sizeof(TraceMagic));
+    Header[8]  = (uint8_t)GlobalHist_TRACE_VERSION;
+    Header[10] = (uint8_t)GlobalHist_BIN_COUNT;
+    Header[12] = (uint8_t)GlobalHist_IET_LUT_LENGTH;
+
+    memcpy(pWriter->Buffer, Header, sizeof(Header));
+    pWriter->BufferUsed = sizeof(Header);
+
+    pthread_mutex_init(&pWriter->Lock, NULL);
+
+    return pWriter;
+}
+
+bool DisplayGheTraceRecord(GlobalHist_TRACE_WRITER *pWriter, uint64_t TimestampNs, const GlobalHist_ARGS *pArgs)
+{
+    TRACE_PIPE_STATE *pPipe;
+    uint8_t *pOut;
+    uint8_t Flags = 0;
+
+    pthread_mutex_lock(&pWriter->Lock);
+
+    if (TRACE_BUFFER_SIZE - pWriter->BufferUsed < TRACE_MAX_RECORD_SIZE)
+    {
+        FlushBuffer(pWriter);
+    }
+
+    pPipe = &pWriter->Pipe[GetPipeSlot(pArgs->PipeId)];
+    pOut  = pWriter->Buffer + pWriter->BufferUsed;
+
+    if ((pArgs->Resolution_X != pPipe->Resolution_X) || (pArgs->Resolution_Y != pPipe->Resolution_Y))
+    {
+        Flags |= GlobalHist_TRACE_FLAG_RESOLUTION;
+    }
+
+    if (pArgs->IsProgramDiet)
+    {
+        Flags |= GlobalHist_TRACE_FLAG_PROGRAM;
+    }
+
+    if (0 != pArgs->TimestampNs)
+    {
+        Flags |= GlobalHist_TRACE_FLAG_TIMESTAMP;
+        TimestampNs = pArgs->TimestampNs;
+    }
+
+    pOut = PutVarint(pOut, ZigZagEncode((int64_t)(TimestampNs - pWriter->PrevTimestampNs)));
+    *pOut++ = (uint8_t)pArgs->PipeId;
+    *pOut++ = Flags;
+
+    if (Flags & GlobalHist_TRACE_FLAG_RESOLUTION)
+    {
+        pOut = PutVarint(pOut, pArgs->Resolution_X);
+        pOut = PutVarint(pOut, pArgs->Resolution_Y);
+        pPipe->Resolution_X = pArgs->Resolution_X;
+        pPipe->Resolution_Y = pArgs->Resolution_Y;
+    }
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        pOut = PutVarint(pOut, ZigZagEncode((int64_t)pArgs->Histogram[BinIndex] - (int64_t)pPipe->Histogram[BinIndex]));
+    }
+
+    for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        pOut = PutVarint(pOut, ZigZagEncode((int64_t)pArgs->DietFactor[IetIndex] - (int64_t)pPipe->DietFactor[IetIndex]));
+    }
+
+    memcpy(pPipe->Histogram, pArgs->Histogram, sizeof(pPipe->Histogram));
+    memcpy(pPipe->DietFactor, pArgs->DietFactor, sizeof(pPipe->DietFactor));
+    pWriter->PrevTimestampNs = TimestampNs;
+    pWriter->BufferUsed = (uint32_t)(pOut - pWriter->Buffer);
+
+    pthread_mutex_unlock(&pWriter->Lock);
+
+    return (FALSE == pWriter->IsWriteFailed);
+}
+
+bool DisplayGheTraceRecordSetup(GlobalHist_TRACE_WRITER *pWriter, PIPE_ID Pipe, const GlobalHist_TRACE_SETUP *pSetup)
+{
+    const GlobalHist_CFG *pCfg = &pSetup->Cfg;
+    uint8_t *pOut;
+
+    pthread_mutex_lock(&pWriter->Lock);
+
+    if (TRACE_BUFFER_SIZE - pWriter->BufferUsed < TRACE_MAX_RECORD_SIZE)
+    {
+        FlushBuffer(pWriter);
+    }
+
+    // No timestamp delta, the record takes no time
+    pOut = PutVarint(pWriter->Buffer + pWriter->BufferUsed, 0);
+    *pOut++ = (uint8_t)Pipe;
+    *pOut++ = GlobalHist_TRACE_FLAG_SETUP;
+    *pOut++ = (uint8_t)pSetup->TransferFunction;
+    *pOut++ = (uint8_t)pSetup->Precision;
+    pOut = PutVarint(pOut, pSetup->ChangeTolerance);
+    pOut = PutVarint(pOut, pSetup->CacheKeyShift);
+    pOut = PutF64(pOut, pCfg->MinimumStepPercent);
+    pOut = PutF64(pOut, pCfg->MinIIRCutOffFreq);
+    pOut = PutF64(pOut, pCfg->MaxIIRCutOffFreq);
+    pOut = PutF64(pOut, pCfg->MinPhaseInDuration);
+    pOut = PutF64(pOut, pCfg->MaxPhaseInDuration);
+    pOut = PutF64(pOut, pCfg->MinSlope);
+    pOut = PutF64(pOut, pCfg->MaxSlope);
+
+    pWriter->BufferUsed = (uint32_t)(pOut - pWriter->Buffer);
+
+    pthread_mutex_unlock(&pWriter->Lock);
+
+    return (FALSE == pWriter->IsWriteFailed);
+}
+
+void DisplayGheTraceCloseWriter(GlobalHist_TRACE_WRITER *pWriter)
+{
+    if (NULL == pWriter)
+    {
+        return;
+    }
+
+    FlushBuffer(pWriter);
+    fclose(pWriter->pFile);
+    pthread_mutex_destroy(&pWriter->Lock);
+    free(pWriter);
+}
+
+GlobalHist_TRACE_READER *DisplayGheTraceOpenReader(const char *pPath)
+{
+    GlobalHist_TRACE_READER *pReader;
+    struct stat FileStat;
+    void *pData;
+    int Fd = open(pPath, O_RDONLY);
+
+    if (Fd < 0)
+    {
+        return NULL;
+    }
+
+    if ((0 != fstat(Fd, &FileStat)) || (FileStat.st_size < GlobalHist_TRACE_HEADER_SIZE))
+    {
+        close(Fd);
+        return NULL;
+    }
+
+    pData = mmap(NULL, (size_t)FileStat.st_size, PROT_READ, MAP_PRIVATE, Fd, 0);
+    close(Fd);
+
+    if (MAP_FAILED == pData)
+    {
+        return NULL;
+    }
+
+    // Streamed once front to back, let the kernel read ahead and drop pages behind us
+    madvise(pData, (size_t)FileStat.st_size, MADV_SEQUENTIAL);
+
+    if ((0 != memcmp(pData, TraceMagic, sizeof(TraceMagic))) ||
+        (GlobalHist_TRACE_MIN_VERSION > ((const uint8_t *)pData)[8]) || (GlobalHist_TRACE_VERSION < ((const uint8_t *)pData)[8]) ||
+        (GlobalHist_BIN_COUNT != ((const uint8_t *)pData)[10]) ||
+        (GlobalHist_IET_LUT_LENGTH != ((const uint8_t *)pData)[12]) ||
+        (NULL == (pReader = (GlobalHist_TRACE_READER *)calloc(1, sizeof(GlobalHist_TRACE_READER)))))
+    {
+        munmap(pData, (size_t)FileStat.st_size);
+        return NULL;
+    }
+
+    pReader->pData  = (const uint8_t *)pData;
+    pReader->Size   = (uint64_t)FileStat.st_size;
+    pReader->Offset = GlobalHist_TRACE_HEADER_SIZE;
+
+    // What a fresh context runs on, until a setup record says otherwise
+    for (uint32_t PipeSlot = 0; PipeSlot < GlobalHist_TRACE_PIPE_SLOTS; PipeSlot++)
+    {
+        DisplayGheGetDefaultConfig(&pReader->Setup[PipeSlot].Cfg);
+        pReader->Setup[PipeSlot].TransferFunction = GlobalHist_TRANSFER_SRGB;
+        pReader->Setup[PipeSlot].Precision        = GlobalHist_PRECISION_DOUBLE;
+    }
+
+    return pReader;
+}
+
+// Consumes the setup records at the reader offset. Returns FALSE at a truncated one, a frame or
+// the end of the trace is left to DisplayGheTraceNextFrame.
+static bool ReadSetupRecords(GlobalHist_TRACE_READER *pReader)
+{
+    const uint8_t *pEnd = pReader->pData + pReader->Size;
+
+    for (;;)
+    {
+        const uint8_t *pIn = pReader->pData + pReader->Offset;
+        GlobalHist_TRACE_SETUP Setup;
+        GlobalHist_CFG *pCfg = &Setup.Cfg;
+        uint32_t PipeSlot;
+        uint64_t Value;
+
+        if ((NULL == (pIn = GetVarint(pIn, pEnd, &Value))) || (pEnd - pIn < 2) || (0 == (pIn[1] & GlobalHist_TRACE_FLAG_SETUP)))
+        {
+            return TRUE;
+        }
+
+        PipeSlot = GetPipeSlot((PIPE_ID)pIn[0]);
+        pIn += 2;
+
+        if (pEnd - pIn < 2)
+        {
+            return FALSE;
+        }
+
+        Setup.TransferFunction = (GlobalHist_TRANSFER_FUNCTION)*pIn++;
+        Setup.Precision        = (GlobalHist_PRECISION)*pIn++;
+
+        if (NULL == (pIn = GetVarint(pIn, pEnd, &Value)))
+        {
+            return FALSE;
+        }
+        Setup.ChangeTolerance = (uint32_t)Value;
+
+        if ((NULL == (pIn = GetVarint(pIn, pEnd, &Value))) || (pEnd - pIn < 7 * 8))
+        {
+            return FALSE;
+        }
+        Setup.CacheKeyShift = (uint32_t)Value;
+
+        pIn = GetF64(pIn, &pCfg->MinimumStepPercent);
+        pIn = GetF64(pIn, &pCfg->MinIIRCutOffFreq);
+        pIn = GetF64(pIn, &pCfg->MaxIIRCutOffFreq);
+        pIn = GetF64(pIn, &pCfg->MinPhaseInDuration);
+        pIn = GetF64(pIn, &pCfg->MaxPhaseInDuration);
+        pIn = GetF64(pIn, &pCfg->MinSlope);
+        pIn = GetF64(pIn, &pCfg->MaxSlope);
+
+        pReader->Setup[PipeSlot]          = Setup;
+        pReader->IsSetupChanged[PipeSlot] = TRUE;
+        pReader->Offset                   = (uint64_t)(pIn - pReader->pData);
+    }
+}
+
+bool DisplayGheTraceNextFrame(GlobalHist_TRACE_READER *pReader, GlobalHist_TRACE_FRAME *pFrame)
+{
+    const uint8_t *pIn, *pEnd = pReader->pData + pReader->Size;
+    GlobalHist_ARGS *pArgs = &pFrame->Args;
+    TRACE_PIPE_STATE Pipe;
+    uint32_t PipeSlot;
+    uint64_t Value;
+    uint8_t Flags;
+
+    if (FALSE == ReadSetupRecords(pReader))
+    {
+        return FALSE;
+    }
+
+    pIn = pReader->pData + pReader->Offset;
+
+    if ((NULL == (pIn = GetVarint(pIn, pEnd, &Value))) || (pEnd - pIn < 2))
+    {
+        return FALSE;
+    }
+
+    pFrame->TimestampNs = pReader->PrevTimestampNs + (uint64_t)ZigZagDecode(Value);
+    pArgs->PipeId = (PIPE_ID)*pIn++;
+    Flags = *pIn++;
+
+    // Decode into a copy so a truncated record leaves the reader untouched
+    PipeSlot = GetPipeSlot(pArgs->PipeId);
+    Pipe = pReader->Pipe[PipeSlot];
+
+    if (Flags & GlobalHist_TRACE_FLAG_RESOLUTION)
+    {
+        if (NULL == (pIn = GetVarint(pIn, pEnd, &Value)))
+        {
+            return FALSE;
+        }
+        Pipe.Resolution_X = (uint32_t)Value;
+
+        if (NULL == (pIn = GetVarint(pIn, pEnd, &Value)))
+        {
+            return FALSE;
+        }
+        Pipe.Resolution_Y = (uint32_t)Value;
+    }
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        if (NULL == (pIn = GetVarint(pIn, pEnd, &Value)))
+        {
+            return FALSE;
+        }
+
+        Pipe.Histogram[BinIndex] = (uint32_t)((int64_t)Pipe.Histogram[BinIndex] + ZigZagDecode(Value));
+    }
+
+    for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        if (NULL == (pIn = GetVarint(pIn, pEnd, &Value)))
+        {
+            return FALSE;
+        }
+
+        Pipe.DietFactor[IetIndex] = (uint32_t)((int64_t)Pipe.DietFactor[IetIndex] + ZigZagDecode(Value));
+    }
+
+    pReader->Pipe[PipeSlot]  = Pipe;
+    pReader->PrevTimestampNs = pFrame->TimestampNs;
+    pReader->Offset          = (uint64_t)(pIn - pReader->pData);
+
+    pArgs->IsProgramDiet = (0 != (Flags & GlobalHist_TRACE_FLAG_PROGRAM));
+    pArgs->TimestampNs   = (Flags & GlobalHist_TRACE_FLAG_TIMESTAMP) ? pFrame->TimestampNs : 0;
+    pArgs->Resolution_X  = Pipe.Resolution_X;
+    pArgs->Resolution_Y  = Pipe.Resolution_Y;
+    memcpy(pArgs->Histogram, Pipe.Histogram, sizeof(pArgs->Histogram));
+    memcpy(pArgs->DietFactor, Pipe.DietFactor, sizeof(pArgs->DietFactor));
+
+    pFrame->IsSetupChanged = pReader->IsSetupChanged[PipeSlot];
+    pFrame->Setup          = pReader->Setup[PipeSlot];
+    pReader->IsSetupChanged[PipeSlot] = FALSE;
+
+    return TRUE;
+}
+
+uint64_t DisplayGheTraceGetOffset(GlobalHist_TRACE_READER *pReader)
+{
+    return pReader->Offset;
+}
+
+uint64_t DisplayGheTraceGetSize(GlobalHist_TRACE_READER *pReader)
+{
+    return pReader->Size;
+}
+
+void DisplayGheTraceCloseReader(GlobalHist_TRACE_READER *pReader)
+{
+    if (NULL == pReader)
+    {
+        return;
+    }
+
+    munmap((void *)pReader->pData, (size_t)pReader->Size);
+    free(pReader);
+}
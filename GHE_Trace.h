@@ -0,0 +1,93 @@
+/**
+ *
+ * @file  GHE_Trace.h
+ * @brief  Binary trace of the GlobalHist_ARGS stream for offline replay
+ *
+ * A trace is a 16 byte header followed by one variable length record per frame:
+ *
+ *   varint   timestamp delta to the previous record, in ns
+ *   u8       PipeId
+ *   u8       flags, GlobalHist_TRACE_FLAG_*
+ *   varint   Resolution_X, Resolution_Y   only with GlobalHist_TRACE_FLAG_RESOLUTION
+ *   varint   zigzag delta of every Histogram bin
+ *   varint   zigzag delta of every DietFactor entry
+ *
+ * A record with GlobalHist_TRACE_FLAG_SETUP instead carries the setup of its pipe. It is written
+ * ahead of the first frame a writer records from a context and ahead of the next frame after any
+ * setup call on the context:
+ *
+ *   varint   0
+ *   u8       PipeId
+ *   u8       GlobalHist_TRACE_FLAG_SETUP
+ *   u8       TransferFunction, Precision
+ *   varint   change detection Tolerance, CacheKeyShift
+ *   f64      GlobalHist_CFG fields in declaration order, little endian
+ *
+ * Histogram and DietFactor deltas are against the previous record of the same pipe, so
+ * interleaved pipes still compress. Static content costs about 70 bytes per frame.
+ *
+ * The header carries GlobalHist_TRACE_VERSION. Readers refuse a newer version, whose records they
+ * could misread, and decode every older one down to GlobalHist_TRACE_MIN_VERSION.
+ *
+ */
+
+#ifndef _DISPLAY_GHETRACE_H_
+#define _DISPLAY_GHETRACE_H_
+
+#include "DisplayPc.h"
+
+#define GlobalHist_TRACE_VERSION          3 // 2 added GlobalHist_TRACE_FLAG_TIMESTAMP, 3 setup records
+#define GlobalHist_TRACE_MIN_VERSION      1 // Oldest version the reader decodes, its pipes run on the defaults
+#define GlobalHist_TRACE_HEADER_SIZE      16
+#define GlobalHist_TRACE_FLAG_RESOLUTION  0x01 // Resolution differs from the previous record of the pipe
+#define GlobalHist_TRACE_FLAG_PROGRAM     0x02 // IsProgramDiet was set
+#define GlobalHist_TRACE_FLAG_TIMESTAMP   0x04 // The record timestamp is GlobalHist_ARGS.TimestampNs of the frame
+#define GlobalHist_TRACE_FLAG_SETUP       0x08 // Setup record, not a frame
+#define GlobalHist_TRACE_PIPE_SLOTS       (GlobalHist_MAX_PIPES + 1) // Pipes A..D plus one for any other PipeId
+
+typedef struct _GlobalHist_TRACE_WRITER GlobalHist_TRACE_WRITER;
+typedef struct _GlobalHist_TRACE_READER GlobalHist_TRACE_READER;
+
+// Everything the DietFactor of a pipe depends on besides its frames
+typedef struct _GlobalHist_TRACE_SETUP
+{
+    GlobalHist_CFG Cfg;
+    GlobalHist_TRANSFER_FUNCTION TransferFunction;
+    GlobalHist_PRECISION Precision;
+    uint32_t ChangeTolerance;  // See DisplayGheSetChangeDetection
+    uint32_t CacheKeyShift;
+} GlobalHist_TRACE_SETUP;
+
+typedef struct _GlobalHist_TRACE_FRAME
+{
+    uint64_t TimestampNs;
+    GlobalHist_ARGS Args;  // PipeId, IsProgramDiet, resolution, Histogram and the DietFactor that was produced
+    bool IsSetupChanged;   // A setup record of the pipe came since its previous frame
+    GlobalHist_TRACE_SETUP Setup; // Of the pipe, the context defaults until its first setup record
+} GlobalHist_TRACE_FRAME;
+
+// Recording. Records are encoded into a buffer and written out in large blocks.
+// DisplayGheTraceRecord may be called from several threads. A frame that carries its own
+// TimestampNs is recorded with that instead of the TimestampNs argument, so replay feeds the filter
+// the same frame times.
+GlobalHist_TRACE_WRITER *DisplayGheTraceOpenWriter(const char *pPath);
+bool DisplayGheTraceRecord(GlobalHist_TRACE_WRITER *pWriter, uint64_t TimestampNs, const GlobalHist_ARGS *pArgs);
+bool DisplayGheTraceRecordSetup(GlobalHist_TRACE_WRITER *pWriter, PIPE_ID Pipe, const GlobalHist_TRACE_SETUP *pSetup);
+void DisplayGheTraceCloseWriter(GlobalHist_TRACE_WRITER *pWriter);
+
+// Recorder hook of DisplayGheProcessFrame. Every processed frame is recorded with its resulting
+// DietFactor while a writer is set, NULL turns recording off. Costs one pointer check when off.
+// The setup of a context is recorded ahead of its first frame and after every setter that ran.
+// Safe while frames are in flight on any thread: it returns once no frame records to the previous
+// writer any more, which may then be closed. Calls must not overlap each other.
+void DisplayGheSetTraceRecorder(GlobalHist_TRACE_WRITER *pWriter);
+
+// Replay. The whole file is memory mapped and decoded sequentially. DisplayGheTraceNextFrame
+// returns FALSE at the end of the trace or at a truncated or corrupt record.
+GlobalHist_TRACE_READER *DisplayGheTraceOpenReader(const char *pPath);
+bool DisplayGheTraceNextFrame(GlobalHist_TRACE_READER *pReader, GlobalHist_TRACE_FRAME *pFrame);
+uint64_t DisplayGheTraceGetOffset(GlobalHist_TRACE_READER *pReader);
+uint64_t DisplayGheTraceGetSize(GlobalHist_TRACE_READER *pReader);
+void DisplayGheTraceCloseReader(GlobalHist_TRACE_READER *pReader);
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ *
+ * @file  ghe_batch_bench.c
+ * @brief  Throughput of DisplayGheBatchProcess against one DisplayGheProcessFrame call per stream
+ *
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "../GHE_Batch.h"
+#include "../GHE_Cpu.h"
+#include "ghe_tool_common.h"
+
+#define BENCH_DEFAULT_STREAMS 256
+#define BENCH_DEFAULT_FRAMES  2000
+
+// Each stream drifts around its own random shape, with an occasional scene cut. Odd streams are
+// timestamped at their own refresh rate between 48 and 240 Hz with some jitter, even ones carry none.
+static void GenerateFrame(GlobalHist_ARGS *pArgs, uint32_t StreamCount, uint32_t Frame)
+{
+    for (uint32_t Stream = 0; Stream < StreamCount; Stream++)
+    {
+        bool IsSceneCut = (0 == ((Frame + Stream) % 97));
+        uint64_t FramePeriodNs = 1000000000ull / (48 + (Stream * 37) % 193);
+
+        pArgs[Stream].TimestampNs = (Stream & 1) ? (uint64_t)(Frame + 1) * FramePeriodNs + NextRandom() % 1000000 : 0;
+
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            uint32_t *pBin = &pArgs[Stream].Histogram[BinIndex];
+
+            if ((0 == Frame) || IsSceneCut)
+            {
+                *pBin = NextRandom() % 65536;
+            }
+            else
+            {
+                *pBin = *pBin + (NextRandom() % 512) - DD_MIN(*pBin, 255);
+            }
+        }
+
+        pArgs[Stream].Resolution_X = 1920;
+        pArgs[Stream].Resolution_Y = 1080;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t StreamCount = (argc > 1) ? (uint32_t)atoi(argv[1]) : BENCH_DEFAULT_STREAMS;
+    uint32_t FrameCount  = (argc > 2) ? (uint32_t)atoi(argv[2]) : BENCH_DEFAULT_FRAMES;
+    GlobalHist_ARGS *pInput  = (GlobalHist_ARGS *)calloc(StreamCount, sizeof(GlobalHist_ARGS));
+    GlobalHist_ARGS *pScalar = (GlobalHist_ARGS *)calloc(StreamCount, sizeof(GlobalHist_ARGS));
+    GlobalHist_ARGS *pBatched = (GlobalHist_ARGS *)calloc(StreamCount, sizeof(GlobalHist_ARGS));
+    GlobalHist_CONTEXT **ppContext = (GlobalHist_CONTEXT **)calloc(StreamCount, sizeof(GlobalHist_CONTEXT *));
+    GlobalHist_BATCH_CONTEXT *pBatch = DisplayGheCreateBatch(StreamCount);
+    double ScalarTime = 0, BatchTime = 0, Start;
+    uint64_t Mismatches = 0;
+
+    if ((0 == StreamCount) || (NULL == pInput) || (NULL == pScalar) || (NULL == pBatched) || (NULL == ppContext) || (NULL == pBatch))
+    {
+        fprintf(stderr, "usage: %s [streams] [frames]\n", argv[0]);
+        return 1;
+    }
+
+    for (uint32_t Stream = 0; Stream < StreamCount; Stream++)
+    {
+        ppContext[Stream] = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+    }
+
+    for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+    {
+        GenerateFrame(pInput, StreamCount, Frame);
+        memcpy(pScalar, pInput, StreamCount * sizeof(GlobalHist_ARGS));
+        memcpy(pBatched, pInput, StreamCount * sizeof(GlobalHist_ARGS));
+
+        Start = NowInSeconds();
+        for (uint32_t Stream = 0; Stream < StreamCount; Stream++)
+        {
+            DisplayGheProcessFrame(ppContext[Stream], &pScalar[Stream]);
+        }
+        ScalarTime += NowInSeconds() - Start;
+
+        Start = NowInSeconds();
+        DisplayGheBatchProcess(pBatch, pBatched, StreamCount);
+        BatchTime += NowInSeconds() - Start;
+
+        for (uint32_t Stream = 0; Stream < StreamCount; Stream++)
+        {
+            Mismatches += IsLutMismatch(pScalar[Stream].DietFactor, pBatched[Stream].DietFactor);
+        }
+    }
+
+    printf("kernels            %s\n", DisplayGheGetIsaName(DisplayGheGetIsa()));
+    printf("streams            %u\n", StreamCount);
+    printf("frames             %u\n", FrameCount);
+    printf("per-call streams/s %.0f\n", (double)StreamCount * FrameCount / ScalarTime);
+    printf("batch streams/s    %.0f\n", (double)StreamCount * FrameCount / BatchTime);
+    printf("speedup            %.2fx\n", ScalarTime / BatchTime);
+    printf("mismatched frames  %llu\n", (unsigned long long)Mismatches);
+
+    for (uint32_t Stream = 0; Stream < StreamCount; Stream++)
+    {
+        DisplayGheDestroyContext(ppContext[Stream]);
+    }
+
+    DisplayGheDestroyBatch(pBatch);
+    free(ppContext);
+    free(pBatched);
+    free(pScalar);
+    free(pInput);
+
+    return (0 == Mismatches) ? 0 : 1;
+}
@@ -0,0 +1,511 @@
+/**
+ *
+ * @file  ghe_bench.c
+ * @brief  Per stage and full frame microbenchmarks of the GHE algorithm
+ *
+ * Every stage runs in isolation over synthetic histogram families. Wall time comes from
+ * CLOCK_MONOTONIC, cycles and instructions from perf_event_open when the kernel allows it
+ * (perf_event_paranoid, containers). Results go to stdout as a table and, with -o, to a JSON
+ * or CSV file for tracking regressions between releases.
+ *
+ * usage: ghe_bench [-n iterations] [-s stage] [-o file] [-f json|csv]
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "../GHE_Engine.h"
+#include "ghe_tool_common.h"
+
+#define BENCH_DEFAULT_ITERATIONS 100000
+#define BENCH_WARMUP_ITERATIONS  1000
+#define BENCH_FAMILY_FRAMES      64     // Frames per family, iterations cycle through them
+
+typedef enum _BENCH_FAMILY
+{
+    BENCH_FAMILY_SOLID_COLOR,
+    BENCH_FAMILY_BIMODAL,
+    BENCH_FAMILY_RAMP,
+    BENCH_FAMILY_NOISY_VIDEO,
+    BENCH_FAMILY_STATIC,
+    BENCH_FAMILY_LOOPING,
+    BENCH_FAMILY_COUNT
+} BENCH_FAMILY;
+
+static const char *FamilyName[BENCH_FAMILY_COUNT] = { "solid-color", "bimodal", "ramp", "noisy-video", "static", "looping" };
+
+// Inputs of every stage, precomputed so a stage measures only itself
+typedef struct _BENCH_FRAME
+{
+    GlobalHist_ARGS Args;
+    double PowerDistribution[GlobalHist_BIN_COUNT];
+    double SumPower;
+    double FilteredEnhancementTable[GlobalHist_BIN_COUNT];
+    uint32_t LutTarget[GlobalHist_IET_LUT_LENGTH];
+} BENCH_FRAME;
+
+typedef struct _BENCH_STATE
+{
+    GlobalHist_CONTEXT *pContext;
+    BENCH_FRAME Frame[BENCH_FAMILY_FRAMES];
+    GlobalHist_ARGS Args;
+    volatile double Sink;   // Keeps results of pure stages alive
+} BENCH_STATE;
+
+typedef void (*PFN_BENCHSTAGE)(BENCH_STATE *pState, const BENCH_FRAME *pFrame, const BENCH_FRAME *pPrevFrame);
+
+typedef struct _BENCH_STAGE
+{
+    const char *pName;
+    PFN_BENCHSTAGE pfnRun;
+} BENCH_STAGE;
+
+typedef struct _BENCH_RESULT
+{
+    const char *pStage;
+    const char *pFamily;
+    uint64_t Iterations;
+    double NsPerOp;
+    double CyclesPerOp;        // Negative when perf counters are unavailable
+    double InstructionsPerOp;
+} BENCH_RESULT;
+
+typedef struct _BENCH_COUNTERS
+{
+    int CyclesFd;              // Group leader
+    int InstructionsFd;
+} BENCH_COUNTERS;
+
+static void GenerateHistogram(BENCH_FAMILY Family, uint32_t FrameIndex, uint32_t *pHistogram)
+{
+    const uint32_t PixelCount = 1920 * 1080;
+
+    memset(pHistogram, 0, GlobalHist_BIN_COUNT * sizeof(uint32_t));
+
+    switch (Family)
+    {
+    case BENCH_FAMILY_SOLID_COLOR:
+        pHistogram[(FrameIndex * 5) % GlobalHist_BIN_COUNT] = PixelCount;
+        break;
+
+    case BENCH_FAMILY_BIMODAL:
+    {
+        uint32_t Dark = 2 + FrameIndex % 6;
+        uint32_t Bright = 22 + FrameIndex % 7;
+
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            uint32_t Distance = DD_MIN(DD_DIFF(BinIndex, Dark), DD_DIFF(BinIndex, Bright));
+
+            pHistogram[BinIndex] = (PixelCount / 8) >> DD_MIN(2 * Distance, 31);
+        }
+        break;
+    }
+
+    case BENCH_FAMILY_RAMP:
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            pHistogram[BinIndex] = PixelCount / GlobalHist_BIN_COUNT + (BinIndex * FrameIndex * 37) % 2048;
+        }
+        break;
+
+    case BENCH_FAMILY_STATIC:
+    case BENCH_FAMILY_LOOPING:
+        // A desktop that never changes, or signage cycling through 6 stills
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            uint32_t Still = (BENCH_FAMILY_LOOPING == Family) ? FrameIndex % 6 : 0;
+
+            pHistogram[BinIndex] = 20000 + ((BinIndex * 2654435761u + Still * 40503u) >> 16) % 100000;
+        }
+        break;
+
+    default:
+        // Slowly drifting content with sensor noise and a scene cut every 16 frames
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            uint32_t Scene = FrameIndex / 16;
+            uint32_t Base = 20000 + ((BinIndex * 2654435761u + Scene * 40503u) >> 16) % 100000;
+
+            pHistogram[BinIndex] = Base + FrameIndex * 64 + NextRandom() % 4096;
+        }
+        break;
+    }
+}
+
+static void PrepareFamily(BENCH_STATE *pState, BENCH_FAMILY Family)
+{
+    for (uint32_t FrameIndex = 0; FrameIndex < BENCH_FAMILY_FRAMES; FrameIndex++)
+    {
+        BENCH_FRAME *pFrame = &pState->Frame[FrameIndex];
+        double EnhancementTable[GlobalHist_BIN_COUNT];
+        GlobalHist_ENGINE_32_33_ANALYSIS Analysis;
+        uint32_t TotalNumOfPixel = 0;
+
+        memset(pFrame, 0, sizeof(*pFrame));
+        GenerateHistogram(Family, FrameIndex, pFrame->Args.Histogram);
+        pFrame->Args.PipeId = GlobalHist_PIPE_ANY;
+        pFrame->Args.Resolution_X = 1920;
+        pFrame->Args.Resolution_Y = 1080;
+
+        pFrame->SumPower = 0;
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            TotalNumOfPixel += pFrame->Args.Histogram[BinIndex];
+            EnhancementTable[BinIndex] = (double)TotalNumOfPixel;
+
+            pFrame->PowerDistribution[BinIndex] = pState->pContext->pDeGammaLUT[BinIndex] * (double)pFrame->Args.Histogram[BinIndex];
+            pFrame->SumPower += pFrame->PowerDistribution[BinIndex];
+        }
+
+        // The normalized CDF, any monotonic curve will do for the interpolation stage
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            pFrame->FilteredEnhancementTable[BinIndex] = EnhancementTable[BinIndex] / (double)TotalNumOfPixel;
+        }
+
+        DisplayGheEngine_32_33_ComputeLutTarget(pFrame->Args.Histogram, pState->pContext->pDeGammaLUT, GlobalHist_MIN_SLOPE, GlobalHist_MAX_SLOPE,
+                                                pFrame->LutTarget, &Analysis);
+    }
+}
+
+static void RunInitializeAlgorithm(BENCH_STATE *pState, const BENCH_FRAME *pFrame, const BENCH_FRAME *pPrevFrame)
+{
+    (void)pPrevFrame;
+
+    memcpy(pState->pContext->Histogram, pFrame->Args.Histogram, sizeof(pFrame->Args.Histogram));
+    DisplayInitializeAlgorithm(pState->pContext, &pState->Args);
+}
+
+static void RunGheAlgorithm(BENCH_STATE *pState, const BENCH_FRAME *pFrame, const BENCH_FRAME *pPrevFrame)
+{
+    (void)pPrevFrame;
+
+    memcpy(pState->pContext->Histogram, pFrame->Args.Histogram, sizeof(pFrame->Args.Histogram));
+    DisplayGheAlgorithm(pState->pContext, &pState->Args);
+}
+
+static void RunSolidColorEstimate(BENCH_STATE *pState, const BENCH_FRAME *pFrame, const BENCH_FRAME *pPrevFrame)
+{
+    (void)pPrevFrame;
+
+    pState->Sink = EstimateProbabilityOfFullScreenSolidColor((double *)pFrame->PowerDistribution, pFrame->SumPower);
+}
+
+// One op is a full histogram LUT to IET LUT conversion, as DisplayGheAlgorithm does per frame
+static void RunApply1DLUT(BENCH_STATE *pState, const BENCH_FRAME *pFrame, const BENCH_FRAME *pPrevFrame)
+{
+    double Sum = 0;
+
+    (void)pPrevFrame;
+
+    for (uint32_t IetIndex = 1; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        Sum += Apply1DLUT((double)IetIndex / GlobalHist_MAX_IET_INDEX, (double *)pFrame->FilteredEnhancementTable, GlobalHist_MAX_BIN_INDEX);
+    }
+
+    pState->Sink = Sum;
+}
+
+static void RunComputeLutTarget(BENCH_STATE *pState, const BENCH_FRAME *pFrame, const BENCH_FRAME *pPrevFrame)
+{
+    uint32_t LutTarget[GlobalHist_IET_LUT_LENGTH];
+    GlobalHist_ENGINE_32_33_ANALYSIS Analysis;
+
+    (void)pPrevFrame;
+
+    pState->Sink = DisplayGheEngine_32_33_ComputeLutTarget(pFrame->Args.Histogram, pState->pContext->pDeGammaLUT, GlobalHist_MIN_SLOPE, GlobalHist_MAX_SLOPE,
+                                                           LutTarget, &Analysis) + LutTarget[GlobalHist_IET_LUT_LENGTH / 2];
+}
+
+static void RunComputeLutTargetSingle(BENCH_STATE *pState, const BENCH_FRAME *pFrame, const BENCH_FRAME *pPrevFrame)
+{
+    uint32_t LutTarget[GlobalHist_IET_LUT_LENGTH];
+    GlobalHist_ENGINE_32_33_ANALYSIS Analysis;
+
+    (void)pPrevFrame;
+
+    pState->Sink = DisplayGheEngine_32_33_ComputeLutTargetSingle(pFrame->Args.Histogram, pState->pContext->pDeGammaLUT, GlobalHist_MIN_SLOPE, GlobalHist_MAX_SLOPE,
+                                                                 LutTarget, &Analysis) + LutTarget[GlobalHist_IET_LUT_LENGTH / 2];
+}
+
+static void RunTemporalSmoothen(BENCH_STATE *pState, const BENCH_FRAME *pFrame, const BENCH_FRAME *pPrevFrame)
+{
+    (void)pPrevFrame;
+
+    memcpy(pState->pContext->Histogram, pFrame->Args.Histogram, sizeof(pFrame->Args.Histogram));
+    memcpy(pState->pContext->ImageEnhancement.LutTarget, pFrame->LutTarget, sizeof(pFrame->LutTarget));
+    TemporalSmoothenIET(pState->pContext, &pState->Args);
+}
+
+static void RunBrightnessChange(BENCH_STATE *pState, const BENCH_FRAME *pFrame, const BENCH_FRAME *pPrevFrame)
+{
+    memcpy(pState->pContext->Histogram, pFrame->Args.Histogram, sizeof(pFrame->Args.Histogram));
+    pState->Sink = GetRelativeFrameBrightnessChange(pState->pContext, (uint32_t *)pPrevFrame->Args.Histogram);
+}
+
+static void RunProcessFrame(BENCH_STATE *pState, const BENCH_FRAME *pFrame, const BENCH_FRAME *pPrevFrame)
+{
+    (void)pPrevFrame;
+
+    pState->Args = pFrame->Args;
+    DisplayGheProcessFrame(pState->pContext, &pState->Args);
+}
+
+static const BENCH_STAGE Stage[] =
+{
+    { "DisplayInitializeAlgorithm",                RunInitializeAlgorithm },
+    { "DisplayGheAlgorithm",                       RunGheAlgorithm },
+    { "EstimateProbabilityOfFullScreenSolidColor", RunSolidColorEstimate },
+    { "Apply1DLUT",                                RunApply1DLUT },
+    { "ComputeLutTarget",                          RunComputeLutTarget },
+    { "ComputeLutTargetSingle",                    RunComputeLutTargetSingle },
+    { "TemporalSmoothenIET",                       RunTemporalSmoothen },
+    { "GetRelativeFrameBrightnessChange",          RunBrightnessChange },
+    { "DisplayGheProcessFrame",                    RunProcessFrame },
+};
+
+#define BENCH_STAGE_COUNT (sizeof(Stage) / sizeof(Stage[0]))
+
+static int OpenCounter(uint64_t Config, int GroupFd)
+{
+    struct perf_event_attr Attr;
+
+    memset(&Attr, 0, sizeof(Attr));
+    Attr.size           = sizeof(Attr);
+    Attr.type           = PERF_TYPE_HARDWARE;
+    Attr.config         = Config;
+    Attr.disabled       = (-1 == GroupFd);
+    Attr.exclude_kernel = 1;
+    Attr.exclude_hv     = 1;
+    Attr.read_format    = PERF_FORMAT_GROUP;
+
+    return (int)syscall(SYS_perf_event_open, &Attr, 0, -1, GroupFd, 0);
+}
+
+static void OpenCounters(BENCH_COUNTERS *pCounters)
+{
+    pCounters->CyclesFd = OpenCounter(PERF_COUNT_HW_CPU_CYCLES, -1);
+    pCounters->InstructionsFd = (pCounters->CyclesFd < 0) ? -1 : OpenCounter(PERF_COUNT_HW_INSTRUCTIONS, pCounters->CyclesFd);
+
+    if ((pCounters->CyclesFd >= 0) && (pCounters->InstructionsFd < 0))
+    {
+        close(pCounters->CyclesFd);
+        pCounters->CyclesFd = -1;
+    }
+}
+
+static void CloseCounters(BENCH_COUNTERS *pCounters)
+{
+    if (pCounters->CyclesFd >= 0)
+    {
+        close(pCounters->InstructionsFd);
+        close(pCounters->CyclesFd);
+    }
+}
+
+static void RunStage(BENCH_STATE *pState, const BENCH_STAGE *pStage, uint32_t Iterations, BENCH_COUNTERS *pCounters, BENCH_RESULT *pResult)
+{
+    uint64_t Values[3] = { 0 }; // Counter count, cycles, instructions
+    double Start, Elapsed;
+
+    // Fresh context per stage and family so the temporal filter state does not leak across runs
+    DisplayInitializeAlgorithmState(pState->pContext);
+
+    for (uint32_t Iteration = 0; Iteration < BENCH_WARMUP_ITERATIONS; Iteration++)
+    {
+        pStage->pfnRun(pState, &pState->Frame[Iteration % BENCH_FAMILY_FRAMES], &pState->Frame[(Iteration + BENCH_FAMILY_FRAMES - 1) % BENCH_FAMILY_FRAMES]);
+    }
+
+    if (pCounters->CyclesFd >= 0)
+    {
+        ioctl(pCounters->CyclesFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(pCounters->CyclesFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    Start = (double)GetTimeNs();
+    for (uint32_t Iteration = 0; Iteration < Iterations; Iteration++)
+    {
+        pStage->pfnRun(pState, &pState->Frame[Iteration % BENCH_FAMILY_FRAMES], &pState->Frame[(Iteration + BENCH_FAMILY_FRAMES - 1) % BENCH_FAMILY_FRAMES]);
+    }
+    Elapsed = (double)GetTimeNs() - Start;
+
+    pResult->CyclesPerOp = -1;
+    pResult->InstructionsPerOp = -1;
+
+    if (pCounters->CyclesFd >= 0)
+    {
+        ioctl(pCounters->CyclesFd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        if ((sizeof(Values) == read(pCounters->CyclesFd, Values, sizeof(Values))) && (2 == Values[0]))
+        {
+            pResult->CyclesPerOp = (double)Values[1] / Iterations;
+            pResult->InstructionsPerOp = (double)Values[2] / Iterations;
+        }
+    }
+
+    pResult->pStage = pStage->pName;
+    pResult->Iterations = Iterations;
+    pResult->NsPerOp = Elapsed / Iterations;
+}
+
+static void WriteResults(FILE *pFile, bool IsJson, const BENCH_RESULT *pResult, uint32_t ResultCount, bool IsPerfAvailable)
+{
+    if (IsJson)
+    {
+        fprintf(pFile, "{\n  \"bins\": %u,\n  \"iet_entries\": %u,\n  \"isa\": \"%s\",\n  \"perf_counters\": %s,\n  \"results\": [\n",
+                GlobalHist_BIN_COUNT, GlobalHist_IET_LUT_LENGTH, DisplayGheGetIsaName(DisplayGheGetIsa()), IsPerfAvailable ? "true" : "false");
+    }
+    else
+    {
+        fprintf(pFile, "stage,family,iterations,ns_per_op,cycles_per_op,instructions_per_op\n");
+    }
+
+    for (uint32_t Index = 0; Index < ResultCount; Index++)
+    {
+        const BENCH_RESULT *pEntry = &pResult[Index];
+
+        if (IsJson)
+        {
+            fprintf(pFile, "    { \"stage\": \"%s\", \"family\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, ",
+                    pEntry->pStage, pEntry->pFamily, (unsigned long long)pEntry->Iterations, pEntry->NsPerOp);
+
+            if (pEntry->CyclesPerOp < 0)
+            {
+                fprintf(pFile, "\"cycles_per_op\": null, \"instructions_per_op\": null }");
+            }
+            else
+            {
+                fprintf(pFile, "\"cycles_per_op\": %.2f, \"instructions_per_op\": %.2f }", pEntry->CyclesPerOp, pEntry->InstructionsPerOp);
+            }
+
+            fprintf(pFile, "%s\n", (Index + 1 < ResultCount) ? "," : "");
+        }
+        else
+        {
+            fprintf(pFile, "%s,%s,%llu,%.3f,", pEntry->pStage, pEntry->pFamily, (unsigned long long)pEntry->Iterations, pEntry->NsPerOp);
+
+            if (pEntry->CyclesPerOp < 0)
+            {
+                fprintf(pFile, ",\n");
+            }
+            else
+            {
+                fprintf(pFile, "%.2f,%.2f\n", pEntry->CyclesPerOp, pEntry->InstructionsPerOp);
+            }
+        }
+    }
+
+    if (IsJson)
+    {
+        fprintf(pFile, "  ]\n}\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t Iterations = BENCH_DEFAULT_ITERATIONS;
+    const char *pStageFilter = NULL;
+    const char *pOutputPath = NULL;
+    bool IsJson = TRUE;
+    BENCH_RESULT Result[BENCH_STAGE_COUNT * BENCH_FAMILY_COUNT];
+    uint32_t ResultCount = 0;
+    BENCH_COUNTERS Counters;
+    BENCH_STATE *pState;
+    int Option;
+
+    while (-1 != (Option = getopt(argc, argv, "n:s:o:f:")))
+    {
+        switch (Option)
+        {
+        case 'n':
+            Iterations = (uint32_t)atoi(optarg);
+            break;
+        case 's':
+            pStageFilter = optarg;
+            break;
+        case 'o':
+            pOutputPath = optarg;
+            break;
+        case 'f':
+            IsJson = (0 != strcmp(optarg, "csv"));
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n iterations] [-s stage] [-o file] [-f json|csv]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    pState = (BENCH_STATE *)calloc(1, sizeof(BENCH_STATE));
+
+    if ((NULL == pState) || (0 == Iterations) || (NULL == (pState->pContext = DisplayGheCreateContext(GlobalHist_PIPE_ANY))))
+    {
+        fprintf(stderr, "setup failed\n");
+        return 1;
+    }
+
+    OpenCounters(&Counters);
+
+    if (Counters.CyclesFd < 0)
+    {
+        fprintf(stderr, "perf_event_open unavailable, reporting time only\n");
+    }
+
+    printf("kernels %s, host supports %s\n", DisplayGheGetIsaName(DisplayGheGetIsa()), DisplayGheGetIsaName(DisplayGheGetHostIsa()));
+    printf("%-42s %-12s %12s %12s %12s\n", "stage", "family", "ns/op", "cycles/op", "instr/op");
+
+    for (uint32_t Family = 0; Family < BENCH_FAMILY_COUNT; Family++)
+    {
+        PrepareFamily(pState, (BENCH_FAMILY)Family);
+
+        for (uint32_t StageIndex = 0; StageIndex < BENCH_STAGE_COUNT; StageIndex++)
+        {
+            BENCH_RESULT *pResult = &Result[ResultCount];
+
+            if ((NULL != pStageFilter) && (0 != strcmp(pStageFilter, Stage[StageIndex].pName)))
+            {
+                continue;
+            }
+
+            RunStage(pState, &Stage[StageIndex], Iterations, &Counters, pResult);
+            pResult->pFamily = FamilyName[Family];
+            ResultCount++;
+
+            printf("%-42s %-12s %12.1f", pResult->pStage, pResult->pFamily, pResult->NsPerOp);
+
+            if (pResult->CyclesPerOp < 0)
+            {
+                printf(" %12s %12s\n", "-", "-");
+            }
+            else
+            {
+                printf(" %12.1f %12.1f\n", pResult->CyclesPerOp, pResult->InstructionsPerOp);
+            }
+        }
+    }
+
+    if (NULL != pOutputPath)
+    {
+        FILE *pFile = fopen(pOutputPath, "w");
+
+        if (NULL == pFile)
+        {
+            fprintf(stderr, "cannot write %s\n", pOutputPath);
+            return 1;
+        }
+
+        WriteResults(pFile, IsJson, Result, ResultCount, Counters.CyclesFd >= 0);
+        fclose(pFile);
+    }
+
+    CloseCounters(&Counters);
+    DisplayGheDestroyContext(pState->pContext);
+    free(pState);
+
+    return 0;
+}
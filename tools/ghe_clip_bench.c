@@ -0,0 +1,182 @@
+/**
+ *
+ * @file  ghe_clip_bench.c
+ * @brief  DisplayGheProcessClip on all cores against DisplayGheProcessFrame frame by frame
+ *
+ * A synthetic clip of scenes with noise, fades, static stretches and solid color frames, partly
+ * with 60 Hz timestamps, runs through both paths. Every DietFactor must match bit for bit, and so
+ * must the state both contexts are left in: their snapshots, and the frames after the clip.
+ *
+ * usage: ghe_clip_bench [-n frames] [-t threads, 0 for all CPUs] [-c change tolerance] [-s]
+ *
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <unistd.h>
+
+#include "../GHE_Algorithm.h"
+#include "../GHE_Clip.h"
+#include "../GHE_Snapshot.h"
+#include "ghe_tool_common.h"
+
+#define BENCH_PIXELS       (3840 * 2160)
+#define BENCH_AFTER_FRAMES 1000 // Processed frame by frame on both contexts after the clip
+
+// Scenes of 60 to 600 frames around a peak of their own. Most scenes carry sensor noise, some
+// fade over their first 60 frames, some are static, and one in eight is a solid color. Every
+// other 5000 frames have 60 Hz timestamps with jitter, the rest none.
+static void GenerateClip(GlobalHist_ARGS *pArgs, uint32_t FrameCount)
+{
+    uint32_t SceneEnd = 0, SceneKind = 0, SceneStart = 0;
+    int32_t Peak = 0, Width = 1;
+
+    for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+    {
+        GlobalHist_ARGS *pFrame = &pArgs[Frame];
+        uint32_t Weight[GlobalHist_BIN_COUNT], WeightSum = 0, Assigned = 0;
+
+        if (Frame == SceneEnd)
+        {
+            SceneStart = Frame;
+            SceneEnd   = Frame + 60 + NextRandom() % 541;
+            SceneKind  = NextRandom() % 8;
+            Peak       = (int32_t)(NextRandom() % GlobalHist_BIN_COUNT);
+            Width      = 1 + (int32_t)(NextRandom() % 6);
+        }
+
+        memset(pFrame, 0, sizeof(*pFrame));
+        pFrame->PipeId       = GlobalHist_PIPE_ANY;
+        pFrame->Resolution_X = 3840;
+        pFrame->Resolution_Y = 2160;
+        pFrame->TimestampNs  = ((Frame / 5000) & 1) ? (uint64_t)(Frame + 1) * 16666667ull + NextRandom() % 1000000 : 0;
+
+        if (0 == SceneKind)
+        {
+            pFrame->Histogram[Peak] = BENCH_PIXELS;
+            continue;
+        }
+
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            int32_t Distance = (int32_t)BinIndex - Peak;
+            uint32_t Fade = ((1 == SceneKind) && (Frame - SceneStart < 60)) ? (Frame - SceneStart) * BinIndex * 8 : 0;
+            uint32_t Noise = (2 == SceneKind) ? 0 : NextRandom() % 64;
+
+            Weight[BinIndex] = 64 + 16384 * (uint32_t)Width / (uint32_t)(Width + Distance * Distance) + Fade + Noise;
+            WeightSum += Weight[BinIndex];
+        }
+
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            pFrame->Histogram[BinIndex] = (uint32_t)((uint64_t)BENCH_PIXELS * Weight[BinIndex] / WeightSum);
+            Assigned += pFrame->Histogram[BinIndex];
+        }
+
+        pFrame->Histogram[Peak] += BENCH_PIXELS - Assigned;
+    }
+}
+
+static GlobalHist_CONTEXT *CreateBenchContext(uint32_t Tolerance, bool IsSingle)
+{
+    GlobalHist_CONTEXT *pGheContext = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+
+    if (NULL != pGheContext)
+    {
+        DisplayGheSetChangeDetection(pGheContext, Tolerance, 0);
+        DisplayGheSetPrecision(pGheContext, IsSingle ? GlobalHist_PRECISION_SINGLE : GlobalHist_PRECISION_DOUBLE);
+    }
+
+    return pGheContext;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t FrameCount = 100000, ThreadCount = 0, Tolerance = 0;
+    bool IsSingle = FALSE;
+    GlobalHist_ARGS *pReferenceArgs, *pClipArgs;
+    GlobalHist_CONTEXT *pReference, *pClip;
+    GlobalHist_THREAD_POOL *pPool;
+    GlobalHist_CLIP_STATS Stats;
+    uint8_t ReferenceSnapshot[GlobalHist_SNAPSHOT_SIZE], ClipSnapshot[GlobalHist_SNAPSHOT_SIZE];
+    uint64_t Mismatches = 0;
+    double Start, SequentialSeconds, ClipSeconds;
+    int Option;
+
+    while (-1 != (Option = getopt(argc, argv, "n:t:c:s")))
+    {
+        switch (Option)
+        {
+        case 'n': FrameCount  = (uint32_t)atoi(optarg);   break;
+        case 't': ThreadCount = (uint32_t)atoi(optarg);   break;
+        case 'c': Tolerance   = (uint32_t)atoi(optarg);   break;
+        case 's': IsSingle    = TRUE;                     break;
+        default:  FrameCount  = 0;                        break;
+        }
+    }
+
+    if (FrameCount <= BENCH_AFTER_FRAMES)
+    {
+        fprintf(stderr, "usage: %s [-n frames, more than %u] [-t threads, 0 for all CPUs] [-c change tolerance] [-s]\n", argv[0], BENCH_AFTER_FRAMES);
+        return 1;
+    }
+
+    pReferenceArgs = (GlobalHist_ARGS *)malloc((size_t)FrameCount * sizeof(GlobalHist_ARGS));
+    pClipArgs      = (GlobalHist_ARGS *)malloc((size_t)FrameCount * sizeof(GlobalHist_ARGS));
+    pReference     = CreateBenchContext(Tolerance, IsSingle);
+    pClip          = CreateBenchContext(Tolerance, IsSingle);
+    pPool          = DisplayGheCreateThreadPool(ThreadCount);
+
+    if ((NULL == pReferenceArgs) || (NULL == pClipArgs) || (NULL == pReference) || (NULL == pClip) || (NULL == pPool))
+    {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
+
+    GenerateClip(pReferenceArgs, FrameCount);
+    memcpy(pClipArgs, pReferenceArgs, (size_t)FrameCount * sizeof(GlobalHist_ARGS));
+
+    // The last frames are kept back to check the state the clip leaves
+    FrameCount -= BENCH_AFTER_FRAMES;
+
+    Start = NowInSeconds();
+    for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+    {
+        DisplayGheProcessFrame(pReference, &pReferenceArgs[Frame]);
+    }
+    SequentialSeconds = NowInSeconds() - Start;
+
+    Start = NowInSeconds();
+    DisplayGheProcessClip(pClip, pClipArgs, FrameCount, pPool, &Stats);
+    ClipSeconds = NowInSeconds() - Start;
+
+    DisplayGheSaveSnapshot(pReference, ReferenceSnapshot, sizeof(ReferenceSnapshot));
+    DisplayGheSaveSnapshot(pClip, ClipSnapshot, sizeof(ClipSnapshot));
+    Mismatches += (0 != memcmp(ReferenceSnapshot, ClipSnapshot, sizeof(ClipSnapshot)));
+
+    for (uint32_t Frame = FrameCount; Frame < FrameCount + BENCH_AFTER_FRAMES; Frame++)
+    {
+        DisplayGheProcessFrame(pReference, &pReferenceArgs[Frame]);
+        DisplayGheProcessFrame(pClip, &pClipArgs[Frame]);
+    }
+
+    for (uint32_t Frame = 0; Frame < FrameCount + BENCH_AFTER_FRAMES; Frame++)
+    {
+        Mismatches += IsLutMismatch(pReferenceArgs[Frame].DietFactor, pClipArgs[Frame].DietFactor) ||
+                      (pReferenceArgs[Frame].PipeId != pClipArgs[Frame].PipeId) || (pReferenceArgs[Frame].IsProgramDiet != pClipArgs[Frame].IsProgramDiet);
+    }
+
+    printf("frames             %u, %u threads%s\n", FrameCount, DisplayGheGetThreadCount(pPool), IsSingle ? ", single precision" : "");
+    printf("frame by frame     %.1f ms, %.0f ns per frame\n", SequentialSeconds * 1e3, SequentialSeconds * 1e9 / FrameCount);
+    printf("clip               %.1f ms, %.0f ns per frame, %.2fx\n", ClipSeconds * 1e3, ClipSeconds * 1e9 / FrameCount, SequentialSeconds / ClipSeconds);
+    printf("chunks             %u, %u frames replayed\n", Stats.ChunkCount, Stats.ReplayedFrames);
+    printf("mismatches         %llu\n", (unsigned long long)Mismatches);
+
+    DisplayGheDestroyThreadPool(pPool);
+    DisplayGheDestroyContext(pReference);
+    DisplayGheDestroyContext(pClip);
+    free(pReferenceArgs);
+    free(pClipArgs);
+
+    return (0 == Mismatches) ? 0 : 1;
+}
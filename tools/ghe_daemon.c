@@ -0,0 +1,95 @@
+/**
+ *
+ * @file  ghe_daemon.c
+ * @brief  GHE daemon serving the per pipe contexts to every local process, see GHE_Daemon.h
+ *
+ * Runs until SIGINT or SIGTERM and prints the frame counts on the way out.
+ *
+ * usage: ghe_daemon [-n shared memory name] [-t srgb|gamma22|pq|hlg]
+ *
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <signal.h>
+#include <strings.h>
+#include <unistd.h>
+
+#include "../GHE_DeGamma.h"
+#include "../GHE_Daemon.h"
+
+static GlobalHist_DAEMON *pRunningDaemon;
+
+static void OnSignal(int Signal)
+{
+    (void)Signal;
+    DisplayGheDaemonStop(pRunningDaemon);
+}
+
+int main(int argc, char **argv)
+{
+    const char *pName = GlobalHist_DAEMON_DEFAULT_NAME;
+    uint32_t TransferFunction = GlobalHist_TRANSFER_SRGB;
+    GlobalHist_DAEMON_STATS Stats;
+    struct sigaction Action;
+    int Option;
+
+    while (-1 != (Option = getopt(argc, argv, "n:t:")))
+    {
+        switch (Option)
+        {
+        case 'n':
+            pName = optarg;
+            break;
+        case 't':
+            for (TransferFunction = 0; TransferFunction < GlobalHist_TRANSFER_COUNT; TransferFunction++)
+            {
+                if (0 == strcasecmp(optarg, DisplayGheGetTransferFunctionName((GlobalHist_TRANSFER_FUNCTION)TransferFunction)))
+                {
+                    break;
+                }
+            }
+            break;
+        default:
+            TransferFunction = GlobalHist_TRANSFER_COUNT;
+            break;
+        }
+    }
+
+    if (GlobalHist_TRANSFER_COUNT == TransferFunction)
+    {
+        fprintf(stderr, "usage: %s [-n shared memory name] [-t srgb|gamma22|pq|hlg]\n", argv[0]);
+        return 1;
+    }
+
+    pRunningDaemon = DisplayGheCreateDaemon(pName);
+
+    if (NULL == pRunningDaemon)
+    {
+        fprintf(stderr, "%s: can not create %s, is another daemon serving it?\n", argv[0], pName);
+        return 1;
+    }
+
+    for (uint32_t Pipe = 0; Pipe < GlobalHist_MAX_PIPES; Pipe++)
+    {
+        DisplayGheSetTransferFunction(DisplayGheDaemonGetContext(pRunningDaemon, (PIPE_ID)Pipe), (GlobalHist_TRANSFER_FUNCTION)TransferFunction);
+    }
+
+    memset(&Action, 0, sizeof(Action));
+    Action.sa_handler = OnSignal;
+    sigaction(SIGINT, &Action, NULL);
+    sigaction(SIGTERM, &Action, NULL);
+
+    printf("serving %s, %s\n", pName, DisplayGheGetTransferFunctionName((GlobalHist_TRANSFER_FUNCTION)TransferFunction));
+    fflush(stdout);
+
+    DisplayGheDaemonRun(pRunningDaemon);
+
+    DisplayGheDaemonGetStats(pRunningDaemon, &Stats);
+    printf("frames %llu, rejected %llu, sleeps %llu, reclaimed slots %llu\n", (unsigned long long)Stats.Frames, (unsigned long long)Stats.Rejected,
+           (unsigned long long)Stats.Sleeps, (unsigned long long)Stats.Reclaimed);
+
+    DisplayGheDestroyDaemon(pRunningDaemon);
+
+    return 0;
+}
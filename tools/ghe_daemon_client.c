@@ -0,0 +1,239 @@
+/**
+ *
+ * @file  ghe_daemon_client.c
+ * @brief  Test client of the GHE daemon: round trip latency, pipelined throughput and a bit exactness check
+ *
+ * Frames for all four pipes go through the zero copy ring. First one at a time, timing every round
+ * trip, then with up to the ring size in flight. With -s the client forks a daemon of its own on a
+ * private segment, and as it is then the only client every DietFactor, and the last one each pipe
+ * published, is checked against a local context per pipe.
+ *
+ * usage: ghe_daemon_client [-n shared memory name] [-f frames] [-d frames in flight] [-s]
+ *
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "../GHE_Algorithm.h"
+#include "../GHE_Daemon.h"
+#include "ghe_tool_common.h"
+
+#define CLIENT_TIMEOUT_NS 1000000000ull
+#define CLIENT_PIPES      GlobalHist_MAX_PIPES
+
+static GlobalHist_CONTEXT *pReference[CLIENT_PIPES];                        // With -s only
+static uint32_t LastDietFactor[CLIENT_PIPES][GlobalHist_IET_LUT_LENGTH];     // Of the references
+
+// Drifting content with a scene cut every 240 frames, different per pipe
+static void GenerateFrame(GlobalHist_ARGS *pArgs, uint32_t Frame)
+{
+    uint32_t Pipe = Frame % CLIENT_PIPES;
+    uint32_t Scene = Frame / (240 * CLIENT_PIPES);
+
+    memset(pArgs, 0, sizeof(*pArgs));
+    pArgs->PipeId       = (PIPE_ID)Pipe;
+    pArgs->Resolution_X = 3840;
+    pArgs->Resolution_Y = 2160;
+    pArgs->TimestampNs  = (uint64_t)(Frame / CLIENT_PIPES + 1) * 16666667ull;
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        uint32_t Shape = ((BinIndex + 1) * 2654435761u + (Scene * 4 + Pipe) * 40503u) >> 16;
+
+        pArgs->Histogram[BinIndex] = 2000 + Shape % 120000 + ((Frame * 37 + BinIndex * 11) % 512);
+    }
+}
+
+// Runs the frame through the reference context of its pipe and compares
+static uint64_t CheckResult(uint32_t Frame, const GlobalHist_ARGS *pResult)
+{
+    GlobalHist_ARGS Args;
+    uint32_t Pipe = Frame % CLIENT_PIPES;   // DisplayGheProcessFrame rewrites Args.PipeId
+
+    if (NULL == pReference[0])
+    {
+        return 0;
+    }
+
+    GenerateFrame(&Args, Frame);
+    DisplayGheProcessFrame(pReference[Pipe], &Args);
+    memcpy(LastDietFactor[Pipe], Args.DietFactor, sizeof(Args.DietFactor));
+
+    return IsLutMismatch(Args.DietFactor, pResult->DietFactor) || (Args.IsProgramDiet != pResult->IsProgramDiet);
+}
+
+static int CompareLatency(const void *pLeft, const void *pRight)
+{
+    uint64_t Left = *(const uint64_t *)pLeft, Right = *(const uint64_t *)pRight;
+
+    return (Left > Right) - (Left < Right);
+}
+
+int main(int argc, char **argv)
+{
+    const char *pName = GlobalHist_DAEMON_DEFAULT_NAME;
+    char PrivateName[64];
+    uint32_t FrameCount = 20000, Depth = GlobalHist_DAEMON_RING_SIZE;
+    bool IsSpawn = FALSE;
+    GlobalHist_DAEMON *pDaemon = NULL;
+    GlobalHist_DAEMON_CLIENT *pClient;
+    GlobalHist_SERVICE_RESULT Published;
+    uint64_t *pLatency, Mismatches = 0, Timeouts = 0, Start;
+    uint32_t Submitted, Completed;
+    double PipelinedSeconds;
+    pid_t Child = 0;
+    int Option;
+
+    while (-1 != (Option = getopt(argc, argv, "n:f:d:s")))
+    {
+        switch (Option)
+        {
+        case 'n': pName      = optarg;                   break;
+        case 'f': FrameCount = (uint32_t)atoi(optarg);   break;
+        case 'd': Depth      = (uint32_t)atoi(optarg);   break;
+        case 's': IsSpawn    = TRUE;                     break;
+        default:  FrameCount = 0;                        break;
+        }
+    }
+
+    if ((0 == FrameCount) || (0 == Depth) || (Depth > GlobalHist_DAEMON_RING_SIZE))
+    {
+        fprintf(stderr, "usage: %s [-n shared memory name] [-f frames] [-d frames in flight, at most %u] [-s]\n", argv[0], GlobalHist_DAEMON_RING_SIZE);
+        return 1;
+    }
+
+    if (IsSpawn)
+    {
+        snprintf(PrivateName, sizeof(PrivateName), "/dpst-ghe-client-%d", (int)getpid());
+        pName   = PrivateName;
+        pDaemon = DisplayGheCreateDaemon(pName);
+
+        if ((NULL == pDaemon) || (0 > (Child = fork())))
+        {
+            fprintf(stderr, "%s: can not start a daemon on %s\n", argv[0], pName);
+            return 1;
+        }
+
+        if (0 == Child)
+        {
+            DisplayGheDaemonRun(pDaemon);
+            _exit(0);
+        }
+
+        for (uint32_t Pipe = 0; Pipe < CLIENT_PIPES; Pipe++)
+        {
+            pReference[Pipe] = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+        }
+    }
+
+    pClient  = DisplayGheDaemonConnect(pName);
+    pLatency = (uint64_t *)calloc(FrameCount, sizeof(uint64_t));
+
+    if ((NULL == pClient) || (NULL == pLatency))
+    {
+        fprintf(stderr, "%s: can not connect to %s\n", argv[0], pName);
+        Mismatches = 1;
+        goto Exit;
+    }
+
+    // One frame at a time, every round trip timed
+    for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+    {
+        const GlobalHist_ARGS *pResult;
+
+        Start = GetTimeNs();
+        GenerateFrame(DisplayGheDaemonBeginSubmit(pClient), Frame);
+        DisplayGheDaemonEndSubmit(pClient);
+        pResult = DisplayGheDaemonWaitResult(pClient, CLIENT_TIMEOUT_NS);
+        pLatency[Frame] = GetTimeNs() - Start;
+
+        if (NULL == pResult)
+        {
+            Timeouts++;
+            break;
+        }
+
+        Mismatches += CheckResult(Frame, pResult);
+        DisplayGheDaemonReleaseResult(pClient);
+    }
+
+    // Up to Depth frames in flight, continuing the same sequences
+    Start     = GetTimeNs();
+    Submitted = 0;
+    Completed = 0;
+
+    while ((0 == Timeouts) && (Completed < FrameCount))
+    {
+        const GlobalHist_ARGS *pResult;
+
+        while ((Submitted < FrameCount) && (Submitted - Completed < Depth))
+        {
+            GenerateFrame(DisplayGheDaemonBeginSubmit(pClient), FrameCount + Submitted);
+            DisplayGheDaemonEndSubmit(pClient);
+            Submitted++;
+        }
+
+        pResult = DisplayGheDaemonWaitResult(pClient, CLIENT_TIMEOUT_NS);
+
+        if (NULL == pResult)
+        {
+            Timeouts++;
+            break;
+        }
+
+        Mismatches += CheckResult(FrameCount + Completed, pResult);
+        DisplayGheDaemonReleaseResult(pClient);
+        Completed++;
+    }
+
+    PipelinedSeconds = (double)(GetTimeNs() - Start) * 1e-9;
+
+    // The results published per pipe are the last frame of each pipe
+    if (NULL != pReference[0])
+    {
+        for (uint32_t Pipe = 0; Pipe < CLIENT_PIPES; Pipe++)
+        {
+            Mismatches += (FALSE == DisplayGheDaemonRead(pClient, (PIPE_ID)Pipe, &Published)) ||
+                          IsLutMismatch(Published.DietFactor, LastDietFactor[Pipe]);
+        }
+    }
+
+    qsort(pLatency, FrameCount, sizeof(uint64_t), CompareLatency);
+
+    printf("daemon             %s%s\n", pName, IsSpawn ? " (spawned)" : "");
+    printf("frames             %u round trips, %u pipelined %u deep\n", FrameCount, FrameCount, Depth);
+    printf("round trip us      p50 %.1f  p99 %.1f  max %.1f\n", (double)pLatency[FrameCount / 2] * 1e-3,
+           (double)pLatency[(uint64_t)FrameCount * 99 / 100] * 1e-3, (double)pLatency[FrameCount - 1] * 1e-3);
+    printf("pipelined frames/s %.0f\n", (double)Completed / PipelinedSeconds);
+    printf("timeouts           %llu\n", (unsigned long long)Timeouts);
+    if (IsSpawn)
+    {
+        printf("mismatches         %llu\n", (unsigned long long)Mismatches);
+    }
+    else
+    {
+        printf("mismatches         not checked, other clients share the contexts\n");
+    }
+
+Exit:
+    DisplayGheDaemonDisconnect(pClient);
+    free(pLatency);
+
+    if (NULL != pDaemon)
+    {
+        DisplayGheDaemonStop(pDaemon);
+        waitpid(Child, NULL, 0);
+        DisplayGheDestroyDaemon(pDaemon);
+    }
+
+    for (uint32_t Pipe = 0; Pipe < CLIENT_PIPES; Pipe++)
+    {
+        DisplayGheDestroyContext(pReference[Pipe]);
+    }
+
+    return ((0 == Mismatches) && (0 == Timeouts)) ? 0 : 1;
+}
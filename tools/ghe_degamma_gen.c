@@ -0,0 +1,123 @@
+/**
+ *
+ * @file  ghe_degamma_gen.c
+ * @brief  Writes GHE_DeGammaTables.h, or checks the tables compiled into the library
+ *
+ * Every table entry is DisplayGheGetDecodingValue of the bin position, computed exactly as
+ * contexts used to compute their own DeGamma LUT at init, and printed with 17 significant
+ * digits so it reads back to the same double. -c compares the compiled in tables against the
+ * formulas bit for bit and exits with 1 on any difference, which catches a stale generated file.
+ *
+ * usage: ghe_degamma_gen [-c] > GHE_DeGammaTables.h
+ *
+ */
+
+#include <unistd.h>
+
+#include "../GHE_DeGamma.h"
+
+static double GetBinValue(GlobalHist_TRANSFER_FUNCTION TransferFunction, uint32_t BinCount, uint32_t BinIndex)
+{
+    const double HistLutStepSize = 1.0 / (double)(BinCount - 1);
+
+    return DisplayGheGetDecodingValue(TransferFunction, (double)BinIndex * HistLutStepSize);
+}
+
+static void PrintTables(void)
+{
+    printf("// Generated by tools/ghe_degamma_gen.c, see GHE_DeGamma.h. Do not edit.\n");
+
+    for (uint32_t TransferFunction = 0; TransferFunction < GlobalHist_TRANSFER_COUNT; TransferFunction++)
+    {
+        for (uint32_t BinCount = GlobalHist_DEGAMMA_MIN_BINS; BinCount <= GlobalHist_DEGAMMA_MAX_BINS; BinCount *= 2)
+        {
+            printf("\nstatic const double DeGamma_%s_%u[%u] =\n{\n",
+                   DisplayGheGetTransferFunctionName((GlobalHist_TRANSFER_FUNCTION)TransferFunction), BinCount, BinCount);
+
+            for (uint32_t BinIndex = 0; BinIndex < BinCount; BinIndex++)
+            {
+                printf("%s%.17g,%s", (0 == BinIndex % 4) ? "    " : " ", GetBinValue((GlobalHist_TRANSFER_FUNCTION)TransferFunction, BinCount, BinIndex),
+                       (3 == BinIndex % 4) ? "\n" : "");
+            }
+
+            printf("};\n");
+        }
+    }
+
+    printf("\nstatic const double *const DeGammaTables[GlobalHist_TRANSFER_COUNT][GlobalHist_DEGAMMA_BIN_COUNTS] =\n{\n");
+
+    for (uint32_t TransferFunction = 0; TransferFunction < GlobalHist_TRANSFER_COUNT; TransferFunction++)
+    {
+        const char *pName = DisplayGheGetTransferFunctionName((GlobalHist_TRANSFER_FUNCTION)TransferFunction);
+
+        printf("    {");
+
+        for (uint32_t BinCount = GlobalHist_DEGAMMA_MIN_BINS; BinCount <= GlobalHist_DEGAMMA_MAX_BINS; BinCount *= 2)
+        {
+            printf(" DeGamma_%s_%u%s", pName, BinCount, (GlobalHist_DEGAMMA_MAX_BINS == BinCount) ? " " : ",");
+        }
+
+        printf("},\n");
+    }
+
+    printf("};\n");
+}
+
+static uint32_t CheckTables(void)
+{
+    uint32_t Mismatches = 0, Checked = 0;
+
+    for (uint32_t TransferFunction = 0; TransferFunction < GlobalHist_TRANSFER_COUNT; TransferFunction++)
+    {
+        for (uint32_t BinCount = GlobalHist_DEGAMMA_MIN_BINS; BinCount <= GlobalHist_DEGAMMA_MAX_BINS; BinCount *= 2)
+        {
+            const double *pTable = DisplayGheGetDeGammaLUT((GlobalHist_TRANSFER_FUNCTION)TransferFunction, BinCount);
+
+            for (uint32_t BinIndex = 0; BinIndex < BinCount; BinIndex++)
+            {
+                double Expected = GetBinValue((GlobalHist_TRANSFER_FUNCTION)TransferFunction, BinCount, BinIndex);
+
+                if ((NULL == pTable) || (0 != memcmp(&pTable[BinIndex], &Expected, sizeof(Expected))))
+                {
+                    fprintf(stderr, "%s %u bins, entry %u: table %.17g, formula %.17g\n",
+                            DisplayGheGetTransferFunctionName((GlobalHist_TRANSFER_FUNCTION)TransferFunction), BinCount, BinIndex,
+                            (NULL == pTable) ? NAN : pTable[BinIndex], Expected);
+                    Mismatches++;
+                }
+
+                Checked++;
+            }
+        }
+    }
+
+    // Bin counts without a table must not alias one
+    if ((NULL != DisplayGheGetDeGammaLUT(GlobalHist_TRANSFER_SRGB, 48)) || (NULL != DisplayGheGetDeGammaLUT(GlobalHist_TRANSFER_COUNT, 32)))
+    {
+        fprintf(stderr, "lookup of a missing table did not return NULL\n");
+        Mismatches++;
+    }
+
+    printf("%u entries checked, %u mismatches\n", Checked, Mismatches);
+
+    return Mismatches;
+}
+
+int main(int argc, char **argv)
+{
+    int Option;
+
+    while (-1 != (Option = getopt(argc, argv, "c")))
+    {
+        switch (Option)
+        {
+        case 'c': return (0 == CheckTables()) ? 0 : 1;
+        default:
+            fprintf(stderr, "usage: %s [-c] > GHE_DeGammaTables.h\n", argv[0]);
+            return 2;
+        }
+    }
+
+    PrintTables();
+
+    return 0;
+}
@@ -0,0 +1,421 @@
+/**
+ *
+ * @file  ghe_fixed_diff.c
+ * @brief  Differential harness running the fixed-point or single precision and double GHE paths side by side
+ *
+ * Feeds randomized histogram sequences, plus any recorded corpora given on the command line,
+ * through DisplayGheProcessFrame and DisplayGheFixedProcess, or with -s through a second context
+ * set to GlobalHist_PRECISION_SINGLE, and reports the largest LUT deviation between the two. A one LSB target difference can flip the solid color or snap to
+ * target decision, after which the paths legitimately run apart until both snap again. Such
+ * episodes are counted separately and the tolerance applies to frames where the paths agree.
+ *
+ * Recorded corpora are text files holding one frame of 32 bin counts per line. Lines starting
+ * with '#' are skipped and an empty line starts a new sequence.
+ *
+ * usage: ghe_fixed_diff [-s] [-f frames] [-t tolerance] [corpus ...]
+ *
+ */
+
+#include "../GHE_Engine.h"
+#include "../GHE_FixedPoint.h"
+#include "ghe_tool_common.h"
+
+#define DIFF_DEFAULT_FRAMES     200000
+#define DIFF_DEFAULT_TOLERANCE  2      // In 1.9 LSBs
+#define DIFF_SINGLE_TOLERANCE   1      // Default with -s
+#define DIFF_SEQUENCE_LENGTH    500
+#define DIFF_DEVIATION_BUCKETS  5      // 0, 1, 2, 3, more
+
+typedef enum _DIFF_SHAPE
+{
+    DIFF_SHAPE_RANDOM_WALK,
+    DIFF_SHAPE_PEAKS,
+    DIFF_SHAPE_DARK,
+    DIFF_SHAPE_BRIGHT,
+    DIFF_SHAPE_NEAR_SOLID,
+    DIFF_SHAPE_SPARSE,
+    DIFF_SHAPE_COUNT
+} DIFF_SHAPE;
+
+static const char *ShapeName[DIFF_SHAPE_COUNT] = { "random-walk", "peaks", "dark", "bright", "near-solid", "sparse" };
+
+typedef enum _DIFF_BRANCH
+{
+    DIFF_BRANCH_SOLID_COLOR,
+    DIFF_BRANCH_SNAP,
+    DIFF_BRANCH_FILTER
+} DIFF_BRANCH;
+
+typedef struct _DIFF_STATS
+{
+    uint64_t Frames;
+    uint64_t DivergedFrames;
+    uint64_t Divergences;
+    uint64_t TargetDeviation[DIFF_DEVIATION_BUCKETS];
+    uint64_t AppliedDeviation[DIFF_DEVIATION_BUCKETS];
+    uint32_t MaxTargetDeviation;
+    uint32_t MaxAppliedDeviation;
+    char WorstFrame[128];
+} DIFF_STATS;
+
+typedef struct _DIFF_STREAM
+{
+    GlobalHist_CONTEXT *pContext;
+    GlobalHist_FIXED_CONTEXT Fixed;
+    GlobalHist_CONTEXT *pSingle;     // With -s, in place of Fixed
+    uint32_t Frame;
+    bool IsDiverged;
+} DIFF_STREAM;
+
+static bool IsSingleMode = FALSE;
+
+static void StartSequence(DIFF_STREAM *pStream)
+{
+    if (NULL != pStream->pContext)
+    {
+        DisplayGheDestroyContext(pStream->pContext);
+    }
+
+    if (NULL != pStream->pSingle)
+    {
+        DisplayGheDestroyContext(pStream->pSingle);
+        pStream->pSingle = NULL;
+    }
+
+    pStream->pContext = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+    DisplayGheFixedInitialize(&pStream->Fixed);
+
+    if (IsSingleMode)
+    {
+        pStream->pSingle = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+        DisplayGheSetPrecision(pStream->pSingle, GlobalHist_PRECISION_SINGLE);
+    }
+
+    pStream->Frame = 0;
+    pStream->IsDiverged = FALSE;
+}
+
+// Branch each path is about to take for pHistogram
+static DIFF_BRANCH GetDoubleBranch(GlobalHist_CONTEXT *pContext, const uint32_t *pHistogram)
+{
+    uint32_t LutTarget[GlobalHist_IET_LUT_LENGTH];
+    GlobalHist_ENGINE_32_33_ANALYSIS Analysis;
+
+    if (FALSE == DisplayGheEngine_32_33_ComputeLutTarget(pHistogram, pContext->pDeGammaLUT, GlobalHist_MIN_SLOPE, GlobalHist_MAX_SLOPE, LutTarget, &Analysis))
+    {
+        return DIFF_BRANCH_SOLID_COLOR;
+    }
+
+    return DisplayGheEngine_32_33_IsTargetReached(pContext->ImageEnhancement.LutApplied, LutTarget, pContext->FilterParams.MinimumStepPercent) ?
+           DIFF_BRANCH_SNAP : DIFF_BRANCH_FILTER;
+}
+
+static DIFF_BRANCH GetSingleBranch(GlobalHist_CONTEXT *pContext, const uint32_t *pHistogram)
+{
+    uint32_t LutTarget[GlobalHist_IET_LUT_LENGTH];
+    GlobalHist_ENGINE_32_33_ANALYSIS Analysis;
+
+    if (FALSE == DisplayGheEngine_32_33_ComputeLutTargetSingle(pHistogram, pContext->pDeGammaLUT, GlobalHist_MIN_SLOPE, GlobalHist_MAX_SLOPE, LutTarget, &Analysis))
+    {
+        return DIFF_BRANCH_SOLID_COLOR;
+    }
+
+    return DisplayGheEngine_32_33_IsTargetReached(pContext->ImageEnhancement.LutApplied, LutTarget, pContext->FilterParams.MinimumStepPercent) ?
+           DIFF_BRANCH_SNAP : DIFF_BRANCH_FILTER;
+}
+
+static DIFF_BRANCH GetFixedBranch(GlobalHist_FIXED_CONTEXT *pFixed, const uint32_t *pHistogram)
+{
+    uint32_t LutTarget[GlobalHist_IET_LUT_LENGTH];
+
+    if (FALSE == DisplayGheFixedComputeLutTarget(pHistogram, LutTarget))
+    {
+        return DIFF_BRANCH_SOLID_COLOR;
+    }
+
+    return DisplayGheFixedIsTargetReached(pFixed->LutApplied, LutTarget, pFixed->MinimumStepPercent) ? DIFF_BRANCH_SNAP : DIFF_BRANCH_FILTER;
+}
+
+static void RunFrame(DIFF_STREAM *pStream, const uint32_t *pHistogram, DIFF_STATS *pStats, const char *pSource)
+{
+    GlobalHist_ARGS DoubleArgs, FixedArgs;
+    uint32_t TargetDeviation, AppliedDeviation;
+    DIFF_BRANCH DoubleBranch = GetDoubleBranch(pStream->pContext, pHistogram);
+    DIFF_BRANCH FixedBranch = IsSingleMode ? GetSingleBranch(pStream->pSingle, pHistogram) : GetFixedBranch(&pStream->Fixed, pHistogram);
+
+    memset(&DoubleArgs, 0, sizeof(DoubleArgs));
+    memcpy(DoubleArgs.Histogram, pHistogram, sizeof(DoubleArgs.Histogram));
+    DoubleArgs.Resolution_X = 1920;
+    DoubleArgs.Resolution_Y = 1080;
+    FixedArgs = DoubleArgs;
+
+    DisplayGheProcessFrame(pStream->pContext, &DoubleArgs);
+
+    if (IsSingleMode)
+    {
+        DisplayGheProcessFrame(pStream->pSingle, &FixedArgs);
+        TargetDeviation = MaxLutDeviation(pStream->pContext->ImageEnhancement.LutTarget, pStream->pSingle->ImageEnhancement.LutTarget, NULL);
+    }
+    else
+    {
+        DisplayGheFixedProcess(&pStream->Fixed, &FixedArgs);
+        TargetDeviation = MaxLutDeviation(pStream->pContext->ImageEnhancement.LutTarget, pStream->Fixed.LutTarget, NULL);
+    }
+
+    AppliedDeviation = MaxLutDeviation(DoubleArgs.DietFactor, FixedArgs.DietFactor, NULL);
+
+    pStats->Frames++;
+
+    // Both paths snapping puts them back in step
+    if (DoubleBranch != FixedBranch)
+    {
+        pStats->Divergences += (FALSE == pStream->IsDiverged);
+        pStream->IsDiverged = TRUE;
+    }
+    else if (DIFF_BRANCH_SNAP == DoubleBranch)
+    {
+        pStream->IsDiverged = FALSE;
+    }
+
+    if (pStream->IsDiverged)
+    {
+        pStats->DivergedFrames++;
+        pStream->Frame++;
+        return;
+    }
+
+    pStats->TargetDeviation[DD_MIN(TargetDeviation, DIFF_DEVIATION_BUCKETS - 1)]++;
+    pStats->AppliedDeviation[DD_MIN(AppliedDeviation, DIFF_DEVIATION_BUCKETS - 1)]++;
+    pStats->MaxTargetDeviation = DD_MAX(pStats->MaxTargetDeviation, TargetDeviation);
+
+    if (AppliedDeviation > pStats->MaxAppliedDeviation)
+    {
+        pStats->MaxAppliedDeviation = AppliedDeviation;
+        snprintf(pStats->WorstFrame, sizeof(pStats->WorstFrame), "%s frame %u", pSource, pStream->Frame);
+    }
+
+    pStream->Frame++;
+}
+
+// Next frame of a synthetic sequence. Shapes drift from frame to frame with an occasional scene cut,
+// so the temporal filter sees both slow changes and jumps.
+static void GenerateFrame(DIFF_SHAPE Shape, uint32_t Frame, uint32_t PixelCount, uint32_t *pHistogram)
+{
+    bool IsSceneCut = (0 == Frame) || (0 == (NextRandom() % 61));
+    uint32_t Weight[GlobalHist_BIN_COUNT] = { 0 };
+    uint64_t WeightSum = 0;
+
+    if ((DIFF_SHAPE_RANDOM_WALK == Shape) && (FALSE == IsSceneCut))
+    {
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            pHistogram[BinIndex] = pHistogram[BinIndex] + (NextRandom() % 512) - DD_MIN(pHistogram[BinIndex], 255);
+        }
+
+        return;
+    }
+
+    if ((FALSE == IsSceneCut) && (0 != (NextRandom() % 4)))
+    {
+        return; // Static content, the filter converges
+    }
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        switch (Shape)
+        {
+        case DIFF_SHAPE_PEAKS:
+            Weight[BinIndex] = 1 + NextRandom() % 8;
+            break;
+        case DIFF_SHAPE_DARK:
+            Weight[BinIndex] = (GlobalHist_BIN_COUNT - BinIndex) * (GlobalHist_BIN_COUNT - BinIndex) * (1 + NextRandom() % 4);
+            break;
+        case DIFF_SHAPE_BRIGHT:
+            Weight[BinIndex] = (BinIndex + 1) * (BinIndex + 1) * (1 + NextRandom() % 4);
+            break;
+        case DIFF_SHAPE_SPARSE:
+            Weight[BinIndex] = (0 == (NextRandom() % 5)) ? (NextRandom() % 1000) : 0;
+            break;
+        default:
+            Weight[BinIndex] = NextRandom() % 64;
+            break;
+        }
+    }
+
+    if (DIFF_SHAPE_PEAKS == Shape)
+    {
+        for (uint32_t Peak = 0; Peak < 1 + NextRandom() % 3; Peak++)
+        {
+            Weight[NextRandom() % GlobalHist_BIN_COUNT] += 200 + NextRandom() % 400;
+        }
+    }
+    else if (DIFF_SHAPE_NEAR_SOLID == Shape)
+    {
+        // Sweeps across the solid color threshold
+        uint32_t BinIndex = NextRandom() % GlobalHist_BIN_COUNT;
+
+        Weight[BinIndex] += 64 * (8 + NextRandom() % 32);
+    }
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        WeightSum += Weight[BinIndex];
+    }
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        pHistogram[BinIndex] = (0 == WeightSum) ? 0 : (uint32_t)((uint64_t)PixelCount * Weight[BinIndex] / WeightSum);
+    }
+}
+
+static void RunRandomized(uint32_t FrameCount, DIFF_STATS *pStats)
+{
+    static const uint32_t PixelCount[] = { 64 * 64, 1920 * 1080, 3840 * 2160, 7680 * 4320 };
+    DIFF_STREAM Stream = { 0 };
+    uint32_t Histogram[GlobalHist_BIN_COUNT] = { 0 };
+    char Source[64];
+
+    for (uint32_t Sequence = 0; pStats->Frames < FrameCount; Sequence++)
+    {
+        DIFF_SHAPE Shape = (DIFF_SHAPE)(Sequence % DIFF_SHAPE_COUNT);
+        uint32_t Pixels = PixelCount[(Sequence / DIFF_SHAPE_COUNT) % (sizeof(PixelCount) / sizeof(PixelCount[0]))];
+
+        snprintf(Source, sizeof(Source), "random %s #%u", ShapeName[Shape], Sequence);
+        StartSequence(&Stream);
+
+        for (uint32_t Frame = 0; (Frame < DIFF_SEQUENCE_LENGTH) && (pStats->Frames < FrameCount); Frame++)
+        {
+            GenerateFrame(Shape, Frame, Pixels, Histogram);
+            RunFrame(&Stream, Histogram, pStats, Source);
+        }
+    }
+
+    DisplayGheDestroyContext(Stream.pContext);
+    DisplayGheDestroyContext(Stream.pSingle);
+}
+
+static bool RunCorpus(const char *pPath, DIFF_STATS *pStats)
+{
+    FILE *pFile = fopen(pPath, "r");
+    DIFF_STREAM Stream = { 0 };
+    char Line[1024];
+
+    if (NULL == pFile)
+    {
+        fprintf(stderr, "cannot open %s\n", pPath);
+        return FALSE;
+    }
+
+    StartSequence(&Stream);
+
+    while (NULL != fgets(Line, sizeof(Line), pFile))
+    {
+        uint32_t Histogram[GlobalHist_BIN_COUNT];
+        char *pCursor = Line;
+        uint32_t BinIndex;
+
+        if ('#' == Line[0])
+        {
+            continue;
+        }
+
+        if (('\n' == Line[0]) || ('\0' == Line[0]))
+        {
+            StartSequence(&Stream);
+            continue;
+        }
+
+        for (BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            char *pEnd;
+
+            Histogram[BinIndex] = (uint32_t)strtoul(pCursor, &pEnd, 0);
+
+            if (pEnd == pCursor)
+            {
+                break;
+            }
+
+            pCursor = pEnd;
+        }
+
+        if (BinIndex < GlobalHist_BIN_COUNT)
+        {
+            fprintf(stderr, "%s: skipping frame with %u bins\n", pPath, BinIndex);
+            continue;
+        }
+
+        RunFrame(&Stream, Histogram, pStats, pPath);
+    }
+
+    DisplayGheDestroyContext(Stream.pContext);
+    DisplayGheDestroyContext(Stream.pSingle);
+    fclose(pFile);
+
+    return TRUE;
+}
+
+static void PrintStats(const char *pName, const DIFF_STATS *pStats)
+{
+    printf("%s\n", pName);
+    printf("  frames                 %llu\n", (unsigned long long)pStats->Frames);
+    printf("  branch divergences     %llu (%llu frames)\n", (unsigned long long)pStats->Divergences, (unsigned long long)pStats->DivergedFrames);
+    printf("  max LutTarget delta    %u\n", pStats->MaxTargetDeviation);
+    printf("  max DietFactor delta   %u (%s)\n", pStats->MaxAppliedDeviation, pStats->Frames ? pStats->WorstFrame : "-");
+
+    for (uint32_t Bucket = 0; Bucket < DIFF_DEVIATION_BUCKETS; Bucket++)
+    {
+        printf("  frames off by %s%u        target %-9llu applied %llu\n", (DIFF_DEVIATION_BUCKETS - 1 == Bucket) ? ">=" : "  ", Bucket,
+               (unsigned long long)pStats->TargetDeviation[Bucket], (unsigned long long)pStats->AppliedDeviation[Bucket]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t FrameCount = DIFF_DEFAULT_FRAMES;
+    uint32_t Tolerance = UINT32_MAX;
+    DIFF_STATS Randomized = { 0 };
+    DIFF_STATS Recorded = { 0 };
+    bool IsCorpusOk = TRUE;
+    int Arg = 1;
+
+    for (; (Arg < argc) && ('-' == argv[Arg][0]); Arg++)
+    {
+        if (0 == strcmp(argv[Arg], "-s"))
+        {
+            IsSingleMode = TRUE;
+        }
+        else if ((Arg + 1 < argc) && (0 == strcmp(argv[Arg], "-f")))
+        {
+            FrameCount = (uint32_t)atoi(argv[++Arg]);
+        }
+        else if ((Arg + 1 < argc) && (0 == strcmp(argv[Arg], "-t")))
+        {
+            Tolerance = (uint32_t)atoi(argv[++Arg]);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (UINT32_MAX == Tolerance)
+    {
+        Tolerance = IsSingleMode ? DIFF_SINGLE_TOLERANCE : DIFF_DEFAULT_TOLERANCE;
+    }
+
+    RunRandomized(FrameCount, &Randomized);
+    PrintStats("randomized", &Randomized);
+
+    for (; Arg < argc; Arg++)
+    {
+        IsCorpusOk &= RunCorpus(argv[Arg], &Recorded);
+    }
+
+    if (0 != Recorded.Frames)
+    {
+        PrintStats("recorded", &Recorded);
+    }
+
+    return (IsCorpusOk && (Randomized.MaxAppliedDeviation <= Tolerance) && (Recorded.MaxAppliedDeviation <= Tolerance)) ? 0 : 1;
+}
@@ -0,0 +1,274 @@
+/**
+ *
+ * @file  ghe_kernel_check.c
+ * @brief  The dispatched pixel kernels against scalar references, on the GHE_ISA level in use
+ *
+ * Random frames of every pixel format, with odd widths, padded strides and rows longer than a
+ * binning chunk so every vector loop ends in its scalar tail, go through DisplayGheBuildHistogram,
+ * DisplayGheBuildTileHistograms and DisplayGheApplyDiet, on the calling thread and on a pool. The
+ * histograms must match a per pixel count of the max channel / luma bin, and the output must match
+ * a per pixel application of DisplayGheBuildDietFactorTable with rounding and saturation, bit for
+ * bit. Run it once per level, GHE_ISA=baseline|avx2|avx512.
+ *
+ * usage: ghe_kernel_check [-n frames per format and size]
+ *
+ */
+
+#include <unistd.h>
+
+#include "../GHE_Algorithm.h"
+#include "../GHE_Cpu.h"
+#include "../GHE_Histogram.h"
+#include "../GHE_LutApply.h"
+#include "../GHE_ThreadPool.h"
+#include "ghe_tool_common.h"
+
+#define CHECK_TILES_X 3
+#define CHECK_TILES_Y 2
+
+static const char *const FormatName[GlobalHist_PIXEL_FORMAT_COUNT] = { "RGB888", "RGBA8888", "Y8", "YUYV", "RGBA1010102", "Y10", "P010" };
+
+// Widths around the 16 and 32 pixel vector steps and the 256 pixel binning chunk
+static const uint32_t Width[] = { 1, 15, 33, 67, 257, 1283 };
+
+#define CHECK_WIDTH_COUNT (sizeof(Width) / sizeof(Width[0]))
+
+static uint32_t ReadPixel(const uint8_t *pPixel, uint32_t Bpp)
+{
+    uint32_t Val = 0;
+
+    memcpy(&Val, pPixel, Bpp);
+    return Val;
+}
+
+// The value both the histogram and the DIET multiplier are indexed by
+static uint32_t ReferenceValue(GlobalHist_PIXEL_FORMAT Format, uint32_t Val)
+{
+    switch (Format)
+    {
+    case GlobalHist_PIXEL_FORMAT_RGB888:
+    case GlobalHist_PIXEL_FORMAT_RGBA8888:
+        return DD_MAX(DD_MAX(Val & 0xFF, (Val >> 8) & 0xFF), (Val >> 16) & 0xFF);
+    case GlobalHist_PIXEL_FORMAT_Y8:
+    case GlobalHist_PIXEL_FORMAT_YUYV:
+        return Val & 0xFF;
+    case GlobalHist_PIXEL_FORMAT_RGBA1010102:
+        return DD_MAX(DD_MAX(Val & 0x3FF, (Val >> 10) & 0x3FF), (Val >> 20) & 0x3FF);
+    case GlobalHist_PIXEL_FORMAT_Y10:
+        return Val & 0x3FF;
+    default:
+        return Val >> 6;
+    }
+}
+
+static uint32_t ReferenceBin(GlobalHist_PIXEL_FORMAT Format, uint32_t Val)
+{
+    return ReferenceValue(Format, Val) >> (DisplayGheGetBitsPerChannel(Format) - GlobalHist_BIN_COUNT_LOG2);
+}
+
+static uint32_t ReferenceApply(uint32_t Value, uint32_t Factor, uint32_t MaxValue)
+{
+    uint32_t Result = (Value * Factor + (1 << (GlobalHist_DIET_FRACTION_BITS - 1))) >> GlobalHist_DIET_FRACTION_BITS;
+    return DD_MIN(Result, MaxValue);
+}
+
+static uint32_t ReferenceDiet(GlobalHist_PIXEL_FORMAT Format, uint32_t Val, const uint16_t *pFactor)
+{
+    uint32_t Factor = pFactor[ReferenceValue(Format, Val)];
+
+    switch (Format)
+    {
+    case GlobalHist_PIXEL_FORMAT_RGB888:
+    case GlobalHist_PIXEL_FORMAT_RGBA8888:
+        return (Val & 0xFF000000) | ReferenceApply(Val & 0xFF, Factor, 0xFF) | (ReferenceApply((Val >> 8) & 0xFF, Factor, 0xFF) << 8) |
+               (ReferenceApply((Val >> 16) & 0xFF, Factor, 0xFF) << 16);
+    case GlobalHist_PIXEL_FORMAT_Y8:
+    case GlobalHist_PIXEL_FORMAT_YUYV:
+        return (Val & 0xFF00) | ReferenceApply(Val & 0xFF, Factor, 0xFF);
+    case GlobalHist_PIXEL_FORMAT_RGBA1010102:
+        return (Val & 0xC0000000) | ReferenceApply(Val & 0x3FF, Factor, 0x3FF) | (ReferenceApply((Val >> 10) & 0x3FF, Factor, 0x3FF) << 10) |
+               (ReferenceApply((Val >> 20) & 0x3FF, Factor, 0x3FF) << 20);
+    case GlobalHist_PIXEL_FORMAT_Y10:
+        return ReferenceApply(Val & 0x3FF, Factor, 0x3FF);
+    default:
+        return ReferenceApply(Val >> 6, Factor, 0x3FF) << 6;
+    }
+}
+
+// The tile of GlobalHist_TILE_START holding Position
+static uint32_t TileOf(uint32_t Position, uint32_t Count, uint32_t Size)
+{
+    uint32_t Tile = 0;
+
+    while ((Tile + 1 < Count) && (Position >= GlobalHist_TILE_START(Tile + 1, Count, Size)))
+    {
+        Tile++;
+    }
+
+    return Tile;
+}
+
+static uint32_t CheckFrame(const GlobalHist_FRAME *pFrame, GlobalHist_THREAD_POOL *pPool, const char *pPoolName)
+{
+    uint32_t Bpp = DisplayGheGetBytesPerPixel(pFrame->Format);
+    uint32_t TileHistogram[CHECK_TILES_X * CHECK_TILES_Y][GlobalHist_BIN_COUNT];
+    uint32_t BuiltTileHistogram[CHECK_TILES_X * CHECK_TILES_Y][GlobalHist_BIN_COUNT];
+    uint32_t Histogram[GlobalHist_BIN_COUNT], DietFactor[GlobalHist_IET_LUT_LENGTH];
+    uint16_t Factor[1 << 10];
+    uint32_t TilesY = DD_MIN(CHECK_TILES_Y, pFrame->Height);
+    uint32_t TilesX = DD_MIN(CHECK_TILES_X, pFrame->Width);
+    uint32_t OutputStride = pFrame->Stride + 4;
+    uint8_t *pOutput = (uint8_t *)malloc((size_t)OutputStride * pFrame->Height);
+    GlobalHist_ARGS Args;
+    uint32_t Failures = 0, Mismatches = 0;
+
+    if (NULL == pOutput)
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+
+    // Multipliers up to past the IET clamp, so saturation and the clamp are both exercised
+    for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        DietFactor[IetIndex] = NextRandom() % (GlobalHist_IET_MAX_VAL + 64);
+    }
+
+    DisplayGheBuildDietFactorTable(DietFactor, DisplayGheGetBitsPerChannel(pFrame->Format), Factor);
+
+    memset(Histogram, 0, sizeof(Histogram));
+    memset(TileHistogram, 0, sizeof(TileHistogram));
+
+    for (uint32_t Row = 0; Row < pFrame->Height; Row++)
+    {
+        const uint8_t *pRow = (const uint8_t *)pFrame->pData + (size_t)Row * pFrame->Stride;
+        uint32_t TileY = TileOf(Row, TilesY, pFrame->Height);
+
+        for (uint32_t Column = 0; Column < pFrame->Width; Column++)
+        {
+            uint32_t Bin = ReferenceBin(pFrame->Format, ReadPixel(pRow + (size_t)Column * Bpp, Bpp));
+
+            Histogram[Bin]++;
+            TileHistogram[TileY * TilesX + TileOf(Column, TilesX, pFrame->Width)][Bin]++;
+        }
+    }
+
+    if (!DisplayGheBuildHistogram(pFrame, &Args, pPool) || (0 != memcmp(Args.Histogram, Histogram, sizeof(Histogram))))
+    {
+        printf("histogram          %s %ux%u, %s\n", FormatName[pFrame->Format], pFrame->Width, pFrame->Height, pPoolName);
+        Failures++;
+    }
+
+    if (!DisplayGheBuildTileHistograms(pFrame, TilesX, TilesY, BuiltTileHistogram, pPool) ||
+        (0 != memcmp(BuiltTileHistogram, TileHistogram, (size_t)TilesX * TilesY * sizeof(TileHistogram[0]))))
+    {
+        printf("tile histograms    %s %ux%u, %s\n", FormatName[pFrame->Format], pFrame->Width, pFrame->Height, pPoolName);
+        Failures++;
+    }
+
+    if (!DisplayGheApplyDiet(pFrame, pOutput, OutputStride, DietFactor, pPool))
+    {
+        printf("apply refused      %s %ux%u, %s\n", FormatName[pFrame->Format], pFrame->Width, pFrame->Height, pPoolName);
+        Failures++;
+    }
+    else
+    {
+        for (uint32_t Row = 0; Row < pFrame->Height; Row++)
+        {
+            const uint8_t *pRow = (const uint8_t *)pFrame->pData + (size_t)Row * pFrame->Stride;
+
+            for (uint32_t Column = 0; Column < pFrame->Width; Column++)
+            {
+                uint32_t Expected = ReferenceDiet(pFrame->Format, ReadPixel(pRow + (size_t)Column * Bpp, Bpp), Factor);
+                Mismatches += (Expected != ReadPixel(pOutput + (size_t)Row * OutputStride + (size_t)Column * Bpp, Bpp));
+            }
+        }
+
+        if (0 != Mismatches)
+        {
+            printf("apply              %s %ux%u, %s, %u pixels differ\n", FormatName[pFrame->Format], pFrame->Width, pFrame->Height, pPoolName,
+                   Mismatches);
+            Failures++;
+        }
+    }
+
+    free(pOutput);
+
+    return Failures;
+}
+
+// Random pixels in every bit, so the reserved bits the kernels have to mask or pass are set too
+static void FillFrame(uint8_t *pData, size_t Size)
+{
+    for (size_t Byte = 0; Byte < Size; Byte++)
+    {
+        pData[Byte] = (uint8_t)NextRandom();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    GlobalHist_THREAD_POOL *pPool = DisplayGheCreateThreadPool(4);
+    uint32_t FrameCount = 4, Failures = 0, Frames = 0;
+    int Option;
+
+    while (-1 != (Option = getopt(argc, argv, "n:")))
+    {
+        FrameCount = ('n' == Option) ? (uint32_t)atoi(optarg) : 0;
+    }
+
+    if (0 == FrameCount)
+    {
+        fprintf(stderr, "usage: %s [-n frames per format and size]\n", argv[0]);
+        return 1;
+    }
+
+    if (NULL == pPool)
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    for (uint32_t Format = 0; Format < GlobalHist_PIXEL_FORMAT_COUNT; Format++)
+    {
+        for (uint32_t WidthIndex = 0; WidthIndex < CHECK_WIDTH_COUNT; WidthIndex++)
+        {
+            for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+            {
+                GlobalHist_FRAME GheFrame;
+                uint32_t Bpp = DisplayGheGetBytesPerPixel((GlobalHist_PIXEL_FORMAT)Format);
+                uint8_t *pData;
+
+                GheFrame.Format = (GlobalHist_PIXEL_FORMAT)Format;
+                GheFrame.Width  = Width[WidthIndex];
+                GheFrame.Height = 1 + NextRandom() % 97;
+                GheFrame.Stride = GheFrame.Width * Bpp + NextRandom() % 13;
+
+                pData = (uint8_t *)malloc((size_t)GheFrame.Stride * GheFrame.Height);
+
+                if (NULL == pData)
+                {
+                    fprintf(stderr, "out of memory\n");
+                    return 1;
+                }
+
+                FillFrame(pData, (size_t)GheFrame.Stride * GheFrame.Height);
+                GheFrame.pData = pData;
+
+                Failures += CheckFrame(&GheFrame, NULL, "calling thread");
+                Failures += CheckFrame(&GheFrame, pPool, "pool");
+                Frames++;
+
+                free(pData);
+            }
+        }
+    }
+
+    DisplayGheDestroyThreadPool(pPool);
+
+    printf("isa                %s\n", DisplayGheGetIsaName(DisplayGheGetIsa()));
+    printf("frames             %u, %u formats\n", Frames, (uint32_t)GlobalHist_PIXEL_FORMAT_COUNT);
+    printf("failures           %u\n", Failures);
+
+    return (0 == Failures) ? 0 : 1;
+}
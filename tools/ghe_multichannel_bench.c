@@ -0,0 +1,164 @@
+/**
+ *
+ * @file  ghe_multichannel_bench.c
+ * @brief  Throughput of DisplayGheMultiChannelProcess against one DisplayGheProcessFrame call per channel
+ *
+ * Independent channels are checked against three single channel contexts and must match bit for
+ * bit. Linked channels have no per call equivalent: fed three identical histograms they must
+ * match independent channels bit for bit, and on the regular input all channels must go solid
+ * and snap to their targets on the same frames.
+ *
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "../GHE_Algorithm.h"
+#include "../GHE_Cpu.h"
+#include "../GHE_MultiChannel.h"
+#include "ghe_tool_common.h"
+
+#define BENCH_DEFAULT_FRAMES 20000
+
+// Channels drift around their own shape with an occasional scene cut. Now and then one channel
+// goes solid while the others keep their content, or all of them go solid in the same bin. Every
+// other stretch carries 60 Hz timestamps.
+static void GenerateFrame(GlobalHist_MULTI_CHANNEL_ARGS *pArgs, uint32_t Frame)
+{
+    bool IsSceneCut = (0 == (Frame % 97));
+    uint32_t SolidChannel = (Frame / 50) % 8;
+
+    pArgs->TimestampNs = ((Frame / 500) & 1) ? (uint64_t)(Frame + 1) * 16666667ull + NextRandom() % 1000000 : 0;
+
+    for (uint32_t Channel = 0; Channel < GlobalHist_CHANNEL_COUNT; Channel++)
+    {
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            uint32_t *pBin = &pArgs->Histogram[Channel][BinIndex];
+
+            if ((Channel == SolidChannel) || (GlobalHist_CHANNEL_COUNT == SolidChannel))
+            {
+                *pBin = (BinIndex == 20) ? 2000000 : 0;
+            }
+            else if ((0 == Frame) || IsSceneCut || (0 == *pBin))
+            {
+                *pBin = NextRandom() % 65536;
+            }
+            else
+            {
+                *pBin = *pBin + (NextRandom() % 512) - DD_MIN(*pBin, 255);
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t FrameCount = (argc > 1) ? (uint32_t)atoi(argv[1]) : BENCH_DEFAULT_FRAMES;
+    GlobalHist_MULTI_CHANNEL_CONTEXT *pIndependent = DisplayGheCreateMultiChannel(GlobalHist_PIPE_ANY, GlobalHist_CHANNELS_INDEPENDENT);
+    GlobalHist_MULTI_CHANNEL_CONTEXT *pLinked = DisplayGheCreateMultiChannel(GlobalHist_PIPE_ANY, GlobalHist_CHANNELS_LINKED);
+    GlobalHist_MULTI_CHANNEL_CONTEXT *pSameIndependent = DisplayGheCreateMultiChannel(GlobalHist_PIPE_ANY, GlobalHist_CHANNELS_INDEPENDENT);
+    GlobalHist_MULTI_CHANNEL_CONTEXT *pSameLinked = DisplayGheCreateMultiChannel(GlobalHist_PIPE_ANY, GlobalHist_CHANNELS_LINKED);
+    GlobalHist_CONTEXT *pContext[GlobalHist_CHANNEL_COUNT];
+    GlobalHist_MULTI_CHANNEL_ARGS Input, Independent, Linked, SameIndependent, SameLinked;
+    GlobalHist_MULTI_CHANNEL_STATS PrevStats, Stats;
+    GlobalHist_ARGS Scalar[GlobalHist_CHANNEL_COUNT];
+    double ScalarTime = 0, IndependentTime = 0, LinkedTime = 0, Start;
+    uint64_t Mismatches = 0, SameMismatches = 0, OutOfStep = 0;
+
+    if ((0 == FrameCount) || (NULL == pIndependent) || (NULL == pLinked) || (NULL == pSameIndependent) || (NULL == pSameLinked))
+    {
+        fprintf(stderr, "usage: %s [frames]\n", argv[0]);
+        return 1;
+    }
+
+    for (uint32_t Channel = 0; Channel < GlobalHist_CHANNEL_COUNT; Channel++)
+    {
+        pContext[Channel] = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+    }
+
+    memset(&Input, 0, sizeof(Input));
+    memset(Scalar, 0, sizeof(Scalar));
+    DisplayGheMultiChannelGetStats(pLinked, &PrevStats);
+
+    for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+    {
+        GenerateFrame(&Input, Frame);
+        Independent = Input;
+        Linked      = Input;
+
+        for (uint32_t Channel = 0; Channel < GlobalHist_CHANNEL_COUNT; Channel++)
+        {
+            Scalar[Channel].TimestampNs = Input.TimestampNs;
+            memcpy(Scalar[Channel].Histogram, Input.Histogram[Channel], sizeof(Scalar[Channel].Histogram));
+        }
+
+        Start = NowInSeconds();
+        for (uint32_t Channel = 0; Channel < GlobalHist_CHANNEL_COUNT; Channel++)
+        {
+            DisplayGheProcessFrame(pContext[Channel], &Scalar[Channel]);
+        }
+        ScalarTime += NowInSeconds() - Start;
+
+        Start = NowInSeconds();
+        DisplayGheMultiChannelProcess(pIndependent, &Independent);
+        IndependentTime += NowInSeconds() - Start;
+
+        Start = NowInSeconds();
+        DisplayGheMultiChannelProcess(pLinked, &Linked);
+        LinkedTime += NowInSeconds() - Start;
+
+        // Linked channels move together: every channel solid or none, every channel snapped or none
+        DisplayGheMultiChannelGetStats(pLinked, &Stats);
+
+        for (uint32_t Channel = 0; Channel < GlobalHist_CHANNEL_COUNT; Channel++)
+        {
+            Mismatches += IsLutMismatch(Scalar[Channel].DietFactor, Independent.DietFactor[Channel]);
+            OutOfStep  += (Stats.SolidColorFrames[Channel] - PrevStats.SolidColorFrames[Channel] != Stats.SolidColorFrames[0] - PrevStats.SolidColorFrames[0]) ||
+                          (Stats.TargetReachedFrames[Channel] - PrevStats.TargetReachedFrames[Channel] != Stats.TargetReachedFrames[0] - PrevStats.TargetReachedFrames[0]);
+        }
+
+        PrevStats = Stats;
+
+        // Three copies of the first channel, linked or not
+        for (uint32_t Channel = 0; Channel < GlobalHist_CHANNEL_COUNT; Channel++)
+        {
+            memcpy(SameIndependent.Histogram[Channel], Input.Histogram[0], sizeof(Input.Histogram[0]));
+        }
+
+        SameIndependent.TimestampNs = Input.TimestampNs;
+        SameLinked                  = SameIndependent;
+
+        DisplayGheMultiChannelProcess(pSameIndependent, &SameIndependent);
+        DisplayGheMultiChannelProcess(pSameLinked, &SameLinked);
+
+        for (uint32_t Channel = 0; Channel < GlobalHist_CHANNEL_COUNT; Channel++)
+        {
+            SameMismatches += IsLutMismatch(SameIndependent.DietFactor[Channel], SameLinked.DietFactor[Channel]);
+        }
+    }
+
+    // Without a shared solid frame and a shared snap the lockstep check above proves nothing
+    OutOfStep += (0 == Stats.SolidColorFrames[0]) || (0 == Stats.TargetReachedFrames[0]);
+
+    printf("kernels            %s\n", DisplayGheGetIsaName(DisplayGheGetIsa()));
+    printf("frames             %u\n", FrameCount);
+    printf("per-call frames/s  %.0f\n", (double)FrameCount / ScalarTime);
+    printf("independent fps    %.0f (%.2fx)\n", (double)FrameCount / IndependentTime, ScalarTime / IndependentTime);
+    printf("linked fps         %.0f (%.2fx)\n", (double)FrameCount / LinkedTime, ScalarTime / LinkedTime);
+    printf("mismatched LUTs    %llu\n", (unsigned long long)Mismatches);
+    printf("linked, identical  %llu mismatched LUTs\n", (unsigned long long)SameMismatches);
+    printf("linked, in step    %llu out of step channel frames, %llu solid, %llu snapped\n", (unsigned long long)OutOfStep,
+           (unsigned long long)Stats.SolidColorFrames[0], (unsigned long long)Stats.TargetReachedFrames[0]);
+
+    for (uint32_t Channel = 0; Channel < GlobalHist_CHANNEL_COUNT; Channel++)
+    {
+        DisplayGheDestroyContext(pContext[Channel]);
+    }
+
+    DisplayGheDestroyMultiChannel(pIndependent);
+    DisplayGheDestroyMultiChannel(pLinked);
+    DisplayGheDestroyMultiChannel(pSameIndependent);
+    DisplayGheDestroyMultiChannel(pSameLinked);
+
+    return ((0 == Mismatches) && (0 == SameMismatches) && (0 == OutOfStep)) ? 0 : 1;
+}
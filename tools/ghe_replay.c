@@ -0,0 +1,185 @@
+/**
+ *
+ * @file  ghe_replay.c
+ * @brief  Replays a recorded GHE trace and diffs the output against the recorded DietFactor
+ *
+ * The trace is memory mapped and streamed through DisplayGheProcessFrame, one context per
+ * recorded pipe, as fast as the algorithm runs. Every pipe runs on the setup its setup records
+ * carry: GlobalHist_CFG, transfer function, precision and change detection. Any DietFactor that
+ * differs from the one recorded in the field is reported. With -s the GHE_Stats.h counters of every replayed pipe are printed,
+ * which needs the library built with -DGlobalHist_ENABLE_STATS.
+ *
+ * usage: ghe_replay [-v] [-s] trace
+ *
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <unistd.h>
+
+#include "../GHE_Algorithm.h"
+#include "../GHE_Trace.h"
+#include "ghe_tool_common.h"
+
+#define REPLAY_MAX_REPORTED_MISMATCHES 10
+
+static bool ApplySetup(GlobalHist_CONTEXT *pContext, const GlobalHist_TRACE_SETUP *pSetup)
+{
+    DisplayGheSetChangeDetection(pContext, pSetup->ChangeTolerance, pSetup->CacheKeyShift);
+
+    return DisplayGheSetConfig(pContext, &pSetup->Cfg) && DisplayGheSetTransferFunction(pContext, pSetup->TransferFunction) &&
+           DisplayGheSetPrecision(pContext, pSetup->Precision);
+}
+
+static void PrintLut(const char *pName, const uint32_t *pLut)
+{
+    printf("    %-9s", pName);
+
+    for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        printf(" %4u", pLut[IetIndex]);
+    }
+
+    printf("\n");
+}
+
+static void PrintStats(uint32_t Slot, GlobalHist_CONTEXT *pContext)
+{
+    static const char *StageName[GlobalHist_STATS_STAGE_COUNT] = { "frame", "lut target", "temporal filter", "program diet" };
+    double NsPerTick = 1e9 / (double)DisplayGheStatsGetTicksPerSecond();
+    GlobalHist_STATS Stats;
+
+    if (FALSE == DisplayGheGetStatsSnapshot(pContext, &Stats))
+    {
+        printf("pipe %u: no stats, library built without GlobalHist_ENABLE_STATS\n", Slot);
+        return;
+    }
+
+    printf("pipe %u\n", Slot);
+    printf("    frames %llu, fast path %llu, cache hits %llu, misses %llu, solid color %llu\n",
+           (unsigned long long)Stats.FramesProcessed, (unsigned long long)Stats.FastPathFrames, (unsigned long long)Stats.LutCacheHits,
+           (unsigned long long)Stats.LutCacheMisses, (unsigned long long)Stats.SolidColorFrames);
+    printf("    filter steps %llu, on target %llu, clamps min slope %llu, max slope %llu, iet max %llu\n",
+           (unsigned long long)Stats.FilterSteps, (unsigned long long)Stats.TargetReachedFrames, (unsigned long long)Stats.MinSlopeClamps,
+           (unsigned long long)Stats.MaxSlopeClamps, (unsigned long long)Stats.IetMaxClamps);
+    printf("    steps to converge");
+
+    for (uint32_t Bucket = 0; Bucket < GlobalHist_STATS_CONVERGENCE_BUCKETS; Bucket++)
+    {
+        printf(" %llu", (unsigned long long)Stats.ConvergenceHistogram[Bucket]);
+    }
+
+    printf("\n");
+
+    for (uint32_t Stage = 0; Stage < GlobalHist_STATS_STAGE_COUNT; Stage++)
+    {
+        printf("    %-16s %10llu calls %10.1f ns avg %10.1f ns max\n", StageName[Stage], (unsigned long long)Stats.StageCalls[Stage],
+               (0 != Stats.StageCalls[Stage]) ? (double)Stats.StageTicks[Stage] * NsPerTick / (double)Stats.StageCalls[Stage] : 0.0,
+               (double)Stats.StageMaxTicks[Stage] * NsPerTick);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    GlobalHist_CONTEXT *pContext[GlobalHist_TRACE_PIPE_SLOTS] = { NULL };
+    GlobalHist_TRACE_READER *pReader;
+    GlobalHist_TRACE_FRAME Frame;
+    GlobalHist_ARGS Args;
+    uint64_t FrameCount = 0, Mismatches = 0, FirstMismatch = 0;
+    uint64_t FirstTimestampNs = 0, LastTimestampNs = 0;
+    uint32_t MaxDeviation = 0;
+    bool IsVerbose = FALSE, IsStats = FALSE;
+    double Start, Elapsed;
+    int Option;
+
+    while (-1 != (Option = getopt(argc, argv, "vs")))
+    {
+        IsVerbose |= ('v' == Option);
+        IsStats   |= ('s' == Option);
+    }
+
+    if ((optind >= argc) || (NULL == (pReader = DisplayGheTraceOpenReader(argv[optind]))))
+    {
+        fprintf(stderr, "usage: %s [-v] [-s] trace\n", argv[0]);
+        return 1;
+    }
+
+    Start = NowInSeconds();
+
+    while (DisplayGheTraceNextFrame(pReader, &Frame))
+    {
+        uint32_t Slot = ((uint32_t)Frame.Args.PipeId < GlobalHist_MAX_PIPES) ? (uint32_t)Frame.Args.PipeId : GlobalHist_MAX_PIPES;
+        uint32_t Deviation;
+
+        // Contexts are not registered, so replay never disturbs a live pipe in the same process
+        if ((NULL == pContext[Slot]) && (NULL == (pContext[Slot] = DisplayGheCreateContext(GlobalHist_PIPE_ANY))))
+        {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+
+        if (Frame.IsSetupChanged && !ApplySetup(pContext[Slot], &Frame.Setup))
+        {
+            fprintf(stderr, "frame %llu pipe %u: setup record out of range\n", (unsigned long long)FrameCount,
+                    (uint32_t)Frame.Args.PipeId);
+        }
+
+        Args = Frame.Args;
+        memset(Args.DietFactor, 0, sizeof(Args.DietFactor));
+        DisplayGheProcessFrame(pContext[Slot], &Args);
+
+        Deviation = MaxLutDeviation(Args.DietFactor, Frame.Args.DietFactor, NULL);
+
+        if (0 != Deviation)
+        {
+            if ((0 == Mismatches) || (IsVerbose && (Mismatches < REPLAY_MAX_REPORTED_MISMATCHES)))
+            {
+                printf("frame %llu pipe %u t=%llu ns: DietFactor off by up to %u\n", (unsigned long long)FrameCount,
+                       (uint32_t)Frame.Args.PipeId, (unsigned long long)Frame.TimestampNs, Deviation);
+                PrintLut("recorded", Frame.Args.DietFactor);
+                PrintLut("replayed", Args.DietFactor);
+            }
+
+            FirstMismatch = (0 == Mismatches) ? FrameCount : FirstMismatch;
+            MaxDeviation = DD_MAX(MaxDeviation, Deviation);
+            Mismatches++;
+        }
+
+        FirstTimestampNs = (0 == FrameCount) ? Frame.TimestampNs : FirstTimestampNs;
+        LastTimestampNs = Frame.TimestampNs;
+        FrameCount++;
+    }
+
+    Elapsed = NowInSeconds() - Start;
+
+    if (DisplayGheTraceGetOffset(pReader) != DisplayGheTraceGetSize(pReader))
+    {
+        fprintf(stderr, "trace truncated or corrupt at byte %llu of %llu\n",
+                (unsigned long long)DisplayGheTraceGetOffset(pReader), (unsigned long long)DisplayGheTraceGetSize(pReader));
+    }
+
+    printf("frames             %llu\n", (unsigned long long)FrameCount);
+    printf("captured span      %.3f s\n", (double)(LastTimestampNs - FirstTimestampNs) * 1e-9);
+    printf("replay rate        %.0f frames/s, %.1f MB/s\n", (double)FrameCount / Elapsed, (double)DisplayGheTraceGetOffset(pReader) / Elapsed / 1e6);
+    printf("mismatched frames  %llu\n", (unsigned long long)Mismatches);
+
+    if (0 != Mismatches)
+    {
+        printf("first mismatch     frame %llu\n", (unsigned long long)FirstMismatch);
+        printf("max deviation      %u\n", MaxDeviation);
+    }
+
+    for (uint32_t Slot = 0; Slot < GlobalHist_TRACE_PIPE_SLOTS; Slot++)
+    {
+        if (IsStats && (NULL != pContext[Slot]))
+        {
+            PrintStats(Slot, pContext[Slot]);
+        }
+
+        DisplayGheDestroyContext(pContext[Slot]);
+    }
+
+    DisplayGheTraceCloseReader(pReader);
+
+    return (0 == Mismatches) ? 0 : 1;
+}
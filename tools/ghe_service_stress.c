@@ -0,0 +1,256 @@
+/**
+ *
+ * @file  ghe_service_stress.c
+ * @brief  Stress test of the GHE service: four pipes submitting concurrently at display rate
+ *
+ * One producer thread per pipe submits a frame every vblank, while a reader thread keeps copying
+ * the published DietFactor of every pipe like the register programming side would. Afterwards
+ * every frame the service accepted is replayed per pipe through DisplayGheProcessFrame on a fresh
+ * context and every DietFactor the reader saw is checked against it, so a torn or misattributed
+ * read shows up as a mismatch.
+ *
+ * usage: ghe_service_stress [-d seconds] [-r refresh Hz] [-w workers] [-p reader poll us]
+ *
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../GHE_Algorithm.h"
+#include "../GHE_Service.h"
+#include "ghe_tool_common.h"
+
+#define STRESS_PIPES GlobalHist_MAX_PIPES
+
+typedef struct _STRESS_PIPE
+{
+    GlobalHist_SERVICE *pService;
+    PIPE_ID Pipe;
+    uint32_t FrameCount;
+    uint64_t StartNs;
+    uint64_t FramePeriodNs;
+    GlobalHist_ARGS *pSubmitted;   // [FrameCount], indexed by FrameId - 1
+    bool *pIsAccepted;             // [FrameCount]
+    uint32_t *pSeen;               // [FrameCount][GlobalHist_IET_LUT_LENGTH], DietFactor first read for the frame
+    bool *pIsSeen;                 // [FrameCount]
+} STRESS_PIPE;
+
+typedef struct _STRESS_READER
+{
+    STRESS_PIPE *pPipe;
+    uint32_t PollUs;
+    volatile bool IsDone;
+    uint64_t Reads;
+} STRESS_READER;
+
+static void SleepUntil(uint64_t DeadlineNs)
+{
+    struct timespec Deadline = { (time_t)(DeadlineNs / 1000000000ull), (long)(DeadlineNs % 1000000000ull) };
+
+    while (0 != clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Deadline, NULL))
+    {
+        // Interrupted by a signal
+    }
+}
+
+// Drifting content with a scene cut every second, different per pipe
+static void GenerateHistogram(uint32_t Pipe, uint32_t Frame, uint32_t RefreshHz, uint32_t *pHistogram)
+{
+    uint32_t Scene = Frame / RefreshHz;
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        uint32_t Shape = ((BinIndex + 1) * 2654435761u + (Scene * 4 + Pipe) * 40503u) >> 16;
+
+        pHistogram[BinIndex] = 2000 + Shape % 120000 + ((Frame * 37 + BinIndex * 11) % 512);
+    }
+}
+
+static void *ProducerMain(void *pArg)
+{
+    STRESS_PIPE *pPipe = (STRESS_PIPE *)pArg;
+    uint32_t RefreshHz = (uint32_t)(1000000000ull / pPipe->FramePeriodNs);
+
+    for (uint32_t Frame = 0; Frame < pPipe->FrameCount; Frame++)
+    {
+        GlobalHist_ARGS *pArgs = &pPipe->pSubmitted[Frame];
+        uint64_t VblankNs = pPipe->StartNs + (uint64_t)Frame * pPipe->FramePeriodNs;
+
+        SleepUntil(VblankNs);
+
+        memset(pArgs, 0, sizeof(*pArgs));
+        pArgs->PipeId       = pPipe->Pipe;
+        pArgs->Resolution_X = 3840;
+        pArgs->Resolution_Y = 2160;
+        pArgs->TimestampNs  = VblankNs;
+        GenerateHistogram((uint32_t)pPipe->Pipe, Frame, RefreshHz, pArgs->Histogram);
+
+        pPipe->pIsAccepted[Frame] = DisplayGheServiceSubmit(pPipe->pService, pArgs);
+    }
+
+    return NULL;
+}
+
+static void *ReaderMain(void *pArg)
+{
+    STRESS_READER *pReader = (STRESS_READER *)pArg;
+    GlobalHist_SERVICE_RESULT Result;
+
+    while (FALSE == pReader->IsDone)
+    {
+        for (uint32_t Pipe = 0; Pipe < STRESS_PIPES; Pipe++)
+        {
+            STRESS_PIPE *pPipe = &pReader->pPipe[Pipe];
+
+            if (DisplayGheServiceRead(pPipe->pService, (PIPE_ID)Pipe, &Result) && (Result.FrameId <= pPipe->FrameCount))
+            {
+                uint64_t Frame = Result.FrameId - 1;
+
+                if (FALSE == pPipe->pIsSeen[Frame])
+                {
+                    memcpy(&pPipe->pSeen[Frame * GlobalHist_IET_LUT_LENGTH], Result.DietFactor, sizeof(Result.DietFactor));
+                    pPipe->pIsSeen[Frame] = TRUE;
+                }
+            }
+
+            pReader->Reads++;
+        }
+
+        if (0 != pReader->PollUs)
+        {
+            SleepUntil(GetTimeNs() + (uint64_t)pReader->PollUs * 1000);
+        }
+    }
+
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    STRESS_PIPE Pipe[STRESS_PIPES];
+    STRESS_READER Reader;
+    pthread_t Producer[STRESS_PIPES], ReaderThread;
+    GlobalHist_SERVICE *pService;
+    double Seconds = 2;
+    uint32_t RefreshHz = 240, WorkerCount = 2, PollUs = 100;
+    uint64_t Mismatches = 0;
+    int Option;
+
+    while (-1 != (Option = getopt(argc, argv, "d:r:w:p:")))
+    {
+        switch (Option)
+        {
+        case 'd': Seconds     = atof(optarg);             break;
+        case 'r': RefreshHz   = (uint32_t)atoi(optarg);   break;
+        case 'w': WorkerCount = (uint32_t)atoi(optarg);   break;
+        case 'p': PollUs      = (uint32_t)atoi(optarg);   break;
+        default:
+            fprintf(stderr, "usage: %s [-d seconds] [-r refresh Hz] [-w workers] [-p reader poll us]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if ((Seconds <= 0) || (0 == RefreshHz) || (NULL == (pService = DisplayGheCreateService(WorkerCount))))
+    {
+        fprintf(stderr, "usage: %s [-d seconds] [-r refresh Hz] [-w workers] [-p reader poll us]\n", argv[0]);
+        return 1;
+    }
+
+    memset(Pipe, 0, sizeof(Pipe));
+    memset(&Reader, 0, sizeof(Reader));
+    Reader.pPipe  = Pipe;
+    Reader.PollUs = PollUs;
+
+    for (uint32_t Index = 0; Index < STRESS_PIPES; Index++)
+    {
+        STRESS_PIPE *pPipe = &Pipe[Index];
+
+        pPipe->pService      = pService;
+        pPipe->Pipe          = (PIPE_ID)Index;
+        pPipe->FrameCount    = (uint32_t)(Seconds * RefreshHz);
+        pPipe->FramePeriodNs = 1000000000ull / RefreshHz;
+        pPipe->pSubmitted    = (GlobalHist_ARGS *)calloc(pPipe->FrameCount, sizeof(GlobalHist_ARGS));
+        pPipe->pIsAccepted   = (bool *)calloc(pPipe->FrameCount, sizeof(bool));
+        pPipe->pSeen         = (uint32_t *)calloc((size_t)pPipe->FrameCount * GlobalHist_IET_LUT_LENGTH, sizeof(uint32_t));
+        pPipe->pIsSeen       = (bool *)calloc(pPipe->FrameCount, sizeof(bool));
+
+        if ((NULL == pPipe->pSubmitted) || (NULL == pPipe->pIsAccepted) || (NULL == pPipe->pSeen) || (NULL == pPipe->pIsSeen))
+        {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+    }
+
+    pthread_create(&ReaderThread, NULL, ReaderMain, &Reader);
+
+    // Pipes start a quarter frame apart, as unsynchronized displays would
+    for (uint32_t Index = 0; Index < STRESS_PIPES; Index++)
+    {
+        Pipe[Index].StartNs = GetTimeNs() + 10000000ull + Index * Pipe[Index].FramePeriodNs / STRESS_PIPES;
+        pthread_create(&Producer[Index], NULL, ProducerMain, &Pipe[Index]);
+    }
+
+    for (uint32_t Index = 0; Index < STRESS_PIPES; Index++)
+    {
+        pthread_join(Producer[Index], NULL);
+    }
+
+    // Let the workers finish what is queued before the last read
+    SleepUntil(GetTimeNs() + 50000000ull);
+    Reader.IsDone = TRUE;
+    pthread_join(ReaderThread, NULL);
+
+    printf("pipes %u at %u Hz for %.1f s, %u workers, reader %llu reads\n", STRESS_PIPES, RefreshHz, Seconds, WorkerCount, (unsigned long long)Reader.Reads);
+    printf("%-6s %10s %10s %10s %10s %12s %12s %10s\n", "pipe", "submitted", "dropped", "published", "seen", "avg lat us", "max lat us", "mismatch");
+
+    for (uint32_t Index = 0; Index < STRESS_PIPES; Index++)
+    {
+        STRESS_PIPE *pPipe = &Pipe[Index];
+        GlobalHist_CONTEXT *pReference = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+        GlobalHist_SERVICE_STATS Stats;
+        uint64_t SeenCount = 0, PipeMismatches = 0;
+
+        for (uint32_t Frame = 0; Frame < pPipe->FrameCount; Frame++)
+        {
+            GlobalHist_ARGS Args = pPipe->pSubmitted[Frame];
+
+            if (FALSE == pPipe->pIsAccepted[Frame])
+            {
+                continue;
+            }
+
+            DisplayGheProcessFrame(pReference, &Args);
+
+            if (pPipe->pIsSeen[Frame])
+            {
+                SeenCount++;
+                PipeMismatches += IsLutMismatch(Args.DietFactor, &pPipe->pSeen[(size_t)Frame * GlobalHist_IET_LUT_LENGTH]);
+            }
+        }
+
+        DisplayGheServiceGetStats(pService, (PIPE_ID)Index, &Stats);
+        printf("%-6u %10llu %10llu %10llu %10llu %12.1f %12.1f %10llu\n", Index, (unsigned long long)Stats.Submitted,
+               (unsigned long long)Stats.Dropped, (unsigned long long)Stats.Published, (unsigned long long)SeenCount,
+               (0 != Stats.Published) ? (double)Stats.TotalLatencyNs / (double)Stats.Published / 1000.0 : 0.0,
+               (double)Stats.MaxLatencyNs / 1000.0, (unsigned long long)PipeMismatches);
+
+        Mismatches += PipeMismatches;
+        Mismatches += (Stats.Published != Stats.Submitted - Stats.Dropped);
+        DisplayGheDestroyContext(pReference);
+    }
+
+    DisplayGheDestroyService(pService);
+
+    for (uint32_t Index = 0; Index < STRESS_PIPES; Index++)
+    {
+        free(Pipe[Index].pSubmitted);
+        free(Pipe[Index].pIsAccepted);
+        free(Pipe[Index].pSeen);
+        free(Pipe[Index].pIsSeen);
+    }
+
+    return (0 == Mismatches) ? 0 : 1;
+}
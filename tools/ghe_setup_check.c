@@ -0,0 +1,192 @@
+/**
+ *
+ * @file  ghe_setup_check.c
+ * @brief  Setup changes on a converged static pipe against a fresh context with the new setup
+ *
+ * A context runs one static frame until its filter has converged, then takes a new setup and
+ * keeps running the same frame. The change detection fast path must not hold on to the LUT of the
+ * old setup: the first frame after the change runs the algorithm, and once both have converged the
+ * DietFactor must match a context that ran the new setup from the start, bit for bit. A setup the
+ * target depends on must also move the DietFactor away from the one before the change.
+ *
+ * usage: ghe_setup_check [-n frames per run]
+ *
+ */
+
+#include <unistd.h>
+
+#include "../GHE_Algorithm.h"
+#include "../GHE_Snapshot.h"
+#include "ghe_tool_common.h"
+
+#define CHECK_PIXELS (1920 * 1080)
+
+typedef bool (*PFN_CHECK_SETUP)(GlobalHist_CONTEXT *pGheContext);
+
+typedef struct _CHECK_CASE
+{
+    const char *pName;
+    PFN_CHECK_SETUP pfnSetup;
+    bool IsTargetMoved; // The setup changes the target of the frame, not only the filter
+} CHECK_CASE;
+
+// Two humps, dark and mid gray, so the target moves with every setup
+static void GenerateFrame(GlobalHist_ARGS *pArgs)
+{
+    uint32_t Weight[GlobalHist_BIN_COUNT], WeightSum = 0, Assigned = 0;
+
+    memset(pArgs, 0, sizeof(*pArgs));
+    pArgs->PipeId       = GlobalHist_PIPE_ANY;
+    pArgs->Resolution_X = 1920;
+    pArgs->Resolution_Y = 1080;
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        int32_t Dark = (int32_t)BinIndex - 5;
+        int32_t Gray = (int32_t)BinIndex - 17;
+
+        Weight[BinIndex] = 32 + 4096 / (uint32_t)(1 + Dark * Dark) + 2048 / (uint32_t)(2 + Gray * Gray);
+        WeightSum += Weight[BinIndex];
+    }
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        pArgs->Histogram[BinIndex] = (uint32_t)((uint64_t)CHECK_PIXELS * Weight[BinIndex] / WeightSum);
+        Assigned += pArgs->Histogram[BinIndex];
+    }
+
+    pArgs->Histogram[5] += CHECK_PIXELS - Assigned;
+}
+
+static bool SetSlopes(GlobalHist_CONTEXT *pGheContext)
+{
+    GlobalHist_CFG Cfg;
+
+    DisplayGheGetConfig(pGheContext, &Cfg);
+    Cfg.MinSlope = 0.9;
+    Cfg.MaxSlope = 1.2;
+
+    return DisplayGheSetConfig(pGheContext, &Cfg);
+}
+
+static bool SetPq(GlobalHist_CONTEXT *pGheContext)
+{
+    return DisplayGheSetTransferFunction(pGheContext, GlobalHist_TRANSFER_PQ);
+}
+
+static bool SetSingle(GlobalHist_CONTEXT *pGheContext)
+{
+    return DisplayGheSetPrecision(pGheContext, GlobalHist_PRECISION_SINGLE);
+}
+
+// The state saved under the old config, restored into the context after it took the new one
+static bool RestoreUnderSlopes(GlobalHist_CONTEXT *pGheContext)
+{
+    uint8_t Snapshot[GlobalHist_SNAPSHOT_SIZE];
+
+    return (GlobalHist_SNAPSHOT_SIZE == DisplayGheSaveSnapshot(pGheContext, Snapshot, sizeof(Snapshot))) && SetSlopes(pGheContext) &&
+           DisplayGheRestoreSnapshot(pGheContext, Snapshot, sizeof(Snapshot));
+}
+
+static const CHECK_CASE Case[] =
+{
+    { "config slopes",     SetSlopes, TRUE },
+    { "transfer function", SetPq,     FALSE }, // Weights the solid color and brightness estimates only
+    { "single precision",  SetSingle, FALSE }, // Within one LSB, the frame may round the same
+    { "restored snapshot", RestoreUnderSlopes, TRUE },
+};
+
+#define CHECK_CASE_COUNT (sizeof(Case) / sizeof(Case[0]))
+
+// Runs the frame FrameCount times, the DietFactor of the last one is left in pArgs
+static void RunStatic(GlobalHist_CONTEXT *pGheContext, GlobalHist_ARGS *pArgs, uint32_t FrameCount)
+{
+    for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+    {
+        GenerateFrame(pArgs);
+        DisplayGheProcessFrame(pGheContext, pArgs);
+    }
+}
+
+static uint32_t CheckCase(const CHECK_CASE *pCase, uint32_t FrameCount)
+{
+    GlobalHist_CONTEXT *pChanged = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+    GlobalHist_CONTEXT *pFresh = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+    GlobalHist_ARGS Before, Changed, Fresh;
+    uint64_t FastPathHits;
+    uint32_t Failures = 0;
+
+    if ((NULL == pChanged) || (NULL == pFresh))
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+
+    RunStatic(pChanged, &Before, FrameCount);
+
+    if (!pCase->pfnSetup(pChanged) || !pCase->pfnSetup(pFresh))
+    {
+        printf("refused            %s\n", pCase->pName);
+        Failures++;
+    }
+
+    FastPathHits = pChanged->ChangeDetection.FastPathHits;
+    RunStatic(pChanged, &Changed, 1);
+
+    if (FastPathHits != pChanged->ChangeDetection.FastPathHits)
+    {
+        printf("fast path          %s, the first frame after the change kept the old LUT\n", pCase->pName);
+        Failures++;
+    }
+
+    RunStatic(pChanged, &Changed, FrameCount);
+    RunStatic(pFresh, &Fresh, FrameCount);
+
+    if (!pChanged->ChangeDetection.IsConverged || !pFresh->ChangeDetection.IsConverged)
+    {
+        printf("not converged      %s\n", pCase->pName);
+        Failures++;
+    }
+    else if (pCase->IsTargetMoved && !IsLutMismatch(Before.DietFactor, Fresh.DietFactor))
+    {
+        printf("same target        %s, the frame does not show the change\n", pCase->pName);
+        Failures++;
+    }
+    else if (IsLutMismatch(Changed.DietFactor, Fresh.DietFactor))
+    {
+        printf("stale              %s, DietFactor[16] %u, fresh context %u\n", pCase->pName, Changed.DietFactor[16], Fresh.DietFactor[16]);
+        Failures++;
+    }
+
+    DisplayGheDestroyContext(pChanged);
+    DisplayGheDestroyContext(pFresh);
+
+    return Failures;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t FrameCount = 600, Failures = 0;
+    int Option;
+
+    while (-1 != (Option = getopt(argc, argv, "n:")))
+    {
+        FrameCount = ('n' == Option) ? (uint32_t)atoi(optarg) : 0;
+    }
+
+    if (0 == FrameCount)
+    {
+        fprintf(stderr, "usage: %s [-n frames per run]\n", argv[0]);
+        return 1;
+    }
+
+    for (uint32_t CaseIndex = 0; CaseIndex < CHECK_CASE_COUNT; CaseIndex++)
+    {
+        Failures += CheckCase(&Case[CaseIndex], FrameCount);
+    }
+
+    printf("cases              %u, %u frames per run\n", (uint32_t)CHECK_CASE_COUNT, FrameCount);
+    printf("failures           %u\n", Failures);
+
+    return (0 == Failures) ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+/**
+ *
+ * @file  ghe_snapshot_check.c
+ * @brief  Warm start through GHE_Snapshot.h against an uninterrupted context
+ *
+ * A reference context runs a clip of scene cuts, fades and solid color frames uninterrupted. A
+ * second one runs the same clip and every few frames saves its state, which a fresh context
+ * restores and continues to the end of the clip with: the DietFactor of every later frame must
+ * match the reference bit for bit. Truncated, corrupt, wrong version and
+ * resealed but insane snapshots, NaN and Inf doubles, negative holds, unknown flags and LUT
+ * entries above the register limit, must each be rejected with the context left untouched.
+ *
+ * usage: ghe_snapshot_check [-n frames] [-i save interval]
+ *
+ */
+
+#include <unistd.h>
+
+#include "../GHE_Algorithm.h"
+#include "../GHE_Snapshot.h"
+#include "ghe_tool_common.h"
+
+#define CHECK_PIXELS (1920 * 1080)
+
+// Byte offsets of the snapshot fields, see GHE_Snapshot.h
+#define CHECK_LUT_APPLIED_OFFSET   GlobalHist_SNAPSHOT_HEADER_SIZE
+#define CHECK_PREV_POWER_OFFSET    (CHECK_LUT_APPLIED_OFFSET + 2 * 2 * GlobalHist_IET_LUT_LENGTH + 4 * GlobalHist_BIN_COUNT + 8)
+#define CHECK_HOLD_OFFSET          (CHECK_PREV_POWER_OFFSET + 8 * 3)
+#define CHECK_IET_HISTORY_OFFSET   (CHECK_PREV_POWER_OFFSET + 8 * 4)
+
+// Scenes of 40 frames around a peak of their own, fading brighter over the scene, every fifth one
+// a solid color. The ripple is a hash of the frame, so every run sees the same clip.
+static void GenerateFrame(GlobalHist_ARGS *pArgs, uint32_t Frame)
+{
+    uint32_t Scene = Frame / 40;
+    uint32_t Peak = (Scene * 7) % GlobalHist_BIN_COUNT;
+    uint32_t Width = 1 + Scene % 5;
+    uint32_t Weight[GlobalHist_BIN_COUNT], WeightSum = 0, Assigned = 0;
+
+    memset(pArgs, 0, sizeof(*pArgs));
+    pArgs->PipeId       = GlobalHist_PIPE_ANY;
+    pArgs->Resolution_X = 1920;
+    pArgs->Resolution_Y = 1080;
+
+    if (4 == Scene % 5)
+    {
+        pArgs->Histogram[Peak] = CHECK_PIXELS;
+        return;
+    }
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        int32_t Distance = (int32_t)BinIndex - (int32_t)Peak;
+        uint32_t Ripple = ((Frame * 2654435761u) ^ (BinIndex * 40503u)) >> 26;
+
+        Weight[BinIndex] = 64 + 16384 * Width / (Width + (uint32_t)(Distance * Distance)) + (Frame % 40) * BinIndex * 4 + Ripple;
+        WeightSum += Weight[BinIndex];
+    }
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        pArgs->Histogram[BinIndex] = (uint32_t)((uint64_t)CHECK_PIXELS * Weight[BinIndex] / WeightSum);
+        Assigned += pArgs->Histogram[BinIndex];
+    }
+
+    pArgs->Histogram[Peak] += CHECK_PIXELS - Assigned;
+}
+
+static void PutU64(uint8_t *pOut, uint64_t Value)
+{
+    for (uint32_t Byte = 0; Byte < 8; Byte++)
+    {
+        pOut[Byte] = (uint8_t)(Value >> (8 * Byte));
+    }
+}
+
+static void PutF64(uint8_t *pOut, double Value)
+{
+    uint64_t Bits;
+
+    memcpy(&Bits, &Value, sizeof(Bits));
+    PutU64(pOut, Bits);
+}
+
+// Recomputes the FNV-1a checksum, so only the edited field can fail the restore
+static void Reseal(uint8_t *pSnapshot)
+{
+    uint32_t Hash = 2166136261u;
+
+    for (uint32_t Index = 0; Index < GlobalHist_SNAPSHOT_SIZE; Index++)
+    {
+        if ((Index - GlobalHist_SNAPSHOT_CHECKSUM_OFFSET) >= 4)
+        {
+            Hash = (Hash ^ pSnapshot[Index]) * 16777619u;
+        }
+    }
+
+    for (uint32_t Byte = 0; Byte < 4; Byte++)
+    {
+        pSnapshot[GlobalHist_SNAPSHOT_CHECKSUM_OFFSET + Byte] = (uint8_t)(Hash >> (8 * Byte));
+    }
+}
+
+// Restores a broken copy of pSnapshot into pGheContext, which must refuse it and stay as it was
+static uint32_t CheckRejected(GlobalHist_CONTEXT *pGheContext, const uint8_t *pSnapshot, size_t Size, uint32_t Offset, const void *pValue,
+                              size_t ValueSize, bool IsResealed, const char *pName)
+{
+    static GlobalHist_CONTEXT Before;
+    uint8_t Broken[GlobalHist_SNAPSHOT_SIZE];
+
+    memcpy(Broken, pSnapshot, sizeof(Broken));
+    memcpy(Broken + Offset, pValue, ValueSize);
+
+    if (IsResealed)
+    {
+        Reseal(Broken);
+    }
+
+    memcpy(&Before, pGheContext, sizeof(Before));
+
+    if (DisplayGheRestoreSnapshot(pGheContext, Broken, Size))
+    {
+        printf("accepted           %s\n", pName);
+        return 1;
+    }
+
+    if (0 != memcmp(&Before, pGheContext, sizeof(Before)))
+    {
+        printf("touched            %s\n", pName);
+        return 1;
+    }
+
+    return 0;
+}
+
+static uint32_t CheckRejections(GlobalHist_CONTEXT *pGheContext, const uint8_t *pSnapshot)
+{
+    uint8_t Double[8], Byte;
+    uint16_t Version = GlobalHist_SNAPSHOT_VERSION + 1;
+    uint16_t Entry = GlobalHist_IET_MAX_VAL + 1;
+    uint32_t Failures = 0;
+
+    // Version and LUT entry are little endian u16, as the host is
+    uint8_t VersionBytes[2] = { (uint8_t)Version, (uint8_t)(Version >> 8) };
+    uint8_t EntryBytes[2] = { (uint8_t)Entry, (uint8_t)(Entry >> 8) };
+
+    Byte = pSnapshot[CHECK_IET_HISTORY_OFFSET] ^ 0x01;
+    Failures += CheckRejected(pGheContext, pSnapshot, GlobalHist_SNAPSHOT_SIZE - 1, 0, pSnapshot, 1, FALSE, "truncated");
+    Failures += CheckRejected(pGheContext, pSnapshot, GlobalHist_SNAPSHOT_SIZE, CHECK_IET_HISTORY_OFFSET, &Byte, 1, FALSE, "corrupt");
+    Failures += CheckRejected(pGheContext, pSnapshot, GlobalHist_SNAPSHOT_SIZE, 4, VersionBytes, 2, FALSE, "wrong version");
+    Failures += CheckRejected(pGheContext, pSnapshot, GlobalHist_SNAPSHOT_SIZE, 4, VersionBytes, 2, TRUE, "wrong version, resealed");
+
+    Byte = pSnapshot[9] | 0x80;
+    Failures += CheckRejected(pGheContext, pSnapshot, GlobalHist_SNAPSHOT_SIZE, 9, &Byte, 1, TRUE, "unknown flag");
+    Byte = 1;
+    Failures += CheckRejected(pGheContext, pSnapshot, GlobalHist_SNAPSHOT_SIZE, 10, &Byte, 1, TRUE, "reserved set");
+    Failures += CheckRejected(pGheContext, pSnapshot, GlobalHist_SNAPSHOT_SIZE, CHECK_LUT_APPLIED_OFFSET + 2 * 16, EntryBytes, 2, TRUE, "LUT entry");
+
+    PutF64(Double, NAN);
+    Failures += CheckRejected(pGheContext, pSnapshot, GlobalHist_SNAPSHOT_SIZE, CHECK_IET_HISTORY_OFFSET + 8 * 50, Double, 8, TRUE, "NaN IETHistory");
+    Failures += CheckRejected(pGheContext, pSnapshot, GlobalHist_SNAPSHOT_SIZE, CHECK_HOLD_OFFSET, Double, 8, TRUE, "NaN hold remaining");
+    PutF64(Double, INFINITY);
+    Failures += CheckRejected(pGheContext, pSnapshot, GlobalHist_SNAPSHOT_SIZE, CHECK_PREV_POWER_OFFSET, Double, 8, TRUE, "Inf PrevFramePower");
+    Failures += CheckRejected(pGheContext, pSnapshot, GlobalHist_SNAPSHOT_SIZE, CHECK_PREV_POWER_OFFSET + 8, Double, 8, TRUE, "Inf TargetBoost");
+    PutF64(Double, -INFINITY);
+    Failures += CheckRejected(pGheContext, pSnapshot, GlobalHist_SNAPSHOT_SIZE, CHECK_IET_HISTORY_OFFSET, Double, 8, TRUE, "-Inf IETHistory");
+    PutF64(Double, -1.0);
+    Failures += CheckRejected(pGheContext, pSnapshot, GlobalHist_SNAPSHOT_SIZE, CHECK_HOLD_OFFSET - 8, Double, 8, TRUE, "negative held cut off");
+    Failures += CheckRejected(pGheContext, pSnapshot, GlobalHist_SNAPSHOT_SIZE, CHECK_HOLD_OFFSET, Double, 8, TRUE, "negative hold remaining");
+
+    return Failures;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t FrameCount = 600, Interval = 23, Failures = 0, Restores = 0;
+    GlobalHist_ARGS *pReferenceArgs;
+    GlobalHist_ARGS Args;
+    GlobalHist_CONTEXT *pReference, *pSaving;
+    uint8_t Snapshot[GlobalHist_SNAPSHOT_SIZE];
+    int Option;
+
+    while (-1 != (Option = getopt(argc, argv, "n:i:")))
+    {
+        switch (Option)
+        {
+        case 'n': FrameCount = (uint32_t)atoi(optarg); break;
+        case 'i': Interval   = (uint32_t)atoi(optarg); break;
+        default:  FrameCount = 0;                      break;
+        }
+    }
+
+    if ((0 == FrameCount) || (0 == Interval))
+    {
+        fprintf(stderr, "usage: %s [-n frames] [-i save interval]\n", argv[0]);
+        return 1;
+    }
+
+    pReferenceArgs = (GlobalHist_ARGS *)malloc((size_t)FrameCount * sizeof(GlobalHist_ARGS));
+    pReference     = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+    pSaving        = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+
+    if ((NULL == pReferenceArgs) || (NULL == pReference) || (NULL == pSaving))
+    {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
+
+    if (0 != DisplayGheSaveSnapshot(pReference, Snapshot, sizeof(Snapshot) - 1))
+    {
+        printf("saved              into a short buffer\n");
+        Failures++;
+    }
+
+    // The uninterrupted run every restored context must follow
+    for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+    {
+        GenerateFrame(&pReferenceArgs[Frame], Frame);
+        DisplayGheProcessFrame(pReference, &pReferenceArgs[Frame]);
+    }
+
+    for (uint32_t Frame = 0; Frame + 1 < FrameCount; Frame++)
+    {
+        GenerateFrame(&Args, Frame);
+        DisplayGheProcessFrame(pSaving, &Args);
+
+        if (0 != (Frame + 1) % Interval)
+        {
+            continue;
+        }
+
+        // Warm start after the frame, then the rest of the clip on the restored context
+        GlobalHist_CONTEXT *pRestored = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+
+        if ((NULL == pRestored) || (GlobalHist_SNAPSHOT_SIZE != DisplayGheSaveSnapshot(pSaving, Snapshot, sizeof(Snapshot))))
+        {
+            fprintf(stderr, "%s: out of memory\n", argv[0]);
+            return 1;
+        }
+
+        // Rejected into a context that already ran, so a partial restore would show
+        if (0 == Restores)
+        {
+            Failures += CheckRejections(pSaving, Snapshot);
+        }
+
+        if (!DisplayGheRestoreSnapshot(pRestored, Snapshot, sizeof(Snapshot)))
+        {
+            printf("rejected           the snapshot after frame %u\n", Frame);
+            Failures++;
+        }
+
+        for (uint32_t Later = Frame + 1; Later < FrameCount; Later++)
+        {
+            GenerateFrame(&Args, Later);
+            DisplayGheProcessFrame(pRestored, &Args);
+
+            if (IsLutMismatch(Args.DietFactor, pReferenceArgs[Later].DietFactor) || (Args.IsProgramDiet != pReferenceArgs[Later].IsProgramDiet))
+            {
+                printf("diverged           on frame %u, restored after frame %u\n", Later, Frame);
+                Failures++;
+                break;
+            }
+        }
+
+        Restores++;
+        DisplayGheDestroyContext(pRestored);
+    }
+
+    printf("frames             %u, %u restores\n", FrameCount, Restores);
+    printf("failures           %u\n", Failures);
+
+    DisplayGheDestroyContext(pReference);
+    DisplayGheDestroyContext(pSaving);
+    free(pReferenceArgs);
+
+    return (0 == Failures) ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+/**
+ *
+ * @file  ghe_stripe_bench.c
+ * @brief  Stripe wise accumulation against summing the stripes at the end of the frame
+ *
+ * Frames arrive as per stripe histograms, brighter towards the top as a sky would be. One context
+ * takes them through GHE_Stripe.h, a reference context gets the stripes summed after the last one
+ * and DisplayGheProcessFrame, and the DietFactor of every frame must match bit for bit. Reports the
+ * work left after the last stripe on both paths, and how far the provisional DietFactor and the
+ * previous frame's DietFactor, what is shown without it, are from the final one.
+ *
+ * usage: ghe_stripe_bench [-n frames] [-s stripes] [-p provisional fraction]
+ *
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <unistd.h>
+
+#include "../GHE_Algorithm.h"
+#include "../GHE_Histogram.h"
+#include "../GHE_Stripe.h"
+#include "ghe_tool_common.h"
+
+#define BENCH_WIDTH      3840
+#define BENCH_HEIGHT     2160
+#define BENCH_MAX_STRIPES 256
+
+// Every stripe holds its rows' pixels. A dark peak moves with every scene cut, 120 frames apart,
+// and fades brighter in between. Bright sky bins weigh most in the top stripe, none at the bottom.
+static void GenerateStripes(uint32_t Frame, uint32_t StripeCount, uint32_t (*pStripe)[GlobalHist_BIN_COUNT])
+{
+    uint32_t Scene = Frame / 120;
+
+    for (uint32_t Stripe = 0; Stripe < StripeCount; Stripe++)
+    {
+        uint32_t Rows = GlobalHist_TILE_START(Stripe + 1, StripeCount, BENCH_HEIGHT) - GlobalHist_TILE_START(Stripe, StripeCount, BENCH_HEIGHT);
+        uint32_t Pixels = Rows * BENCH_WIDTH;
+        uint32_t Weight[GlobalHist_BIN_COUNT], WeightSum = 0, Assigned = 0;
+
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            int32_t Peak = (int32_t)(4 + (Scene * 7) % 12 + (Frame % 120) / 12);
+            int32_t Distance = (int32_t)BinIndex - Peak;
+            uint32_t Sky = (BinIndex > 24) ? 512 * (StripeCount - Stripe) / StripeCount : 0;
+
+            Weight[BinIndex] = 16 + 16384 / (uint32_t)(4 + Distance * Distance) + Sky + NextRandom() % 16;
+            WeightSum += Weight[BinIndex];
+        }
+
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            pStripe[Stripe][BinIndex] = (uint32_t)((uint64_t)Pixels * Weight[BinIndex] / WeightSum);
+            Assigned += pStripe[Stripe][BinIndex];
+        }
+
+        pStripe[Stripe][NextRandom() % GlobalHist_BIN_COUNT] += Pixels - Assigned;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static uint32_t Stripe[BENCH_MAX_STRIPES][GlobalHist_BIN_COUNT];
+    uint32_t FrameCount = 5000, StripeCount = 16;
+    double ProvisionalFraction = 0.5;
+    GlobalHist_CONTEXT *pContext = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+    GlobalHist_CONTEXT *pReference = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+    GlobalHist_STRIPE_CONTEXT *pStripe;
+    uint32_t PrevDietFactor[GlobalHist_IET_LUT_LENGTH];
+    uint32_t MaxProvisional = 0, MaxPrevious = 0, ProvisionalFrames = 0;
+    uint64_t StripeNs = 0, ReferenceNs = 0, SumProvisional = 0, SumPrevious = 0, Mismatches = 0;
+    int Option;
+
+    while (-1 != (Option = getopt(argc, argv, "n:s:p:")))
+    {
+        switch (Option)
+        {
+        case 'n': FrameCount          = (uint32_t)atoi(optarg);   break;
+        case 's': StripeCount         = (uint32_t)atoi(optarg);   break;
+        case 'p': ProvisionalFraction = atof(optarg);             break;
+        default:  FrameCount          = 0;                        break;
+        }
+    }
+
+    pStripe = DisplayGheCreateStripeContext(pContext, ProvisionalFraction);
+
+    if ((0 == FrameCount) || (0 == StripeCount) || (StripeCount > BENCH_MAX_STRIPES) || (NULL == pStripe))
+    {
+        fprintf(stderr, "usage: %s [-n frames] [-s stripes, at most %u] [-p provisional fraction, 0 for none]\n", argv[0], BENCH_MAX_STRIPES);
+        return 1;
+    }
+
+    for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        PrevDietFactor[IetIndex] = GlobalHist_IET_SCALE_FACTOR;
+    }
+
+    for (uint32_t Frame = 0; Frame < FrameCount; Frame++)
+    {
+        GlobalHist_ARGS Args, Result, Reference;
+        const uint32_t *pProvisional;
+        uint64_t Start;
+
+        memset(&Args, 0, sizeof(Args));
+        Args.PipeId       = GlobalHist_PIPE_ANY;
+        Args.Resolution_X = BENCH_WIDTH;
+        Args.Resolution_Y = BENCH_HEIGHT;
+        Args.TimestampNs  = (uint64_t)(Frame + 1) * 16666667ull;
+
+        GenerateStripes(Frame, StripeCount, Stripe);
+
+        // Every stripe but the last arrives while the frame scans out
+        DisplayGheStripeBegin(pStripe, &Args);
+
+        for (uint32_t Index = 0; Index + 1 < StripeCount; Index++)
+        {
+            DisplayGheStripeAdd(pStripe, Stripe[Index]);
+        }
+
+        Start = GetTimeNs();
+        DisplayGheStripeAdd(pStripe, Stripe[StripeCount - 1]);
+        pProvisional = DisplayGheStripeGetProvisional(pStripe);
+        DisplayGheStripeFinish(pStripe, &Result);
+        StripeNs += GetTimeNs() - Start;
+
+        // The reference waits for the whole frame
+        Reference = Args;
+        Start = GetTimeNs();
+        for (uint32_t Index = 0; Index < StripeCount; Index++)
+        {
+            for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+            {
+                Reference.Histogram[BinIndex] += Stripe[Index][BinIndex];
+            }
+        }
+        DisplayGheProcessFrame(pReference, &Reference);
+        ReferenceNs += GetTimeNs() - Start;
+
+        Mismatches += IsLutMismatch(Result.DietFactor, Reference.DietFactor) ||
+                      (0 != memcmp(Result.Histogram, Reference.Histogram, sizeof(Result.Histogram)));
+
+        if (NULL != pProvisional)
+        {
+            MaxProvisional = DD_MAX(MaxProvisional, MaxLutDeviation(pProvisional, Result.DietFactor, &SumProvisional));
+            MaxPrevious    = DD_MAX(MaxPrevious, MaxLutDeviation(PrevDietFactor, Result.DietFactor, &SumPrevious));
+            ProvisionalFrames++;
+        }
+
+        memcpy(PrevDietFactor, Result.DietFactor, sizeof(PrevDietFactor));
+    }
+
+    printf("frames             %u, %ux%u in %u stripes\n", FrameCount, BENCH_WIDTH, BENCH_HEIGHT, StripeCount);
+    printf("after last stripe  %.0f ns, summing at frame end %.0f ns\n", (double)StripeNs / FrameCount, (double)ReferenceNs / FrameCount);
+
+    if (0 != ProvisionalFrames)
+    {
+        printf("provisional at %.0f%%  max %u, mean %.2f LSB from the final DietFactor\n", ProvisionalFraction * 100, MaxProvisional,
+               (double)SumProvisional / ((double)ProvisionalFrames * GlobalHist_IET_LUT_LENGTH));
+        printf("previous frame     max %u, mean %.2f LSB from the final DietFactor\n", MaxPrevious,
+               (double)SumPrevious / ((double)ProvisionalFrames * GlobalHist_IET_LUT_LENGTH));
+    }
+
+    printf("mismatched LUTs    %llu\n", (unsigned long long)Mismatches);
+
+    DisplayGheDestroyStripeContext(pStripe);
+    DisplayGheDestroyContext(pContext);
+    DisplayGheDestroyContext(pReference);
+
+    return (0 == Mismatches) ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+/**
+ *
+ * @file  ghe_tiled_bench.c
+ * @brief  Throughput of the tiled local histogram equalization of GHE_Tiled.h on 4K frames
+ *
+ * Synthetic 3840x2160 RGBA8888 frames with a moving bright window over a dark gradient, so tiles
+ * see different content and the temporal filters keep moving. Every frame runs the three stages
+ * a display pipeline would, tile histograms, per tile GHE and the bilinear apply, each timed on
+ * its own. Reports the sustained frame rate against the -r refresh rate and exits with 1 when it
+ * falls short.
+ *
+ * usage: ghe_tiled_bench [-x tiles] [-y tiles] [-t threads] [-n frames] [-r refresh Hz]
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <time.h>
+#include <unistd.h>
+
+#include "../GHE_Cpu.h"
+#include "../GHE_Tiled.h"
+#include "ghe_tool_common.h"
+
+#define BENCH_WIDTH  3840
+#define BENCH_HEIGHT 2160
+#define BENCH_SOURCE_FRAMES 8      // Distinct source frames, the benchmark cycles through them
+
+static void GenerateFrame(uint8_t *pPixels, uint32_t FrameIndex)
+{
+    uint32_t WindowX = (FrameIndex * 397) % (BENCH_WIDTH / 2);
+    uint32_t WindowY = (FrameIndex * 211) % (BENCH_HEIGHT / 2);
+
+    for (uint32_t Row = 0; Row < BENCH_HEIGHT; Row++)
+    {
+        uint8_t *pRow = pPixels + (size_t)Row * BENCH_WIDTH * 4;
+
+        for (uint32_t Column = 0; Column < BENCH_WIDTH; Column++)
+        {
+            bool IsWindow = (Column - WindowX < BENCH_WIDTH / 3) && (Row - WindowY < BENCH_HEIGHT / 3);
+            uint32_t Level = IsWindow ? 160 + (Column ^ Row) % 96 : (Column + Row) * 96 / (BENCH_WIDTH + BENCH_HEIGHT);
+
+            pRow[Column * 4]     = (uint8_t)Level;
+            pRow[Column * 4 + 1] = (uint8_t)(Level * 3 / 4);
+            pRow[Column * 4 + 2] = (uint8_t)(Level / 2);
+            pRow[Column * 4 + 3] = 0xFF;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t TilesX = 8, TilesY = 8, ThreadCount = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN), FrameCount = 240, Refresh = 120;
+    GlobalHist_TILED_CONTEXT *pTiled;
+    GlobalHist_THREAD_POOL *pPool;
+    uint8_t *pSource, *pOutput;
+    uint32_t (*pHistogram)[GlobalHist_BIN_COUNT];
+    double HistogramNs = 0, TilesNs = 0, ApplyNs = 0, TotalNs, FramesPerSecond;
+    int Option;
+
+    while (-1 != (Option = getopt(argc, argv, "x:y:t:n:r:")))
+    {
+        switch (Option)
+        {
+        case 'x': TilesX = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'y': TilesY = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 't': ThreadCount = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'n': FrameCount = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'r': Refresh = (uint32_t)strtoul(optarg, NULL, 0); break;
+        default:
+            fprintf(stderr, "usage: %s [-x tiles] [-y tiles] [-t threads] [-n frames] [-r refresh Hz]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    pTiled     = DisplayGheCreateTiled(TilesX, TilesY);
+    pPool      = DisplayGheCreateThreadPool((0 == ThreadCount) ? 1 : ThreadCount);
+    pSource    = (uint8_t *)malloc((size_t)BENCH_SOURCE_FRAMES * BENCH_WIDTH * BENCH_HEIGHT * 4);
+    pOutput    = (uint8_t *)malloc((size_t)BENCH_WIDTH * BENCH_HEIGHT * 4);
+    pHistogram = (uint32_t (*)[GlobalHist_BIN_COUNT])calloc((size_t)TilesX * TilesY, sizeof(*pHistogram));
+
+    if ((NULL == pTiled) || (NULL == pPool) || (NULL == pSource) || (NULL == pOutput) || (NULL == pHistogram) || (0 == FrameCount))
+    {
+        fprintf(stderr, "bad tile grid (1..%u per axis), thread count or frame count, or out of memory\n", GlobalHist_MAX_TILES);
+        return 2;
+    }
+
+    for (uint32_t FrameIndex = 0; FrameIndex < BENCH_SOURCE_FRAMES; FrameIndex++)
+    {
+        GenerateFrame(pSource + (size_t)FrameIndex * BENCH_WIDTH * BENCH_HEIGHT * 4, FrameIndex);
+    }
+
+    for (uint32_t FrameIndex = 0; FrameIndex < FrameCount; FrameIndex++)
+    {
+        GlobalHist_FRAME Frame;
+        double Start, Histograms, Tiles;
+
+        Frame.pData  = pSource + (size_t)(FrameIndex % BENCH_SOURCE_FRAMES) * BENCH_WIDTH * BENCH_HEIGHT * 4;
+        Frame.Width  = BENCH_WIDTH;
+        Frame.Height = BENCH_HEIGHT;
+        Frame.Stride = BENCH_WIDTH * 4;
+        Frame.Format = GlobalHist_PIXEL_FORMAT_RGBA8888;
+
+        Start = (double)GetTimeNs();
+        DisplayGheBuildTileHistograms(&Frame, TilesX, TilesY, pHistogram, pPool);
+        Histograms = (double)GetTimeNs();
+        DisplayGheTiledProcessHistograms(pTiled, (const uint32_t (*)[GlobalHist_BIN_COUNT])pHistogram, BENCH_WIDTH, BENCH_HEIGHT,
+                                         (uint64_t)FrameIndex * 1000000000ull / Refresh, pPool);
+        Tiles = (double)GetTimeNs();
+        DisplayGheTiledApplyDiet(pTiled, &Frame, pOutput, BENCH_WIDTH * 4, pPool);
+
+        HistogramNs += Histograms - Start;
+        TilesNs     += Tiles - Histograms;
+        ApplyNs     += (double)GetTimeNs() - Tiles;
+    }
+
+    TotalNs = HistogramNs + TilesNs + ApplyNs;
+    FramesPerSecond = 1e9 * FrameCount / TotalNs;
+
+    printf("frame              %ux%u RGBA8888, %ux%u tiles\n", BENCH_WIDTH, BENCH_HEIGHT, TilesX, TilesY);
+    printf("threads            %u\n", DisplayGheGetThreadCount(pPool));
+    printf("kernels            %s\n", DisplayGheGetIsaName(DisplayGheGetIsa()));
+    printf("tile histograms    %10.3f ms/frame\n", HistogramNs / FrameCount / 1e6);
+    printf("tile GHE           %10.3f ms/frame\n", TilesNs / FrameCount / 1e6);
+    printf("bilinear apply     %10.3f ms/frame\n", ApplyNs / FrameCount / 1e6);
+    printf("total              %10.3f ms/frame, %.1f frames/s against %u Hz\n", TotalNs / FrameCount / 1e6, FramesPerSecond, Refresh);
+
+    DisplayGheDestroyTiled(pTiled);
+    DisplayGheDestroyThreadPool(pPool);
+    free(pSource);
+    free(pOutput);
+    free(pHistogram);
+
+    return (FramesPerSecond >= Refresh) ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+/**
+ *
+ * @file  ghe_tool_common.h
+ * @brief  Scaffolding shared by the benchmark and check tools
+ *
+ * A seeded xorshift generator, so every tool and every run sees the same synthetic input, the
+ * monotonic clock and the LUT comparisons behind the mismatch counts. Header only, every tool
+ * still builds from its one source file.
+ *
+ */
+
+#ifndef _GHE_TOOL_COMMON_H_
+#define _GHE_TOOL_COMMON_H_
+
+#include <time.h>
+
+#include "../GHE_Algorithm.h"
+
+#define GHE_TOOL_RANDOM_SEED 0x9E3779B97F4A7C15ull
+
+static uint64_t RandomState = GHE_TOOL_RANDOM_SEED;
+
+static inline uint32_t NextRandom(void)
+{
+    RandomState ^= RandomState << 13;
+    RandomState ^= RandomState >> 7;
+    RandomState ^= RandomState << 17;
+    return (uint32_t)RandomState;
+}
+
+static inline uint64_t GetTimeNs(void)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return (uint64_t)Now.tv_sec * 1000000000ull + (uint64_t)Now.tv_nsec;
+}
+
+static inline double NowInSeconds(void)
+{
+    return (double)GetTimeNs() * 1e-9;
+}
+
+// 1 when the two LUTs differ in any entry, summed into the mismatch counts
+static inline uint32_t IsLutMismatch(const uint32_t *pLut1, const uint32_t *pLut2)
+{
+    return (0 != memcmp(pLut1, pLut2, GlobalHist_IET_LUT_LENGTH * sizeof(uint32_t)));
+}
+
+// Largest entry deviation between the two LUTs, every deviation is added to *pSum unless NULL
+static inline uint32_t MaxLutDeviation(const uint32_t *pLut1, const uint32_t *pLut2, uint64_t *pSum)
+{
+    uint32_t Max = 0;
+
+    for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+    {
+        uint32_t Deviation = DD_DIFF(pLut1[IetIndex], pLut2[IetIndex]);
+
+        Max = DD_MAX(Max, Deviation);
+
+        if (NULL != pSum)
+        {
+            *pSum += Deviation;
+        }
+    }
+
+    return Max;
+}
+
+#endif
@@ -0,0 +1,748 @@
+/**
+ *
+ * @file  ghe_tune.c
+ * @brief  Parallel GlobalHist_CFG sweep over recorded histogram sequences
+ *
+ * Every combination of the swept parameters runs over every sequence, one recorded pipe of a
+ * GHE_Trace.h trace or, without traces, synthetic scene cuts and fades. A combination is scored on
+ *
+ *   flicker      mean DietFactor change from one frame to the next, in percent
+ *   convergence  mean seconds from a target change of more than TUNE_TARGET_CHANGE until the
+ *                applied LUT is within TUNE_CONVERGED_DELTA of the target
+ *   strength     mean DietFactor boost over identity, in percent
+ *
+ * Each metric is divided by its mean over all combinations, so the weights of -w are unitless;
+ * score = flicker + convergence - strength with the default weights, lower is better.
+ *
+ * One job is one combination over one sequence. Workers start with an equal share of the jobs
+ * and steal half of the largest remaining share when they run dry, so long sequences do not
+ * leave cores idle at the end of a sweep.
+ *
+ * usage: ghe_tune [-t threads] [-p name=first:last:steps] [-w flicker,convergence,strength]
+ *                 [-n top] [-o results.csv] [-s seconds] [trace ...]
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <unistd.h>
+
+#include "../GHE_Algorithm.h"
+#include "../GHE_ThreadPool.h"
+#include "../GHE_Trace.h"
+#include "ghe_tool_common.h"
+
+#define TUNE_MAX_PARAMETERS    7
+#define TUNE_MAX_STEPS         1024
+#define TUNE_TARGET_CHANGE     64     // Max LutTarget entry change that starts a convergence measurement, a scene change
+#define TUNE_CONVERGED_DELTA   5      // Max LutApplied to LutTarget distance that ends it, about 1 percent
+#define TUNE_SYNTHETIC_STREAMS 8
+#define TUNE_SYNTHETIC_FPS     60
+#define TUNE_DEFAULT_PERIOD_NS 16666667ull // Frame spacing assumed for frames without a timestamp
+#define TUNE_CACHE_LINE        64
+
+typedef struct _TUNE_PARAMETER
+{
+    const char *pName;
+    size_t Offset;         // In GlobalHist_CFG
+} TUNE_PARAMETER;
+
+static const TUNE_PARAMETER Parameters[TUNE_MAX_PARAMETERS] =
+{
+    { "MinimumStepPercent", offsetof(GlobalHist_CFG, MinimumStepPercent) },
+    { "MinIIRCutOffFreq",   offsetof(GlobalHist_CFG, MinIIRCutOffFreq) },
+    { "MaxIIRCutOffFreq",   offsetof(GlobalHist_CFG, MaxIIRCutOffFreq) },
+    { "MinPhaseInDuration", offsetof(GlobalHist_CFG, MinPhaseInDuration) },
+    { "MaxPhaseInDuration", offsetof(GlobalHist_CFG, MaxPhaseInDuration) },
+    { "MinSlope",           offsetof(GlobalHist_CFG, MinSlope) },
+    { "MaxSlope",           offsetof(GlobalHist_CFG, MaxSlope) },
+};
+
+typedef struct _TUNE_SWEEP
+{
+    double First[TUNE_MAX_PARAMETERS];
+    double Last[TUNE_MAX_PARAMETERS];
+    uint32_t Steps[TUNE_MAX_PARAMETERS];  // 0 keeps the default value
+} TUNE_SWEEP;
+
+typedef struct _TUNE_FRAME
+{
+    uint64_t TimestampNs;                     // GlobalHist_ARGS.TimestampNs, 0 when not recorded
+    uint32_t Histogram[GlobalHist_BIN_COUNT];
+} TUNE_FRAME;
+
+typedef struct _TUNE_SEQUENCE
+{
+    TUNE_FRAME *pFrame;
+    uint32_t FrameCount;
+    uint32_t Capacity;
+} TUNE_SEQUENCE;
+
+// Accumulated over one sequence, summed over sequences afterwards
+typedef struct _TUNE_RESULT
+{
+    double FlickerSum;
+    double StrengthSum;
+    double ConvergenceSeconds;
+    uint64_t Frames;
+    uint64_t ConvergenceEvents;
+} TUNE_RESULT;
+
+typedef struct _TUNE_SCORE
+{
+    uint32_t Combination;
+    double Flicker;
+    double Convergence;
+    double Strength;
+    double Score;
+} TUNE_SCORE;
+
+// Jobs [Begin, End) of one worker, Begin in the low half. The owner takes from the front and
+// thieves from the back, both with one compare and swap on the whole range.
+typedef struct _TUNE_QUEUE
+{
+    _Alignas(TUNE_CACHE_LINE) atomic_ullong Range;
+    uint64_t Steals;
+} TUNE_QUEUE;
+
+typedef struct _TUNE_STATE
+{
+    const TUNE_SEQUENCE *pSequence;
+    uint32_t SequenceCount;
+    GlobalHist_CFG *pCombination;
+    bool *pIsValid;
+    uint32_t CombinationCount;
+    TUNE_RESULT *pResult;          // [Combination][Sequence]
+    TUNE_QUEUE *pQueue;
+    uint8_t *pContextMemory;       // One context per worker
+    size_t ContextStride;
+    uint32_t WorkerCount;
+} TUNE_STATE;
+
+static uint64_t PackRange(uint32_t Begin, uint32_t End)
+{
+    return (uint64_t)Begin | ((uint64_t)End << 32);
+}
+
+static bool AppendFrame(TUNE_SEQUENCE *pSequence, uint64_t TimestampNs, const uint32_t *pHistogram)
+{
+    if (pSequence->FrameCount == pSequence->Capacity)
+    {
+        uint32_t Capacity = (0 == pSequence->Capacity) ? 4096 : pSequence->Capacity * 2;
+        TUNE_FRAME *pFrame = (TUNE_FRAME *)realloc(pSequence->pFrame, (size_t)Capacity * sizeof(TUNE_FRAME));
+
+        if (NULL == pFrame)
+        {
+            return FALSE;
+        }
+
+        pSequence->pFrame   = pFrame;
+        pSequence->Capacity = Capacity;
+    }
+
+    pSequence->pFrame[pSequence->FrameCount].TimestampNs = TimestampNs;
+    memcpy(pSequence->pFrame[pSequence->FrameCount].Histogram, pHistogram, sizeof(pSequence->pFrame[0].Histogram));
+    pSequence->FrameCount++;
+
+    return TRUE;
+}
+
+// Every recorded pipe of the trace becomes one sequence
+static bool LoadTrace(const char *pPath, TUNE_SEQUENCE **ppSequence, uint32_t *pSequenceCount)
+{
+    TUNE_SEQUENCE Pipe[GlobalHist_TRACE_PIPE_SLOTS];
+    GlobalHist_TRACE_READER *pReader = DisplayGheTraceOpenReader(pPath);
+    GlobalHist_TRACE_FRAME Frame;
+    bool IsOk = TRUE;
+
+    if (NULL == pReader)
+    {
+        fprintf(stderr, "cannot read trace %s\n", pPath);
+        return FALSE;
+    }
+
+    memset(Pipe, 0, sizeof(Pipe));
+
+    while (IsOk && DisplayGheTraceNextFrame(pReader, &Frame))
+    {
+        uint32_t Slot = ((uint32_t)Frame.Args.PipeId < GlobalHist_MAX_PIPES) ? (uint32_t)Frame.Args.PipeId : GlobalHist_MAX_PIPES;
+
+        IsOk = AppendFrame(&Pipe[Slot], Frame.Args.TimestampNs, Frame.Args.Histogram);
+    }
+
+    DisplayGheTraceCloseReader(pReader);
+
+    for (uint32_t Slot = 0; Slot < GlobalHist_TRACE_PIPE_SLOTS; Slot++)
+    {
+        TUNE_SEQUENCE *pSequence;
+
+        if (0 == Pipe[Slot].FrameCount)
+        {
+            continue;
+        }
+
+        pSequence = (TUNE_SEQUENCE *)realloc(*ppSequence, (*pSequenceCount + 1) * sizeof(TUNE_SEQUENCE));
+
+        if ((FALSE == IsOk) || (NULL == pSequence))
+        {
+            free(Pipe[Slot].pFrame);
+            IsOk = FALSE;
+            continue;
+        }
+
+        pSequence[(*pSequenceCount)++] = Pipe[Slot];
+        *ppSequence = pSequence;
+    }
+
+    return IsOk;
+}
+
+// Scenes of one to six seconds, cut or faded into each other, with sensor noise on every frame
+static bool GenerateSequence(TUNE_SEQUENCE *pSequence, uint32_t Seconds)
+{
+    uint32_t Scene[GlobalHist_BIN_COUNT], NextScene[GlobalHist_BIN_COUNT];
+    uint32_t FrameCount = Seconds * TUNE_SYNTHETIC_FPS;
+    uint32_t Frame = 0;
+
+    memset(pSequence, 0, sizeof(*pSequence));
+
+    for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+    {
+        NextScene[BinIndex] = NextRandom() % 60000;
+    }
+
+    while (Frame < FrameCount)
+    {
+        uint32_t SceneFrames = TUNE_SYNTHETIC_FPS + NextRandom() % (5 * TUNE_SYNTHETIC_FPS);
+        uint32_t FadeFrames = (0 == NextRandom() % 3) ? TUNE_SYNTHETIC_FPS / 2 : 0;
+        uint32_t Center = NextRandom() % GlobalHist_BIN_COUNT, Width = 2 + NextRandom() % 12;
+
+        memcpy(Scene, NextScene, sizeof(Scene));
+
+        for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+        {
+            NextScene[BinIndex] = 200 + ((DD_DIFF(BinIndex, Center) < Width) ? 20000 + NextRandom() % 40000 : NextRandom() % 3000);
+        }
+
+        for (uint32_t SceneFrame = 0; (SceneFrame < SceneFrames) && (Frame < FrameCount); SceneFrame++, Frame++)
+        {
+            uint32_t Histogram[GlobalHist_BIN_COUNT];
+            uint32_t Fade = (SceneFrame + FadeFrames >= SceneFrames) ? SceneFrame + FadeFrames + 1 - SceneFrames : 0;
+
+            for (uint32_t BinIndex = 0; BinIndex < GlobalHist_BIN_COUNT; BinIndex++)
+            {
+                uint64_t Mixed = ((uint64_t)Scene[BinIndex] * (FadeFrames + 1 - Fade) + (uint64_t)NextScene[BinIndex] * Fade) / (FadeFrames + 1);
+
+                Histogram[BinIndex] = (uint32_t)Mixed + NextRandom() % 64;
+            }
+
+            if (FALSE == AppendFrame(pSequence, 1 + (uint64_t)Frame * (1000000000ull / TUNE_SYNTHETIC_FPS), Histogram))
+            {
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+static void RunJob(TUNE_STATE *pState, uint32_t Worker, uint32_t Job)
+{
+    uint32_t Combination = Job / pState->SequenceCount, SequenceIndex = Job % pState->SequenceCount;
+    const TUNE_SEQUENCE *pSequence = &pState->pSequence[SequenceIndex];
+    TUNE_RESULT *pResult = &pState->pResult[Job];
+    GlobalHist_CONTEXT *pContext;
+    uint32_t PrevDiet[GlobalHist_IET_LUT_LENGTH], PrevTarget[GlobalHist_IET_LUT_LENGTH];
+    uint64_t PrevTimestampNs = 0;
+    bool IsConverging = FALSE;
+    double ConvergingSeconds = 0;
+
+    memset(pResult, 0, sizeof(*pResult));
+
+    if (FALSE == pState->pIsValid[Combination])
+    {
+        return;
+    }
+
+    pContext = DisplayGheCreateContextInPlace(GlobalHist_PIPE_ANY, pState->pContextMemory + (size_t)Worker * pState->ContextStride,
+                                              pState->ContextStride);
+    DisplayGheSetConfig(pContext, &pState->pCombination[Combination]);
+    memcpy(PrevTarget, pContext->ImageEnhancement.LutTarget, sizeof(PrevTarget));
+
+    for (uint32_t Frame = 0; Frame < pSequence->FrameCount; Frame++)
+    {
+        const TUNE_FRAME *pFrame = &pSequence->pFrame[Frame];
+        const uint32_t *pTarget = pContext->ImageEnhancement.LutTarget;
+        GlobalHist_ARGS Args;
+        uint64_t PeriodNs = ((0 != pFrame->TimestampNs) && (0 != PrevTimestampNs) && (pFrame->TimestampNs > PrevTimestampNs)) ?
+                            pFrame->TimestampNs - PrevTimestampNs : TUNE_DEFAULT_PERIOD_NS;
+        double Flicker = 0, Strength = 0;
+
+        memset(&Args, 0, sizeof(Args));
+        Args.PipeId      = GlobalHist_PIPE_ANY;
+        Args.TimestampNs = pFrame->TimestampNs;
+        memcpy(Args.Histogram, pFrame->Histogram, sizeof(Args.Histogram));
+        DisplayGheProcessFrame(pContext, &Args);
+
+        for (uint32_t IetIndex = 0; IetIndex < GlobalHist_IET_LUT_LENGTH; IetIndex++)
+        {
+            Flicker  += (0 == Frame) ? 0 : (double)DD_DIFF(Args.DietFactor[IetIndex], PrevDiet[IetIndex]);
+            Strength += (double)Args.DietFactor[IetIndex] - GlobalHist_IET_SCALE_FACTOR;
+        }
+
+        // A new target restarts the measurement, time still converging at the end counts too
+        ConvergingSeconds += IsConverging ? (double)PeriodNs * 1e-9 : 0;
+
+        if (MaxLutDeviation(pTarget, PrevTarget, NULL) > TUNE_TARGET_CHANGE)
+        {
+            pResult->ConvergenceSeconds += IsConverging ? ConvergingSeconds : 0;
+            pResult->ConvergenceEvents++;
+            ConvergingSeconds = 0;
+            IsConverging = TRUE;
+        }
+
+        if (IsConverging && (MaxLutDeviation(Args.DietFactor, pTarget, NULL) <= TUNE_CONVERGED_DELTA))
+        {
+            pResult->ConvergenceSeconds += ConvergingSeconds;
+            IsConverging = FALSE;
+        }
+
+        pResult->FlickerSum  += Flicker * (100.0 / GlobalHist_IET_SCALE_FACTOR / GlobalHist_IET_LUT_LENGTH);
+        pResult->StrengthSum += Strength * (100.0 / GlobalHist_IET_SCALE_FACTOR / GlobalHist_IET_LUT_LENGTH);
+        pResult->Frames++;
+
+        memcpy(PrevDiet, Args.DietFactor, sizeof(PrevDiet));
+        memcpy(PrevTarget, pTarget, sizeof(PrevTarget));
+        PrevTimestampNs = pFrame->TimestampNs;
+    }
+
+    pResult->ConvergenceSeconds += IsConverging ? ConvergingSeconds : 0;
+
+    DisplayGheDestroyContext(pContext);
+}
+
+static bool PopJob(TUNE_QUEUE *pQueue, uint32_t *pJob)
+{
+    uint64_t Range = atomic_load(&pQueue->Range);
+
+    for (;;)
+    {
+        uint32_t Begin = (uint32_t)Range, End = (uint32_t)(Range >> 32);
+
+        if (Begin >= End)
+        {
+            return FALSE;
+        }
+
+        if (atomic_compare_exchange_weak(&pQueue->Range, &Range, PackRange(Begin + 1, End)))
+        {
+            *pJob = Begin;
+            return TRUE;
+        }
+    }
+}
+
+// Moves the back half of the fullest other queue into the empty queue of Thief
+static bool StealJobs(TUNE_STATE *pState, uint32_t Thief)
+{
+    for (;;)
+    {
+        uint32_t Victim = Thief, MostJobs = 0;
+        uint64_t Range;
+
+        for (uint32_t Worker = 0; Worker < pState->WorkerCount; Worker++)
+        {
+            uint64_t Candidate = atomic_load(&pState->pQueue[Worker].Range);
+            uint32_t Jobs = (uint32_t)(Candidate >> 32) - DD_MIN((uint32_t)Candidate, (uint32_t)(Candidate >> 32));
+
+            if ((Worker != Thief) && (Jobs > MostJobs))
+            {
+                Victim   = Worker;
+                MostJobs = Jobs;
+            }
+        }
+
+        if (0 == MostJobs)
+        {
+            return FALSE;
+        }
+
+        Range = atomic_load(&pState->pQueue[Victim].Range);
+
+        {
+            uint32_t Begin = (uint32_t)Range, End = (uint32_t)(Range >> 32);
+            uint32_t Half = (End > Begin) ? (End - Begin + 1) / 2 : 0;
+
+            // Only the owner ever grows its queue, so a plain store is enough for the thief's own
+            if ((0 != Half) && atomic_compare_exchange_strong(&pState->pQueue[Victim].Range, &Range, PackRange(Begin, End - Half)))
+            {
+                atomic_store(&pState->pQueue[Thief].Range, PackRange(End - Half, End));
+                pState->pQueue[Thief].Steals++;
+                return TRUE;
+            }
+        }
+    }
+}
+
+static void WorkerTask(void *pTaskContext, uint32_t Worker)
+{
+    TUNE_STATE *pState = (TUNE_STATE *)pTaskContext;
+    uint32_t Job;
+
+    do
+    {
+        while (PopJob(&pState->pQueue[Worker], &Job))
+        {
+            RunJob(pState, Worker, Job);
+        }
+    } while (StealJobs(pState, Worker));
+}
+
+static bool ParseSweep(const char *pSpec, TUNE_SWEEP *pSweep)
+{
+    const char *pEquals = strchr(pSpec, '=');
+    char *pEnd;
+
+    for (uint32_t Index = 0; (NULL != pEquals) && (Index < TUNE_MAX_PARAMETERS); Index++)
+    {
+        if ((strlen(Parameters[Index].pName) != (size_t)(pEquals - pSpec)) || (0 != strncmp(pSpec, Parameters[Index].pName, pEquals - pSpec)))
+        {
+            continue;
+        }
+
+        pSweep->First[Index] = strtod(pEquals + 1, &pEnd);
+        pSweep->Last[Index]  = pSweep->First[Index];
+        pSweep->Steps[Index] = 1;
+
+        if (':' == *pEnd)
+        {
+            pSweep->Last[Index]  = strtod(pEnd + 1, &pEnd);
+            pSweep->Steps[Index] = (':' == *pEnd) ? (uint32_t)strtoul(pEnd + 1, &pEnd, 0) : 2;
+        }
+
+        return ('\0' == *pEnd) && (0 != pSweep->Steps[Index]) && (pSweep->Steps[Index] <= TUNE_MAX_STEPS);
+    }
+
+    return FALSE;
+}
+
+static void DefaultSweep(TUNE_SWEEP *pSweep)
+{
+    static const struct { uint32_t Index; double First, Last; uint32_t Steps; } Default[] =
+    {
+        { 1, 0.2, 1.0, 5 },    // MinIIRCutOffFreq
+        { 2, 0.5, 4.0, 6 },    // MaxIIRCutOffFreq
+        { 3, 0.0, 1000.0, 3 }, // MinPhaseInDuration
+        { 6, 2.0, 7.0, 6 },    // MaxSlope
+    };
+
+    for (uint32_t Count = 0; Count < sizeof(Default) / sizeof(Default[0]); Count++)
+    {
+        pSweep->First[Default[Count].Index] = Default[Count].First;
+        pSweep->Last[Default[Count].Index]  = Default[Count].Last;
+        pSweep->Steps[Default[Count].Index] = Default[Count].Steps;
+    }
+}
+
+// Cartesian product of the sweep, the last parameter varies fastest
+static GlobalHist_CFG *BuildCombinations(const TUNE_SWEEP *pSweep, uint32_t *pCount)
+{
+    GlobalHist_CFG Default, *pCombination;
+    uint64_t Count = 1;
+
+    DisplayGheGetDefaultConfig(&Default);
+
+    for (uint32_t Index = 0; Index < TUNE_MAX_PARAMETERS; Index++)
+    {
+        Count *= DD_MAX(pSweep->Steps[Index], 1);
+    }
+
+    if ((Count > UINT32_MAX / 64) || (NULL == (pCombination = (GlobalHist_CFG *)malloc(Count * sizeof(GlobalHist_CFG)))))
+    {
+        return NULL;
+    }
+
+    for (uint64_t Combination = 0; Combination < Count; Combination++)
+    {
+        uint64_t Rest = Combination;
+
+        pCombination[Combination] = Default;
+
+        for (int32_t Index = TUNE_MAX_PARAMETERS - 1; Index >= 0; Index--)
+        {
+            uint32_t Steps = pSweep->Steps[Index], Step;
+
+            if (0 == Steps)
+            {
+                continue;
+            }
+
+            Step = (uint32_t)(Rest % Steps);
+            Rest /= Steps;
+
+            *(double *)((uint8_t *)&pCombination[Combination] + Parameters[Index].Offset) =
+                (1 == Steps) ? pSweep->First[Index] : pSweep->First[Index] + (pSweep->Last[Index] - pSweep->First[Index]) * Step / (Steps - 1);
+        }
+    }
+
+    *pCount = (uint32_t)Count;
+    return pCombination;
+}
+
+static int CompareScore(const void *p1, const void *p2)
+{
+    const TUNE_SCORE *pScore1 = (const TUNE_SCORE *)p1, *pScore2 = (const TUNE_SCORE *)p2;
+
+    return (pScore1->Score > pScore2->Score) - (pScore1->Score < pScore2->Score);
+}
+
+static void PrintParameters(FILE *pFile, const GlobalHist_CFG *pCfg, const char *pSeparator)
+{
+    for (uint32_t Index = 0; Index < TUNE_MAX_PARAMETERS; Index++)
+    {
+        fprintf(pFile, "%s%g", (0 == Index) ? "" : pSeparator, *(const double *)((const uint8_t *)pCfg + Parameters[Index].Offset));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t ThreadCount = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN), TopCount = 10, SyntheticSeconds = 600;
+    uint32_t SequenceCount = 0, CombinationCount = 0, JobCount, ValidCount = 0;
+    double Weight[3] = { 1, 1, 1 }, Mean[3] = { 0, 0, 0 }, Start, Elapsed;
+    const char *pOutputPath = NULL;
+    TUNE_SEQUENCE *pSequence = NULL;
+    TUNE_SCORE *pScore;
+    TUNE_SWEEP Sweep;
+    TUNE_STATE State;
+    GlobalHist_THREAD_POOL *pPool;
+    uint64_t FrameCount = 0, Steals = 0;
+    bool IsSwept = FALSE;
+    int Option;
+
+    memset(&Sweep, 0, sizeof(Sweep));
+
+    while (-1 != (Option = getopt(argc, argv, "t:p:w:n:o:s:")))
+    {
+        switch (Option)
+        {
+        case 't': ThreadCount = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'n': TopCount = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'o': pOutputPath = optarg; break;
+        case 's': SyntheticSeconds = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'w':
+            if (3 != sscanf(optarg, "%lf,%lf,%lf", &Weight[0], &Weight[1], &Weight[2]))
+            {
+                fprintf(stderr, "bad weights %s, expected flicker,convergence,strength\n", optarg);
+                return 2;
+            }
+            break;
+        case 'p':
+            if (FALSE == ParseSweep(optarg, &Sweep))
+            {
+                fprintf(stderr, "bad sweep %s, expected name=first[:last[:steps]] with name one of\n", optarg);
+
+                for (uint32_t Index = 0; Index < TUNE_MAX_PARAMETERS; Index++)
+                {
+                    fprintf(stderr, "    %s\n", Parameters[Index].pName);
+                }
+                return 2;
+            }
+            IsSwept = TRUE;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-t threads] [-p name=first:last:steps] [-w flicker,convergence,strength] [-n top] [-o results.csv] "
+                    "[-s seconds] [trace ...]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (FALSE == IsSwept)
+    {
+        DefaultSweep(&Sweep);
+    }
+
+    for (int Arg = optind; Arg < argc; Arg++)
+    {
+        if (FALSE == LoadTrace(argv[Arg], &pSequence, &SequenceCount))
+        {
+            return 1;
+        }
+    }
+
+    if (optind == argc)
+    {
+        pSequence = (TUNE_SEQUENCE *)calloc(TUNE_SYNTHETIC_STREAMS, sizeof(TUNE_SEQUENCE));
+
+        for (SequenceCount = 0; (NULL != pSequence) && (SequenceCount < TUNE_SYNTHETIC_STREAMS); SequenceCount++)
+        {
+            if (FALSE == GenerateSequence(&pSequence[SequenceCount], DD_MAX(SyntheticSeconds / TUNE_SYNTHETIC_STREAMS, 1)))
+            {
+                fprintf(stderr, "out of memory\n");
+                return 1;
+            }
+        }
+    }
+
+    for (uint32_t Index = 0; Index < SequenceCount; Index++)
+    {
+        FrameCount += pSequence[Index].FrameCount;
+    }
+
+    memset(&State, 0, sizeof(State));
+    State.pSequence     = pSequence;
+    State.SequenceCount = SequenceCount;
+    State.pCombination  = BuildCombinations(&Sweep, &CombinationCount);
+    pPool               = DisplayGheCreateThreadPool(ThreadCount);
+
+    if ((0 == SequenceCount) || (NULL == State.pCombination) || (NULL == pPool) ||
+        ((uint64_t)CombinationCount * SequenceCount > UINT32_MAX))
+    {
+        fprintf(stderr, "no sequences, sweep too large or out of memory\n");
+        return 1;
+    }
+
+    JobCount = CombinationCount * SequenceCount;
+    State.CombinationCount = CombinationCount;
+    State.WorkerCount      = DisplayGheGetThreadCount(pPool);
+    State.ContextStride    = (DisplayGheGetContextSize() + TUNE_CACHE_LINE - 1) / TUNE_CACHE_LINE * TUNE_CACHE_LINE;
+    State.pIsValid         = (bool *)calloc(CombinationCount, sizeof(bool));
+    State.pResult          = (TUNE_RESULT *)calloc(JobCount, sizeof(TUNE_RESULT));
+    State.pQueue           = (TUNE_QUEUE *)aligned_alloc(TUNE_CACHE_LINE, State.WorkerCount * sizeof(TUNE_QUEUE));
+    State.pContextMemory   = (uint8_t *)aligned_alloc(TUNE_CACHE_LINE, State.WorkerCount * State.ContextStride);
+    pScore                 = (TUNE_SCORE *)calloc(CombinationCount, sizeof(TUNE_SCORE));
+
+    if ((NULL == State.pIsValid) || (NULL == State.pResult) || (NULL == State.pQueue) || (NULL == State.pContextMemory) || (NULL == pScore))
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    for (uint32_t Combination = 0; Combination < CombinationCount; Combination++)
+    {
+        State.pIsValid[Combination] = DisplayGheIsValidConfig(&State.pCombination[Combination]);
+        ValidCount += State.pIsValid[Combination];
+    }
+
+    // Contiguous shares keep one combination's sequences together
+    for (uint32_t Worker = 0; Worker < State.WorkerCount; Worker++)
+    {
+        atomic_init(&State.pQueue[Worker].Range, PackRange((uint32_t)((uint64_t)JobCount * Worker / State.WorkerCount),
+                                                           (uint32_t)((uint64_t)JobCount * (Worker + 1) / State.WorkerCount)));
+        State.pQueue[Worker].Steals = 0;
+    }
+
+    Start = NowInSeconds();
+    DisplayGheThreadPoolRun(pPool, State.WorkerCount, WorkerTask, &State);
+    Elapsed = NowInSeconds() - Start;
+
+    for (uint32_t Worker = 0; Worker < State.WorkerCount; Worker++)
+    {
+        Steals += State.pQueue[Worker].Steals;
+    }
+
+    for (uint32_t Combination = 0; Combination < CombinationCount; Combination++)
+    {
+        TUNE_RESULT Total;
+        TUNE_SCORE *pEntry = &pScore[Combination];
+
+        memset(&Total, 0, sizeof(Total));
+
+        for (uint32_t Index = 0; Index < SequenceCount; Index++)
+        {
+            const TUNE_RESULT *pResult = &State.pResult[(size_t)Combination * SequenceCount + Index];
+
+            Total.FlickerSum         += pResult->FlickerSum;
+            Total.StrengthSum        += pResult->StrengthSum;
+            Total.ConvergenceSeconds += pResult->ConvergenceSeconds;
+            Total.Frames             += pResult->Frames;
+            Total.ConvergenceEvents  += pResult->ConvergenceEvents;
+        }
+
+        pEntry->Combination = Combination;
+        pEntry->Flicker     = (0 != Total.Frames) ? Total.FlickerSum / (double)Total.Frames : 0;
+        pEntry->Strength    = (0 != Total.Frames) ? Total.StrengthSum / (double)Total.Frames : 0;
+        pEntry->Convergence = (0 != Total.ConvergenceEvents) ? Total.ConvergenceSeconds / (double)Total.ConvergenceEvents : 0;
+
+        if (State.pIsValid[Combination])
+        {
+            Mean[0] += pEntry->Flicker / ValidCount;
+            Mean[1] += pEntry->Convergence / ValidCount;
+            Mean[2] += pEntry->Strength / ValidCount;
+        }
+    }
+
+    for (uint32_t Combination = 0; Combination < CombinationCount; Combination++)
+    {
+        TUNE_SCORE *pEntry = &pScore[Combination];
+
+        pEntry->Score = State.pIsValid[Combination] ?
+                        Weight[0] * pEntry->Flicker / DD_MAX(Mean[0], 1e-12) + Weight[1] * pEntry->Convergence / DD_MAX(Mean[1], 1e-12) -
+                        Weight[2] * pEntry->Strength / DD_MAX(Mean[2], 1e-12) : HUGE_VAL;
+    }
+
+    qsort(pScore, CombinationCount, sizeof(TUNE_SCORE), CompareScore);
+
+    printf("sequences          %u, %llu frames\n", SequenceCount, (unsigned long long)FrameCount);
+    printf("combinations       %u, %u valid\n", CombinationCount, ValidCount);
+    printf("threads            %u, %llu steals\n", State.WorkerCount, (unsigned long long)Steals);
+    printf("elapsed            %.2f s, %.1f M frames/s\n", Elapsed, (double)FrameCount * ValidCount / Elapsed / 1e6);
+    printf("\n%4s %9s %9s %9s %9s  ", "rank", "score", "flicker%", "conv s", "boost%");
+    for (uint32_t Index = 0; Index < TUNE_MAX_PARAMETERS; Index++)
+    {
+        printf("%s%s", (0 == Index) ? "" : " ", Parameters[Index].pName);
+    }
+    printf("\n");
+
+    for (uint32_t Rank = 0; (Rank < TopCount) && (Rank < ValidCount); Rank++)
+    {
+        printf("%4u %9.4f %9.4f %9.3f %9.3f  ", Rank + 1, pScore[Rank].Score, pScore[Rank].Flicker, pScore[Rank].Convergence, pScore[Rank].Strength);
+        PrintParameters(stdout, &State.pCombination[pScore[Rank].Combination], " ");
+        printf("\n");
+    }
+
+    if (NULL != pOutputPath)
+    {
+        FILE *pFile = fopen(pOutputPath, "w");
+
+        if (NULL == pFile)
+        {
+            fprintf(stderr, "cannot write %s\n", pOutputPath);
+            return 1;
+        }
+
+        fprintf(pFile, "rank,score,flicker_percent,convergence_s,boost_percent");
+        for (uint32_t Index = 0; Index < TUNE_MAX_PARAMETERS; Index++)
+        {
+            fprintf(pFile, ",%s", Parameters[Index].pName);
+        }
+        fprintf(pFile, "\n");
+
+        for (uint32_t Rank = 0; Rank < ValidCount; Rank++)
+        {
+            fprintf(pFile, "%u,%.6f,%.6f,%.6f,%.6f,", Rank + 1, pScore[Rank].Score, pScore[Rank].Flicker, pScore[Rank].Convergence, pScore[Rank].Strength);
+            PrintParameters(pFile, &State.pCombination[pScore[Rank].Combination], ",");
+            fprintf(pFile, "\n");
+        }
+
+        fclose(pFile);
+    }
+
+    DisplayGheDestroyThreadPool(pPool);
+
+    for (uint32_t Index = 0; Index < SequenceCount; Index++)
+    {
+        free(pSequence[Index].pFrame);
+    }
+
+    free(pSequence);
+    free(State.pCombination);
+    free(State.pIsValid);
+    free(State.pResult);
+    free(State.pQueue);
+    free(State.pContextMemory);
+    free(pScore);
+
+    return 0;
+}
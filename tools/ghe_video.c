@@ -0,0 +1,590 @@
+/**
+ *
+ * @file  ghe_video.c
+ * @brief  Streaming GHE over raw or Y4M video files: histogram, GHE and DIET apply as pipelined stages
+ *
+ * The input is mapped read only and the output is created at the same size and mapped shared, so
+ * DisplayGheApplyDiet reads every frame straight from the page cache of the input and writes it
+ * straight into the page cache of the output. Chroma planes and Y4M headers are copied once from
+ * input to output, nothing else is copied.
+ *
+ * Three threads run the stages, histogram extraction, DisplayGheProcessFrame on one context that
+ * keeps its temporal state across the whole file, and the DIET apply. They hand frames on through
+ * a bounded ring of VIDEO_QUEUE_DEPTH slots, so frame n + 2 is binned while frame n is written and
+ * the stages never run more than the ring ahead of each other. -s runs the same stages one after
+ * another on a single thread for comparison.
+ *
+ * Frame n carries TimestampNs (n + 1) / rate, which drives the temporal filter at the file rate.
+ * Its own LUT is applied to it. The rate is the F tag of a Y4M header, else -r, 60 by default.
+ *
+ * Planar and semi planar YUV are equalized on the luma plane. Y4M takes C420 (all siting
+ * variants), C422, C444 and Cmono, 8 bit or p10.
+ *
+ * -t gives the histogram and the apply stage a thread pool each for their row bands.
+ *
+ * usage: ghe_video [-f format -w width -h height] [-r fps] [-t threads] [-s] input output
+ *        format: rgb888 rgba8888 rgba1010102 yuyv y8 y10 i420 nv12 p010, omitted for Y4M input
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../GHE_Algorithm.h"
+#include "../GHE_Cpu.h"
+#include "../GHE_Histogram.h"
+#include "../GHE_LutApply.h"
+#include "ghe_tool_common.h"
+
+#define VIDEO_QUEUE_DEPTH 4         // Frames in flight between the first and the last stage
+#define VIDEO_NO_FRAME_COUNT UINT64_MAX
+
+typedef enum _VIDEO_CHROMA
+{
+    VIDEO_CHROMA_NONE,              // Packed formats carry chroma in the pixel, luma only formats have none
+    VIDEO_CHROMA_420,
+    VIDEO_CHROMA_422,
+    VIDEO_CHROMA_444
+} VIDEO_CHROMA;
+
+typedef enum _VIDEO_STAGE
+{
+    VIDEO_STAGE_HISTOGRAM = 0,
+    VIDEO_STAGE_GHE,
+    VIDEO_STAGE_APPLY,
+    VIDEO_STAGE_COUNT
+} VIDEO_STAGE;
+
+static const char *StageName[VIDEO_STAGE_COUNT] = { "histogram", "ghe", "apply" };
+
+typedef struct _VIDEO_RAW_FORMAT
+{
+    const char *pName;
+    GlobalHist_PIXEL_FORMAT LumaFormat;
+    VIDEO_CHROMA Chroma;
+} VIDEO_RAW_FORMAT;
+
+static const VIDEO_RAW_FORMAT RawFormat[] =
+{
+    { "rgb888",      GlobalHist_PIXEL_FORMAT_RGB888,      VIDEO_CHROMA_NONE },
+    { "rgba8888",    GlobalHist_PIXEL_FORMAT_RGBA8888,    VIDEO_CHROMA_NONE },
+    { "rgba1010102", GlobalHist_PIXEL_FORMAT_RGBA1010102, VIDEO_CHROMA_NONE },
+    { "yuyv",        GlobalHist_PIXEL_FORMAT_YUYV,        VIDEO_CHROMA_NONE },
+    { "y8",          GlobalHist_PIXEL_FORMAT_Y8,          VIDEO_CHROMA_NONE },
+    { "y10",         GlobalHist_PIXEL_FORMAT_Y10,         VIDEO_CHROMA_NONE },
+    { "i420",        GlobalHist_PIXEL_FORMAT_Y8,          VIDEO_CHROMA_420 },
+    { "nv12",        GlobalHist_PIXEL_FORMAT_Y8,          VIDEO_CHROMA_420 },
+    { "p010",        GlobalHist_PIXEL_FORMAT_P010,        VIDEO_CHROMA_420 },
+};
+
+typedef struct _VIDEO_STREAM
+{
+    const uint8_t *pInput;
+    uint8_t *pOutput;
+    uint64_t Size;
+    uint32_t Width;
+    uint32_t Height;
+    GlobalHist_PIXEL_FORMAT LumaFormat;
+    uint32_t LumaStride;
+    uint64_t LumaBytes;
+    uint64_t ChromaBytes;          // All chroma planes of a frame, following the luma plane
+    uint64_t FirstFrame;           // Offset of the first frame, after the Y4M stream header
+    bool IsY4m;                    // Every frame starts with a FRAME line
+    uint32_t RateNum;
+    uint32_t RateDen;
+} VIDEO_STREAM;
+
+typedef struct _VIDEO_SLOT
+{
+    uint64_t FrameOffset;          // First byte of the frame, its FRAME line for Y4M
+    uint64_t PixelOffset;          // First luma byte
+    GlobalHist_ARGS Args;
+} VIDEO_SLOT;
+
+typedef struct _VIDEO_PIPELINE
+{
+    VIDEO_STREAM *pStream;
+    GlobalHist_CONTEXT *pContext;
+    GlobalHist_THREAD_POOL *pHistogramPool;  // Row bands of each stage, NULL for none
+    GlobalHist_THREAD_POOL *pApplyPool;
+    uint64_t NextFrameOffset;                // Histogram stage only
+
+    VIDEO_SLOT Slot[VIDEO_QUEUE_DEPTH];
+    pthread_mutex_t Lock;
+    pthread_cond_t Progress;
+    uint64_t Done[VIDEO_STAGE_COUNT];        // Frames every stage has finished, under Lock
+    uint64_t FrameCount;                     // Set by the histogram stage at the end of the input
+    double BusyNs[VIDEO_STAGE_COUNT];        // Each written by its stage only
+} VIDEO_PIPELINE;
+
+typedef struct _VIDEO_WORKER
+{
+    VIDEO_PIPELINE *pPipeline;
+    VIDEO_STAGE Stage;
+} VIDEO_WORKER;
+
+static uint64_t GetChromaBytes(VIDEO_CHROMA Chroma, uint32_t Width, uint32_t Height, uint32_t SampleBytes)
+{
+    uint64_t HalfWidth = (Width + 1) / 2, HalfHeight = (Height + 1) / 2;
+
+    switch (Chroma)
+    {
+    case VIDEO_CHROMA_420: return 2 * HalfWidth * HalfHeight * SampleBytes;
+    case VIDEO_CHROMA_422: return 2 * HalfWidth * Height * SampleBytes;
+    case VIDEO_CHROMA_444: return 2 * (uint64_t)Width * Height * SampleBytes;
+    default:               return 0;
+    }
+}
+
+static void SetLumaPlane(VIDEO_STREAM *pStream, GlobalHist_PIXEL_FORMAT LumaFormat, VIDEO_CHROMA Chroma)
+{
+    uint32_t Bpp = DisplayGheGetBytesPerPixel(LumaFormat);
+
+    pStream->LumaFormat  = LumaFormat;
+    pStream->LumaStride  = pStream->Width * Bpp;
+    pStream->LumaBytes   = (uint64_t)pStream->LumaStride * pStream->Height;
+    pStream->ChromaBytes = GetChromaBytes(Chroma, pStream->Width, pStream->Height, (VIDEO_CHROMA_NONE == Chroma) ? 0 : Bpp);
+}
+
+// YUV4MPEG2 W<width> H<height> F<num>:<den> C<colorspace> ..., the other tags are ignored
+static bool ParseY4mHeader(VIDEO_STREAM *pStream)
+{
+    const char *pHeader = (const char *)pStream->pInput;
+    const char *pEnd = memchr(pHeader, '\n', (size_t)DD_MIN(pStream->Size, 1024));
+    const char *pTag = pHeader + 10;
+    GlobalHist_PIXEL_FORMAT LumaFormat = GlobalHist_PIXEL_FORMAT_Y8;
+    VIDEO_CHROMA Chroma = VIDEO_CHROMA_420;
+
+    if (NULL == pEnd)
+    {
+        return FALSE;
+    }
+
+    // The rate stays as -r or its default gave it unless the header carries one
+    while (pTag < pEnd)
+    {
+        const char *pNext = pTag + 1;
+
+        while ((pNext < pEnd) && (' ' != *pNext))
+        {
+            pNext++;
+        }
+
+        switch (*pTag)
+        {
+        case 'W': pStream->Width = (uint32_t)strtoul(pTag + 1, NULL, 10); break;
+        case 'H': pStream->Height = (uint32_t)strtoul(pTag + 1, NULL, 10); break;
+        case 'F': sscanf(pTag + 1, "%u:%u", &pStream->RateNum, &pStream->RateDen); break;
+        case 'C':
+        {
+            const char *pDepth = pTag + 4;   // C420p10, C444p10, Cmono10
+
+            Chroma = (0 == strncmp(pTag, "Cmono", 5)) ? VIDEO_CHROMA_NONE :
+                     (0 == strncmp(pTag, "C444", 4))  ? VIDEO_CHROMA_444 :
+                     (0 == strncmp(pTag, "C422", 4))  ? VIDEO_CHROMA_422 : VIDEO_CHROMA_420;
+
+            pDepth += (VIDEO_CHROMA_NONE == Chroma) ? 1 : (('p' == *pDepth) ? 1 : 0);
+
+            // High bit depth samples are little endian words with the value in the low bits
+            if ((pDepth < pNext) && ('0' <= *pDepth) && ('9' >= *pDepth))
+            {
+                if (10 != strtoul(pDepth, NULL, 10))
+                {
+                    return FALSE;
+                }
+
+                LumaFormat = GlobalHist_PIXEL_FORMAT_Y10;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+
+        pTag = pNext + 1;
+    }
+
+    if ((0 == pStream->Width) || (0 == pStream->Height) || (0 == pStream->RateNum) || (0 == pStream->RateDen))
+    {
+        return FALSE;
+    }
+
+    pStream->IsY4m = TRUE;
+    pStream->FirstFrame = (uint64_t)(pEnd + 1 - pHeader);
+    SetLumaPlane(pStream, LumaFormat, Chroma);
+
+    return TRUE;
+}
+
+// Finds the frame at pPipeline->NextFrameOffset. FALSE at the end of the input, a truncated last
+// frame included.
+static bool LocateFrame(VIDEO_PIPELINE *pPipeline, VIDEO_SLOT *pSlot)
+{
+    const VIDEO_STREAM *pStream = pPipeline->pStream;
+    uint64_t Offset = pPipeline->NextFrameOffset;
+
+    pSlot->FrameOffset = Offset;
+
+    if (pStream->IsY4m)
+    {
+        const uint8_t *pLine = pStream->pInput + Offset;
+        const uint8_t *pEnd;
+
+        if ((Offset + 5 > pStream->Size) || (0 != memcmp(pLine, "FRAME", 5)))
+        {
+            return FALSE;
+        }
+
+        pEnd = memchr(pLine, '\n', (size_t)DD_MIN(pStream->Size - Offset, 1024));
+
+        if (NULL == pEnd)
+        {
+            return FALSE;
+        }
+
+        Offset += (uint64_t)(pEnd + 1 - pLine);
+    }
+
+    pSlot->PixelOffset = Offset;
+    Offset += pStream->LumaBytes + pStream->ChromaBytes;
+
+    if (Offset > pStream->Size)
+    {
+        return FALSE;
+    }
+
+    pPipeline->NextFrameOffset = Offset;
+    return TRUE;
+}
+
+static GlobalHist_FRAME GetLumaFrame(const VIDEO_STREAM *pStream, const VIDEO_SLOT *pSlot)
+{
+    GlobalHist_FRAME Frame;
+
+    Frame.pData  = pStream->pInput + pSlot->PixelOffset;
+    Frame.Width  = pStream->Width;
+    Frame.Height = pStream->Height;
+    Frame.Stride = pStream->LumaStride;
+    Frame.Format = pStream->LumaFormat;
+
+    return Frame;
+}
+
+static bool RunHistogram(VIDEO_PIPELINE *pPipeline, uint64_t FrameIndex, VIDEO_SLOT *pSlot)
+{
+    const VIDEO_STREAM *pStream = pPipeline->pStream;
+    GlobalHist_FRAME Frame;
+
+    if (FALSE == LocateFrame(pPipeline, pSlot))
+    {
+        return FALSE;
+    }
+
+    Frame = GetLumaFrame(pStream, pSlot);
+
+    memset(&pSlot->Args, 0, sizeof(pSlot->Args));
+    pSlot->Args.PipeId      = GlobalHist_PIPE_ANY;
+    pSlot->Args.TimestampNs = (FrameIndex + 1) * 1000000000ull * pStream->RateDen / pStream->RateNum;
+
+    return DisplayGheBuildHistogram(&Frame, &pSlot->Args, pPipeline->pHistogramPool);
+}
+
+static void RunGhe(VIDEO_PIPELINE *pPipeline, VIDEO_SLOT *pSlot)
+{
+    DisplayGheProcessFrame(pPipeline->pContext, &pSlot->Args);
+}
+
+static void RunApply(VIDEO_PIPELINE *pPipeline, VIDEO_SLOT *pSlot)
+{
+    const VIDEO_STREAM *pStream = pPipeline->pStream;
+    GlobalHist_FRAME Frame = GetLumaFrame(pStream, pSlot);
+    uint64_t ChromaOffset = pSlot->PixelOffset + pStream->LumaBytes;
+
+    // The FRAME line and the chroma planes pass through
+    memcpy(pStream->pOutput + pSlot->FrameOffset, pStream->pInput + pSlot->FrameOffset, (size_t)(pSlot->PixelOffset - pSlot->FrameOffset));
+    memcpy(pStream->pOutput + ChromaOffset, pStream->pInput + ChromaOffset, (size_t)pStream->ChromaBytes);
+
+    DisplayGheApplyDiet(&Frame, pStream->pOutput + pSlot->PixelOffset, pStream->LumaStride, pSlot->Args.DietFactor, pPipeline->pApplyPool);
+}
+
+// Waits until the stage may take FrameIndex: the previous stage is done with it, and for the
+// first stage the last one has freed its slot. FALSE once the input ended before FrameIndex.
+static bool WaitForFrame(VIDEO_PIPELINE *pPipeline, VIDEO_STAGE Stage, uint64_t FrameIndex)
+{
+    bool IsReady;
+
+    pthread_mutex_lock(&pPipeline->Lock);
+
+    for (;;)
+    {
+        if (FrameIndex >= pPipeline->FrameCount)
+        {
+            IsReady = FALSE;
+            break;
+        }
+
+        if ((VIDEO_STAGE_HISTOGRAM == Stage) ? (FrameIndex < pPipeline->Done[VIDEO_STAGE_COUNT - 1] + VIDEO_QUEUE_DEPTH)
+                                             : (FrameIndex < pPipeline->Done[Stage - 1]))
+        {
+            IsReady = TRUE;
+            break;
+        }
+
+        pthread_cond_wait(&pPipeline->Progress, &pPipeline->Lock);
+    }
+
+    pthread_mutex_unlock(&pPipeline->Lock);
+
+    return IsReady;
+}
+
+static void FinishFrame(VIDEO_PIPELINE *pPipeline, VIDEO_STAGE Stage, uint64_t FrameCount, bool IsEnd)
+{
+    pthread_mutex_lock(&pPipeline->Lock);
+
+    pPipeline->Done[Stage] = FrameCount;
+
+    if (IsEnd)
+    {
+        pPipeline->FrameCount = FrameCount;
+    }
+
+    pthread_cond_broadcast(&pPipeline->Progress);
+    pthread_mutex_unlock(&pPipeline->Lock);
+}
+
+static void *StageMain(void *pArg)
+{
+    VIDEO_WORKER *pWorker = (VIDEO_WORKER *)pArg;
+    VIDEO_PIPELINE *pPipeline = pWorker->pPipeline;
+    VIDEO_STAGE Stage = pWorker->Stage;
+
+    for (uint64_t FrameIndex = 0; WaitForFrame(pPipeline, Stage, FrameIndex); FrameIndex++)
+    {
+        VIDEO_SLOT *pSlot = &pPipeline->Slot[FrameIndex % VIDEO_QUEUE_DEPTH];
+        double Start = (double)GetTimeNs();
+        bool IsEnd = FALSE;
+
+        switch (Stage)
+        {
+        case VIDEO_STAGE_HISTOGRAM: IsEnd = (FALSE == RunHistogram(pPipeline, FrameIndex, pSlot)); break;
+        case VIDEO_STAGE_GHE:       RunGhe(pPipeline, pSlot); break;
+        default:                    RunApply(pPipeline, pSlot); break;
+        }
+
+        pPipeline->BusyNs[Stage] += (double)GetTimeNs() - Start;
+        FinishFrame(pPipeline, Stage, IsEnd ? FrameIndex : FrameIndex + 1, IsEnd);
+    }
+
+    return NULL;
+}
+
+static uint64_t RunPipelined(VIDEO_PIPELINE *pPipeline)
+{
+    pthread_t Thread[VIDEO_STAGE_COUNT];
+    VIDEO_WORKER Worker[VIDEO_STAGE_COUNT];
+
+    for (uint32_t Stage = 0; Stage < VIDEO_STAGE_COUNT; Stage++)
+    {
+        Worker[Stage].pPipeline = pPipeline;
+        Worker[Stage].Stage = (VIDEO_STAGE)Stage;
+        pthread_create(&Thread[Stage], NULL, StageMain, &Worker[Stage]);
+    }
+
+    for (uint32_t Stage = 0; Stage < VIDEO_STAGE_COUNT; Stage++)
+    {
+        pthread_join(Thread[Stage], NULL);
+    }
+
+    return pPipeline->FrameCount;
+}
+
+static uint64_t RunSequential(VIDEO_PIPELINE *pPipeline)
+{
+    VIDEO_SLOT *pSlot = &pPipeline->Slot[0];
+    uint64_t FrameIndex = 0;
+
+    for (;;)
+    {
+        double Start = (double)GetTimeNs(), Histogram, Ghe;
+
+        if (FALSE == RunHistogram(pPipeline, FrameIndex, pSlot))
+        {
+            return FrameIndex;
+        }
+
+        Histogram = (double)GetTimeNs();
+        RunGhe(pPipeline, pSlot);
+        Ghe = (double)GetTimeNs();
+        RunApply(pPipeline, pSlot);
+
+        pPipeline->BusyNs[VIDEO_STAGE_HISTOGRAM] += Histogram - Start;
+        pPipeline->BusyNs[VIDEO_STAGE_GHE]       += Ghe - Histogram;
+        pPipeline->BusyNs[VIDEO_STAGE_APPLY]     += (double)GetTimeNs() - Ghe;
+        FrameIndex++;
+    }
+}
+
+static int Usage(const char *pProgram)
+{
+    fprintf(stderr, "usage: %s [-f format -w width -h height] [-r fps] [-t threads] [-s] input output\n"
+                    "       format: rgb888 rgba8888 rgba1010102 yuyv y8 y10 i420 nv12 p010, omitted for Y4M input\n", pProgram);
+    return 2;
+}
+
+int main(int argc, char **argv)
+{
+    VIDEO_STREAM Stream;
+    VIDEO_PIPELINE Pipeline;
+    const VIDEO_RAW_FORMAT *pRawFormat = NULL;
+    uint32_t ThreadCount = 0;
+    bool IsSequential = FALSE;
+    struct stat Info;
+    int Option, InputFd, OutputFd;
+    double Start, ElapsedNs;
+    uint64_t FrameCount;
+
+    memset(&Stream, 0, sizeof(Stream));
+    Stream.RateNum = 60;
+    Stream.RateDen = 1;
+
+    while (-1 != (Option = getopt(argc, argv, "f:w:h:r:t:s")))
+    {
+        switch (Option)
+        {
+        case 'f':
+            for (uint32_t Index = 0; Index < sizeof(RawFormat) / sizeof(RawFormat[0]); Index++)
+            {
+                if (0 == strcasecmp(optarg, RawFormat[Index].pName))
+                {
+                    pRawFormat = &RawFormat[Index];
+                }
+            }
+
+            if (NULL == pRawFormat)
+            {
+                return Usage(argv[0]);
+            }
+            break;
+        case 'w': Stream.Width = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'h': Stream.Height = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'r': Stream.RateNum = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 't': ThreadCount = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 's': IsSequential = TRUE; break;
+        default:  return Usage(argv[0]);
+        }
+    }
+
+    if ((argc - optind != 2) || (0 == Stream.RateNum))
+    {
+        return Usage(argv[0]);
+    }
+
+    InputFd = open(argv[optind], O_RDONLY);
+
+    if ((InputFd < 0) || (0 != fstat(InputFd, &Info)) || (0 == Info.st_size))
+    {
+        fprintf(stderr, "can not read %s\n", argv[optind]);
+        return 1;
+    }
+
+    Stream.Size = (uint64_t)Info.st_size;
+    Stream.pInput = (const uint8_t *)mmap(NULL, (size_t)Stream.Size, PROT_READ, MAP_PRIVATE, InputFd, 0);
+
+    if (MAP_FAILED == (void *)Stream.pInput)
+    {
+        fprintf(stderr, "can not map %s\n", argv[optind]);
+        return 1;
+    }
+
+    madvise((void *)Stream.pInput, (size_t)Stream.Size, MADV_SEQUENTIAL);
+
+    if (NULL != pRawFormat)
+    {
+        if ((0 == Stream.Width) || (0 == Stream.Height))
+        {
+            return Usage(argv[0]);
+        }
+
+        SetLumaPlane(&Stream, pRawFormat->LumaFormat, pRawFormat->Chroma);
+    }
+    else if ((Stream.Size < 10) || (0 != memcmp(Stream.pInput, "YUV4MPEG2 ", 10)) || (FALSE == ParseY4mHeader(&Stream)))
+    {
+        fprintf(stderr, "%s is not Y4M 8 bit or p10, give -f -w -h for raw input\n", argv[optind]);
+        return 1;
+    }
+
+    // Same size and layout as the input, the stages write every frame in place
+    OutputFd = open(argv[optind + 1], O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if ((OutputFd < 0) || (0 != ftruncate(OutputFd, (off_t)Stream.Size)))
+    {
+        fprintf(stderr, "can not create %s\n", argv[optind + 1]);
+        return 1;
+    }
+
+    Stream.pOutput = (uint8_t *)mmap(NULL, (size_t)Stream.Size, PROT_READ | PROT_WRITE, MAP_SHARED, OutputFd, 0);
+
+    if (MAP_FAILED == (void *)Stream.pOutput)
+    {
+        fprintf(stderr, "can not map %s\n", argv[optind + 1]);
+        return 1;
+    }
+
+    memcpy(Stream.pOutput, Stream.pInput, (size_t)Stream.FirstFrame);
+
+    memset(&Pipeline, 0, sizeof(Pipeline));
+    Pipeline.pStream         = &Stream;
+    Pipeline.pContext        = DisplayGheCreateContext(GlobalHist_PIPE_ANY);
+    Pipeline.pHistogramPool  = (0 == ThreadCount) ? NULL : DisplayGheCreateThreadPool(ThreadCount);
+    Pipeline.pApplyPool      = (0 == ThreadCount) ? NULL : DisplayGheCreateThreadPool(ThreadCount);
+    Pipeline.NextFrameOffset = Stream.FirstFrame;
+    Pipeline.FrameCount      = VIDEO_NO_FRAME_COUNT;
+    pthread_mutex_init(&Pipeline.Lock, NULL);
+    pthread_cond_init(&Pipeline.Progress, NULL);
+
+    if ((NULL == Pipeline.pContext) || ((0 != ThreadCount) && ((NULL == Pipeline.pHistogramPool) || (NULL == Pipeline.pApplyPool))))
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    Start = (double)GetTimeNs();
+    FrameCount = IsSequential ? RunSequential(&Pipeline) : RunPipelined(&Pipeline);
+
+    // Anything after the last complete frame passes through
+    memcpy(Stream.pOutput + Pipeline.NextFrameOffset, Stream.pInput + Pipeline.NextFrameOffset, (size_t)(Stream.Size - Pipeline.NextFrameOffset));
+    msync(Stream.pOutput, (size_t)Stream.Size, MS_SYNC);
+    ElapsedNs = (double)GetTimeNs() - Start;
+
+    printf("input              %ux%u %s luma, %s, %u/%u fps\n", Stream.Width, Stream.Height,
+           (NULL != pRawFormat) ? pRawFormat->pName : "y4m", IsSequential ? "sequential" : "pipelined", Stream.RateNum, Stream.RateDen);
+    printf("kernels            %s, %u pool threads per stage\n", DisplayGheGetIsaName(DisplayGheGetIsa()), ThreadCount);
+    printf("frames             %llu in %.3f s, %.1f frames/s, %.1f MB/s\n", (unsigned long long)FrameCount, ElapsedNs / 1e9,
+           1e9 * FrameCount / ElapsedNs, 1e3 * Stream.Size / ElapsedNs);
+
+    for (uint32_t Stage = 0; Stage < VIDEO_STAGE_COUNT; Stage++)
+    {
+        printf("%-18s %8.3f ms/frame busy, %5.1f%% of wall\n", StageName[Stage],
+               (0 == FrameCount) ? 0.0 : Pipeline.BusyNs[Stage] / FrameCount / 1e6, 100.0 * Pipeline.BusyNs[Stage] / ElapsedNs);
+    }
+
+    munmap(Stream.pOutput, (size_t)Stream.Size);
+    munmap((void *)Stream.pInput, (size_t)Stream.Size);
+    close(OutputFd);
+    close(InputFd);
+    DisplayGheDestroyThreadPool(Pipeline.pHistogramPool);
+    DisplayGheDestroyThreadPool(Pipeline.pApplyPool);
+    DisplayGheDestroyContext(Pipeline.pContext);
+    pthread_mutex_destroy(&Pipeline.Lock);
+    pthread_cond_destroy(&Pipeline.Progress);
+
+    return 0;
+}